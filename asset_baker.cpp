@@ -0,0 +1,30 @@
+/*
+ * =================================================================================================
+ * ASSET BAKER - SISTEMA SOLAR EM OPENGL
+ *
+ * Gera o pacote de assets (asset_pack.h) usado pelo sistema_solar: o catálogo de corpos e todas
+ * as texturas, já reamostradas e com os mipmaps prontos. Com o pacote presente e atualizado, o
+ * programa mapeia o arquivo na inicialização em vez de decodificar cada imagem.
+ *
+ * Uso: ./asset_baker [arquivo.pack]   (padrão: sistema_solar.pack)
+ * =================================================================================================
+ */
+
+#include <chrono>
+#include <cstdio>
+
+#include "asset_pack.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : DEFAULT_PACK_PATH;
+    auto start = chrono::steady_clock::now();
+    printf("Gerando %s...\n", path);
+    if (!bakeAssetPack(path, BODY_CATALOG, BODY_CATALOG_SIZE, true)) return 1;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    printf("Pacote gerado em %.0f ms\n", ms);
+    return 0;
+}
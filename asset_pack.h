@@ -0,0 +1,287 @@
+/*
+ * =================================================================================================
+ * PACOTE DE ASSETS
+ *
+ * Um único arquivo com o catálogo de corpos e todas as texturas já reamostradas para o tamanho
+ * comum das camadas, com a cadeia de mipmaps completa em RGBA8. Em tempo de execução o arquivo
+ * é mapeado com mmap e os níveis são enviados ao OpenGL direto do mapeamento, sem decodificação.
+ *
+ * Cada nível é gravado duas vezes: em RGBA8 e codificado em BC3 (texture_compression.h); o
+ * programa envia a versão que o driver suporta e as páginas da outra nunca são lidas.
+ *
+ * Layout (little-endian):
+ *   PackHeader
+ *   CatalogEntry[catalogCount]
+ *   PackTexture[textureCount]
+ *   dados dos níveis, cada um alinhado em PACK_ALIGNMENT bytes
+ *
+ * O cabeçalho guarda um hash do conteúdo de origem (versão do formato, catálogo e bytes de cada
+ * imagem). Se alguma imagem ou o catálogo mudar, o hash deixa de bater e o pacote é refeito.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "catalog.h"
+#include "mipmap.h"
+#include "texture_compression.h"
+#include "stb_image.h"
+
+const char PACK_MAGIC[8] = {'S', 'S', 'P', 'A', 'C', 'K', 0, 0};
+const uint32_t PACK_VERSION = 4;
+const uint32_t PACK_MAX_LEVELS = 16;
+const uint64_t PACK_ALIGNMENT = 64;
+const char* const DEFAULT_PACK_PATH = "sistema_solar.pack";
+
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t catalogCount;
+    uint32_t textureCount;
+    uint32_t layerWidth, layerHeight; // Tamanho comum do nível 0 de todas as texturas.
+    uint32_t reserved;
+    uint64_t contentHash;
+};
+
+struct PackTexture {
+    char name[32];                      // Mesmo nome do campo 'texture' do catálogo.
+    uint32_t levelCount;
+    uint32_t reserved;
+    uint64_t levelOffset[PACK_MAX_LEVELS]; // Deslocamento de cada nível a partir do início do arquivo.
+    uint64_t blockOffset[PACK_MAX_LEVELS]; // O mesmo, para os níveis codificados em BC3.
+};
+
+// Pacote mapeado em memória.
+struct AssetPack {
+    void* mapping = nullptr;
+    size_t size = 0;
+    const PackHeader* header = nullptr;
+    const CatalogEntry* catalog = nullptr;
+    const PackTexture* textures = nullptr;
+};
+
+// Hash de 64 bits simples (FNV-1a sobre palavras de 8 bytes, com mistura final).
+inline uint64_t packHash(const void* data, size_t size, uint64_t hash) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    const uint64_t prime = 0x100000001b3ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; i++) hash = (hash ^ bytes[i]) * prime;
+    return hash;
+}
+
+// Hash de tudo o que entra no pacote: versão do formato, catálogo e o conteúdo de cada textura.
+// Texturas ausentes entram como um marcador, para que o pacote seja refeito quando aparecerem.
+inline uint64_t computeAssetHash(const CatalogEntry* catalog, int count) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = packHash(&PACK_VERSION, sizeof(PACK_VERSION), hash);
+    hash = packHash(catalog, sizeof(CatalogEntry) * count, hash);
+    for (int i = 0; i < count; i++) {
+        int fd = open(catalog[i].texture, O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0) {
+            if (fd >= 0) close(fd);
+            hash = packHash("ausente", 7, hash);
+            continue;
+        }
+        void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            hash = packHash("ausente", 7, hash);
+            continue;
+        }
+        hash = packHash(data, info.st_size, hash);
+        munmap(data, info.st_size);
+    }
+    return hash;
+}
+
+// Reamostra uma imagem RGBA com filtragem bilinear (centros de texel alinhados).
+inline MipLevel resampleImage(const MipLevel& src, int width, int height) {
+    MipLevel dst = {width, height, std::vector<unsigned char>((size_t)width * height * 4)};
+    for (int y = 0; y < height; y++) {
+        float sy = std::fmax((y + 0.5f) * src.height / height - 0.5f, 0.0f);
+        int y0 = std::min((int)sy, src.height - 1), y1 = std::min(y0 + 1, src.height - 1);
+        float fy = sy - y0;
+        for (int x = 0; x < width; x++) {
+            float sx = std::fmax((x + 0.5f) * src.width / width - 0.5f, 0.0f);
+            int x0 = std::min((int)sx, src.width - 1), x1 = std::min(x0 + 1, src.width - 1);
+            float fx = sx - x0;
+            const unsigned char* p00 = &src.pixels[((size_t)y0 * src.width + x0) * 4];
+            const unsigned char* p01 = &src.pixels[((size_t)y0 * src.width + x1) * 4];
+            const unsigned char* p10 = &src.pixels[((size_t)y1 * src.width + x0) * 4];
+            const unsigned char* p11 = &src.pixels[((size_t)y1 * src.width + x1) * 4];
+            unsigned char* out = &dst.pixels[((size_t)y * width + x) * 4];
+            for (int c = 0; c < 4; c++) {
+                float top = p00[c] + (p01[c] - p00[c]) * fx;
+                float bottom = p10[c] + (p11[c] - p10[c]) * fx;
+                out[c] = (unsigned char)(top + (bottom - top) * fy + 0.5f);
+            }
+        }
+    }
+    return dst;
+}
+
+// Decodifica uma imagem como RGBA8 e a reamostra para width x height. Em caso de falha,
+// devolve um texel branco reamostrado, como um corpo sem textura.
+inline MipLevel decodeLayerImage(const char* filename, int width, int height) {
+    int imageWidth, imageHeight, nrChannels;
+    unsigned char* data = stbi_load(filename, &imageWidth, &imageHeight, &nrChannels, 4);
+    MipLevel image;
+    if (data) {
+        image = {imageWidth, imageHeight, std::vector<unsigned char>(data, data + (size_t)imageWidth * imageHeight * 4)};
+        stbi_image_free(data);
+    } else {
+        fprintf(stderr, "Falha ao carregar textura: %s\n", filename);
+        image = {1, 1, {255, 255, 255, 255}};
+    }
+    if (image.width != width || image.height != height) image = resampleImage(image, width, height);
+    return image;
+}
+
+// Tamanho comum das camadas: o da maior imagem do catálogo (só os cabeçalhos são lidos).
+inline void packLayerSize(const CatalogEntry* catalog, int count, int& width, int& height) {
+    width = height = 1;
+    for (int i = 0; i < count; i++) {
+        int imageWidth = 1, imageHeight = 1, nrChannels;
+        stbi_info(catalog[i].texture, &imageWidth, &imageHeight, &nrChannels);
+        width = std::max(width, imageWidth);
+        height = std::max(height, imageHeight);
+    }
+}
+
+// Gera o pacote a partir das imagens e do catálogo. O arquivo é escrito com outro nome e
+// renomeado no fim, então um pacote interrompido nunca é lido. Retorna false em caso de erro.
+inline bool bakeAssetPack(const char* path, const CatalogEntry* catalog, int count, bool verbose) {
+    PackHeader header = {};
+    memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_VERSION;
+    header.catalogCount = count;
+    header.textureCount = count;
+    header.contentHash = computeAssetHash(catalog, count);
+    int width, height;
+    packLayerSize(catalog, count, width, height);
+    header.layerWidth = width;
+    header.layerHeight = height;
+
+    std::string temporary = std::string(path) + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file) {
+        fprintf(stderr, "Falha ao criar o pacote: %s\n", temporary.c_str());
+        return false;
+    }
+    std::vector<PackTexture> textures(count);
+    uint64_t offset = sizeof(PackHeader) + sizeof(CatalogEntry) * count + sizeof(PackTexture) * count;
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(catalog, sizeof(CatalogEntry), count, file);
+    fwrite(textures.data(), sizeof(PackTexture), count, file); // Reescrita no fim com os deslocamentos.
+
+    const char zeros[PACK_ALIGNMENT] = {};
+    bool ok = true;
+    // Grava um bloco de dados alinhado e devolve o seu deslocamento.
+    auto writeAligned = [&](const std::vector<unsigned char>& data) {
+        uint64_t padding = (PACK_ALIGNMENT - offset % PACK_ALIGNMENT) % PACK_ALIGNMENT;
+        fwrite(zeros, 1, padding, file);
+        offset += padding;
+        uint64_t start = offset;
+        ok = ok && fwrite(data.data(), 1, data.size(), file) == data.size();
+        offset += data.size();
+        return start;
+    };
+    for (int i = 0; i < count && ok; i++) {
+        PackTexture& texture = textures[i];
+        snprintf(texture.name, sizeof(texture.name), "%s", catalog[i].texture);
+        std::vector<MipLevel> levels = generateMipChain(decodeLayerImage(catalog[i].texture, width, height));
+        texture.levelCount = (uint32_t)std::min<size_t>(levels.size(), PACK_MAX_LEVELS);
+        for (uint32_t level = 0; level < texture.levelCount; level++) {
+            texture.levelOffset[level] = writeAligned(levels[level].pixels);
+            texture.blockOffset[level] = writeAligned(compressLevelBC3(levels[level]).pixels);
+        }
+        if (verbose) printf("  %s: %u niveis\n", texture.name, texture.levelCount);
+    }
+    fseek(file, sizeof(PackHeader) + sizeof(CatalogEntry) * count, SEEK_SET);
+    fwrite(textures.data(), sizeof(PackTexture), count, file);
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path) != 0) {
+        fprintf(stderr, "Falha ao gravar o pacote: %s\n", path);
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Libera o mapeamento do pacote.
+inline void closeAssetPack(AssetPack& pack) {
+    if (pack.mapping) munmap(pack.mapping, pack.size);
+    pack = AssetPack();
+}
+
+// Mapeia o pacote e confere se ele corresponde ao conteúdo de origem atual ('expectedHash').
+// Retorna false se o arquivo não existir, estiver corrompido ou desatualizado.
+inline bool openAssetPack(const char* path, uint64_t expectedHash, AssetPack& pack) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(PackHeader)) {
+        close(fd);
+        return false;
+    }
+    pack.size = info.st_size;
+    pack.mapping = mmap(nullptr, pack.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pack.mapping == MAP_FAILED) {
+        pack = AssetPack();
+        return false;
+    }
+
+    const char* base = (const char*)pack.mapping;
+    pack.header = (const PackHeader*)base;
+    const PackHeader& header = *pack.header;
+    size_t tables = sizeof(PackHeader) + sizeof(CatalogEntry) * (size_t)header.catalogCount +
+                    sizeof(PackTexture) * (size_t)header.textureCount;
+    bool valid = memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0 && header.version == PACK_VERSION &&
+                 header.contentHash == expectedHash && tables <= pack.size;
+    if (valid) {
+        pack.catalog = (const CatalogEntry*)(base + sizeof(PackHeader));
+        pack.textures = (const PackTexture*)(pack.catalog + header.catalogCount);
+        // Confere se todos os níveis cabem no arquivo antes de confiar nos deslocamentos.
+        for (uint32_t i = 0; i < header.textureCount && valid; i++) {
+            const PackTexture& texture = pack.textures[i];
+            valid = texture.levelCount > 0 && texture.levelCount <= PACK_MAX_LEVELS;
+            uint64_t width = header.layerWidth, height = header.layerHeight;
+            for (uint32_t level = 0; level < texture.levelCount && valid; level++) {
+                valid = texture.levelOffset[level] + width * height * 4 <= pack.size &&
+                        texture.blockOffset[level] + bc3LevelSize((int)width, (int)height) <= pack.size;
+                width = std::max<uint64_t>(width / 2, 1);
+                height = std::max<uint64_t>(height / 2, 1);
+            }
+        }
+    }
+    if (!valid) closeAssetPack(pack);
+    return valid;
+}
+
+// Procura uma textura do pacote pelo nome; retorna nullptr se ela não existir.
+inline const PackTexture* findPackTexture(const AssetPack& pack, const char* name) {
+    for (uint32_t i = 0; i < pack.header->textureCount; i++) {
+        if (strncmp(pack.textures[i].name, name, sizeof(pack.textures[i].name)) == 0) return &pack.textures[i];
+    }
+    return nullptr;
+}
@@ -0,0 +1,141 @@
+/*
+ * =================================================================================================
+ * CINTURÃO DE ASTEROIDES (ARQUIVO MPCORB)
+ *
+ * Leitura dos elementos orbitais de corpos menores no formato MPCORB.DAT do Minor Planet Center
+ * (uma linha de colunas fixas por objeto, cerca de 1,3 milhão de linhas). O arquivo é lido em
+ * blocos, sem ser carregado inteiro na memória, e cada linha vai direto para um KeplerBatch
+ * (kepler.h), com a anomalia média trazida da época da linha para J2000, a época do catálogo.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "kepler.h"
+#include "simulation_clock.h"
+
+const size_t MPCORB_BLOCK_BYTES = 4 << 20; // Tamanho de cada leitura do arquivo.
+const size_t MPCORB_LINE_BYTES = 203;      // Tamanho típico de uma linha, para reservar memória.
+
+// Converte um campo de colunas fixas com um número decimal simples ("  2.7670963"). Retorna
+// false se o campo estiver vazio ou tiver outros caracteres.
+inline bool mpcorbField(const char* line, size_t lineLength, size_t firstColumn, size_t lastColumn, double& value) {
+    if (lastColumn > lineLength) return false;
+    const char* c = line + firstColumn - 1;
+    const char* end = line + lastColumn;
+    while (c < end && *c == ' ') c++;
+    bool negative = c < end && *c == '-';
+    if (c < end && (*c == '-' || *c == '+')) c++;
+    double integer = 0.0, fraction = 0.0, scale = 1.0;
+    bool digits = false;
+    for (; c < end && *c >= '0' && *c <= '9'; c++, digits = true) integer = integer * 10.0 + (*c - '0');
+    if (c < end && *c == '.') {
+        for (c++; c < end && *c >= '0' && *c <= '9'; c++, digits = true) {
+            fraction = fraction * 10.0 + (*c - '0');
+            scale *= 10.0;
+        }
+    }
+    while (c < end && *c == ' ') c++;
+    if (!digits || c != end) return false;
+    value = (integer + fraction / scale) * (negative ? -1.0 : 1.0);
+    return true;
+}
+
+// Valor de um caractere das datas compactadas do MPC: '1'-'9' e depois 'A' = 10, 'B' = 11...
+inline int mpcorbPackedDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'V') return c - 'A' + 10;
+    return -1;
+}
+
+// Dia juliano (às 0h TT) de uma época compactada, como "K24AH" = 2024-10-17.
+inline bool mpcorbEpoch(const char* packed, double& julianDay) {
+    int century = packed[0] == 'I' ? 18 : packed[0] == 'J' ? 19 : packed[0] == 'K' ? 20 : -1;
+    int decade = mpcorbPackedDigit(packed[1]), unit = mpcorbPackedDigit(packed[2]);
+    int month = mpcorbPackedDigit(packed[3]), day = mpcorbPackedDigit(packed[4]);
+    if (century < 0 || decade < 0 || decade > 9 || unit < 0 || unit > 9 || month < 1 || month > 12 || day < 1) {
+        return false;
+    }
+    julianDay = julianDayFromCalendar(century * 100 + decade * 10 + unit, month, day);
+    return true;
+}
+
+// Lê uma linha de objeto do MPCORB. Colunas (a partir de 1): época 21-25, anomalia média 27-35,
+// argumento do periélio 38-46, nodo 49-57, inclinação 60-68, excentricidade 71-79, movimento
+// médio em graus por dia 81-91 e semieixo maior em UA 93-103. Linhas do cabeçalho, vazias ou
+// de órbitas não elípticas retornam false.
+inline bool parseMpcorbLine(const char* line, size_t length, OrbitalElements& elements, double& semiMajorAxisAU) {
+    double julianDay, meanMotion;
+    if (length < 103 || !mpcorbEpoch(line + 20, julianDay)) return false;
+    if (!mpcorbField(line, length, 27, 35, elements.meanAnomaly) ||
+        !mpcorbField(line, length, 38, 46, elements.argPeriapsis) ||
+        !mpcorbField(line, length, 49, 57, elements.ascendingNode) ||
+        !mpcorbField(line, length, 60, 68, elements.inclination) ||
+        !mpcorbField(line, length, 71, 79, elements.eccentricity) ||
+        !mpcorbField(line, length, 81, 91, meanMotion) ||
+        !mpcorbField(line, length, 93, 103, semiMajorAxisAU)) {
+        return false;
+    }
+    if (elements.eccentricity >= 1.0 || meanMotion <= 0.0 || semiMajorAxisAU <= 0.0) return false;
+    elements.period = 360.0 / meanMotion;
+    // A anomalia média é trazida da época da linha para a época J2000.
+    elements.meanAnomaly -= meanMotion * (julianDay - J2000_JULIAN_DAY);
+    return true;
+}
+
+// Lê todos os objetos do arquivo para 'batch'. O semieixo maior em UA passa por 'toScene', que
+// o leva para as unidades da cena. Retorna a quantidade de objetos lidos, ou -1 se o arquivo
+// não puder ser aberto.
+inline long loadMpcorb(const char* path, const std::function<double(double)>& toScene, KeplerBatch& batch) {
+    FILE* file = std::fopen(path, "rb");
+    if (!file) return -1;
+    std::fseek(file, 0, SEEK_END);
+    long fileBytes = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    batch.reserve(batch.size() + (size_t)std::max(fileBytes, 0L) / MPCORB_LINE_BYTES);
+
+    std::vector<char> block(MPCORB_BLOCK_BYTES);
+    size_t pending = 0; // Bytes de uma linha incompleta no começo do bloco.
+    long count = 0;
+    for (;;) {
+        size_t read = std::fread(block.data() + pending, 1, block.size() - pending, file);
+        size_t available = pending + read;
+        if (available == 0) break;
+        const char* begin = block.data();
+        const char* end = begin + available;
+        for (;;) {
+            const char* newline = (const char*)std::memchr(begin, '\n', end - begin);
+            // A última linha do arquivo pode não terminar em '\n'.
+            if (!newline && read > 0) break;
+            const char* lineEnd = newline ? newline : end;
+            size_t length = lineEnd - begin;
+            if (length > 0 && begin[length - 1] == '\r') length--;
+            OrbitalElements elements;
+            double semiMajorAxisAU;
+            if (parseMpcorbLine(begin, length, elements, semiMajorAxisAU)) {
+                elements.semiMajorAxis = toScene(semiMajorAxisAU);
+                batch.add(elements);
+                count++;
+            }
+            if (!newline) {
+                begin = end;
+                break;
+            }
+            begin = newline + 1;
+        }
+        pending = end - begin;
+        if (read == 0) break;
+        // Uma linha maior que o bloco não é do formato; é descartada.
+        if (pending == block.size()) pending = 0;
+        std::memmove(block.data(), begin, pending);
+    }
+    std::fclose(file);
+    return count;
+}
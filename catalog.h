@@ -0,0 +1,57 @@
+/*
+ * =================================================================================================
+ * CATÁLOGO DE CORPOS CELESTES
+ *
+ * Dados de todos os corpos desenhados pelo programa. O catálogo é compartilhado entre o
+ * sistema_solar e o asset_baker, que o grava no pacote de assets junto com as texturas.
+ * As entradas têm tamanho fixo para poderem ser copiadas byte a byte para o pacote.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Papel de cada entrada do catálogo.
+enum BodyKind : uint32_t {
+    BODY_SUN = 0,    // Estrela central, desenhada sem iluminação.
+    BODY_PLANET = 1, // Orbita o Sol.
+    BODY_MOON = 2,   // Orbita o corpo indicado em 'parent'.
+    BODY_RING = 3,   // Anéis do corpo indicado em 'parent'; só a textura é usada.
+};
+
+struct CatalogEntry {
+    char name[16];
+    char parent[16];     // Corpo orbitado (luas) ou que recebe os anéis.
+    char texture[32];    // Arquivo de imagem, relativo à pasta do executável.
+    uint32_t kind;       // Um dos valores de BodyKind.
+    float radius;        // Raio do corpo em unidades OpenGL.
+    float distance;      // Distância do corpo que ele orbita.
+    float orbitSpeed;    // Período orbital em dias terrestres.
+    float rotationSpeed; // Período de rotação em seu eixo.
+    // Elementos orbitais na época J2000, em graus; 'distance' faz o papel do semieixo maior.
+    float eccentricity;
+    float inclination;   // Em relação à eclíptica, também para as luas.
+    float ascendingNode; // Longitude do nodo ascendente.
+    float argPeriapsis;  // Argumento do periélio.
+    float meanAnomaly;   // Anomalia média na época.
+    float mass;          // Em massas solares; usada só no modo N-corpos.
+};
+
+// {nome, pai, textura, tipo, raio, distância, período orbital, período de rotação,
+//  excentricidade, inclinação, nodo ascendente, argumento do periélio, anomalia média, massa}
+const CatalogEntry BODY_CATALOG[] = {
+    {"sun", "", "sun.jpg", BODY_SUN, 5.0f, 0.0f, 0.0f, 25.38f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f},
+    {"mercury", "sun", "mercury.jpg", BODY_PLANET, 0.5f, 10.0f, 88.0f, 58.6f, 0.2056f, 7.005f, 48.331f, 29.127f, 174.793f, 1.6601e-7f},
+    {"venus", "sun", "venus.jpg", BODY_PLANET, 0.9f, 15.0f, 225.0f, -243.0f, 0.0068f, 3.395f, 76.680f, 54.923f, 50.377f, 2.4478e-6f},
+    {"earth", "sun", "earth.jpg", BODY_PLANET, 1.0f, 20.0f, 365.0f, 1.0f, 0.0167f, 0.0f, 0.0f, 102.938f, 357.527f, 3.0035e-6f},
+    {"mars", "sun", "mars.jpg", BODY_PLANET, 0.7f, 28.0f, 687.0f, 1.03f, 0.0934f, 1.850f, 49.560f, 286.497f, 19.390f, 3.2272e-7f},
+    {"jupiter", "sun", "jupiter.jpg", BODY_PLANET, 4.0f, 45.0f, 4333.0f, 0.41f, 0.0484f, 1.304f, 100.474f, 274.255f, 19.668f, 9.5479e-4f},
+    {"saturn", "sun", "saturn.jpg", BODY_PLANET, 3.5f, 65.0f, 10759.0f, 0.44f, 0.0539f, 2.486f, 113.662f, 338.936f, 317.355f, 2.8589e-4f},
+    {"uranus", "sun", "uranus.jpg", BODY_PLANET, 2.5f, 80.0f, 30687.0f, -0.72f, 0.0473f, 0.773f, 74.017f, 96.937f, 142.284f, 4.3662e-5f},
+    {"neptune", "sun", "neptune.jpg", BODY_PLANET, 2.3f, 95.0f, 60190.0f, 0.67f, 0.0086f, 1.770f, 131.784f, 273.181f, 259.915f, 5.1514e-5f},
+    {"moon", "earth", "moon.jpg", BODY_MOON, 0.3f, 2.5f, 27.3f, 27.3f, 0.0549f, 5.145f, 125.08f, 318.15f, 134.96f, 3.6943e-8f},
+    {"saturn_ring", "saturn", "saturn_ring.png", BODY_RING, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
+};
+
+const int BODY_CATALOG_SIZE = sizeof(BODY_CATALOG) / sizeof(BODY_CATALOG[0]);
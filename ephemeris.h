@@ -0,0 +1,479 @@
+/*
+ * =================================================================================================
+ * EFEMÉRIDES DO JPL (POLINÔMIOS DE CHEBYSHEV)
+ *
+ * Leitura das efemérides planetárias do JPL nos dois formatos binários em que elas são
+ * distribuídas: os kernels SPK do SPICE (arquivos DAF, como de440s.bsp, com segmentos de tipo 2
+ * ou 3) e os arquivos binários antigos do DE (como lnxp1900p2053.430). O arquivo é mapeado com
+ * mmap e nada é copiado: cada corpo vira uma ou mais séries (EphemerisSeries) que apontam para os
+ * coeficientes dentro do mapeamento. Os intervalos de uma série têm todos a mesma duração, então
+ * o intervalo de um instante sai de uma divisão, em O(1), sem busca e sem ler o arquivo.
+ *
+ * As posições são avaliadas pela recorrência de Clenshaw, em lotes de instantes: em AVX2 e
+ * AVX-512 cada pista do vetor avalia um instante, com os coeficientes do seu intervalo trazidos
+ * por gather. Unidades de saída: km, no referencial equatorial J2000 (ICRF); os instantes são
+ * dias desde J2000 (TDB). Os códigos dos corpos são os do NAIF: 0 é o baricentro do Sistema
+ * Solar, 1 a 9 os baricentros dos planetas, 10 o Sol, 199 Mercúrio, 299 Vênus, 399 a Terra e
+ * 301 a Lua.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "simulation_clock.h"
+
+#include "simd.h"
+
+const int NAIF_SOLAR_SYSTEM_BARYCENTER = 0;
+const int NAIF_EARTH_MOON_BARYCENTER = 3;
+const int NAIF_SUN = 10;
+const int NAIF_MOON = 301;
+const int NAIF_EARTH = 399;
+const double SECONDS_PER_DAY = 86400.0;
+const size_t DAF_RECORD_BYTES = 1024;
+const int EPHEMERIS_MAX_COEFFICIENTS = 64; // Por componente; o DE440 usa no máximo 14.
+
+// Posição de 'target' em relação a 'center' por polinômios de Chebyshev em intervalos de mesma
+// duração. O intervalo k começa em first + k * length (no tempo do arquivo) e seus coeficientes
+// de x, y e z ficam em sequência, 'coefficients' para cada um.
+struct EphemerisSeries {
+    int target, center;
+    double start, end;       // Cobertura, em dias desde J2000.
+    bool closedEnd;          // Se 'end' pertence à série (a última série do corpo).
+    double timeScale;        // Unidades de tempo do arquivo por dia: segundos no SPK, dias no DE.
+    double timeOffset;       // J2000 no tempo do arquivo: 0 no SPK, o dia juliano no DE.
+    double first, length;    // Início do primeiro intervalo e duração de cada um, no tempo do arquivo.
+    uint64_t count;          // Quantidade de intervalos.
+    const double* data;      // Primeiro coeficiente de x do intervalo 0.
+    uint64_t recordStride;   // Doubles entre registros.
+    uint32_t subintervals;   // Intervalos por registro: no DE um registro de 32 dias é dividido.
+    uint32_t coefficients;   // Coeficientes por componente (grau + 1).
+    double scale;            // Fator aplicado ao resultado (a Terra no DE sai da Lua geocêntrica).
+
+    // Deslocamento, em doubles a partir de 'data', dos coeficientes do intervalo 'k'.
+    uint64_t offset(uint64_t k) const {
+        return (k / subintervals) * recordStride + (k % subintervals) * 3 * coefficients;
+    }
+};
+
+// Efemérides mapeadas em memória.
+struct Ephemeris {
+    void* mapping = nullptr;
+    size_t size = 0;
+    std::vector<EphemerisSeries> series; // Agrupadas por corpo, em ordem de início.
+    double kmPerAu = 0.0;                // UA do cabeçalho de um arquivo do DE; 0 no SPK, que não a traz.
+};
+
+inline void closeEphemeris(Ephemeris& ephemeris) {
+    if (ephemeris.mapping) munmap(ephemeris.mapping, ephemeris.size);
+    ephemeris = Ephemeris();
+}
+
+// Lê os segmentos de posição (tipos 2 e 3, referencial J2000) de um kernel SPK. A lista de
+// resumos é uma cadeia de registros de 1024 bytes; cada resumo tem 2 doubles (início e fim, em
+// segundos TDB desde J2000) e 6 inteiros (alvo, centro, referencial, tipo e os endereços do
+// segmento, em doubles a partir de 1). Os 4 últimos doubles de um segmento são o início do
+// primeiro intervalo, a duração, o tamanho de cada registro e a quantidade de registros; cada
+// registro guarda o meio e o raio do intervalo e depois os coeficientes.
+inline bool parseSpk(const char* base, size_t size, std::vector<EphemerisSeries>& out) {
+    int32_t nd, ni, forward;
+    memcpy(&nd, base + 8, 4);
+    memcpy(&ni, base + 12, 4);
+    memcpy(&forward, base + 76, 4);
+    // Só arquivos little-endian; os anteriores a 1995 não têm o campo e são do formato nativo.
+    if (memcmp(base + 88, "BIG-IEEE", 8) == 0 || nd != 2 || ni != 6) return false;
+    const double* words = (const double*)base;
+    uint64_t wordCount = size / sizeof(double);
+    int summarySize = nd + (ni + 1) / 2;
+    for (int guard = 0; forward > 0 && guard < 100000; guard++) {
+        if ((uint64_t)forward * DAF_RECORD_BYTES > size) return false;
+        const double* record = (const double*)(base + (forward - 1) * DAF_RECORD_BYTES);
+        int summaries = (int)record[2];
+        if (summaries < 0 || 3 + summaries * summarySize > (int)(DAF_RECORD_BYTES / sizeof(double))) return false;
+        for (int s = 0; s < summaries; s++) {
+            const double* summary = record + 3 + s * summarySize;
+            int32_t ints[6];
+            memcpy(ints, summary + nd, sizeof(ints));
+            int target = ints[0], center = ints[1], frame = ints[2], type = ints[3];
+            uint64_t first = (uint64_t)ints[4], last = (uint64_t)ints[5];
+            if (frame != 1 || (type != 2 && type != 3)) continue;
+            if (first < 1 || last > wordCount || last < first + 4) return false;
+            const double* trailer = words + last - 4; // Endereços começam em 1.
+            double init = trailer[0], length = trailer[1];
+            uint64_t recordSize = (uint64_t)trailer[2], count = (uint64_t)trailer[3];
+            uint64_t components = type == 2 ? 3 : 6;
+            if (length <= 0.0 || count == 0 || recordSize < 2 + components || (recordSize - 2) % components != 0 ||
+                first - 1 + count * recordSize > last - 4 || (recordSize - 2) / components > EPHEMERIS_MAX_COEFFICIENTS) {
+                return false;
+            }
+            EphemerisSeries series = {};
+            series.target = target;
+            series.center = center;
+            series.start = summary[0] / SECONDS_PER_DAY;
+            series.end = summary[1] / SECONDS_PER_DAY;
+            series.timeScale = SECONDS_PER_DAY;
+            series.timeOffset = 0.0;
+            series.first = init;
+            series.length = length;
+            series.count = count;
+            series.data = words + first - 1 + 2; // Pula o meio e o raio do registro.
+            series.recordStride = recordSize;
+            series.subintervals = 1;
+            series.coefficients = (uint32_t)((recordSize - 2) / components);
+            series.scale = 1.0;
+            out.push_back(series);
+        }
+        forward = (int32_t)record[0];
+    }
+    return !out.empty();
+}
+
+// Lê um arquivo binário do DE. O primeiro registro tem os títulos (3 x 84 bytes), os nomes das
+// 400 primeiras constantes (6 bytes cada), o início, o fim e a duração dos registros em dias
+// julianos, a quantidade de constantes, a UA (km), a razão de massas Terra/Lua e, para cada item, a
+// posição dos coeficientes no registro, a quantidade por componente e de subintervalos. Os
+// registros de dados começam no terceiro. Os itens são Mercúrio, Vênus, o baricentro
+// Terra-Lua, Marte a Plutão, a Lua geocêntrica e o Sol, todos (menos a Lua) em relação ao
+// baricentro do Sistema Solar; a Terra sai do baricentro Terra-Lua e da Lua.
+inline bool parseDe(const char* base, size_t size, std::vector<EphemerisSeries>& out, double& kmPerAu) {
+    const size_t CONSTANTS = 2652, POINTERS = 2696;
+    if (size < POINTERS + 160) return false;
+    double span[3], emrat;
+    int32_t constantCount, pointers[12][3], libration[3], extra[2][3] = {};
+    memcpy(span, base + CONSTANTS, sizeof(span));
+    memcpy(&constantCount, base + CONSTANTS + 24, 4);
+    memcpy(&kmPerAu, base + CONSTANTS + 28, 8);
+    memcpy(&emrat, base + CONSTANTS + 36, 8);
+    memcpy(pointers, base + POINTERS, sizeof(pointers));
+    memcpy(libration, base + POINTERS + 148, sizeof(libration));
+    if (!(span[2] > 0.0 && span[1] > span[0] && emrat > 0.0) || constantCount < 0 || constantCount > 10000) {
+        return false;
+    }
+    // Nos arquivos com mais de 400 constantes os nomes extras vêm aqui; no DE430t e seguintes,
+    // depois deles, mais 2 itens (velocidade angular do manto lunar e TT - TDB).
+    size_t extraOffset = POINTERS + 160 + (constantCount > 400 ? (constantCount - 400) * 6 : 0);
+    if (extraOffset + sizeof(extra) <= size) memcpy(extra, base + extraOffset, sizeof(extra));
+
+    // Doubles por registro: o fim do item que vai mais longe. Como os itens extras podem não
+    // existir (e os bytes ali serem outra coisa), vale o tamanho em que o primeiro registro de
+    // dados começa no início da cobertura.
+    uint64_t recordCount = (uint64_t)std::llround((span[1] - span[0]) / span[2]);
+    int64_t recordSize = 0;
+    for (int withExtras = 0; withExtras < 2 && !recordSize; withExtras++) {
+        int64_t candidate = 0;
+        auto reach = [&](const int32_t* item, int components) {
+            if (item[0] > 0 && item[1] > 0 && item[2] > 0) {
+                candidate = std::max<int64_t>(candidate, item[0] - 1 + (int64_t)item[1] * components * item[2]);
+            }
+        };
+        for (int item = 0; item < 12; item++) reach(pointers[item], item == 11 ? 2 : 3);
+        reach(libration, 3);
+        if (withExtras) {
+            reach(extra[0], 3);
+            reach(extra[1], 1);
+        }
+        if (candidate < 2 || recordCount == 0 || (2 + recordCount) * candidate * sizeof(double) > size) continue;
+        const double* first = (const double*)base + 2 * candidate;
+        if (std::fabs(first[0] - span[0]) <= 1e-6 && std::fabs(first[1] - span[0] - span[2]) <= 1e-6) {
+            recordSize = candidate;
+        }
+    }
+    if (!recordSize) return false;
+    const double* records = (const double*)base + 2 * recordSize;
+
+    const int targets[11] = {1, 2, NAIF_EARTH_MOON_BARYCENTER, 4, 5, 6, 7, 8, 9, NAIF_MOON, NAIF_SUN};
+    auto add = [&](int item, int target, int center, double scale) {
+        const int32_t* pointer = pointers[item];
+        if (pointer[0] < 3 || pointer[1] <= 0 || pointer[2] <= 0 || pointer[1] > EPHEMERIS_MAX_COEFFICIENTS) return;
+        EphemerisSeries series = {};
+        series.target = target;
+        series.center = center;
+        series.start = span[0] - J2000_JULIAN_DAY;
+        series.end = span[1] - J2000_JULIAN_DAY;
+        series.timeScale = 1.0;
+        series.timeOffset = J2000_JULIAN_DAY;
+        series.first = span[0];
+        series.length = span[2] / pointer[2];
+        series.count = recordCount * pointer[2];
+        series.data = records + pointer[0] - 1;
+        series.recordStride = recordSize;
+        series.subintervals = pointer[2];
+        series.coefficients = pointer[1];
+        series.scale = scale;
+        out.push_back(series);
+    };
+    for (int item = 0; item < 11; item++) {
+        add(item, targets[item], item == 9 ? NAIF_EARTH : NAIF_SOLAR_SYSTEM_BARYCENTER, 1.0);
+    }
+    // Terra = baricentro Terra-Lua - Lua geocêntrica / (1 + massa da Terra / massa da Lua).
+    add(9, NAIF_EARTH, NAIF_EARTH_MOON_BARYCENTER, -1.0 / (1.0 + emrat));
+    return !out.empty();
+}
+
+// Mapeia um kernel SPK ou um arquivo binário do DE. Retorna false se o arquivo não existir ou não
+// tiver nenhum segmento de posição que possa ser lido.
+inline bool openEphemeris(const char* path, Ephemeris& ephemeris) {
+    closeEphemeris(ephemeris);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < DAF_RECORD_BYTES) {
+        close(fd);
+        return false;
+    }
+    ephemeris.size = info.st_size;
+    ephemeris.mapping = mmap(nullptr, ephemeris.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ephemeris.mapping == MAP_FAILED) {
+        ephemeris = Ephemeris();
+        return false;
+    }
+    const char* base = (const char*)ephemeris.mapping;
+    bool valid = memcmp(base, "DAF/SPK", 7) == 0 || memcmp(base, "NAIF/DAF", 8) == 0
+                     ? parseSpk(base, ephemeris.size, ephemeris.series)
+                     : parseDe(base, ephemeris.size, ephemeris.series, ephemeris.kmPerAu);
+    if (!valid) {
+        closeEphemeris(ephemeris);
+        return false;
+    }
+    std::vector<EphemerisSeries>& series = ephemeris.series;
+    std::stable_sort(series.begin(), series.end(), [](const EphemerisSeries& a, const EphemerisSeries& b) {
+        return a.target != b.target ? a.target < b.target : a.start < b.start;
+    });
+    for (size_t i = 0; i < series.size(); i++) {
+        series[i].closedEnd = i + 1 == series.size() || series[i + 1].target != series[i].target;
+        // Segmentos sobrepostos de um corpo: como no SPICE, vale o mais novo (aqui, o que começa depois).
+        if (!series[i].closedEnd) series[i].end = std::min(series[i].end, series[i + 1].start);
+    }
+    // O núcleo começa a trazer o arquivo para a memória já, em segundo plano, para que a avaliação
+    // não espere pelo disco na primeira vez que usa cada registro.
+    madvise(ephemeris.mapping, ephemeris.size, MADV_WILLNEED);
+    return true;
+}
+
+// Séries de 'target', em ordem de início; [first, last).
+inline std::pair<const EphemerisSeries*, const EphemerisSeries*> ephemerisSeriesOf(const Ephemeris& ephemeris,
+                                                                                  int target) {
+    const EphemerisSeries* begin = ephemeris.series.data();
+    const EphemerisSeries* end = begin + ephemeris.series.size();
+    const EphemerisSeries* first =
+        std::lower_bound(begin, end, target, [](const EphemerisSeries& series, int value) { return series.target < value; });
+    const EphemerisSeries* last =
+        std::upper_bound(first, end, target, [](int value, const EphemerisSeries& series) { return value < series.target; });
+    return {first, last};
+}
+
+// Se a série vale no instante 'days'.
+inline bool ephemerisCovers(const EphemerisSeries& series, double days) {
+    return days >= series.start && (days < series.end || (series.closedEnd && days == series.end));
+}
+
+// Intervalo de dias [first, last] coberto por todos os corpos do arquivo. Retorna false se ele for
+// vazio.
+inline bool ephemerisCommonCoverage(const Ephemeris& ephemeris, double& first, double& last) {
+    first = -std::numeric_limits<double>::infinity();
+    last = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < ephemeris.series.size();) {
+        auto range = ephemerisSeriesOf(ephemeris, ephemeris.series[i].target);
+        first = std::max(first, range.first->start);
+        last = std::min(last, (range.second - 1)->end);
+        i = range.second - ephemeris.series.data();
+    }
+    return first <= last;
+}
+
+// Posição (km) de uma série no instante 'days', sem conferir a cobertura: instantes fora dela
+// usam o primeiro ou o último intervalo.
+inline void evaluateSeries(const EphemerisSeries& series, double days, double position[3]) {
+    double x = (days * series.timeScale + series.timeOffset - series.first) / series.length;
+    double k = std::min(std::max(std::floor(x), 0.0), (double)(series.count - 1));
+    double s = 2.0 * (x - k) - 1.0; // Tempo normalizado para [-1, 1] no intervalo.
+    const double* c = series.data + series.offset((uint64_t)k);
+    int n = series.coefficients;
+    for (int component = 0; component < 3; component++, c += n) {
+        double b1 = 0.0, b2 = 0.0;
+        for (int j = n - 1; j >= 1; j--) {
+            double b0 = 2.0 * s * b1 - b2 + c[j];
+            b2 = b1;
+            b1 = b0;
+        }
+        position[component] = (s * b1 - b2 + c[0]) * series.scale;
+    }
+}
+
+#ifdef SIMD_HAS_AVX2
+// Soma sign * posição de 'series' em x, y e z para os instantes [begin, end) cobertos por ela,
+// 4 por vez; retorna o índice do primeiro instante não processado.
+SIMD_TARGET_AVX2 inline size_t accumulateSeriesAVX2(const EphemerisSeries& series, const double* days,
+                                                         double sign, double* x, double* y, double* z, size_t begin,
+                                                         size_t end) {
+    const __m256d timeScale = _mm256_set1_pd(series.timeScale);
+    const __m256d origin = _mm256_set1_pd(series.timeOffset - series.first);
+    const __m256d inverseLength = _mm256_set1_pd(1.0 / series.length);
+    const __m256d last = _mm256_set1_pd((double)(series.count - 1));
+    const __m256d start = _mm256_set1_pd(series.start), stop = _mm256_set1_pd(series.end);
+    const __m256d factor = _mm256_set1_pd(series.scale * sign);
+    const int n = series.coefficients;
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d t = _mm256_loadu_pd(days + i);
+        __m256d before = series.closedEnd ? _mm256_cmp_pd(t, stop, _CMP_LE_OQ) : _mm256_cmp_pd(t, stop, _CMP_LT_OQ);
+        __m256d inside = _mm256_and_pd(_mm256_cmp_pd(t, start, _CMP_GE_OQ), before);
+        if (_mm256_testz_pd(inside, inside)) continue;
+        __m256d u = _mm256_mul_pd(_mm256_fmadd_pd(t, timeScale, origin), inverseLength);
+        __m256d k = _mm256_min_pd(_mm256_max_pd(_mm256_floor_pd(u), _mm256_setzero_pd()), last);
+        __m256d s = _mm256_sub_pd(_mm256_add_pd(_mm256_sub_pd(u, k), _mm256_sub_pd(u, k)), _mm256_set1_pd(1.0));
+        __m256d twoS = _mm256_add_pd(s, s);
+        alignas(32) double lanes[4];
+        alignas(32) int64_t offsets[4];
+        _mm256_store_pd(lanes, k);
+        for (int lane = 0; lane < 4; lane++) offsets[lane] = (int64_t)series.offset((uint64_t)lanes[lane]);
+        __m256i index = _mm256_load_si256((const __m256i*)offsets);
+        __m256d result[3];
+        for (int component = 0; component < 3; component++) {
+            const double* c = series.data + component * n;
+            __m256d b1 = _mm256_setzero_pd(), b2 = _mm256_setzero_pd();
+            for (int j = n - 1; j >= 1; j--) {
+                __m256d cj = _mm256_i64gather_pd(c + j, index, 8);
+                __m256d b0 = _mm256_fmadd_pd(twoS, b1, _mm256_sub_pd(cj, b2));
+                b2 = b1;
+                b1 = b0;
+            }
+            __m256d c0 = _mm256_i64gather_pd(c, index, 8);
+            result[component] = _mm256_and_pd(_mm256_mul_pd(_mm256_fmadd_pd(s, b1, _mm256_sub_pd(c0, b2)), factor), inside);
+        }
+        _mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_loadu_pd(x + i), result[0]));
+        _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), result[1]));
+        _mm256_storeu_pd(z + i, _mm256_add_pd(_mm256_loadu_pd(z + i), result[2]));
+    }
+    return i;
+}
+#endif
+
+#ifdef SIMD_HAS_AVX512
+SIMD_AVX512_WARNINGS_BEGIN
+
+// Como accumulateSeriesAVX2(), 8 instantes por vez.
+SIMD_TARGET_AVX512 inline size_t accumulateSeriesAVX512(const EphemerisSeries& series, const double* days,
+                                                             double sign, double* x, double* y, double* z,
+                                                             size_t begin, size_t end) {
+    const __m512d timeScale = _mm512_set1_pd(series.timeScale);
+    const __m512d origin = _mm512_set1_pd(series.timeOffset - series.first);
+    const __m512d inverseLength = _mm512_set1_pd(1.0 / series.length);
+    const __m512d last = _mm512_set1_pd((double)(series.count - 1));
+    const __m512d start = _mm512_set1_pd(series.start), stop = _mm512_set1_pd(series.end);
+    const __m512d factor = _mm512_set1_pd(series.scale * sign);
+    const __m256i subintervals = _mm256_set1_epi32(series.subintervals);
+    const __m256i subintervalStride = _mm256_set1_epi32(3 * series.coefficients);
+    const __m512i recordStride = _mm512_set1_epi64((int64_t)series.recordStride);
+    const int n = series.coefficients;
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d t = _mm512_loadu_pd(days + i);
+        __mmask8 before = series.closedEnd ? _mm512_cmp_pd_mask(t, stop, _CMP_LE_OQ) : _mm512_cmp_pd_mask(t, stop, _CMP_LT_OQ);
+        __mmask8 inside = _mm512_cmp_pd_mask(t, start, _CMP_GE_OQ) & before;
+        if (!inside) continue;
+        __m512d u = _mm512_mul_pd(_mm512_fmadd_pd(t, timeScale, origin), inverseLength);
+        __m512d k = _mm512_min_pd(_mm512_max_pd(_mm512_roundscale_pd(u, _MM_FROUND_TO_NEG_INF), _mm512_setzero_pd()), last);
+        __m512d s = _mm512_sub_pd(_mm512_add_pd(_mm512_sub_pd(u, k), _mm512_sub_pd(u, k)), _mm512_set1_pd(1.0));
+        __m512d twoS = _mm512_add_pd(s, s);
+        // Deslocamento de cada intervalo: (k / sub) * registro + (k % sub) * 3n. O quociente sai
+        // em double, exato para qualquer quantidade de intervalos que caiba num arquivo.
+        __m512d record = _mm512_roundscale_pd(_mm512_div_pd(k, _mm512_set1_pd(series.subintervals)),
+                                              _MM_FROUND_TO_NEG_INF);
+        __m256i whole = _mm512_cvttpd_epi32(record);
+        __m256i part = _mm256_sub_epi32(_mm512_cvttpd_epi32(k), _mm256_mullo_epi32(whole, subintervals));
+        __m512i index = _mm512_add_epi64(_mm512_mul_epu32(_mm512_cvtepu32_epi64(whole), recordStride),
+                                         _mm512_cvtepu32_epi64(_mm256_mullo_epi32(part, subintervalStride)));
+        __m512d result[3];
+        for (int component = 0; component < 3; component++) {
+            const double* c = series.data + component * n;
+            __m512d b1 = _mm512_setzero_pd(), b2 = _mm512_setzero_pd();
+            for (int j = n - 1; j >= 1; j--) {
+                __m512d cj = _mm512_i64gather_pd(index, c + j, 8);
+                __m512d b0 = _mm512_fmadd_pd(twoS, b1, _mm512_sub_pd(cj, b2));
+                b2 = b1;
+                b1 = b0;
+            }
+            __m512d c0 = _mm512_i64gather_pd(index, c, 8);
+            result[component] = _mm512_mul_pd(_mm512_fmadd_pd(s, b1, _mm512_sub_pd(c0, b2)), factor);
+        }
+        double* outputs[3] = {x + i, y + i, z + i};
+        for (int component = 0; component < 3; component++) {
+            __m512d sum = _mm512_loadu_pd(outputs[component]);
+            _mm512_storeu_pd(outputs[component], _mm512_mask_add_pd(sum, inside, sum, result[component]));
+        }
+    }
+    return i;
+}
+SIMD_AVX512_WARNINGS_END
+#endif
+
+// Soma sign * posição de 'series' em x[i], y[i] e z[i] para cada instante days[i] coberto por ela.
+inline void accumulateSeries(const EphemerisSeries& series, const double* days, size_t count, double sign, double* x,
+                             double* y, double* z, SimdKernel kernel) {
+    size_t done = 0;
+#ifdef SIMD_HAS_AVX512
+    if (kernel == SimdKernel::AVX512) done = accumulateSeriesAVX512(series, days, sign, x, y, z, 0, count);
+#endif
+#ifdef SIMD_HAS_AVX2
+    if (kernel == SimdKernel::AVX2) done = accumulateSeriesAVX2(series, days, sign, x, y, z, 0, count);
+#endif
+    for (size_t i = done; i < count; i++) {
+        if (!ephemerisCovers(series, days[i])) continue;
+        double position[3];
+        evaluateSeries(series, days[i], position);
+        x[i] += sign * position[0];
+        y[i] += sign * position[1];
+        z[i] += sign * position[2];
+    }
+}
+
+// Posições (km, equatoriais J2000) de 'target' em relação a 'observer' nos instantes days[i],
+// gravadas em x[i], y[i] e z[i]. Cada corpo é levado até o baricentro do Sistema Solar pela
+// cadeia de centros das suas séries (a Lua passa pela Terra ou pelo baricentro Terra-Lua, por
+// exemplo). Retorna false se faltar alguma série na cadeia; instantes fora da cobertura de algum
+// elo saem como NaN.
+inline bool ephemerisPositions(const Ephemeris& ephemeris, int target, int observer, const double* days, size_t count,
+                               double* x, double* y, double* z, SimdKernel kernel = detectSimdKernel()) {
+    std::fill(x, x + count, 0.0);
+    std::fill(y, y + count, 0.0);
+    std::fill(z, z + count, 0.0);
+    for (int pass = 0; pass < 2; pass++) {
+        double sign = pass == 0 ? 1.0 : -1.0;
+        for (int body = pass == 0 ? target : observer, links = 0; body != NAIF_SOLAR_SYSTEM_BARYCENTER; links++) {
+            auto range = ephemerisSeriesOf(ephemeris, body);
+            if (range.first == range.second || links > 8) return false;
+            for (const EphemerisSeries* series = range.first; series != range.second; series++) {
+                accumulateSeries(*series, days, count, sign, x, y, z, kernel);
+            }
+            const double coverageStart = range.first->start, coverageEnd = (range.second - 1)->end;
+            for (size_t i = 0; i < count; i++) {
+                if (!(days[i] >= coverageStart && days[i] <= coverageEnd)) {
+                    x[i] = y[i] = z[i] = std::numeric_limits<double>::quiet_NaN();
+                }
+            }
+            body = range.first->center;
+        }
+    }
+    return true;
+}
+
+// Como ephemerisPositions(), para um instante só.
+inline bool ephemerisPosition(const Ephemeris& ephemeris, int target, int observer, double days, double position[3]) {
+    return ephemerisPositions(ephemeris, target, observer, &days, 1, &position[0], &position[1], &position[2],
+                              SimdKernel::Scalar);
+}
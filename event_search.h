@@ -0,0 +1,276 @@
+/*
+ * =================================================================================================
+ * BUSCA DE EVENTOS (CONJUNÇÕES, OPOSIÇÕES, ECLIPSES E OCULTAÇÕES)
+ *
+ * Procura, num intervalo de tempo, os instantes em que dois corpos vistos do centro da Terra têm
+ * a mesma longitude eclíptica (conjunção) ou longitudes a 180 graus do Sol (oposição). O modelo
+ * de posições é uma função qualquer que devolve as posições heliocêntricas de todos os corpos
+ * num instante, então a mesma busca serve para as órbitas keplerianas, as teorias analíticas e
+ * as efemérides.
+ *
+ * Cada diferença de longitude é amostrada num passo grosso (meio dia, menos que o tempo em que
+ * a Lua se afasta 90 graus de qualquer corpo); uma troca de sinal entre duas amostras cerca uma
+ * raiz, que é refinada pela falsa posição com a correção de Illinois até EVENT_TOLERANCE. O
+ * intervalo é dividido em janelas independentes, processadas em paralelo pelo pool de threads.
+ *
+ * No instante de cada raiz, a separação angular entre os dois corpos decide o tipo do evento: a
+ * Lua nova vira eclipse do Sol, a Lua cheia eclipse da Lua, a conjunção da Lua com um planeta
+ * ocultação e a conjunção inferior de um planeta com o Sol trânsito, quando os discos (com a
+ * paralaxe, para valer em algum lugar da Terra) se sobrepõem. Aberração e tempo de luz são
+ * desprezados.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "thread_pool.h"
+
+enum class EventKind { Conjunction, Opposition, SolarEclipse, LunarEclipse, Occultation, Transit };
+// Tipo de eclipse; None nos outros eventos.
+enum class EventDetail { None, Penumbral, Partial, Annular, Total };
+
+struct AstronomicalEvent {
+    double days;        // Instante, em dias desde J2000.
+    EventKind kind;
+    EventDetail detail;
+    int first, second;  // Corpos, na ordem da função de posições (first < second).
+    double separation;  // Separação angular no instante, em radianos, vista da Terra.
+};
+
+// Corpos da função de posições que a busca precisa reconhecer e os seus raios.
+struct EventBodies {
+    size_t count = 0;            // Corpos devolvidos pela função de posições.
+    int sun = 0, earth = -1, moon = -1; // Índices; moon = -1 se não houver Lua.
+    double sunRadius = 0.0, earthRadius = 0.0, moonRadius = 0.0; // Na unidade das posições.
+};
+
+// Posições heliocêntricas (x, y, z de cada corpo em sequência) no instante 'days'. Pode ser
+// chamada de várias threads ao mesmo tempo.
+using EventPositions = std::function<void(double days, double* xyz)>;
+
+const double EVENT_COARSE_STEP = 0.5;   // Dias entre as amostras da busca grossa.
+const double EVENT_TOLERANCE = 1e-6;    // Dias (0,09 s): precisão do instante refinado.
+const double EVENT_WINDOW_DAYS = 3652.5; // Duração de cada janela processada por uma thread.
+const int EVENT_MAX_ITERATIONS = 60;
+
+inline const char* eventKindName(EventKind kind) {
+    switch (kind) {
+    case EventKind::Conjunction: return "conjuncao";
+    case EventKind::Opposition: return "oposicao";
+    case EventKind::SolarEclipse: return "eclipse solar";
+    case EventKind::LunarEclipse: return "eclipse lunar";
+    case EventKind::Occultation: return "ocultacao";
+    case EventKind::Transit: return "transito";
+    }
+    return "";
+}
+
+inline const char* eventDetailName(EventDetail detail) {
+    switch (detail) {
+    case EventDetail::None: return "";
+    case EventDetail::Penumbral: return "penumbral";
+    case EventDetail::Partial: return "parcial";
+    case EventDetail::Annular: return "anular";
+    case EventDetail::Total: return "total";
+    }
+    return "";
+}
+
+// Reduz um ângulo em radianos para (-PI, PI].
+inline double wrapRadians(double angle) {
+    angle = std::fmod(angle, 2.0 * M_PI);
+    if (angle > M_PI) angle -= 2.0 * M_PI;
+    if (angle <= -M_PI) angle += 2.0 * M_PI;
+    return angle;
+}
+
+// Ângulo entre dois vetores (atan2 do produto vetorial e do escalar, preciso também perto de 0).
+inline double vectorAngle(const double* u, const double* v) {
+    double cx = u[1] * v[2] - u[2] * v[1], cy = u[2] * v[0] - u[0] * v[2], cz = u[0] * v[1] - u[1] * v[0];
+    return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), u[0] * v[0] + u[1] * v[1] + u[2] * v[2]);
+}
+
+// Função cujas raízes são os eventos do par (first, second): a diferença de longitude
+// geocêntrica, deslocada de PI nas oposições.
+struct EventFunction {
+    int first, second;
+    bool opposition;
+};
+
+// Longitude geocêntrica de cada corpo (a da Terra não é usada).
+inline void geocentricLongitudes(const double* xyz, const EventBodies& bodies, double* longitude) {
+    const double* earth = xyz + 3 * bodies.earth;
+    for (size_t b = 0; b < bodies.count; b++) {
+        longitude[b] = std::atan2(xyz[3 * b + 1] - earth[1], xyz[3 * b] - earth[0]);
+    }
+}
+
+inline double eventValue(const EventFunction& function, const double* longitude) {
+    return wrapRadians(longitude[function.first] - longitude[function.second] + (function.opposition ? M_PI : 0.0));
+}
+
+// Separação angular dos corpos do evento vistos da Terra e o tipo do evento, a partir das
+// posições no instante da raiz. Na oposição do Sol com a Lua, a separação é a da Lua ao ponto
+// oposto ao Sol, o centro da sombra da Terra.
+inline void classifyEvent(const double* xyz, const EventBodies& bodies, AstronomicalEvent& event) {
+    const double* earth = xyz + 3 * bodies.earth;
+    double u[3], v[3];
+    for (int axis = 0; axis < 3; axis++) {
+        u[axis] = xyz[3 * event.first + axis] - earth[axis];
+        v[axis] = xyz[3 * event.second + axis] - earth[axis];
+    }
+    double separation = vectorAngle(u, v);
+    event.separation = event.kind == EventKind::Opposition ? M_PI - separation : separation;
+    event.detail = EventDetail::None;
+    auto length = [](const double* w) { return std::sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]); };
+    // Semidiâmetro aparente de um corpo de raio 'radius' à distância 'distance'; com o raio da
+    // Terra, é a paralaxe horizontal.
+    auto apparent = [](double radius, double distance) { return std::asin(std::min(radius / distance, 1.0)); };
+    bool sun = event.first == bodies.sun || event.second == bodies.sun;
+    bool moon = bodies.moon >= 0 && (event.first == bodies.moon || event.second == bodies.moon);
+    double sunDistance = 0.0, sunSemidiameter = 0.0, sunParallax = 0.0;
+    if (sun) {
+        sunDistance = length(event.first == bodies.sun ? u : v);
+        sunSemidiameter = apparent(bodies.sunRadius, sunDistance);
+        sunParallax = apparent(bodies.earthRadius, sunDistance);
+    }
+    double moonSemidiameter = 0.0, moonParallax = 0.0;
+    if (moon) {
+        double moonDistance = length(event.first == bodies.moon ? u : v);
+        moonSemidiameter = apparent(bodies.moonRadius, moonDistance);
+        moonParallax = apparent(bodies.earthRadius, moonDistance);
+    }
+    if (sun && moon) {
+        if (event.kind == EventKind::Conjunction) {
+            // A sombra da Lua toca a Terra; a central (o eixo da sombra na Terra) é total se a Lua
+            // parecer maior que o Sol e anular se menor.
+            if (event.separation >= sunSemidiameter + moonSemidiameter + moonParallax - sunParallax) return;
+            event.kind = EventKind::SolarEclipse;
+            bool central = event.separation < moonParallax - sunParallax;
+            event.detail = !central ? EventDetail::Partial
+                                    : moonSemidiameter > sunSemidiameter ? EventDetail::Total : EventDetail::Annular;
+        } else {
+            // Raios da umbra e da penumbra da Terra na distância da Lua, com o aumento de 2% da
+            // atmosfera (regra de Chauvenet).
+            double umbra = 1.02 * (moonParallax + sunParallax - sunSemidiameter);
+            double penumbra = 1.02 * (moonParallax + sunParallax + sunSemidiameter);
+            if (event.separation >= penumbra + moonSemidiameter) return;
+            event.kind = EventKind::LunarEclipse;
+            event.detail = event.separation < umbra - moonSemidiameter   ? EventDetail::Total
+                           : event.separation < umbra + moonSemidiameter ? EventDetail::Partial
+                                                                         : EventDetail::Penumbral;
+        }
+    } else if (moon && event.kind == EventKind::Conjunction) {
+        if (event.separation < moonSemidiameter + moonParallax) event.kind = EventKind::Occultation;
+    } else if (sun && event.kind == EventKind::Conjunction) {
+        // Só na conjunção inferior o planeta passa na frente do Sol.
+        if (length(event.first == bodies.sun ? v : u) < sunDistance && event.separation < sunSemidiameter) {
+            event.kind = EventKind::Transit;
+        }
+    }
+}
+
+// Refina a raiz de 'function' em [a, b], com valores fa e fb de sinais opostos, pela falsa
+// posição com a correção de Illinois (o valor da ponta que não muda é dividido por 2, para não
+// ficar preso num lado). 'xyz' e 'longitude' são rascunhos; no fim 'xyz' tem as posições na raiz.
+inline double refineEventRoot(const EventPositions& positions, const EventBodies& bodies, const EventFunction& function,
+                              double a, double fa, double b, double fb, double* xyz, double* longitude) {
+    int side = 0;
+    for (int iteration = 0; iteration < EVENT_MAX_ITERATIONS && b - a > EVENT_TOLERANCE; iteration++) {
+        double t = (a * fb - b * fa) / (fb - fa);
+        // Pelo menos meia tolerância longe das pontas: perto da raiz, o ponto seguinte cai do
+        // outro lado dela e fecha o cerco.
+        t = std::min(std::max(t, a + 0.5 * EVENT_TOLERANCE), b - 0.5 * EVENT_TOLERANCE);
+        positions(t, xyz);
+        geocentricLongitudes(xyz, bodies, longitude);
+        double ft = eventValue(function, longitude);
+        if (ft == 0.0) {
+            a = b = t;
+        } else if ((ft < 0.0) == (fa < 0.0)) {
+            a = t;
+            fa = ft;
+            if (side == -1) fb *= 0.5;
+            side = -1;
+        } else {
+            b = t;
+            fb = ft;
+            if (side == 1) fa *= 0.5;
+            side = 1;
+        }
+    }
+    double root = 0.5 * (a + b);
+    positions(root, xyz);
+    return root;
+}
+
+// Eventos do par ou da oposição 'functions' cujas raízes caem em (from + i * step,
+// from + (i + 1) * step] para i em [first, last), em ordem de tempo.
+inline void searchEventWindow(const EventPositions& positions, const EventBodies& bodies,
+                              const std::vector<EventFunction>& functions, double from, double step, int64_t first,
+                              int64_t last, double to, std::vector<AstronomicalEvent>& events) {
+    const size_t n = bodies.count;
+    std::vector<double> xyz(3 * n), longitude(n), previousValues(functions.size()), values(functions.size());
+    std::vector<double> scratchXyz(3 * n), scratchLongitude(n);
+    double previousTime = from + first * step;
+    positions(previousTime, xyz.data());
+    geocentricLongitudes(xyz.data(), bodies, longitude.data());
+    for (size_t f = 0; f < functions.size(); f++) previousValues[f] = eventValue(functions[f], longitude.data());
+    for (int64_t i = first; i < last; i++) {
+        double time = std::min(from + (i + 1) * step, to);
+        positions(time, xyz.data());
+        geocentricLongitudes(xyz.data(), bodies, longitude.data());
+        for (size_t f = 0; f < functions.size(); f++) {
+            double fa = previousValues[f], fb = values[f] = eventValue(functions[f], longitude.data());
+            // Troca de sinal perto de zero; perto de +-PI é só a volta do ângulo.
+            if ((fa < 0.0) == (fb < 0.0) || std::fabs(fa) > M_PI / 2 || std::fabs(fb) > M_PI / 2) continue;
+            AstronomicalEvent event;
+            event.first = functions[f].first;
+            event.second = functions[f].second;
+            event.kind = functions[f].opposition ? EventKind::Opposition : EventKind::Conjunction;
+            event.days = refineEventRoot(positions, bodies, functions[f], previousTime, fa, time, fb, scratchXyz.data(),
+                                         scratchLongitude.data());
+            classifyEvent(scratchXyz.data(), bodies, event);
+            events.push_back(event);
+        }
+        previousValues.swap(values);
+        previousTime = time;
+    }
+    std::sort(events.begin(), events.end(),
+              [](const AstronomicalEvent& a, const AstronomicalEvent& b) { return a.days < b.days; });
+}
+
+// Todos os eventos entre 'from' e 'to' (dias desde J2000), em ordem de tempo: as conjunções de
+// cada par de corpos (menos a Terra) e as oposições de cada corpo ao Sol. As janelas de
+// EVENT_WINDOW_DAYS são divididas entre as threads de trabalho; o resultado não depende de
+// quantas são.
+inline std::vector<AstronomicalEvent> searchEvents(const EventPositions& positions, const EventBodies& bodies,
+                                                   double from, double to, double step = EVENT_COARSE_STEP) {
+    std::vector<EventFunction> functions;
+    for (int i = 0; i < (int)bodies.count; i++) {
+        if (i == bodies.earth) continue;
+        for (int j = i + 1; j < (int)bodies.count; j++) {
+            if (j == bodies.earth) continue;
+            functions.push_back({i, j, false});
+            if (i == bodies.sun) functions.push_back({i, j, true});
+        }
+    }
+    if (!(to > from) || !(step > 0.0) || bodies.earth < 0) return {};
+    const int64_t steps = (int64_t)std::ceil((to - from) / step);
+    const int64_t stepsPerWindow = std::max<int64_t>(1, (int64_t)(EVENT_WINDOW_DAYS / step));
+    const size_t windows = (size_t)((steps + stepsPerWindow - 1) / stepsPerWindow);
+    std::vector<std::vector<AstronomicalEvent>> found(windows);
+    workerPool().parallelFor(windows, 1, [&](size_t begin, size_t end) {
+        for (size_t w = begin; w < end; w++) {
+            int64_t first = (int64_t)w * stepsPerWindow, last = std::min(first + stepsPerWindow, steps);
+            searchEventWindow(positions, bodies, functions, from, step, first, last, to, found[w]);
+        }
+    });
+    std::vector<AstronomicalEvent> events;
+    for (const auto& window : found) events.insert(events.end(), window.begin(), window.end());
+    return events;
+}
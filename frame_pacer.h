@@ -0,0 +1,114 @@
+/*
+ * =================================================================================================
+ * RITMO DOS QUADROS
+ *
+ * Agenda os quadros pelo relógio monotônico (steady_clock) para atingir uma taxa alvo, em vez de
+ * depender da precisão do timer do GLUT. A espera dorme a maior parte do intervalo e termina em
+ * espera ativa; a margem reservada para a espera ativa acompanha o atraso medido do sono do
+ * sistema. Também registra o intervalo entre quadros consecutivos, para medir a regularidade.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// Resumo dos intervalos entre quadros desde o último reset().
+struct PacingStats {
+    unsigned frames = 0;         // Intervalos medidos.
+    double targetMs = 0.0;       // Intervalo alvo; 0 sem limite de taxa.
+    double meanMs = 0.0;         // Intervalo médio...
+    double stdDevMs = 0.0;       // ...e seu desvio padrão (tremulação).
+    double meanErrorMs = 0.0;    // Erro absoluto médio em relação ao alvo (ou à média, sem limite).
+    double p99ErrorMs = 0.0;     // Percentil 99 do erro absoluto.
+    double maxErrorMs = 0.0;
+};
+
+class FramePacer {
+public:
+    // Define a taxa alvo em quadros por segundo; 0 desliga o limite (modo de benchmark).
+    void setTargetFps(double fps) {
+        targetPeriod = fps > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+                                 : Clock::duration::zero();
+        nextFrame = Clock::now();
+        reset();
+    }
+
+    double targetFps() const {
+        return targetPeriod.count() ? 1.0 / std::chrono::duration<double>(targetPeriod).count() : 0.0;
+    }
+
+    // Espera até o instante do próximo quadro. Sem limite de taxa, retorna na hora. Se o quadro
+    // anterior passou do seu instante, a agenda recomeça a partir de agora, em vez de emendar um
+    // quadro curto logo depois do longo para recuperar o atraso.
+    void waitForNextFrame() {
+        if (targetPeriod == Clock::duration::zero()) return;
+        nextFrame += targetPeriod;
+        Clock::time_point now = Clock::now();
+        if (now > nextFrame) nextFrame = now;
+
+        Clock::duration sleepFor = nextFrame - now - SPIN_MARGIN - sleepOvershoot;
+        if (sleepFor > Clock::duration::zero()) {
+            Clock::time_point wakeAt = now + sleepFor;
+            std::this_thread::sleep_for(sleepFor);
+            // O atraso do sono é acompanhado por uma média móvel exponencial.
+            Clock::duration overshoot = std::max(Clock::now() - wakeAt, Clock::duration::zero());
+            sleepOvershoot += (overshoot - sleepOvershoot) / 8;
+        }
+        while (Clock::now() < nextFrame) std::this_thread::yield();
+    }
+
+    // Registra que um quadro foi apresentado. Chamada logo depois da troca de buffers.
+    void frameSubmitted() {
+        Clock::time_point now = Clock::now();
+        if (lastFrame != Clock::time_point()) {
+            intervals.push_back(std::chrono::duration<double, std::milli>(now - lastFrame).count());
+            if (intervals.size() > MAX_INTERVALS) intervals.erase(intervals.begin(), intervals.begin() + MAX_INTERVALS / 2);
+        }
+        lastFrame = now;
+    }
+
+    // Descarta os intervalos medidos até agora.
+    void reset() {
+        intervals.clear();
+        lastFrame = Clock::time_point();
+    }
+
+    PacingStats stats() const {
+        PacingStats stats;
+        stats.targetMs = std::chrono::duration<double, std::milli>(targetPeriod).count();
+        stats.frames = (unsigned)intervals.size();
+        if (intervals.empty()) return stats;
+        for (double interval : intervals) stats.meanMs += interval;
+        stats.meanMs /= intervals.size();
+        double reference = stats.targetMs > 0.0 ? stats.targetMs : stats.meanMs;
+        std::vector<double> errors;
+        for (double interval : intervals) {
+            stats.stdDevMs += (interval - stats.meanMs) * (interval - stats.meanMs);
+            errors.push_back(std::fabs(interval - reference));
+            stats.meanErrorMs += errors.back();
+        }
+        stats.stdDevMs = std::sqrt(stats.stdDevMs / intervals.size());
+        stats.meanErrorMs /= intervals.size();
+        std::sort(errors.begin(), errors.end());
+        stats.p99ErrorMs = errors[std::min(errors.size() - 1, errors.size() * 99 / 100)];
+        stats.maxErrorMs = errors.back();
+        return stats;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    // Margem mínima terminada em espera ativa, somada ao atraso medido do sono.
+    static constexpr Clock::duration SPIN_MARGIN = std::chrono::microseconds(500);
+    static const size_t MAX_INTERVALS = 4096; // Intervalos guardados para as estatísticas.
+
+    Clock::duration targetPeriod = Clock::duration::zero();
+    Clock::time_point nextFrame = Clock::now();
+    Clock::duration sleepOvershoot = Clock::duration::zero();
+    Clock::time_point lastFrame;
+    std::vector<double> intervals;
+};
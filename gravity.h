@@ -0,0 +1,195 @@
+/*
+ * =================================================================================================
+ * SOMA DIRETA DA GRAVIDADE EM BLOCOS
+ *
+ * Núcleo comum aos cálculos de força de nbody.h: a aceleração de um bloco de alvos causada por
+ * um bloco de fontes, com posições e massas em SoA. Os alvos ficam nas pistas dos registradores
+ * e cada fonte é espalhada para todas elas, então não há redução horizontal nem escrita
+ * compartilhada: quem chama divide os alvos entre as threads e cada uma só escreve nos seus.
+ *
+ * As versões AVX2 e AVX-512 (escolhidas em tempo de execução) trocam a raiz e a divisão pela
+ * raiz inversa aproximada do processador, refinada por duas iterações de Newton até quase a
+ * precisão do double. Tudo é calculado em double: as distâncias Terra-Lua e Sol-Netuno diferem
+ * em quatro ordens de grandeza.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "simd.h"
+
+// Operações de ponto flutuante contadas por interação nas taxas em GFLOP/s, pela convenção usual
+// da literatura de N-corpos (3 subtrações, 6 para a distância ao quadrado, 4 para a raiz inversa,
+// 4 para mu / r^3 e 3 acumulações).
+const double GRAVITY_FLOPS_PER_INTERACTION = 20.0;
+
+// Bloco de fontes: posições e parâmetros gravitacionais (G * massa).
+struct GravitySources {
+    const double* x;
+    const double* y;
+    const double* z;
+    const double* mu;
+    size_t count;
+};
+
+// Soma em (ax, ay, az)[i] a atração das fontes sobre os alvos i em [0, targets). Pares à
+// distância zero (o próprio alvo, sem amortecimento) não contribuem.
+inline void gravityTileScalar(const double* tx, const double* ty, const double* tz, size_t targets,
+                              const GravitySources& sources, double eps2, double* ax, double* ay, double* az) {
+    for (size_t i = 0; i < targets; i++) {
+        double sumX = 0.0, sumY = 0.0, sumZ = 0.0;
+        for (size_t j = 0; j < sources.count; j++) {
+            double dx = sources.x[j] - tx[i], dy = sources.y[j] - ty[i], dz = sources.z[j] - tz[i];
+            double d2 = dx * dx + dy * dy + dz * dz + eps2;
+            double scale = d2 > 0.0 ? sources.mu[j] / (d2 * std::sqrt(d2)) : 0.0;
+            sumX += dx * scale;
+            sumY += dy * scale;
+            sumZ += dz * scale;
+        }
+        ax[i] += sumX;
+        ay[i] += sumY;
+        az[i] += sumZ;
+    }
+}
+
+#ifdef SIMD_HAS_AVX2
+
+// Faixa de d2 em que o chute da raiz inversa em float é usado; fora dela (encontros muito
+// próximos sem amortecimento ou distâncias enormes), o float daria zero ou infinito.
+const double GRAVITY_RSQRT_MIN = 1e-36, GRAVITY_RSQRT_MAX = 1e36;
+
+// mu / r^3 para 4 distâncias ao quadrado. A raiz inversa de 12 bits do float passa por duas
+// iterações de Newton (24 e depois 48 bits). As pistas com d2 fora da faixa do chute usam a raiz
+// e a divisão exatas, como a versão escalar.
+SIMD_TARGET_AVX2 inline __m256d gravityScaleAVX2(__m256d d2, __m256d mu) {
+    const __m256d half = _mm256_set1_pd(0.5), threeHalves = _mm256_set1_pd(1.5);
+    __m256d y = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(d2)));
+    __m256d halfD2 = _mm256_mul_pd(half, d2);
+    y = _mm256_mul_pd(y, _mm256_fnmadd_pd(halfD2, _mm256_mul_pd(y, y), threeHalves));
+    y = _mm256_mul_pd(y, _mm256_fnmadd_pd(halfD2, _mm256_mul_pd(y, y), threeHalves));
+    __m256d scale = _mm256_mul_pd(_mm256_mul_pd(y, y), _mm256_mul_pd(y, mu));
+    __m256d outside = _mm256_or_pd(_mm256_cmp_pd(d2, _mm256_set1_pd(GRAVITY_RSQRT_MIN), _CMP_LT_OQ),
+                                   _mm256_cmp_pd(d2, _mm256_set1_pd(GRAVITY_RSQRT_MAX), _CMP_GT_OQ));
+    if (_mm256_movemask_pd(outside)) {
+        __m256d exact = _mm256_div_pd(mu, _mm256_mul_pd(d2, _mm256_sqrt_pd(d2)));
+        scale = _mm256_blendv_pd(scale, exact, outside);
+    }
+    return _mm256_and_pd(scale, _mm256_cmp_pd(d2, _mm256_setzero_pd(), _CMP_GT_OQ));
+}
+
+// Oito alvos por vez, em dois registradores, para esconder a latência das FMAs. O último bloco
+// usa cargas e escritas mascaradas.
+SIMD_TARGET_AVX2 inline void gravityTileAVX2(const double* tx, const double* ty, const double* tz, size_t targets,
+                                                const GravitySources& sources, double eps2, double* ax, double* ay,
+                                                double* az) {
+    const __m256d softening = _mm256_set1_pd(eps2);
+    for (size_t i = 0; i < targets; i += 8) {
+        size_t lanes = targets - i < 8 ? targets - i : 8;
+        __m256i mask[2];
+        for (int half = 0; half < 2; half++) {
+            int64_t bits[4];
+            for (int lane = 0; lane < 4; lane++) bits[lane] = (size_t)(half * 4 + lane) < lanes ? -1 : 0;
+            mask[half] = _mm256_loadu_si256((const __m256i*)bits);
+        }
+        __m256d px0 = _mm256_maskload_pd(tx + i, mask[0]), px1 = _mm256_maskload_pd(tx + i + 4, mask[1]);
+        __m256d py0 = _mm256_maskload_pd(ty + i, mask[0]), py1 = _mm256_maskload_pd(ty + i + 4, mask[1]);
+        __m256d pz0 = _mm256_maskload_pd(tz + i, mask[0]), pz1 = _mm256_maskload_pd(tz + i + 4, mask[1]);
+        __m256d sumX0 = _mm256_setzero_pd(), sumY0 = _mm256_setzero_pd(), sumZ0 = _mm256_setzero_pd();
+        __m256d sumX1 = _mm256_setzero_pd(), sumY1 = _mm256_setzero_pd(), sumZ1 = _mm256_setzero_pd();
+        for (size_t j = 0; j < sources.count; j++) {
+            __m256d sx = _mm256_broadcast_sd(sources.x + j), sy = _mm256_broadcast_sd(sources.y + j);
+            __m256d sz = _mm256_broadcast_sd(sources.z + j), mu = _mm256_broadcast_sd(sources.mu + j);
+            __m256d dx0 = _mm256_sub_pd(sx, px0), dy0 = _mm256_sub_pd(sy, py0), dz0 = _mm256_sub_pd(sz, pz0);
+            __m256d dx1 = _mm256_sub_pd(sx, px1), dy1 = _mm256_sub_pd(sy, py1), dz1 = _mm256_sub_pd(sz, pz1);
+            __m256d d20 = _mm256_fmadd_pd(dx0, dx0, _mm256_fmadd_pd(dy0, dy0, _mm256_fmadd_pd(dz0, dz0, softening)));
+            __m256d d21 = _mm256_fmadd_pd(dx1, dx1, _mm256_fmadd_pd(dy1, dy1, _mm256_fmadd_pd(dz1, dz1, softening)));
+            __m256d scale0 = gravityScaleAVX2(d20, mu), scale1 = gravityScaleAVX2(d21, mu);
+            sumX0 = _mm256_fmadd_pd(dx0, scale0, sumX0);
+            sumY0 = _mm256_fmadd_pd(dy0, scale0, sumY0);
+            sumZ0 = _mm256_fmadd_pd(dz0, scale0, sumZ0);
+            sumX1 = _mm256_fmadd_pd(dx1, scale1, sumX1);
+            sumY1 = _mm256_fmadd_pd(dy1, scale1, sumY1);
+            sumZ1 = _mm256_fmadd_pd(dz1, scale1, sumZ1);
+        }
+        _mm256_maskstore_pd(ax + i, mask[0], _mm256_add_pd(_mm256_maskload_pd(ax + i, mask[0]), sumX0));
+        _mm256_maskstore_pd(ay + i, mask[0], _mm256_add_pd(_mm256_maskload_pd(ay + i, mask[0]), sumY0));
+        _mm256_maskstore_pd(az + i, mask[0], _mm256_add_pd(_mm256_maskload_pd(az + i, mask[0]), sumZ0));
+        _mm256_maskstore_pd(ax + i + 4, mask[1], _mm256_add_pd(_mm256_maskload_pd(ax + i + 4, mask[1]), sumX1));
+        _mm256_maskstore_pd(ay + i + 4, mask[1], _mm256_add_pd(_mm256_maskload_pd(ay + i + 4, mask[1]), sumY1));
+        _mm256_maskstore_pd(az + i + 4, mask[1], _mm256_add_pd(_mm256_maskload_pd(az + i + 4, mask[1]), sumZ1));
+    }
+}
+
+#endif
+
+#ifdef SIMD_HAS_AVX512
+
+// mu / r^3 para 8 distâncias ao quadrado, a partir da raiz inversa de 14 bits do AVX-512 (28 e
+// depois 56 bits com as iterações de Newton). Distância zero dá zero.
+SIMD_TARGET_AVX512 inline __m512d gravityScaleAVX512(__m512d d2, __m512d mu) {
+    const __m512d half = _mm512_set1_pd(0.5), threeHalves = _mm512_set1_pd(1.5);
+    __mmask8 positive = _mm512_cmp_pd_mask(d2, _mm512_setzero_pd(), _CMP_GT_OQ);
+    __m512d y = _mm512_maskz_rsqrt14_pd(positive, d2);
+    __m512d halfD2 = _mm512_mul_pd(half, d2);
+    y = _mm512_mul_pd(y, _mm512_fnmadd_pd(halfD2, _mm512_mul_pd(y, y), threeHalves));
+    y = _mm512_mul_pd(y, _mm512_fnmadd_pd(halfD2, _mm512_mul_pd(y, y), threeHalves));
+    return _mm512_mul_pd(_mm512_mul_pd(y, y), _mm512_mul_pd(y, mu));
+}
+
+// Dezesseis alvos por vez, em dois registradores; o último bloco usa máscaras.
+SIMD_TARGET_AVX512 inline void gravityTileAVX512(const double* tx, const double* ty, const double* tz,
+                                                    size_t targets, const GravitySources& sources, double eps2,
+                                                    double* ax, double* ay, double* az) {
+    const __m512d softening = _mm512_set1_pd(eps2);
+    for (size_t i = 0; i < targets; i += 16) {
+        size_t lanes = targets - i < 16 ? targets - i : 16;
+        __mmask8 mask0 = (__mmask8)(lanes >= 8 ? 0xFF : (1u << lanes) - 1);
+        __mmask8 mask1 = (__mmask8)(lanes >= 16 ? 0xFF : lanes > 8 ? (1u << (lanes - 8)) - 1 : 0);
+        __m512d px0 = _mm512_maskz_loadu_pd(mask0, tx + i), px1 = _mm512_maskz_loadu_pd(mask1, tx + i + 8);
+        __m512d py0 = _mm512_maskz_loadu_pd(mask0, ty + i), py1 = _mm512_maskz_loadu_pd(mask1, ty + i + 8);
+        __m512d pz0 = _mm512_maskz_loadu_pd(mask0, tz + i), pz1 = _mm512_maskz_loadu_pd(mask1, tz + i + 8);
+        __m512d sumX0 = _mm512_setzero_pd(), sumY0 = _mm512_setzero_pd(), sumZ0 = _mm512_setzero_pd();
+        __m512d sumX1 = _mm512_setzero_pd(), sumY1 = _mm512_setzero_pd(), sumZ1 = _mm512_setzero_pd();
+        for (size_t j = 0; j < sources.count; j++) {
+            __m512d sx = _mm512_set1_pd(sources.x[j]), sy = _mm512_set1_pd(sources.y[j]);
+            __m512d sz = _mm512_set1_pd(sources.z[j]), mu = _mm512_set1_pd(sources.mu[j]);
+            __m512d dx0 = _mm512_sub_pd(sx, px0), dy0 = _mm512_sub_pd(sy, py0), dz0 = _mm512_sub_pd(sz, pz0);
+            __m512d dx1 = _mm512_sub_pd(sx, px1), dy1 = _mm512_sub_pd(sy, py1), dz1 = _mm512_sub_pd(sz, pz1);
+            __m512d d20 = _mm512_fmadd_pd(dx0, dx0, _mm512_fmadd_pd(dy0, dy0, _mm512_fmadd_pd(dz0, dz0, softening)));
+            __m512d d21 = _mm512_fmadd_pd(dx1, dx1, _mm512_fmadd_pd(dy1, dy1, _mm512_fmadd_pd(dz1, dz1, softening)));
+            __m512d scale0 = gravityScaleAVX512(d20, mu), scale1 = gravityScaleAVX512(d21, mu);
+            sumX0 = _mm512_fmadd_pd(dx0, scale0, sumX0);
+            sumY0 = _mm512_fmadd_pd(dy0, scale0, sumY0);
+            sumZ0 = _mm512_fmadd_pd(dz0, scale0, sumZ0);
+            sumX1 = _mm512_fmadd_pd(dx1, scale1, sumX1);
+            sumY1 = _mm512_fmadd_pd(dy1, scale1, sumY1);
+            sumZ1 = _mm512_fmadd_pd(dz1, scale1, sumZ1);
+        }
+        _mm512_mask_storeu_pd(ax + i, mask0, _mm512_add_pd(_mm512_maskz_loadu_pd(mask0, ax + i), sumX0));
+        _mm512_mask_storeu_pd(ay + i, mask0, _mm512_add_pd(_mm512_maskz_loadu_pd(mask0, ay + i), sumY0));
+        _mm512_mask_storeu_pd(az + i, mask0, _mm512_add_pd(_mm512_maskz_loadu_pd(mask0, az + i), sumZ0));
+        _mm512_mask_storeu_pd(ax + i + 8, mask1, _mm512_add_pd(_mm512_maskz_loadu_pd(mask1, ax + i + 8), sumX1));
+        _mm512_mask_storeu_pd(ay + i + 8, mask1, _mm512_add_pd(_mm512_maskz_loadu_pd(mask1, ay + i + 8), sumY1));
+        _mm512_mask_storeu_pd(az + i + 8, mask1, _mm512_add_pd(_mm512_maskz_loadu_pd(mask1, az + i + 8), sumZ1));
+    }
+}
+
+#endif
+
+// Soma em (ax, ay, az)[i] a atração das fontes sobre os alvos i em [0, targets), com o conjunto
+// de instruções 'kernel'. Não divide o trabalho entre threads.
+inline void gravityTile(const double* tx, const double* ty, const double* tz, size_t targets,
+                        const GravitySources& sources, double eps2, double* ax, double* ay, double* az,
+                        SimdKernel kernel = detectSimdKernel()) {
+#ifdef SIMD_HAS_AVX512
+    if (kernel == SimdKernel::AVX512) return gravityTileAVX512(tx, ty, tz, targets, sources, eps2, ax, ay, az);
+#endif
+#ifdef SIMD_HAS_AVX2
+    if (kernel == SimdKernel::AVX2) return gravityTileAVX2(tx, ty, tz, targets, sources, eps2, ax, ay, az);
+#endif
+    gravityTileScalar(tx, ty, tz, targets, sources, eps2, ax, ay, az);
+}
@@ -0,0 +1,383 @@
+/*
+ * =================================================================================================
+ * ÓRBITAS KEPLERIANAS
+ *
+ * Posições de corpos em órbitas elípticas a partir dos elementos orbitais clássicos. As órbitas
+ * ficam em SoA (KeplerBatch), com os vetores do plano orbital já multiplicados pelos semieixos,
+ * e a equação de Kepler (M = E - e sen E) é resolvida em lote por iterações de Newton, em
+ * versões escalar, AVX2 e AVX-512 escolhidas em tempo de execução. As coordenadas de saída já
+ * estão no sistema da cena: a eclíptica é o plano XZ e o norte da eclíptica é +Y.
+ *
+ * A anomalia média é reduzida a [-PI, PI] em double antes de tudo, com o produto
+ * movimento médio x tempo separado em parte alta e erro exato (fma), então a precisão não
+ * depende de quanto tempo já passou. O restante do cálculo dos lotes é em float, que basta para
+ * a cena (cerca de 1e-7 do semieixo). Para os cálculos físicos (exportação e busca de eventos),
+ * KeplerOrbit resolve uma órbita por vez inteira em double, na eclíptica.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "simd.h"
+
+// Elementos orbitais clássicos de um corpo, referidos à eclíptica. Ângulos em graus.
+struct OrbitalElements {
+    double semiMajorAxis; // Em unidades da cena.
+    double eccentricity;  // 0 <= e < 1.
+    double inclination;
+    double ascendingNode; // Longitude do nodo ascendente.
+    double argPeriapsis;  // Argumento do periastro.
+    double meanAnomaly;   // Anomalia média na época (tempo 0).
+    double period;        // Período orbital em dias.
+};
+
+const int KEPLER_MAX_ITERATIONS = 12;   // Limite das iterações de Newton (só e perto de 1 chega perto).
+const float KEPLER_TOLERANCE = 1e-6f;   // Resíduo |E - e sen E - M| aceito, em radianos.
+const double KEPLER_PRECISE_STEP = 1e-7; // Última correção de Newton em KeplerOrbit, em radianos.
+
+// Vetores unitários P (para o periastro) e Q (90 graus à frente no plano da órbita) na eclíptica,
+// com x para o equinócio e z para o norte.
+inline void keplerPlaneVectors(const OrbitalElements& elements, double p[3], double q[3]) {
+    const double toRadians = M_PI / 180.0;
+    double i = elements.inclination * toRadians;
+    double node = elements.ascendingNode * toRadians;
+    double w = elements.argPeriapsis * toRadians;
+    p[0] = std::cos(node) * std::cos(w) - std::sin(node) * std::sin(w) * std::cos(i);
+    p[1] = std::sin(node) * std::cos(w) + std::cos(node) * std::sin(w) * std::cos(i);
+    p[2] = std::sin(w) * std::sin(i);
+    q[0] = -std::cos(node) * std::sin(w) - std::sin(node) * std::cos(w) * std::cos(i);
+    q[1] = -std::sin(node) * std::sin(w) + std::cos(node) * std::cos(w) * std::cos(i);
+    q[2] = std::cos(w) * std::sin(i);
+}
+
+// Órbitas em SoA. A posição no instante t é a * P * (cos E - e) + b * Q * sen E, em que P aponta
+// para o periastro e Q está 90 graus à frente no plano da órbita.
+struct KeplerBatch {
+    std::vector<double> meanAnomaly; // Anomalia média na época, em radianos.
+    std::vector<double> meanMotion;  // Radianos por dia.
+    std::vector<float> eccentricity;
+    std::vector<float> px, py, pz;   // a * P.
+    std::vector<float> qx, qy, qz;   // b * Q.
+
+    size_t size() const { return eccentricity.size(); }
+
+    void reserve(size_t count) {
+        for (auto* values : {&meanAnomaly, &meanMotion}) values->reserve(count);
+        for (auto* values : {&eccentricity, &px, &py, &pz, &qx, &qy, &qz}) values->reserve(count);
+    }
+
+    void add(const OrbitalElements& elements) {
+        double a = elements.semiMajorAxis;
+        double b = a * std::sqrt(1.0 - elements.eccentricity * elements.eccentricity);
+        // P e Q levados para a cena como (x, z, -y), a mesma orientação de glRotatef em torno de +Y.
+        double pEcliptic[3], qEcliptic[3];
+        keplerPlaneVectors(elements, pEcliptic, qEcliptic);
+        meanAnomaly.push_back(elements.meanAnomaly * M_PI / 180.0);
+        meanMotion.push_back(2.0 * M_PI / elements.period);
+        eccentricity.push_back((float)elements.eccentricity);
+        px.push_back((float)(a * pEcliptic[0]));
+        py.push_back((float)(a * pEcliptic[2]));
+        pz.push_back((float)(-a * pEcliptic[1]));
+        qx.push_back((float)(b * qEcliptic[0]));
+        qy.push_back((float)(b * qEcliptic[2]));
+        qz.push_back((float)(-b * qEcliptic[1]));
+    }
+
+    // Ponto da órbita 'index' com anomalia excêntrica E (usado para desenhar a elipse).
+    void orbitPoint(size_t index, double E, float& x, float& y, float& z) const {
+        float u = (float)std::cos(E) - eccentricity[index], v = (float)std::sin(E);
+        x = px[index] * u + qx[index] * v;
+        y = py[index] * u + qy[index] * v;
+        z = pz[index] * u + qz[index] * v;
+    }
+};
+
+// 2 * PI dividido em uma parte com os bits altos e o restante, para a redução de Cody-Waite.
+const double KEPLER_TWO_PI_HIGH = 6.28318530717958623;
+const double KEPLER_TWO_PI_LOW = 2.4492935982947064e-16;
+
+// Anomalia média em [-PI, PI] no instante 'days', em double.
+inline double keplerMeanAnomalyPrecise(double meanAnomaly, double meanMotion, double days) {
+    double high = meanMotion * days;
+    double low = std::fma(meanMotion, days, -high);
+    double k = std::nearbyint(high / KEPLER_TWO_PI_HIGH);
+    double r = std::fma(-k, KEPLER_TWO_PI_HIGH, high);
+    r = std::fma(-k, KEPLER_TWO_PI_LOW, r) + low + meanAnomaly;
+    // A anomalia na época e o erro do produto podem deslocar r em até uma volta.
+    return r - KEPLER_TWO_PI_HIGH * std::nearbyint(r / KEPLER_TWO_PI_HIGH);
+}
+
+// Anomalia média em [-PI, PI] no instante 'days'.
+inline float keplerMeanAnomaly(double meanAnomaly, double meanMotion, double days) {
+    return (float)keplerMeanAnomalyPrecise(meanAnomaly, meanMotion, days);
+}
+
+// Uma órbita inteira em double, com P e Q na eclíptica já multiplicados pelos semieixos. Sem
+// lote nem SIMD: serve aos poucos corpos dos cálculos físicos, em que o float dos lotes deixaria
+// erros de cerca de 1e-7 do semieixo (centenas de km nos planetas).
+struct KeplerOrbit {
+    double meanAnomaly = 0.0, meanMotion = 0.0, eccentricity = 0.0;
+    double p[3] = {0.0, 0.0, 0.0}, q[3] = {0.0, 0.0, 0.0};
+
+    KeplerOrbit() = default;
+    explicit KeplerOrbit(const OrbitalElements& elements) {
+        double a = elements.semiMajorAxis;
+        double b = a * std::sqrt(1.0 - elements.eccentricity * elements.eccentricity);
+        keplerPlaneVectors(elements, p, q);
+        for (int axis = 0; axis < 3; axis++) {
+            p[axis] *= a;
+            q[axis] *= b;
+        }
+        meanAnomaly = elements.meanAnomaly * M_PI / 180.0;
+        meanMotion = 2.0 * M_PI / elements.period;
+        eccentricity = elements.eccentricity;
+    }
+
+    // Posição (x, y, z) na eclíptica no instante 'days' (dias desde a época), como em
+    // keplerSolveScalar(). O Newton converge quadraticamente: depois de uma correção menor que
+    // KEPLER_PRECISE_STEP, o erro que sobra é da ordem do quadrado dela, e o seno e o cosseno
+    // acompanham a correção pela série de Taylor, sem calcular de novo.
+    void position(double days, double out[3]) const {
+        double M = keplerMeanAnomalyPrecise(meanAnomaly, meanMotion, days);
+        double e = eccentricity;
+        double E = M + std::copysign(0.85 * e, M);
+        double s = 0.0, c = 1.0;
+        for (int iteration = 0; iteration < 2 * KEPLER_MAX_ITERATIONS; iteration++) {
+            s = std::sin(E);
+            c = std::cos(E);
+            double step = (E - e * s - M) / (1.0 - e * c);
+            E -= step;
+            if (std::fabs(step) <= KEPLER_PRECISE_STEP) {
+                double half = 0.5 * step * step;
+                double sinE = s - c * step - s * half;
+                c += s * step - c * half;
+                s = sinE;
+                break;
+            }
+        }
+        double u = c - e;
+        for (int axis = 0; axis < 3; axis++) out[axis] = p[axis] * u + q[axis] * s;
+    }
+};
+
+// Versão escalar, também usada para os corpos que sobram no fim de cada lote SIMD. O chute
+// inicial E = M + 0.85 e sinal(M) (Danby) converge para qualquer e < 1.
+inline void keplerSolveScalar(const KeplerBatch& batch, double days, float* x, float* y, float* z,
+                              size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        float M = keplerMeanAnomaly(batch.meanAnomaly[i], batch.meanMotion[i], days);
+        float e = batch.eccentricity[i];
+        float E = M + std::copysign(0.85f * e, M);
+        float s = std::sin(E), c = std::cos(E);
+        for (int iteration = 0; iteration < KEPLER_MAX_ITERATIONS; iteration++) {
+            float f = E - e * s - M;
+            if (std::fabs(f) <= KEPLER_TOLERANCE) break;
+            E -= f / (1.0f - e * c);
+            s = std::sin(E);
+            c = std::cos(E);
+        }
+        float u = c - e;
+        x[i - begin] = batch.px[i] * u + batch.qx[i] * s;
+        y[i - begin] = batch.py[i] * u + batch.qy[i] * s;
+        z[i - begin] = batch.pz[i] * u + batch.qz[i] * s;
+    }
+}
+
+// Coeficientes dos polinômios de seno e cosseno em [-PI/4, PI/4] (os mesmos da sinf/cosf da
+// Cephes) e as partes de PI/2 para a redução do argumento.
+const float KEPLER_SIN1 = -1.6666654611e-1f, KEPLER_SIN2 = 8.3321608736e-3f, KEPLER_SIN3 = -1.9515295891e-4f;
+const float KEPLER_COS1 = 4.166664568298827e-2f, KEPLER_COS2 = -1.388731625493765e-3f, KEPLER_COS3 = 2.443315711809948e-5f;
+const float KEPLER_HALF_PI1 = 1.5703125f, KEPLER_HALF_PI2 = 4.837512969970703125e-4f, KEPLER_HALF_PI3 = 7.54978995489188216e-8f;
+
+#ifdef SIMD_HAS_AVX2
+// Seno e cosseno de 8 floats. O quadrante q = round(x / (PI/2)) escolhe entre os polinômios
+// (q ímpar troca seno e cosseno) e o sinal de cada um.
+SIMD_TARGET_AVX2 inline void keplerSinCosAVX2(__m256 x, __m256& sinX, __m256& cosX) {
+    __m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps((float)(2.0 / M_PI))),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256i q = _mm256_cvtps_epi32(j);
+    __m256 y = _mm256_fnmadd_ps(j, _mm256_set1_ps(KEPLER_HALF_PI1), x);
+    y = _mm256_fnmadd_ps(j, _mm256_set1_ps(KEPLER_HALF_PI2), y);
+    y = _mm256_fnmadd_ps(j, _mm256_set1_ps(KEPLER_HALF_PI3), y);
+    __m256 z = _mm256_mul_ps(y, y);
+    __m256 sinPoly = _mm256_fmadd_ps(z, _mm256_set1_ps(KEPLER_SIN3), _mm256_set1_ps(KEPLER_SIN2));
+    sinPoly = _mm256_fmadd_ps(sinPoly, z, _mm256_set1_ps(KEPLER_SIN1));
+    sinPoly = _mm256_fmadd_ps(sinPoly, _mm256_mul_ps(z, y), y);
+    __m256 cosPoly = _mm256_fmadd_ps(z, _mm256_set1_ps(KEPLER_COS3), _mm256_set1_ps(KEPLER_COS2));
+    cosPoly = _mm256_fmadd_ps(cosPoly, z, _mm256_set1_ps(KEPLER_COS1));
+    cosPoly = _mm256_fmadd_ps(cosPoly, _mm256_mul_ps(z, z), _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+
+    __m256i one = _mm256_set1_epi32(1), signBit = _mm256_set1_epi32((int)0x80000000);
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    __m256i sinSign = _mm256_and_si256(_mm256_slli_epi32(q, 30), signBit);
+    __m256i cosSign = _mm256_and_si256(_mm256_slli_epi32(_mm256_add_epi32(q, one), 30), signBit);
+    sinX = _mm256_xor_ps(_mm256_blendv_ps(sinPoly, cosPoly, swap), _mm256_castsi256_ps(sinSign));
+    cosX = _mm256_xor_ps(_mm256_blendv_ps(cosPoly, sinPoly, swap), _mm256_castsi256_ps(cosSign));
+}
+
+// Anomalia média de 4 corpos, como keplerMeanAnomaly().
+SIMD_TARGET_AVX2 inline __m128 keplerMeanAnomalyAVX2(const double* meanAnomaly, const double* meanMotion, __m256d days) {
+    const __m256d twoPiHigh = _mm256_set1_pd(KEPLER_TWO_PI_HIGH), inverse = _mm256_set1_pd(1.0 / KEPLER_TWO_PI_HIGH);
+    const int nearest = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+    __m256d motion = _mm256_loadu_pd(meanMotion);
+    __m256d high = _mm256_mul_pd(motion, days);
+    __m256d low = _mm256_fmsub_pd(motion, days, high);
+    __m256d k = _mm256_round_pd(_mm256_mul_pd(high, inverse), nearest);
+    __m256d r = _mm256_fnmadd_pd(k, twoPiHigh, high);
+    r = _mm256_fnmadd_pd(k, _mm256_set1_pd(KEPLER_TWO_PI_LOW), r);
+    r = _mm256_add_pd(r, _mm256_add_pd(low, _mm256_loadu_pd(meanAnomaly)));
+    r = _mm256_fnmadd_pd(_mm256_round_pd(_mm256_mul_pd(r, inverse), nearest), twoPiHigh, r);
+    return _mm256_cvtpd_ps(r);
+}
+
+// Resolve 8 corpos por vez; retorna o índice do primeiro corpo não processado.
+SIMD_TARGET_AVX2 inline size_t keplerSolveAVX2(const KeplerBatch& batch, double days, float* x, float* y, float* z,
+                                                 size_t begin, size_t end) {
+    const __m256d t = _mm256_set1_pd(days);
+    const __m256 one = _mm256_set1_ps(1.0f), tolerance = _mm256_set1_ps(KEPLER_TOLERANCE);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 M = _mm256_set_m128(keplerMeanAnomalyAVX2(&batch.meanAnomaly[i + 4], &batch.meanMotion[i + 4], t),
+                                   keplerMeanAnomalyAVX2(&batch.meanAnomaly[i], &batch.meanMotion[i], t));
+        __m256 e = _mm256_loadu_ps(&batch.eccentricity[i]);
+        __m256 E = _mm256_add_ps(M, _mm256_or_ps(_mm256_mul_ps(_mm256_set1_ps(0.85f), e), _mm256_and_ps(M, signMask)));
+        __m256 s, c;
+        keplerSinCosAVX2(E, s, c);
+        for (int iteration = 0; iteration < KEPLER_MAX_ITERATIONS; iteration++) {
+            __m256 f = _mm256_sub_ps(_mm256_fnmadd_ps(e, s, E), M);
+            __m256 pending = _mm256_cmp_ps(_mm256_andnot_ps(signMask, f), tolerance, _CMP_GT_OQ);
+            if (!_mm256_movemask_ps(pending)) break;
+            E = _mm256_sub_ps(E, _mm256_div_ps(f, _mm256_fnmadd_ps(e, c, one)));
+            keplerSinCosAVX2(E, s, c);
+        }
+        __m256 u = _mm256_sub_ps(c, e);
+        _mm256_storeu_ps(x + (i - begin), _mm256_fmadd_ps(_mm256_loadu_ps(&batch.px[i]), u, _mm256_mul_ps(_mm256_loadu_ps(&batch.qx[i]), s)));
+        _mm256_storeu_ps(y + (i - begin), _mm256_fmadd_ps(_mm256_loadu_ps(&batch.py[i]), u, _mm256_mul_ps(_mm256_loadu_ps(&batch.qy[i]), s)));
+        _mm256_storeu_ps(z + (i - begin), _mm256_fmadd_ps(_mm256_loadu_ps(&batch.pz[i]), u, _mm256_mul_ps(_mm256_loadu_ps(&batch.qz[i]), s)));
+    }
+    return i;
+}
+#endif
+
+#ifdef SIMD_HAS_AVX512
+SIMD_AVX512_WARNINGS_BEGIN
+
+// Seno e cosseno de 16 floats, como keplerSinCosAVX2().
+SIMD_TARGET_AVX512 inline void keplerSinCosAVX512(__m512 x, __m512& sinX, __m512& cosX) {
+    __m512 j = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps((float)(2.0 / M_PI))), _MM_FROUND_TO_NEAREST_INT);
+    __m512i q = _mm512_cvtps_epi32(j);
+    __m512 y = _mm512_fnmadd_ps(j, _mm512_set1_ps(KEPLER_HALF_PI1), x);
+    y = _mm512_fnmadd_ps(j, _mm512_set1_ps(KEPLER_HALF_PI2), y);
+    y = _mm512_fnmadd_ps(j, _mm512_set1_ps(KEPLER_HALF_PI3), y);
+    __m512 z = _mm512_mul_ps(y, y);
+    __m512 sinPoly = _mm512_fmadd_ps(z, _mm512_set1_ps(KEPLER_SIN3), _mm512_set1_ps(KEPLER_SIN2));
+    sinPoly = _mm512_fmadd_ps(sinPoly, z, _mm512_set1_ps(KEPLER_SIN1));
+    sinPoly = _mm512_fmadd_ps(sinPoly, _mm512_mul_ps(z, y), y);
+    __m512 cosPoly = _mm512_fmadd_ps(z, _mm512_set1_ps(KEPLER_COS3), _mm512_set1_ps(KEPLER_COS2));
+    cosPoly = _mm512_fmadd_ps(cosPoly, z, _mm512_set1_ps(KEPLER_COS1));
+    cosPoly = _mm512_fmadd_ps(cosPoly, _mm512_mul_ps(z, z), _mm512_fnmadd_ps(_mm512_set1_ps(0.5f), z, _mm512_set1_ps(1.0f)));
+
+    __m512i one = _mm512_set1_epi32(1), signBit = _mm512_set1_epi32((int)0x80000000);
+    __mmask16 swap = _mm512_test_epi32_mask(q, one);
+    __m512i sinSign = _mm512_and_si512(_mm512_slli_epi32(q, 30), signBit);
+    __m512i cosSign = _mm512_and_si512(_mm512_slli_epi32(_mm512_add_epi32(q, one), 30), signBit);
+    sinX = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_blend_ps(swap, sinPoly, cosPoly)), sinSign));
+    cosX = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_mask_blend_ps(swap, cosPoly, sinPoly)), cosSign));
+}
+
+// Anomalia média de 8 corpos, como keplerMeanAnomaly().
+SIMD_TARGET_AVX512 inline __m256 keplerMeanAnomalyAVX512(const double* meanAnomaly, const double* meanMotion, __m512d days) {
+    const __m512d twoPiHigh = _mm512_set1_pd(KEPLER_TWO_PI_HIGH), inverse = _mm512_set1_pd(1.0 / KEPLER_TWO_PI_HIGH);
+    __m512d motion = _mm512_loadu_pd(meanMotion);
+    __m512d high = _mm512_mul_pd(motion, days);
+    __m512d low = _mm512_fmsub_pd(motion, days, high);
+    __m512d k = _mm512_roundscale_pd(_mm512_mul_pd(high, inverse), _MM_FROUND_TO_NEAREST_INT);
+    __m512d r = _mm512_fnmadd_pd(k, twoPiHigh, high);
+    r = _mm512_fnmadd_pd(k, _mm512_set1_pd(KEPLER_TWO_PI_LOW), r);
+    r = _mm512_add_pd(r, _mm512_add_pd(low, _mm512_loadu_pd(meanAnomaly)));
+    r = _mm512_fnmadd_pd(_mm512_roundscale_pd(_mm512_mul_pd(r, inverse), _MM_FROUND_TO_NEAREST_INT), twoPiHigh, r);
+    return _mm512_cvtpd_ps(r);
+}
+
+// Resolve 16 corpos por vez; retorna o índice do primeiro corpo não processado.
+SIMD_TARGET_AVX512 inline size_t keplerSolveAVX512(const KeplerBatch& batch, double days, float* x, float* y, float* z,
+                                                     size_t begin, size_t end) {
+    const __m512d t = _mm512_set1_pd(days);
+    const __m512 one = _mm512_set1_ps(1.0f), tolerance = _mm512_set1_ps(KEPLER_TOLERANCE);
+    const __m512i signBit = _mm512_set1_epi32((int)0x80000000);
+    size_t i = begin;
+    for (; i + 16 <= end; i += 16) {
+        __m256 low = keplerMeanAnomalyAVX512(&batch.meanAnomaly[i], &batch.meanMotion[i], t);
+        __m256 high = keplerMeanAnomalyAVX512(&batch.meanAnomaly[i + 8], &batch.meanMotion[i + 8], t);
+        __m512 M = _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(low)),
+                                                       _mm256_castps_pd(high), 1));
+        __m512 e = _mm512_loadu_ps(&batch.eccentricity[i]);
+        __m512i signM = _mm512_and_si512(_mm512_castps_si512(M), signBit);
+        __m512 E = _mm512_add_ps(M, _mm512_castsi512_ps(_mm512_or_si512(
+                                        _mm512_castps_si512(_mm512_mul_ps(_mm512_set1_ps(0.85f), e)), signM)));
+        __m512 s, c;
+        keplerSinCosAVX512(E, s, c);
+        for (int iteration = 0; iteration < KEPLER_MAX_ITERATIONS; iteration++) {
+            __m512 f = _mm512_sub_ps(_mm512_fnmadd_ps(e, s, E), M);
+            if (!_mm512_cmp_ps_mask(_mm512_abs_ps(f), tolerance, _CMP_GT_OQ)) break;
+            E = _mm512_sub_ps(E, _mm512_div_ps(f, _mm512_fnmadd_ps(e, c, one)));
+            keplerSinCosAVX512(E, s, c);
+        }
+        __m512 u = _mm512_sub_ps(c, e);
+        _mm512_storeu_ps(x + (i - begin), _mm512_fmadd_ps(_mm512_loadu_ps(&batch.px[i]), u, _mm512_mul_ps(_mm512_loadu_ps(&batch.qx[i]), s)));
+        _mm512_storeu_ps(y + (i - begin), _mm512_fmadd_ps(_mm512_loadu_ps(&batch.py[i]), u, _mm512_mul_ps(_mm512_loadu_ps(&batch.qy[i]), s)));
+        _mm512_storeu_ps(z + (i - begin), _mm512_fmadd_ps(_mm512_loadu_ps(&batch.pz[i]), u, _mm512_mul_ps(_mm512_loadu_ps(&batch.qz[i]), s)));
+    }
+    return i;
+}
+SIMD_AVX512_WARNINGS_END
+#endif
+
+// Posições dos corpos [begin, end) do lote no instante 'days' (dias desde a época), gravadas em
+// x[i - begin], y[i - begin] e z[i - begin]. Não divide o trabalho entre threads; quem chama
+// escolhe os intervalos.
+inline void solveKeplerPositions(const KeplerBatch& batch, double days, float* x, float* y, float* z,
+                                 size_t begin, size_t end, SimdKernel kernel = detectSimdKernel()) {
+    size_t done = begin;
+#ifdef SIMD_HAS_AVX512
+    if (kernel == SimdKernel::AVX512) {
+        done = keplerSolveAVX512(batch, days, x, y, z, begin, end);
+        // Toda CPU com AVX-512 tem AVX2: o resto de até 15 corpos (os 8 planetas inteiros) passa
+        // por ele antes do código escalar.
+        kernel = SimdKernel::AVX2;
+    }
+#endif
+#ifdef SIMD_HAS_AVX2
+    if (kernel == SimdKernel::AVX2) {
+        size_t offset = done - begin;
+        done = keplerSolveAVX2(batch, days, x + offset, y + offset, z + offset, done, end);
+    }
+#endif
+    size_t offset = done - begin;
+    keplerSolveScalar(batch, days, x + offset, y + offset, z + offset, done, end);
+}
+
+// Como solveKeplerPositions(), mas grava (x, y, z) intercalados em xyz[3 * (i - begin)], o
+// formato de glVertexPointer. Cada bloco é resolvido em SoA em um rascunho pequeno na pilha e
+// intercalado enquanto ainda está no cache.
+inline void solveKeplerPositionsInterleaved(const KeplerBatch& batch, double days, float* xyz, size_t begin,
+                                            size_t end, SimdKernel kernel = detectSimdKernel()) {
+    const size_t CHUNK = 1024;
+    float x[CHUNK], y[CHUNK], z[CHUNK];
+    for (size_t chunk = begin; chunk < end; chunk += CHUNK) {
+        size_t count = std::min(end - chunk, CHUNK);
+        solveKeplerPositions(batch, days, x, y, z, chunk, chunk + count, kernel);
+        float* out = xyz + 3 * (chunk - begin);
+        for (size_t i = 0; i < count; i++) {
+            out[3 * i] = x[i];
+            out[3 * i + 1] = y[i];
+            out[3 * i + 2] = z[i];
+        }
+    }
+}
@@ -0,0 +1,288 @@
+/*
+ * =================================================================================================
+ * GERADOR DE MIPMAPS
+ *
+ * Substitui o gluBuild2DMipmaps. Cada nível é a média 2x2 do anterior, calculada em espaço de cor
+ * linear (as texturas estão em sRGB) e com o alfa pré-multiplicado, para que texels transparentes
+ * (como as bordas dos anéis de Saturno) não escureçam as cores vizinhas. O nível 0 é lido direto
+ * em RGBA8; os níveis seguintes ficam em float, e só a saída é convertida de volta para 8 bits.
+ *
+ * Dimensões que não são potência de dois são mantidas: cada nível tem max(1, n / 2) texels por
+ * eixo e, em tamanhos ímpares, o último texel é repetido. O laço interno tem versões SSE2 e AVX2,
+ * escolhidas em tempo de execução, e as linhas de cada nível são divididas entre as threads do pool.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "thread_pool.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define MIPMAP_HAS_SSE2 1
+#endif
+
+#if defined(MIPMAP_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define MIPMAP_HAS_AVX2 1
+#define MIPMAP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Um nível de mipmap em RGBA, 8 bits por canal.
+struct MipLevel {
+    int width, height;
+    std::vector<unsigned char> pixels;
+};
+
+// Conjunto de instruções usado pelo laço de redução.
+enum class MipmapKernel { Scalar, SSE2, AVX2 };
+
+// Tabela sRGB (8 bits) -> linear.
+inline const float* srgbToLinearTable() {
+    static const std::vector<float> table = [] {
+        std::vector<float> values(256);
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+// Tabela linear (16 bits) -> sRGB (8 bits). Com 65536 entradas o erro fica abaixo de meio degrau
+// de 8 bits mesmo nos tons escuros, onde a curva sRGB é mais inclinada.
+const int LINEAR_TABLE_SIZE = 65536;
+
+inline const unsigned char* linearToSrgbTable() {
+    static const std::vector<unsigned char> table = [] {
+        std::vector<unsigned char> values(LINEAR_TABLE_SIZE);
+        for (int i = 0; i < LINEAR_TABLE_SIZE; i++) {
+            float l = i / (float)(LINEAR_TABLE_SIZE - 1);
+            float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            values[i] = (unsigned char)std::lround(std::fmin(std::fmax(c, 0.0f), 1.0f) * 255.0f);
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+// Converte um texel RGBA8 sRGB para float linear com o alfa pré-multiplicado e o soma em 'sum'.
+inline void mipAccumulateSrgb(const unsigned char* texel, const float* toLinear, float* sum) {
+    float alpha = texel[3] * (1.0f / 255.0f);
+    sum[0] += toLinear[texel[0]] * alpha;
+    sum[1] += toLinear[texel[1]] * alpha;
+    sum[2] += toLinear[texel[2]] * alpha;
+    sum[3] += alpha;
+}
+
+// Converte texels float linear pré-multiplicados de volta para RGBA8 sRGB.
+inline void mipToSrgbScalar(const float* src, unsigned char* dst, size_t begin, size_t end) {
+    const unsigned char* toSrgb = linearToSrgbTable();
+    const float scale = (float)(LINEAR_TABLE_SIZE - 1);
+    for (size_t i = begin; i < end; i++) {
+        float alpha = src[4 * i + 3];
+        float inverse = alpha > 0.0f ? scale / alpha : 0.0f;
+        for (int c = 0; c < 3; c++) {
+            float index = std::fmin(src[4 * i + c] * inverse, scale);
+            dst[4 * i + c] = toSrgb[(int)(index + 0.5f)];
+        }
+        dst[4 * i + 3] = (unsigned char)(std::fmin(alpha, 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+#ifdef MIPMAP_HAS_SSE2
+// Versão SSE2: desfaz a pré-multiplicação e calcula os índices da tabela com 4 canais por vez.
+inline void mipToSrgbSSE2(const float* src, unsigned char* dst, size_t begin, size_t end) {
+    const unsigned char* toSrgb = linearToSrgbTable();
+    const __m128 scale = _mm_set1_ps((float)(LINEAR_TABLE_SIZE - 1));
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 zero = _mm_setzero_ps();
+    alignas(16) int index[4];
+    for (size_t i = begin; i < end; i++) {
+        __m128 texel = _mm_loadu_ps(src + 4 * i);
+        __m128 alpha = _mm_shuffle_ps(texel, texel, _MM_SHUFFLE(3, 3, 3, 3));
+        // Texels totalmente transparentes viram preto, sem dividir por zero.
+        __m128 inverse = _mm_and_ps(_mm_cmpgt_ps(alpha, zero), _mm_div_ps(scale, alpha));
+        __m128 scaled = _mm_min_ps(_mm_mul_ps(texel, inverse), scale);
+        _mm_store_si128((__m128i*)index, _mm_cvttps_epi32(_mm_add_ps(scaled, half)));
+        dst[4 * i + 0] = toSrgb[index[0]];
+        dst[4 * i + 1] = toSrgb[index[1]];
+        dst[4 * i + 2] = toSrgb[index[2]];
+        dst[4 * i + 3] = (unsigned char)(std::fmin(_mm_cvtss_f32(alpha), 1.0f) * 255.0f + 0.5f);
+    }
+}
+#endif
+
+// Média 2x2 dos texels de destino [begin, end) de uma linha. Onde a coluna 2x+1 não existe
+// (largura ímpar ou 1), o último texel da linha de origem é repetido.
+inline void mipHalveRowScalar(const float* row0, const float* row1, float* out, int begin, int end, int srcWidth) {
+    for (int x = begin; x < end; x++) {
+        int x0 = std::min(2 * x, srcWidth - 1), x1 = std::min(2 * x + 1, srcWidth - 1);
+        for (int c = 0; c < 4; c++) {
+            out[4 * x + c] = 0.25f * (row0[4 * x0 + c] + row0[4 * x1 + c] + row1[4 * x0 + c] + row1[4 * x1 + c]);
+        }
+    }
+}
+
+#ifdef MIPMAP_HAS_SSE2
+// Um texel de destino (4 floats) por iteração; processa os 'simdEnd' primeiros texels.
+inline int mipHalveRowSSE2(const float* row0, const float* row1, float* out, int simdEnd) {
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    for (int x = 0; x < simdEnd; x++) {
+        __m128 top = _mm_add_ps(_mm_loadu_ps(row0 + 8 * x), _mm_loadu_ps(row0 + 8 * x + 4));
+        __m128 bottom = _mm_add_ps(_mm_loadu_ps(row1 + 8 * x), _mm_loadu_ps(row1 + 8 * x + 4));
+        _mm_storeu_ps(out + 4 * x, _mm_mul_ps(_mm_add_ps(top, bottom), quarter));
+    }
+    return simdEnd;
+}
+#endif
+
+#ifdef MIPMAP_HAS_AVX2
+// Dois texels de destino (8 floats) por iteração; o resto fica para a versão SSE2.
+MIPMAP_TARGET_AVX2 inline int mipHalveRowAVX2(const float* row0, const float* row1, float* out, int simdEnd) {
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    int x = 0;
+    for (; x + 2 <= simdEnd; x += 2) {
+        // 'a' e 'b' guardam os texels de origem [p0 p1] e [p2 p3] das duas linhas somadas.
+        __m256 a = _mm256_add_ps(_mm256_loadu_ps(row0 + 8 * x), _mm256_loadu_ps(row1 + 8 * x));
+        __m256 b = _mm256_add_ps(_mm256_loadu_ps(row0 + 8 * x + 8), _mm256_loadu_ps(row1 + 8 * x + 8));
+        __m256 even = _mm256_permute2f128_ps(a, b, 0x20); // [p0 p2]
+        __m256 odd = _mm256_permute2f128_ps(a, b, 0x31);  // [p1 p3]
+        _mm256_storeu_ps(out + 4 * x, _mm256_mul_ps(_mm256_add_ps(even, odd), quarter));
+    }
+    return x;
+}
+#endif
+
+// Primeiro nível: lê o RGBA8 sRGB do nível 0 diretamente, sem guardar uma cópia linear dele.
+inline void mipHalveSrgbRowScalar(const unsigned char* row0, const unsigned char* row1, float* out,
+                                  int begin, int end, int srcWidth) {
+    const float* toLinear = srgbToLinearTable();
+    for (int x = begin; x < end; x++) {
+        int x0 = std::min(2 * x, srcWidth - 1), x1 = std::min(2 * x + 1, srcWidth - 1);
+        float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        mipAccumulateSrgb(row0 + 4 * x0, toLinear, sum);
+        mipAccumulateSrgb(row0 + 4 * x1, toLinear, sum);
+        mipAccumulateSrgb(row1 + 4 * x0, toLinear, sum);
+        mipAccumulateSrgb(row1 + 4 * x1, toLinear, sum);
+        for (int c = 0; c < 4; c++) out[4 * x + c] = 0.25f * sum[c];
+    }
+}
+
+#ifdef MIPMAP_HAS_AVX2
+// Converte dois texels RGBA8 sRGB (8 bytes) para float linear pré-multiplicado. A tabela sRGB é
+// consultada com gather; o canal alfa é apenas normalizado.
+MIPMAP_TARGET_AVX2 inline __m256 mipLoadSrgbAVX2(const unsigned char* texels, const float* toLinear) {
+    __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)texels));
+    __m256 color = _mm256_i32gather_ps(toLinear, bytes, 4);
+    __m256 alpha = _mm256_mul_ps(_mm256_cvtepi32_ps(bytes), _mm256_set1_ps(1.0f / 255.0f));
+    alpha = _mm256_permute_ps(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm256_blend_ps(_mm256_mul_ps(color, alpha), alpha, 0x88);
+}
+
+// Dois texels de destino por iteração, como mipHalveRowAVX2, mas lendo o nível 0 em RGBA8.
+MIPMAP_TARGET_AVX2 inline int mipHalveSrgbRowAVX2(const unsigned char* row0, const unsigned char* row1, float* out,
+                                                  int simdEnd) {
+    const float* toLinear = srgbToLinearTable();
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    int x = 0;
+    for (; x + 2 <= simdEnd; x += 2) {
+        __m256 a = _mm256_add_ps(mipLoadSrgbAVX2(row0 + 8 * x, toLinear), mipLoadSrgbAVX2(row1 + 8 * x, toLinear));
+        __m256 b = _mm256_add_ps(mipLoadSrgbAVX2(row0 + 8 * x + 8, toLinear),
+                                 mipLoadSrgbAVX2(row1 + 8 * x + 8, toLinear));
+        __m256 even = _mm256_permute2f128_ps(a, b, 0x20);
+        __m256 odd = _mm256_permute2f128_ps(a, b, 0x31);
+        _mm256_storeu_ps(out + 4 * x, _mm256_mul_ps(_mm256_add_ps(even, odd), quarter));
+    }
+    return x;
+}
+#endif
+
+// Conjunto de instruções mais rápido disponível nesta CPU.
+inline MipmapKernel detectMipmapKernel() {
+#ifdef MIPMAP_HAS_AVX2
+    if (__builtin_cpu_supports("avx2")) return MipmapKernel::AVX2;
+#endif
+#ifdef MIPMAP_HAS_SSE2
+    return MipmapKernel::SSE2;
+#else
+    return MipmapKernel::Scalar;
+#endif
+}
+
+// Reduz um nível à metade. 'srgb' aponta para o nível 0 em RGBA8 (primeira redução) ou é nulo,
+// caso em que 'src' é um nível linear em float. As linhas de destino são divididas entre as
+// threads do pool.
+inline void mipHalve(const unsigned char* srgb, const float* src, int srcWidth, int srcHeight,
+                     float* dst, int dstWidth, int dstHeight, MipmapKernel kernel) {
+    // Texels de destino cujos dois texels de origem existem na mesma linha.
+    int simdEnd = std::min(dstWidth, srcWidth / 2);
+    workerPool().parallelFor((size_t)dstHeight, 16, [=](size_t rowBegin, size_t rowEnd) {
+        for (size_t y = rowBegin; y < rowEnd; y++) {
+            size_t offset0 = (size_t)std::min(2 * (int)y, srcHeight - 1) * srcWidth * 4;
+            size_t offset1 = (size_t)std::min(2 * (int)y + 1, srcHeight - 1) * srcWidth * 4;
+            float* out = dst + y * dstWidth * 4;
+            int x = 0;
+            if (srgb) {
+#ifdef MIPMAP_HAS_AVX2
+                if (kernel == MipmapKernel::AVX2) x = mipHalveSrgbRowAVX2(srgb + offset0, srgb + offset1, out, simdEnd);
+#endif
+                mipHalveSrgbRowScalar(srgb + offset0, srgb + offset1, out, x, dstWidth, srcWidth);
+                continue;
+            }
+            const float* row0 = src + offset0;
+            const float* row1 = src + offset1;
+#ifdef MIPMAP_HAS_AVX2
+            if (kernel == MipmapKernel::AVX2) x = mipHalveRowAVX2(row0, row1, out, simdEnd);
+#endif
+#ifdef MIPMAP_HAS_SSE2
+            if (kernel != MipmapKernel::Scalar) {
+                x += mipHalveRowSSE2(row0 + 8 * x, row1 + 8 * x, out + 4 * x, simdEnd - x);
+            }
+#endif
+            mipHalveRowScalar(row0, row1, out, x, dstWidth, srcWidth);
+        }
+    });
+}
+
+// Gera a cadeia de mipmaps completa (do nível 0 até 1x1) de uma imagem RGBA8 em sRGB.
+// O nível 0 é a própria entrada.
+inline std::vector<MipLevel> generateMipChain(MipLevel base, MipmapKernel kernel = detectMipmapKernel()) {
+    std::vector<MipLevel> levels;
+    levels.push_back(std::move(base));
+
+    // Buffers lineares sem inicialização: cada nível é inteiramente escrito antes de ser lido.
+    int width = levels[0].width, height = levels[0].height;
+    size_t capacity = (size_t)std::max(width / 2, 1) * std::max(height / 2, 1) * 4;
+    std::unique_ptr<float[]> current(new float[capacity]), next(new float[capacity]);
+
+    while (width > 1 || height > 1) {
+        int nextWidth = std::max(width / 2, 1), nextHeight = std::max(height / 2, 1);
+        const unsigned char* srgb = levels.size() == 1 ? levels[0].pixels.data() : nullptr;
+        mipHalve(srgb, current.get(), width, height, next.get(), nextWidth, nextHeight, kernel);
+
+        MipLevel level = {nextWidth, nextHeight, std::vector<unsigned char>((size_t)nextWidth * nextHeight * 4)};
+        const float* linear = next.get();
+        unsigned char* out = level.pixels.data();
+        workerPool().parallelFor((size_t)nextWidth * nextHeight, 1 << 15, [=](size_t begin, size_t end) {
+#ifdef MIPMAP_HAS_SSE2
+            if (kernel != MipmapKernel::Scalar) {
+                mipToSrgbSSE2(linear, out, begin, end);
+                return;
+            }
+#endif
+            mipToSrgbScalar(linear, out, begin, end);
+        });
+        levels.push_back(std::move(level));
+
+        current.swap(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+    return levels;
+}
@@ -0,0 +1,1079 @@
+/*
+ * =================================================================================================
+ * N-CORPOS GRAVITACIONAL
+ *
+ * Corpos com massa, posição e velocidade em SoA (NBodySystem), em unidades astronômicas: UA,
+ * dias e massas solares. As acelerações vêm de uma árvore de Barnes-Hut (octree construída em
+ * paralelo a cada passo, a partir das partículas ordenadas pela curva de Morton) ou da soma
+ * direta de todos os pares, mais rápida até alguns milhares de corpos. As duas usam o núcleo
+ * vetorizado de gravity.h. A integração é o leapfrog simplético KDK, o Bulirsch-Stoer adaptativo
+ * ou o leapfrog com passos individuais em blocos de potências de dois.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "gravity.h"
+#include "thread_pool.h"
+
+// Constante gravitacional de Gauss ao quadrado: G em UA^3 / (massa solar * dia^2).
+const double GAUSS_GRAVITY = 2.9591220828559115e-4;
+
+struct NBodySystem {
+    std::vector<double> x, y, z;    // Posição, em UA.
+    std::vector<double> vx, vy, vz; // Velocidade, em UA por dia.
+    std::vector<double> ax, ay, az; // Aceleração no estado atual, preenchida pelo cálculo de forças.
+    std::vector<double> mu;         // Parâmetro gravitacional G * massa.
+    double time = 0.0;              // Dias desde a época.
+    double softening = 0.0;         // Comprimento de amortecimento de Plummer, em UA.
+
+    size_t size() const { return mu.size(); }
+
+    void reserve(size_t count) {
+        for (auto* values : {&x, &y, &z, &vx, &vy, &vz, &ax, &ay, &az, &mu}) values->reserve(count);
+    }
+
+    // Acrescenta um corpo de massa 'mass' (em massas solares).
+    void add(const double position[3], const double velocity[3], double mass) {
+        x.push_back(position[0]);
+        y.push_back(position[1]);
+        z.push_back(position[2]);
+        vx.push_back(velocity[0]);
+        vy.push_back(velocity[1]);
+        vz.push_back(velocity[2]);
+        for (auto* values : {&ax, &ay, &az}) values->push_back(0.0);
+        mu.push_back(GAUSS_GRAVITY * mass);
+    }
+
+    // Leva o centro de massa para a origem, parado.
+    void moveToBarycenter() {
+        double total = 0.0, center[6] = {};
+        for (size_t i = 0; i < size(); i++) {
+            total += mu[i];
+            const double values[6] = {x[i], y[i], z[i], vx[i], vy[i], vz[i]};
+            for (int k = 0; k < 6; k++) center[k] += mu[i] * values[k];
+        }
+        if (total <= 0.0) return;
+        for (size_t i = 0; i < size(); i++) {
+            x[i] -= center[0] / total;
+            y[i] -= center[1] / total;
+            z[i] -= center[2] / total;
+            vx[i] -= center[3] / total;
+            vy[i] -= center[4] / total;
+            vz[i] -= center[5] / total;
+        }
+    }
+};
+
+// Preenche as acelerações de todos os corpos do sistema.
+using ForceSolver = std::function<void(NBodySystem&)>;
+// Preenche só as acelerações dos corpos em 'targets' (índices distintos), com as posições de todos.
+using PartialForceSolver = std::function<void(NBodySystem&, const std::vector<uint32_t>& targets)>;
+
+// Posição e velocidade na eclíptica (UA, UA/dia) de uma órbita com semieixo 'a' em UA,
+// excentricidade 'e' e ângulos em graus, em torno de um corpo central com parâmetro 'mu'.
+inline void stateFromElements(double a, double e, double inclination, double ascendingNode, double argPeriapsis,
+                              double meanAnomaly, double mu, double position[3], double velocity[3]) {
+    const double toRadians = M_PI / 180.0;
+    double M = std::remainder(meanAnomaly * toRadians, 2.0 * M_PI);
+    double E = M + std::copysign(0.85 * e, M);
+    for (int iteration = 0; iteration < 50; iteration++) {
+        double step = (E - e * std::sin(E) - M) / (1.0 - e * std::cos(E));
+        E -= step;
+        if (std::fabs(step) < 1e-15) break;
+    }
+    double b = a * std::sqrt(1.0 - e * e);
+    double rate = std::sqrt(mu / (a * a * a)) / (1.0 - e * std::cos(E)); // dE/dt.
+    // Posição e velocidade no plano da órbita (x para o periastro).
+    double planar[2] = {a * (std::cos(E) - e), b * std::sin(E)};
+    double planarVelocity[2] = {-a * std::sin(E) * rate, b * std::cos(E) * rate};
+    double i = inclination * toRadians, node = ascendingNode * toRadians, w = argPeriapsis * toRadians;
+    double p[3] = {std::cos(node) * std::cos(w) - std::sin(node) * std::sin(w) * std::cos(i),
+                   std::sin(node) * std::cos(w) + std::cos(node) * std::sin(w) * std::cos(i),
+                   std::sin(w) * std::sin(i)};
+    double q[3] = {-std::cos(node) * std::sin(w) - std::sin(node) * std::cos(w) * std::cos(i),
+                   -std::sin(node) * std::sin(w) + std::cos(node) * std::cos(w) * std::cos(i),
+                   std::cos(w) * std::sin(i)};
+    for (int k = 0; k < 3; k++) {
+        position[k] = p[k] * planar[0] + q[k] * planar[1];
+        velocity[k] = p[k] * planarVelocity[0] + q[k] * planarVelocity[1];
+    }
+}
+
+// --- Soma direta ---
+
+// Acelerações dos alvos [begin, end) somando a atração de todos os corpos, sem vetorização.
+// O(n) por alvo; serve de referência para os outros cálculos.
+inline void directAccelerations(NBodySystem& system, size_t begin, size_t end) {
+    double eps2 = system.softening * system.softening;
+    size_t n = system.size();
+    for (size_t i = begin; i < end; i++) {
+        double ax = 0.0, ay = 0.0, az = 0.0;
+        for (size_t j = 0; j < n; j++) {
+            if (j == i) continue;
+            double dx = system.x[j] - system.x[i], dy = system.y[j] - system.y[i], dz = system.z[j] - system.z[i];
+            double d2 = dx * dx + dy * dy + dz * dz + eps2;
+            double scale = system.mu[j] / (d2 * std::sqrt(d2));
+            ax += dx * scale;
+            ay += dy * scale;
+            az += dz * scale;
+        }
+        system.ax[i] = ax;
+        system.ay[i] = ay;
+        system.az[i] = az;
+    }
+}
+
+const size_t DIRECT_TARGET_TILE = 256;  // Alvos por tarefa da soma direta.
+const size_t DIRECT_SOURCE_TILE = 1024; // Fontes por bloco: 32 KB de posições e massas, no cache L1/L2.
+
+// Soma direta de todos os pares, em blocos de alvos divididos entre as threads de trabalho.
+// Cada bloco de alvos percorre as fontes em blocos que cabem no cache; as acelerações de um
+// alvo só são escritas pela tarefa dele. O(n^2).
+inline void directForces(NBodySystem& system, SimdKernel kernel = detectSimdKernel()) {
+    double eps2 = system.softening * system.softening;
+    size_t n = system.size();
+    workerPool().parallelFor(n, DIRECT_TARGET_TILE, [&](size_t begin, size_t end) {
+        std::fill(system.ax.begin() + begin, system.ax.begin() + end, 0.0);
+        std::fill(system.ay.begin() + begin, system.ay.begin() + end, 0.0);
+        std::fill(system.az.begin() + begin, system.az.begin() + end, 0.0);
+        for (size_t tile = begin; tile < end; tile += DIRECT_TARGET_TILE) {
+            size_t targets = std::min(end - tile, DIRECT_TARGET_TILE);
+            for (size_t first = 0; first < n; first += DIRECT_SOURCE_TILE) {
+                GravitySources sources = {&system.x[first], &system.y[first], &system.z[first], &system.mu[first],
+                                          std::min(n - first, DIRECT_SOURCE_TILE)};
+                gravityTile(&system.x[tile], &system.y[tile], &system.z[tile], targets, sources, eps2,
+                            &system.ax[tile], &system.ay[tile], &system.az[tile], kernel);
+            }
+        }
+    });
+}
+
+// Soma direta só para os alvos em 'targets', com todos os corpos como fontes. Os alvos são
+// copiados em blocos contíguos para o núcleo vetorizado. O(alvos * n).
+inline void directForces(NBodySystem& system, const std::vector<uint32_t>& targets,
+                         SimdKernel kernel = detectSimdKernel()) {
+    double eps2 = system.softening * system.softening;
+    size_t n = system.size();
+    workerPool().parallelFor(targets.size(), DIRECT_TARGET_TILE, [&](size_t begin, size_t end) {
+        double tx[DIRECT_TARGET_TILE], ty[DIRECT_TARGET_TILE], tz[DIRECT_TARGET_TILE];
+        double ax[DIRECT_TARGET_TILE], ay[DIRECT_TARGET_TILE], az[DIRECT_TARGET_TILE];
+        for (size_t tile = begin; tile < end; tile += DIRECT_TARGET_TILE) {
+            size_t count = std::min(end - tile, DIRECT_TARGET_TILE);
+            for (size_t i = 0; i < count; i++) {
+                uint32_t target = targets[tile + i];
+                tx[i] = system.x[target];
+                ty[i] = system.y[target];
+                tz[i] = system.z[target];
+                ax[i] = ay[i] = az[i] = 0.0;
+            }
+            for (size_t first = 0; first < n; first += DIRECT_SOURCE_TILE) {
+                GravitySources sources = {&system.x[first], &system.y[first], &system.z[first], &system.mu[first],
+                                          std::min(n - first, DIRECT_SOURCE_TILE)};
+                gravityTile(tx, ty, tz, count, sources, eps2, ax, ay, az, kernel);
+            }
+            for (size_t i = 0; i < count; i++) {
+                uint32_t target = targets[tile + i];
+                system.ax[target] = ax[i];
+                system.ay[target] = ay[i];
+                system.az[target] = az[i];
+            }
+        }
+    });
+}
+
+// --- Árvore de Barnes-Hut ---
+
+class BarnesHutTree {
+public:
+    // 'theta' é o ângulo de abertura: um nó é aproximado pelo seu centro de massa quando seu
+    // lado, visto do alvo, é menor que theta radianos. Menor é mais preciso e mais lento.
+    explicit BarnesHutTree(double theta = 0.5) : theta(theta) {}
+
+    void setOpeningAngle(double value) { theta = value; }
+    double openingAngle() const { return theta; }
+    size_t nodeCount() const { return nodes.size(); }
+    // Interações partícula-partícula e partícula-nó do último accelerations().
+    uint64_t interactionCount() const { return interactions; }
+
+    // Constrói a árvore com as posições atuais do sistema.
+    void build(const NBodySystem& system) {
+        size_t n = system.size();
+        nodes.clear();
+        if (n == 0) return;
+        sortByMortonKey(system);
+        sx.resize(n);
+        sy.resize(n);
+        sz.resize(n);
+        smu.resize(n);
+        workerPool().parallelFor(n, 16384, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                uint32_t source = order[i];
+                sx[i] = system.x[source];
+                sy[i] = system.y[source];
+                sz[i] = system.z[source];
+                smu[i] = system.mu[source];
+            }
+        });
+
+        // Os níveis de cima são montados aqui; cada nó em PARALLEL_DEPTH vira uma tarefa
+        // que monta sua subárvore separadamente, depois encaixada no vetor principal.
+        std::vector<Subtree> tasks;
+        nodes.emplace_back();
+        fillNode(nodes, 0, 0, (uint32_t)n, 0, rootCenter, rootHalf, &tasks);
+        size_t topCount = nodes.size();
+        std::vector<std::vector<Node>> subtrees(tasks.size());
+        workerPool().parallelFor(tasks.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                const Subtree& task = tasks[t];
+                subtrees[t].emplace_back();
+                fillNode(subtrees[t], 0, task.begin, task.end, task.level, task.center, task.half, nullptr);
+            }
+        });
+        for (size_t t = 0; t < tasks.size(); t++) {
+            std::vector<Node>& local = subtrees[t];
+            uint32_t offset = (uint32_t)nodes.size() - 1;
+            for (Node& node : local) {
+                if (node.childCount) node.firstChild += offset;
+            }
+            nodes[tasks[t].index] = local[0];
+            nodes.insert(nodes.end(), local.begin() + 1, local.end());
+        }
+        // Filhos sempre ficam depois do pai, então os momentos dos níveis de cima podem ser
+        // calculados de trás para frente.
+        for (size_t index = topCount; index-- > 0;) {
+            if (nodes[index].childCount) computeMoments(nodes, (uint32_t)index);
+        }
+        leaves.clear();
+        for (size_t index = 0; index < nodes.size(); index++) {
+            if (!nodes[index].childCount) leaves.push_back((uint32_t)index);
+        }
+    }
+
+    // Acelerações de todos os corpos, a partir da árvore montada por build() com as mesmas
+    // posições. A árvore é percorrida uma vez por folha, não por partícula: os nós aceitos para
+    // a folha inteira formam uma lista de interações, somada depois para cada partícula dela.
+    // Com 'targets', só as folhas que contêm algum desses corpos são percorridas, e só as
+    // acelerações deles são escritas.
+    void accelerations(NBodySystem& system, SimdKernel kernel = detectSimdKernel(),
+                       const std::vector<uint32_t>* targets = nullptr) {
+        std::atomic<uint64_t> total{0};
+        double eps2 = system.softening * system.softening;
+        if (targets) {
+            active.assign(system.size(), 0);
+            for (uint32_t target : *targets) active[target] = 1;
+        }
+        workerPool().parallelFor(leaves.size(), 16, [&](size_t begin, size_t end) {
+            uint64_t count = 0;
+            InteractionList list;
+            std::vector<uint32_t> stack;
+            std::vector<double> ax, ay, az;
+            for (size_t leaf = begin; leaf < end; leaf++) {
+                const Node& node = nodes[leaves[leaf]];
+                if (targets && std::none_of(order.begin() + node.begin, order.begin() + node.end,
+                                            [&](uint32_t body) { return active[body]; })) {
+                    continue;
+                }
+                gatherInteractions(node, list, stack);
+                // As partículas da folha são contíguas na ordem de Morton: são os alvos do bloco.
+                // Uma folha no nível máximo pode ter mais que LEAF_SIZE partículas.
+                ax.assign(node.end - node.begin, 0.0);
+                ay.assign(node.end - node.begin, 0.0);
+                az.assign(node.end - node.begin, 0.0);
+                GravitySources sources = {list.x.data(), list.y.data(), list.z.data(), list.mu.data(), list.mu.size()};
+                gravityTile(&sx[node.begin], &sy[node.begin], &sz[node.begin], node.end - node.begin, sources, eps2,
+                            ax.data(), ay.data(), az.data(), kernel);
+                for (uint32_t i = node.begin; i < node.end; i++) {
+                    uint32_t target = order[i];
+                    if (targets && !active[target]) continue;
+                    system.ax[target] = ax[i - node.begin];
+                    system.ay[target] = ay[i - node.begin];
+                    system.az[target] = az[i - node.begin];
+                }
+                count += (uint64_t)list.mu.size() * (node.end - node.begin);
+            }
+            total += count;
+        });
+        interactions = total;
+    }
+
+    // Monta a árvore e calcula as acelerações; pode ser usada como ForceSolver.
+    void operator()(NBodySystem& system) {
+        build(system);
+        accelerations(system);
+    }
+
+    // Monta a árvore e calcula só as acelerações de 'targets'; pode ser usada como PartialForceSolver.
+    void operator()(NBodySystem& system, const std::vector<uint32_t>& targets) {
+        build(system);
+        accelerations(system, detectSimdKernel(), &targets);
+    }
+
+private:
+    static const int MAX_LEVEL = 21;     // Bits por eixo da chave de Morton.
+    static const uint32_t LEAF_SIZE = 64; // Partículas por folha (e por lista de interações).
+    static const int PARALLEL_DEPTH = 2; // Nível em que a montagem é dividida em tarefas.
+    static const int RADIX_BITS = 11;    // Bits do dígito do radix sort das chaves.
+    static const size_t RADIX_BUCKETS = size_t(1) << RADIX_BITS;
+    static const size_t RADIX_GRAIN = 65536; // Partículas por bloco de cada passada do radix sort.
+
+    struct Node {
+        double cx, cy, cz, mu;  // Centro de massa e massa total (G * m).
+        double openRadius;      // Distância abaixo da qual o nó é aberto: lado / theta + delta.
+        uint32_t begin, end;    // Partículas do nó, na ordem de Morton.
+        uint32_t firstChild;    // Filhos são contíguos; childCount == 0 em folhas.
+        uint32_t childCount;
+        double center[3], half; // Cubo do nó.
+        double boxCenter[3], boxHalf[3]; // Caixa justa das partículas (usada nas folhas).
+    };
+
+    struct Subtree {
+        uint32_t index, begin, end;
+        int level;
+        double center[3], half;
+    };
+
+    double theta;
+    uint64_t interactions = 0;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;        // order[i]: corpo original da i-ésima partícula ordenada.
+    std::vector<double> sx, sy, sz, smu; // Partículas na ordem de Morton.
+    std::vector<Node> nodes;
+    std::vector<uint32_t> leaves;
+    std::vector<uint8_t> active;        // Corpos pedidos na última chamada parcial de accelerations().
+    double rootCenter[3] = {}, rootHalf = 0.0;
+
+    // Intercala os 21 bits baixos de v com dois zeros entre cada bit.
+    static uint64_t spreadBits(uint64_t v) {
+        v &= 0x1fffff;
+        v = (v | v << 32) & 0x1f00000000ffffULL;
+        v = (v | v << 16) & 0x1f0000ff0000ffULL;
+        v = (v | v << 8) & 0x100f00f00f00f00fULL;
+        v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+        v = (v | v << 2) & 0x1249249249249249ULL;
+        return v;
+    }
+
+    // Calcula o cubo que envolve todas as partículas e as ordena pela chave de Morton.
+    void sortByMortonKey(const NBodySystem& system) {
+        size_t n = system.size();
+        const size_t grain = 16384;
+        size_t chunks = (n + grain - 1) / grain;
+        std::vector<double> bounds(chunks * 6);
+        workerPool().parallelFor(n, grain, [&](size_t begin, size_t end) {
+            double* b = &bounds[begin / grain * 6];
+            b[0] = b[1] = b[2] = INFINITY;
+            b[3] = b[4] = b[5] = -INFINITY;
+            for (size_t i = begin; i < end; i++) {
+                const double p[3] = {system.x[i], system.y[i], system.z[i]};
+                for (int k = 0; k < 3; k++) {
+                    b[k] = std::min(b[k], p[k]);
+                    b[3 + k] = std::max(b[3 + k], p[k]);
+                }
+            }
+        });
+        double low[3] = {INFINITY, INFINITY, INFINITY}, high[3] = {-INFINITY, -INFINITY, -INFINITY};
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            for (int k = 0; k < 3; k++) {
+                low[k] = std::min(low[k], bounds[chunk * 6 + k]);
+                high[k] = std::max(high[k], bounds[chunk * 6 + 3 + k]);
+            }
+        }
+        rootHalf = 0.0;
+        for (int k = 0; k < 3; k++) {
+            rootCenter[k] = 0.5 * (low[k] + high[k]);
+            rootHalf = std::max(rootHalf, 0.5 * (high[k] - low[k]));
+        }
+        rootHalf = rootHalf * (1.0 + 1e-9) + 1e-12; // Garante que as bordas caiam dentro do cubo.
+
+        keys.resize(n);
+        order.resize(n);
+        double scale = (1u << MAX_LEVEL) / (2.0 * rootHalf);
+        workerPool().parallelFor(n, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const double p[3] = {system.x[i], system.y[i], system.z[i]};
+                uint64_t cell[3];
+                for (int k = 0; k < 3; k++) {
+                    double c = (p[k] - (rootCenter[k] - rootHalf)) * scale;
+                    cell[k] = (uint64_t)std::min(std::max(c, 0.0), (double)((1u << MAX_LEVEL) - 1));
+                }
+                keys[i] = spreadBits(cell[0]) << 2 | spreadBits(cell[1]) << 1 | spreadBits(cell[2]);
+                order[i] = (uint32_t)i;
+            }
+        });
+
+        // Radix sort LSD de 63 bits em 6 passadas de RADIX_BITS bits. Em cada passada, os dígitos
+        // de cada bloco de RADIX_GRAIN partículas são contados em paralelo, as contagens são
+        // acumuladas na ordem (dígito, bloco) e cada bloco é espalhado a partir das suas posições,
+        // também em paralelo. A ordenação continua estável e não depende do número de threads.
+        size_t blocks = (n + RADIX_GRAIN - 1) / RADIX_GRAIN;
+        std::vector<uint64_t> keyBuffer(n);
+        std::vector<uint32_t> orderBuffer(n);
+        std::vector<uint32_t> histograms(blocks * RADIX_BUCKETS);
+        for (int shift = 0; shift < 3 * MAX_LEVEL; shift += RADIX_BITS) {
+            workerPool().parallelFor(n, RADIX_GRAIN, [&](size_t begin, size_t end) {
+                uint32_t* histogram = &histograms[begin / RADIX_GRAIN * RADIX_BUCKETS];
+                std::fill(histogram, histogram + RADIX_BUCKETS, 0);
+                for (size_t i = begin; i < end; i++) histogram[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            });
+            uint32_t sum = 0;
+            for (size_t digit = 0; digit < RADIX_BUCKETS; digit++) {
+                for (size_t block = 0; block < blocks; block++) {
+                    uint32_t& count = histograms[block * RADIX_BUCKETS + digit];
+                    uint32_t value = count;
+                    count = sum;
+                    sum += value;
+                }
+            }
+            workerPool().parallelFor(n, RADIX_GRAIN, [&](size_t begin, size_t end) {
+                uint32_t* histogram = &histograms[begin / RADIX_GRAIN * RADIX_BUCKETS];
+                for (size_t i = begin; i < end; i++) {
+                    uint32_t slot = histogram[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                    keyBuffer[slot] = keys[i];
+                    orderBuffer[slot] = order[i];
+                }
+            });
+            keys.swap(keyBuffer);
+            order.swap(orderBuffer);
+        }
+    }
+
+    // Octante de uma chave no nível 'level' (0 é a raiz).
+    static uint32_t octant(uint64_t key, int level) { return (uint32_t)(key >> (3 * (MAX_LEVEL - 1 - level))) & 7; }
+
+    // Preenche out[index] com o nó das partículas [begin, end) e monta seus filhos. Com 'tasks',
+    // os nós no nível PARALLEL_DEPTH são deixados para depois em vez de montados.
+    void fillNode(std::vector<Node>& out, uint32_t index, uint32_t begin, uint32_t end, int level,
+                  const double center[3], double half, std::vector<Subtree>* tasks) {
+        Node node = {};
+        node.begin = begin;
+        node.end = end;
+        for (int k = 0; k < 3; k++) node.center[k] = center[k];
+        node.half = half;
+        out[index] = node;
+        if (end - begin <= LEAF_SIZE || level >= MAX_LEVEL) {
+            computeMoments(out, index);
+            return;
+        }
+        if (tasks && level == PARALLEL_DEPTH) {
+            tasks->push_back({index, begin, end, level, {center[0], center[1], center[2]}, half});
+            return;
+        }
+
+        // As partículas estão ordenadas pela chave, então cada octante é um intervalo contíguo.
+        uint32_t bounds[9];
+        bounds[0] = begin;
+        for (uint32_t child = 0; child < 8; child++) {
+            uint32_t first = bounds[child];
+            uint32_t last = end;
+            while (first < last) { // Primeira partícula de um octante maior que 'child'.
+                uint32_t middle = first + (last - first) / 2;
+                if (octant(keys[middle], level) <= child) first = middle + 1;
+                else last = middle;
+            }
+            bounds[child + 1] = first;
+        }
+        uint32_t firstChild = (uint32_t)out.size(), childCount = 0;
+        for (uint32_t child = 0; child < 8; child++) childCount += bounds[child + 1] > bounds[child];
+        out.resize(out.size() + childCount);
+        out[index].firstChild = firstChild;
+        out[index].childCount = childCount;
+        uint32_t slot = firstChild;
+        for (uint32_t child = 0; child < 8; child++) {
+            if (bounds[child + 1] == bounds[child]) continue;
+            double childHalf = half * 0.5;
+            // Os bits do octante são (x, y, z), do mais para o menos significativo.
+            double childCenter[3] = {center[0] + ((child & 4) ? childHalf : -childHalf),
+                                     center[1] + ((child & 2) ? childHalf : -childHalf),
+                                     center[2] + ((child & 1) ? childHalf : -childHalf)};
+            fillNode(out, slot++, bounds[child], bounds[child + 1], level + 1, childCenter, childHalf, tasks);
+        }
+        if (!tasks || level >= PARALLEL_DEPTH) computeMoments(out, index);
+    }
+
+    // Massa, centro de massa e raio de abertura de um nó, a partir dos filhos ou das partículas.
+    void computeMoments(std::vector<Node>& out, uint32_t index) const {
+        Node& node = out[index];
+        double mu = 0.0, cx = 0.0, cy = 0.0, cz = 0.0;
+        if (node.childCount) {
+            for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; child++) {
+                const Node& c = out[child];
+                mu += c.mu;
+                cx += c.mu * c.cx;
+                cy += c.mu * c.cy;
+                cz += c.mu * c.cz;
+            }
+        } else {
+            double low[3] = {INFINITY, INFINITY, INFINITY}, high[3] = {-INFINITY, -INFINITY, -INFINITY};
+            for (uint32_t i = node.begin; i < node.end; i++) {
+                mu += smu[i];
+                cx += smu[i] * sx[i];
+                cy += smu[i] * sy[i];
+                cz += smu[i] * sz[i];
+                const double p[3] = {sx[i], sy[i], sz[i]};
+                for (int k = 0; k < 3; k++) {
+                    low[k] = std::min(low[k], p[k]);
+                    high[k] = std::max(high[k], p[k]);
+                }
+            }
+            for (int k = 0; k < 3; k++) {
+                node.boxCenter[k] = 0.5 * (low[k] + high[k]);
+                node.boxHalf[k] = 0.5 * (high[k] - low[k]);
+            }
+        }
+        if (mu > 0.0) {
+            node.cx = cx / mu;
+            node.cy = cy / mu;
+            node.cz = cz / mu;
+        } else {
+            node.cx = node.center[0];
+            node.cy = node.center[1];
+            node.cz = node.center[2];
+        }
+        node.mu = mu;
+        // Critério de Barnes com a distância entre o centro de massa e o centro do cubo, que
+        // evita aceitar um nó grande cujo centro de massa está longe do alvo que ele contém.
+        double dx = node.cx - node.center[0], dy = node.cy - node.center[1], dz = node.cz - node.center[2];
+        node.openRadius = 2.0 * node.half / theta + std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    // Fontes que atraem as partículas de uma folha: centros de massa de nós distantes e as
+    // próprias partículas das folhas próximas (incluindo a folha alvo).
+    struct InteractionList {
+        std::vector<double> x, y, z, mu;
+
+        void clear() {
+            for (auto* values : {&x, &y, &z, &mu}) values->clear();
+        }
+        void add(double px, double py, double pz, double m) {
+            x.push_back(px);
+            y.push_back(py);
+            z.push_back(pz);
+            mu.push_back(m);
+        }
+    };
+
+    // Monta a lista de interações da folha 'target'. Um nó é aceito quando seu centro de massa
+    // está a mais que o raio de abertura de todos os pontos da caixa da folha.
+    void gatherInteractions(const Node& target, InteractionList& list, std::vector<uint32_t>& stack) const {
+        list.clear();
+        stack.clear();
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            double d2 = 0.0;
+            const double com[3] = {node.cx, node.cy, node.cz};
+            for (int k = 0; k < 3; k++) {
+                double gap = std::max(std::fabs(com[k] - target.boxCenter[k]) - target.boxHalf[k], 0.0);
+                d2 += gap * gap;
+            }
+            if (d2 >= node.openRadius * node.openRadius) {
+                list.add(node.cx, node.cy, node.cz, node.mu);
+            } else if (node.childCount) {
+                for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; child++) {
+                    stack.push_back(child);
+                }
+            } else {
+                for (uint32_t j = node.begin; j < node.end; j++) list.add(sx[j], sy[j], sz[j], smu[j]);
+            }
+        }
+    }
+};
+
+// --- Integração ---
+
+// Um passo do leapfrog KDK (meio impulso, deriva, novas forças, meio impulso). As acelerações
+// do sistema precisam corresponder às posições atuais antes do primeiro passo; cada passo
+// deixa as do fim do passo, então cada passo custa um cálculo de forças.
+inline void leapfrogStep(NBodySystem& system, double dt, const ForceSolver& forces) {
+    size_t n = system.size();
+    auto kick = [&](double h) {
+        workerPool().parallelFor(n, 16384, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                system.vx[i] += system.ax[i] * h;
+                system.vy[i] += system.ay[i] * h;
+                system.vz[i] += system.az[i] * h;
+            }
+        });
+    };
+    kick(0.5 * dt);
+    workerPool().parallelFor(n, 16384, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            system.x[i] += system.vx[i] * dt;
+            system.y[i] += system.vy[i] * dt;
+            system.z[i] += system.vz[i] * dt;
+        }
+    });
+    forces(system);
+    kick(0.5 * dt);
+    system.time += dt;
+}
+
+// Integrador de Bulirsch-Stoer com passo e ordem adaptativos, para encontros próximos em que um
+// passo fixo ou desperdiça avaliações de força ou perde a precisão. Cada passo H é refeito com
+// 2, 4, 6, ... subpassos pela regra de Störmer (o ponto médio de Gragg para equações de segunda
+// ordem), e os resultados são extrapolados para H / n -> 0 pelo esquema de Aitken-Neville em
+// h^2. A diferença entre as duas últimas extrapolações estima o erro: o passo é aceito quando
+// ela fica abaixo da tolerância e rejeitado (e refeito com H menor) quando não fica. O passo e
+// a quantidade de colunas seguintes são escolhidos pelo menor custo por unidade de tempo, como
+// no ODEX de Hairer e Wanner. Pensado para poucos corpos: guarda várias cópias do estado.
+class BulirschStoer {
+public:
+    // Tolerâncias por componente do estado: absoluta (UA e UA por dia) e relativa.
+    BulirschStoer(double tolerance = 1e-12, double firstStep = 1.0)
+        : absoluteTolerance(tolerance), relativeTolerance(tolerance), step(firstStep) {}
+
+    uint64_t stepsTaken() const { return accepted; }
+    uint64_t stepsRejected() const { return rejected; }
+    uint64_t forceEvaluations() const { return evaluations; }
+    double nextStep() const { return step; }
+    // Estado que decide os passos seguintes (passo sugerido, coluna alvo e se o último passo foi
+    // rejeitado), para continuar de um estado salvo exatamente como da primeira vez.
+    static const size_t STATE_SIZE = 3;
+    void saveState(double* out) const {
+        out[0] = step;
+        out[1] = targetColumn;
+        out[2] = lastRejected;
+    }
+    void loadState(const double* in) {
+        step = in[0];
+        targetColumn = (int)in[1];
+        lastRejected = in[2] != 0.0;
+    }
+
+    // Avança o sistema até 'time' (dias), em no máximo 'maxSteps' passos aceitos. O último
+    // passo é encurtado para cair exatamente em 'time', sem mudar o passo sugerido para o
+    // seguinte. Retorna false se parou antes por causa do limite. As acelerações do sistema
+    // precisam corresponder às posições, como no leapfrog, e continuam correspondendo no fim.
+    bool advance(NBodySystem& system, double time, const ForceSolver& forces, uint64_t maxSteps = UINT64_MAX) {
+        for (uint64_t taken = 0; system.time < time; taken++) {
+            if (taken == maxSteps) return false;
+            double remaining = time - system.time;
+            if (step >= remaining) {
+                double suggested = step;
+                step = remaining;
+                bool last = attemptUntilAccepted(system, forces);
+                // O passo calculado depois de um passo encurtado fica limitado a 4 vezes ele; o
+                // sugerido antes é mantido se for maior.
+                step = last ? std::max(suggested, step) : std::min(suggested, step);
+                if (last) system.time = time; // Sem o resíduo de arredondamento da soma.
+                continue;
+            }
+            attemptUntilAccepted(system, forces);
+        }
+        return true;
+    }
+
+private:
+    static const int MAX_COLUMNS = 10; // Subpassos 2, 4, ..., 20.
+    static int substeps(int column) { return 2 * (column + 1); }
+
+    double absoluteTolerance, relativeTolerance;
+    double step;
+    int targetColumn = 4;
+    bool lastRejected = false;
+    uint64_t accepted = 0, rejected = 0, evaluations = 0;
+    std::vector<double> start, result;        // Estado (posições e velocidades) no início e no fim do passo.
+    std::vector<double> table[MAX_COLUMNS];   // Linha atual do quadro de extrapolação.
+    std::vector<double> positions, delta, startAcceleration;
+
+    // Refaz o passo atual até ele ser aceito. Retorna true se o passo aceito foi o pedido, sem
+    // ser encurtado por rejeições.
+    bool attemptUntilAccepted(NBodySystem& system, const ForceSolver& forces) {
+        bool shortened = false;
+        while (!attempt(system, forces)) shortened = true;
+        return !shortened;
+    }
+
+    static void gather(const NBodySystem& system, std::vector<double>& state) {
+        size_t n = system.size();
+        state.resize(6 * n);
+        const std::vector<double>* parts[6] = {&system.x, &system.y, &system.z, &system.vx, &system.vy, &system.vz};
+        for (int k = 0; k < 6; k++) std::copy(parts[k]->begin(), parts[k]->end(), state.begin() + k * n);
+    }
+
+    static void scatter(const std::vector<double>& state, NBodySystem& system, int partCount) {
+        size_t n = system.size();
+        std::vector<double>* parts[6] = {&system.x, &system.y, &system.z, &system.vx, &system.vy, &system.vz};
+        for (int k = 0; k < partCount; k++) {
+            std::copy(state.begin() + k * n, state.begin() + (k + 1) * n, parts[k]->begin());
+        }
+    }
+
+    // Regra de Störmer com 'count' subpassos de H / count a partir de 'start', guardada em 'out'.
+    void stoermer(NBodySystem& system, const ForceSolver& forces, int count, std::vector<double>& out) {
+        size_t n = system.size();
+        double h = step / count;
+        const double* acceleration[3] = {system.ax.data(), system.ay.data(), system.az.data()};
+        positions.assign(start.begin(), start.begin() + 3 * n);
+        delta.resize(3 * n);
+        for (size_t i = 0; i < 3 * n; i++) {
+            delta[i] = h * (start[3 * n + i] + 0.5 * h * startAcceleration[i]);
+            positions[i] += delta[i];
+        }
+        for (int k = 1; k <= count; k++) {
+            scatter(positions, system, 3);
+            forces(system);
+            evaluations++;
+            if (k == count) break;
+            for (size_t i = 0; i < 3 * n; i++) {
+                delta[i] += h * h * acceleration[i / n][i % n];
+                positions[i] += delta[i];
+            }
+        }
+        out.resize(6 * n);
+        for (size_t i = 0; i < 3 * n; i++) {
+            out[i] = positions[i];
+            out[3 * n + i] = delta[i] / h + 0.5 * h * acceleration[i / n][i % n];
+        }
+    }
+
+    // Uma tentativa de passo de tamanho 'step'. Se for aceita, o sistema avança e o próximo
+    // passo e a próxima ordem são escolhidos; se não, o sistema volta ao início e 'step' diminui.
+    bool attempt(NBodySystem& system, const ForceSolver& forces) {
+        size_t n = system.size();
+        gather(system, start);
+        startAcceleration.resize(3 * n);
+        std::copy(system.ax.begin(), system.ax.end(), startAcceleration.begin());
+        std::copy(system.ay.begin(), system.ay.end(), startAcceleration.begin() + n);
+        std::copy(system.az.begin(), system.az.end(), startAcceleration.begin() + 2 * n);
+
+        double optimalStep[MAX_COLUMNS] = {}, work[MAX_COLUMNS] = {};
+        double cost = 1.0; // Avaliações de força: a do fim do passo mais os subpassos.
+        int lastColumn = std::min(targetColumn + 1, MAX_COLUMNS - 1);
+        int column = 0;
+        double error = INFINITY, previousError = INFINITY;
+        for (; column <= lastColumn; column++) {
+            stoermer(system, forces, substeps(column), result);
+            cost += substeps(column);
+            // Aitken-Neville: table[j] guarda a linha anterior; result vira a diagonal nova.
+            double errorSum = 0.0;
+            for (int j = 0; j < column; j++) {
+                double ratio = (double)substeps(column) / substeps(column - j - 1);
+                double factor = 1.0 / (ratio * ratio - 1.0);
+                for (size_t i = 0; i < 6 * n; i++) {
+                    double correction = (result[i] - table[j][i]) * factor;
+                    table[j][i] = result[i];
+                    result[i] += correction;
+                    if (j == column - 1) {
+                        double scale = absoluteTolerance +
+                                       relativeTolerance * std::max(std::fabs(start[i]), std::fabs(result[i]));
+                        errorSum = std::max(errorSum, std::fabs(correction) / scale);
+                    }
+                }
+            }
+            table[column] = result;
+            if (column == 0) continue;
+            previousError = error;
+            error = std::isfinite(errorSum) ? errorSum : INFINITY;
+            // Passo que daria erro 0,4 nesta coluna (ordem 2 * column + 2), limitado a [H / 50, 4 H].
+            double factor = error > 0.0 ? 0.94 * std::pow(0.4 / error, 1.0 / (2 * column + 1)) : 4.0;
+            optimalStep[column] = step * std::min(std::max(factor, 0.02), 4.0);
+            work[column] = cost / optimalStep[column];
+            if (column < targetColumn - 1) continue;
+            if (error <= 1.0) break;
+            // Monitor de convergência: supondo que cada coluna a mais reduza o erro na mesma
+            // proporção que a última, se nem a última coluna prevista deve bastar, rejeita já. A
+            // estimativa da coluna 1 é grosseira demais para isso.
+            if (column >= 2 && error > std::pow(std::max(previousError / error, 1.0), lastColumn - column)) break;
+        }
+        column = std::min(column, lastColumn);
+
+        if (error > 1.0) {
+            rejected++;
+            lastRejected = true;
+            scatter(start, system, 6);
+            std::copy(startAcceleration.begin(), startAcceleration.begin() + n, system.ax.begin());
+            std::copy(startAcceleration.begin() + n, startAcceleration.begin() + 2 * n, system.ay.begin());
+            std::copy(startAcceleration.begin() + 2 * n, startAcceleration.end(), system.az.begin());
+            targetColumn = column >= 2 && work[column - 1] < 0.8 * work[column] ? column - 1 : column;
+            step = optimalStep[targetColumn];
+            return false;
+        }
+
+        // O resultado extrapolado é o novo estado; as acelerações são recalculadas nele.
+        accepted++;
+        scatter(result, system, 6);
+        forces(system);
+        evaluations++;
+        system.time += step;
+
+        // Próxima ordem: a de menor trabalho por unidade de tempo entre a atual e as vizinhas. Logo
+        // depois de uma rejeição a ordem não sobe.
+        bool afterRejection = lastRejected;
+        lastRejected = false;
+        if (column == 1) {
+            // A coluna 0 não tem estimativa de erro para comparar; a ordem sobe se puder.
+            targetColumn = afterRejection ? 1 : 2;
+            step = optimalStep[1] * (afterRejection ? 1.0 : (cost + substeps(2)) / cost);
+        } else if (work[column - 1] < 0.8 * work[column]) {
+            targetColumn = column - 1;
+            step = optimalStep[column - 1];
+        } else if (!afterRejection && column + 1 < MAX_COLUMNS && column >= targetColumn &&
+                   work[column] < 0.9 * work[column - 1]) {
+            targetColumn = column + 1;
+            step = optimalStep[column] * (cost + substeps(column + 1)) / cost;
+        } else {
+            targetColumn = column;
+            step = optimalStep[column];
+        }
+        return true;
+    }
+};
+
+// Passos individuais em blocos hierárquicos: cada corpo usa o passo maxStep / 2^k do seu nível k,
+// escolhido pelo critério dt = eta * |a| / |da/dt| (a derivada vem da variação da aceleração no
+// passo anterior). Os passos são potências de dois de uma unidade comum, então os corpos de um
+// nível terminam juntos e o tempo é contado em tiques inteiros: a ordem dos eventos não depende
+// de arredondamento. Cada corpo faz o leapfrog KDK com o seu passo: meio impulso ao abrir o
+// passo, deriva de todos os corpos a cada subpasso (as fontes precisam estar no instante certo)
+// e, ao fechar, forças só dos corpos que terminaram o passo e o outro meio impulso. Um corpo só
+// passa para um passo maior quando o instante é múltiplo dele, um nível por vez; para um menor,
+// a qualquer momento. Em sistemas hierárquicos (uma lua rápida entre planetas lentos, ou um disco
+// de partículas em órbitas longas) a maioria dos corpos fica nos níveis de cima e as avaliações
+// de força caem na proporção. Não é simplético como o leapfrog de passo único: a energia deriva
+// devagar em vez de só oscilar.
+class BlockTimesteps {
+public:
+    // 'maxStep' é o passo do nível 0, em dias; o nível mais fundo, 'maxLevel', usa maxStep /
+    // 2^maxLevel. 'accuracy' é o eta do critério de passo.
+    BlockTimesteps(double maxStep = 32.0, int maxLevel = 12, double accuracy = 0.03)
+        : maxStep(maxStep), maxLevel(std::min(std::max(maxLevel, 0), 40)), accuracy(accuracy) {}
+
+    uint64_t substepsTaken() const { return substeps; }
+    // Acelerações de corpos calculadas: cada corpo que fecha um passo conta uma.
+    uint64_t forceEvaluations() const { return evaluations; }
+
+    // Menor passo em uso, em dias.
+    double smallestStep() const {
+        int deepest = 0;
+        for (int value : level) deepest = std::max(deepest, value);
+        return maxStep / double(uint64_t(1) << deepest);
+    }
+
+    // Quantidade de corpos em cada nível, do 0 até maxLevel.
+    std::vector<size_t> levelCounts() const {
+        std::vector<size_t> counts(maxLevel + 1, 0);
+        for (int value : level) counts[value]++;
+        return counts;
+    }
+
+    // Se todos os corpos fecharam seus passos no instante atual. Só então as velocidades
+    // correspondem às posições; no meio de um passo elas estão adiantadas meio impulso.
+    bool synchronized() const {
+        return std::all_of(stepEnd.begin(), stepEnd.end(), [&](uint64_t end) { return end == tick; });
+    }
+
+    // Esquece os níveis e a contagem de tiques; necessário se os corpos do sistema mudarem.
+    void reset() { stepEnd.clear(); }
+
+    // Estado dos passos de um sistema de 'bodies' corpos (a origem e o tique atual; o nível, o
+    // fim do passo e a aceleração do início do passo de cada corpo), para continuar de um estado
+    // salvo no meio dos passos exatamente como da primeira vez. Os tiques cabem sem perda em um
+    // double.
+    static size_t stateSize(size_t bodies) { return 4 + 6 * bodies; }
+    void saveState(double* out) const {
+        size_t n = stepEnd.size();
+        out[0] = (double)n;
+        out[1] = origin;
+        out[2] = unit;
+        out[3] = (double)tick;
+        for (size_t i = 0; i < n; i++) {
+            double* body = out + 4 + 6 * i;
+            body[0] = level[i];
+            body[1] = known[i];
+            body[2] = (double)stepEnd[i];
+            body[3] = startAx[i];
+            body[4] = startAy[i];
+            body[5] = startAz[i];
+        }
+    }
+    // Sem passos começados no estado salvo, os níveis recomeçam na chamada seguinte a advance().
+    void loadState(const double* in) {
+        size_t n = (size_t)in[0];
+        if (n == 0) {
+            reset();
+            return;
+        }
+        origin = in[1];
+        unit = in[2];
+        tick = (uint64_t)in[3];
+        level.resize(n);
+        nextLevel.resize(n);
+        known.resize(n);
+        stepEnd.resize(n);
+        startAx.resize(n);
+        startAy.resize(n);
+        startAz.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            const double* body = in + 4 + 6 * i;
+            level[i] = nextLevel[i] = (int)body[0];
+            known[i] = (uint8_t)body[1];
+            stepEnd[i] = (uint64_t)body[2];
+            startAx[i] = body[3];
+            startAy[i] = body[4];
+            startAz[i] = body[5];
+        }
+    }
+
+    // Avança o sistema até o último fim de subpasso que não passa de 'time' (dias), em no
+    // máximo 'maxSubsteps' subpassos. Retorna false se parou antes por causa do limite. As
+    // acelerações precisam corresponder às posições na primeira chamada, como no leapfrog; os
+    // primeiros passos usam o nível mais fundo, até haver uma aceleração anterior para comparar.
+    bool advance(NBodySystem& system, double time, const PartialForceSolver& forces,
+                 uint64_t maxSubsteps = UINT64_MAX) {
+        size_t n = system.size();
+        if (n == 0) return true;
+        if (stepEnd.size() != n) start(system);
+        for (uint64_t taken = 0;; taken++) {
+            // Próximo instante em que algum corpo fecha o passo, com os níveis que os corpos
+            // parados no instante atual passariam a usar.
+            uint64_t next = UINT64_MAX;
+            for (size_t i = 0; i < n; i++) {
+                if (stepEnd[i] == tick) {
+                    nextLevel[i] = chooseLevel(system, i);
+                    next = std::min(next, tick + ticks(nextLevel[i]));
+                } else {
+                    next = std::min(next, stepEnd[i]);
+                }
+            }
+            if (timeAt(next) > time) return true;
+            if (taken == maxSubsteps) return false;
+
+            // Abre os passos novos com meio impulso da aceleração atual, guardada para estimar
+            // a derivada no fim do passo.
+            for (size_t i = 0; i < n; i++) {
+                if (stepEnd[i] != tick) continue;
+                level[i] = nextLevel[i];
+                known[i] = 1;
+                startAx[i] = system.ax[i];
+                startAy[i] = system.ay[i];
+                startAz[i] = system.az[i];
+                kick(system, i, 0.5 * stepLength(level[i]));
+                stepEnd[i] = tick + ticks(level[i]);
+            }
+
+            double dt = timeAt(next) - timeAt(tick);
+            workerPool().parallelFor(n, 16384, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    system.x[i] += system.vx[i] * dt;
+                    system.y[i] += system.vy[i] * dt;
+                    system.z[i] += system.vz[i] * dt;
+                }
+            });
+            tick = next;
+            system.time = timeAt(tick);
+
+            // Fecha os passos que terminam agora: forças novas só para esses corpos. Os corpos no
+            // meio de um passo andam em linha reta entre as pontas; como fontes, eles são
+            // levados para a parábola, a * tau * (tau - dt) / 2 fora da corda, e voltam depois.
+            active.clear();
+            predicted.clear();
+            for (size_t i = 0; i < n; i++) {
+                if (stepEnd[i] == tick) {
+                    active.push_back((uint32_t)i);
+                } else {
+                    double tau = (tick + ticks(level[i]) - stepEnd[i]) * unit; // Tempo desde o início do passo.
+                    double sag = 0.5 * tau * (tau - stepLength(level[i]));
+                    predicted.push_back({(uint32_t)i, system.x[i], system.y[i], system.z[i]});
+                    system.x[i] += system.ax[i] * sag;
+                    system.y[i] += system.ay[i] * sag;
+                    system.z[i] += system.az[i] * sag;
+                }
+            }
+            forces(system, active);
+            for (const Saved& saved : predicted) {
+                system.x[saved.index] = saved.x;
+                system.y[saved.index] = saved.y;
+                system.z[saved.index] = saved.z;
+            }
+            for (uint32_t i : active) kick(system, i, 0.5 * stepLength(level[i]));
+            evaluations += active.size();
+            substeps++;
+        }
+    }
+
+private:
+    double maxStep;
+    int maxLevel;
+    double accuracy;
+    double origin = 0.0;          // Instante do tique 0, em dias.
+    double unit = 0.0;            // Dias por tique: o passo do nível mais fundo.
+    uint64_t tick = 0;
+    uint64_t substeps = 0, evaluations = 0;
+    std::vector<int> level, nextLevel;
+    std::vector<uint8_t> known;   // Se o corpo já tem a aceleração do início de um passo.
+    std::vector<uint64_t> stepEnd; // Tique em que o passo atual de cada corpo termina.
+    std::vector<double> startAx, startAy, startAz;
+    std::vector<uint32_t> active;
+    struct Saved {
+        uint32_t index;
+        double x, y, z;
+    };
+    std::vector<Saved> predicted; // Posições na corda dos corpos no meio do passo.
+
+    uint64_t ticks(int value) const { return uint64_t(1) << (maxLevel - value); }
+    double stepLength(int value) const { return ticks(value) * unit; }
+    double timeAt(uint64_t value) const { return origin + value * unit; }
+
+    void start(const NBodySystem& system) {
+        size_t n = system.size();
+        origin = system.time;
+        unit = maxStep / double(uint64_t(1) << maxLevel);
+        tick = 0;
+        level.assign(n, maxLevel);
+        nextLevel.assign(n, maxLevel);
+        known.assign(n, 0);
+        stepEnd.assign(n, 0);
+        startAx.assign(n, 0.0);
+        startAy.assign(n, 0.0);
+        startAz.assign(n, 0.0);
+    }
+
+    static void kick(NBodySystem& system, size_t i, double h) {
+        system.vx[i] += system.ax[i] * h;
+        system.vy[i] += system.ay[i] * h;
+        system.vz[i] += system.az[i] * h;
+    }
+
+    // Nível do próximo passo do corpo 'i', que acabou de fechar um passo no tique atual.
+    int chooseLevel(const NBodySystem& system, size_t i) const {
+        if (!known[i]) return maxLevel;
+        double dx = system.ax[i] - startAx[i], dy = system.ay[i] - startAy[i], dz = system.az[i] - startAz[i];
+        double jerk = std::sqrt(dx * dx + dy * dy + dz * dz) / stepLength(level[i]);
+        double acceleration = std::sqrt(system.ax[i] * system.ax[i] + system.ay[i] * system.ay[i] +
+                                        system.az[i] * system.az[i]);
+        int wanted = 0;
+        if (jerk > 0.0) {
+            double ratio = maxStep * jerk / (accuracy * acceleration); // maxStep / dt desejado.
+            wanted = ratio > 1.0 ? (int)std::min(std::ceil(std::log2(ratio)), (double)maxLevel) : 0;
+        }
+        if (wanted >= level[i]) return wanted;
+        // Passo maior: um nível por vez, e só se o instante estiver alinhado com ele.
+        int coarser = level[i] - 1;
+        return tick % ticks(coarser) == 0 ? coarser : level[i];
+    }
+};
+
+// Energia total (cinética + potencial) por soma direta, para medir a deriva da integração.
+inline double totalEnergy(const NBodySystem& system) {
+    double eps2 = system.softening * system.softening;
+    double kinetic = 0.0, potential = 0.0;
+    for (size_t i = 0; i < system.size(); i++) {
+        kinetic += 0.5 * system.mu[i] * (system.vx[i] * system.vx[i] + system.vy[i] * system.vy[i] +
+                                         system.vz[i] * system.vz[i]);
+        for (size_t j = i + 1; j < system.size(); j++) {
+            double dx = system.x[j] - system.x[i], dy = system.y[j] - system.y[i], dz = system.z[j] - system.z[i];
+            potential -= system.mu[i] * system.mu[j] / std::sqrt(dx * dx + dy * dy + dz * dz + eps2);
+        }
+    }
+    return (kinetic + potential) / GAUSS_GRAVITY; // Em massas solares * UA^2 / dia^2.
+}
@@ -0,0 +1,603 @@
+/*
+ * =================================================================================================
+ * TEORIAS PLANETÁRIAS ANALÍTICAS (VSOP87 E ELP)
+ *
+ * Posições dos planetas pela teoria VSOP87 de Bretagnon e Francou e da Lua pela ELP-2000/82 de
+ * Chapront. As duas são somas de milhares de termos periódicos; os menores são descartados na
+ * carga enquanto a soma das amplitudes descartadas, que limita o erro do corte, couber na
+ * precisão pedida, e os que sobram ficam em SoA (amplitude, fase
+ * e frequência em vetores separados), avaliados com um cosseno vetorizado em AVX2 ou AVX-512,
+ * vários termos por vez.
+ *
+ * A VSOP87 vem da truncagem da versão D publicada por Meeus, embutida em vsop87_tables.h, ou
+ * dos arquivos oficiais (VSOP87A.mer, VSOP87D.ear...), em qualquer das versões A a D, que vão
+ * além da precisão da tabela; os dois têm, para cada coordenada e potência do tempo, os termos
+ * A cos(B + C t), com t em milênios julianos desde J2000, e passam pelo mesmo corte. A série da
+ * Lua é a truncagem da ELP-2000/82 publicada por Meeus (Astronomical Algorithms, cap. 47), com 60
+ * termos em longitude e distância e 60 em latitude, e fica embutida aqui. A saída é sempre
+ * retangular, em relação à eclíptica e ao equinócio J2000: as versões "da data" e a Lua são
+ * levadas a J2000 pela precessão da eclíptica.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "simd.h"
+#include "vsop87_tables.h"
+
+const double DAYS_PER_JULIAN_MILLENNIUM = 365250.0;
+const double ARCSECONDS_PER_RADIAN = 206264.80624709636;
+
+// PI/2 em três partes (Cody-Waite, como no Cephes): n * parte é exato para |n| < 2^29, então
+// a redução de argumentos de até 10^8 radianos não perde precisão.
+const double THEORY_HALF_PI1 = 1.57079625129699707031;
+const double THEORY_HALF_PI2 = 7.54978941586159635335e-8;
+const double THEORY_HALF_PI3 = 5.39030285815811905290e-15;
+// Polinômios do seno e do cosseno em [-PI/4, PI/4] (Cephes), do termo de maior grau ao menor.
+const double THEORY_SIN[6] = {1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6,
+                              -1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1};
+const double THEORY_COS[6] = {-1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7,
+                              2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2};
+
+const int VSOP87_MAX_POWER = 5; // Maior potência do tempo nos arquivos e nas tabelas.
+
+// Série da VSOP87 de um planeta: cada coordenada é a soma de A t^power cos(B + C t) dos termos
+// [start[c], start[c + 1]). As potências ficam misturadas numa sequência só por coordenada, em
+// vez de um bloco por potência, para que os blocos pequenos das potências altas não custem uma
+// soma vetorial cada.
+struct Vsop87Series {
+    bool spherical = false;  // L, B e R (versões B e D) em vez de X, Y e Z (A e C).
+    bool ofDate = false;     // Eclíptica e equinócio da data (C e D) em vez de J2000 (A e B).
+    std::vector<double> amplitude, phase, frequency;
+    std::vector<int64_t> power;
+    uint32_t start[4] = {0, 0, 0, 0};
+    size_t sourceTerms = 0;  // Termos do arquivo ou da tabela, antes do corte.
+    double bound = 0.0;      // Limite do desvio da direção causado pelo corte, em radianos.
+
+    size_t size() const { return amplitude.size(); }
+};
+
+// Série da Lua: cada termo é A E^|m| cos(d D + m M + m' M' + f F + fase), com os argumentos
+// fundamentais de Meeus. As coordenadas, nos termos [start[c], start[c + 1]), são a longitude,
+// a distância e a latitude, em 10^-6 grau (ângulos) e em metros.
+struct ElpSeries {
+    std::vector<double> amplitude, phase, d, m, mp, f;
+    uint32_t start[4] = {0, 0, 0, 0};
+    size_t tableTerms = 0;   // Termos da tabela, antes do corte.
+    double bound = 0.0;      // Limite do desvio da direção causado pelo corte, em radianos.
+
+    size_t size() const { return amplitude.size(); }
+};
+
+// Mantém, de uma coordenada, só o começo dos termos (os de maior amplitude) cujo resto tem
+// soma das amplitudes até 'tolerance', e guarda essa soma em 'tail'. A soma é um limite de
+// verdade do erro do corte, qualquer que seja a fase dos termos, só para |t| <= 1 nas potências
+// > 0, ou seja, até mil anos de J2000 na VSOP87 e cem anos na ELP. Retorna a quantidade mantida
+// de termos, que já estão ordenados por amplitude decrescente em 'order'.
+inline size_t theoryKeptTerms(const std::vector<double>& amplitude, const std::vector<uint32_t>& order,
+                              double tolerance, double& tail) {
+    size_t kept = order.size();
+    tail = 0.0;
+    while (kept > 0) {
+        double a = amplitude[order[kept - 1]];
+        if (tail + a > tolerance) break;
+        tail += a;
+        kept--;
+    }
+    return kept;
+}
+
+// Termos de uma coordenada e uma potência do tempo, antes do corte.
+struct Vsop87Block {
+    int coordinate, power;
+    std::vector<double> a, b, c;
+};
+
+// Monta a série com os termos de 'blocks' cujo corte desvia a direção vista do Sol no máximo
+// 'accuracy' radianos: cada coordenada angular tem tolerância 'accuracy' / raiz de 2, e cada
+// coordenada retangular, 'accuracy' vezes a distância média do planeta / raiz de 3 (as
+// distâncias de L, B e R, 'accuracy' vezes ela). Em cada coordenada, os termos de todas as
+// potências do tempo disputam a mesma tolerância.
+inline void buildVsop87Series(const std::vector<Vsop87Block>& blocks, bool spherical, bool ofDate, double accuracy,
+                              Vsop87Series& series) {
+    series = Vsop87Series();
+    series.spherical = spherical;
+    series.ofDate = ofDate;
+
+    // Distância média: o termo constante de R, ou a maior amplitude de X.
+    double distance = 0.0;
+    for (const Vsop87Block& block : blocks) {
+        if (block.power != 0 || block.coordinate != (spherical ? 2 : 0)) continue;
+        for (double a : block.a) distance = std::max(distance, std::fabs(a));
+    }
+    // Termos mantidos, por coordenada e, em cada uma, por amplitude decrescente.
+    struct Kept {
+        int coordinate, power;
+        double a, b, c;
+    };
+    std::vector<Kept> kept;
+    double squaredBound = 0.0;
+    for (int coordinate = 0; coordinate < 3; coordinate++) {
+        std::vector<Kept> terms;
+        for (const Vsop87Block& block : blocks) {
+            if (block.coordinate != coordinate || block.power < 0 || block.power > VSOP87_MAX_POWER) continue;
+            for (size_t i = 0; i < block.a.size(); i++) {
+                terms.push_back({coordinate, block.power, block.a[i], block.b[i], block.c[i]});
+            }
+        }
+        series.sourceTerms += terms.size();
+        bool angle = spherical && coordinate < 2;
+        std::vector<uint32_t> order(terms.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::vector<double> magnitude(terms.size());
+        for (size_t i = 0; i < magnitude.size(); i++) magnitude[i] = std::fabs(terms[i].a);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t i, uint32_t j) { return magnitude[i] > magnitude[j]; });
+        double tail;
+        size_t count = theoryKeptTerms(magnitude, order,
+                                       angle ? accuracy / std::sqrt(2.0) : accuracy * distance / std::sqrt(3.0), tail);
+        for (size_t k = 0; k < count; k++) kept.push_back(terms[order[k]]);
+        // O erro de R não muda a direção; o de X, Y e Z, sim, visto da distância média.
+        if (angle) squaredBound += tail * tail;
+        if (!spherical && distance > 0.0) squaredBound += tail * tail / (distance * distance);
+    }
+    series.bound = std::sqrt(squaredBound);
+    for (const Kept& term : kept) {
+        series.amplitude.push_back(term.a);
+        series.phase.push_back(term.b);
+        series.frequency.push_back(term.c);
+        series.power.push_back(term.power);
+        series.start[term.coordinate + 1] = (uint32_t)series.size();
+    }
+    for (int c = 1; c < 4; c++) series.start[c] = std::max(series.start[c], series.start[c - 1]);
+}
+
+// Lê um arquivo da VSOP87 e mantém os termos acima de 'accuracy', como buildVsop87Series().
+// Retorna false se o arquivo não abrir ou não for da VSOP87.
+inline bool loadVsop87(const char* path, double accuracy, Vsop87Series& series) {
+    series = Vsop87Series();
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+    std::vector<Vsop87Block> raw;
+    char version = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        const char* header = strstr(line, "VSOP87 VERSION");
+        if (header) {
+            // " VSOP87 VERSION A1    MERCURY   VARIABLE 1 (XYZ)       *T**0   1449 TERMS ..."
+            version = header[15];
+            const char* variable = strstr(line, "VARIABLE");
+            const char* power = strstr(line, "*T**");
+            if (!variable || !power || version < 'A' || version > 'D') break;
+            raw.push_back({atoi(variable + 8) - 1, atoi(power + 4), {}, {}, {}});
+            continue;
+        }
+        if (raw.empty()) continue;
+        // Os três últimos números da linha são A, B e C.
+        double values[3];
+        int found = 0;
+        char* end = line + strlen(line);
+        while (found < 3 && end > line) {
+            while (end > line && (end[-1] == ' ' || end[-1] == '\n' || end[-1] == '\r')) end--;
+            char* start = end;
+            while (start > line && start[-1] != ' ') start--;
+            if (start == end) break;
+            values[2 - found++] = strtod(start, nullptr);
+            end = start;
+        }
+        if (found < 3) continue;
+        raw.back().a.push_back(values[0]);
+        raw.back().b.push_back(values[1]);
+        raw.back().c.push_back(values[2]);
+    }
+    fclose(file);
+    if (raw.empty() || version < 'A' || version > 'D') return false;
+    buildVsop87Series(raw, version == 'B' || version == 'D', version == 'C' || version == 'D', accuracy, series);
+    return true;
+}
+
+// Monta a série do planeta 'planet' (1 a 8, de Mercúrio a Netuno) da tabela embutida da
+// VSOP87D, com o mesmo corte dos arquivos. Retorna false se não houver tabela para ele.
+inline bool buildEmbeddedVsop87(int planet, double accuracy, Vsop87Series& series) {
+    series = Vsop87Series();
+    if (planet < 1 || planet > 8) return false;
+    const Vsop87Table& table = VSOP87D_TABLES[planet - 1];
+    std::vector<Vsop87Block> blocks;
+    for (size_t i = 0; i < table.count; i++) {
+        const Vsop87TableTerm& term = table.terms[i];
+        if (blocks.empty() || blocks.back().coordinate != term.coordinate || blocks.back().power != term.power) {
+            blocks.push_back({term.coordinate, term.power, {}, {}, {}});
+        }
+        blocks.back().a.push_back(term.a * 1e-8);
+        blocks.back().b.push_back(term.b);
+        blocks.back().c.push_back(term.c);
+    }
+    buildVsop87Series(blocks, true, true, accuracy, series);
+    return true;
+}
+
+// Termo da tabela de Meeus: múltiplos de D, M, M' e F e os coeficientes de cada coordenada.
+struct ElpTableTerm {
+    signed char d, m, mp, f;
+    int first, second;
+};
+
+// Tabela 47.A: longitude (10^-6 grau, seno) e distância (10^-3 km, cosseno).
+const ElpTableTerm ELP_LONGITUDE_DISTANCE[60] = {
+    {0, 0, 1, 0, 6288774, -20905355}, {2, 0, -1, 0, 1274027, -3699111}, {2, 0, 0, 0, 658314, -2955968},
+    {0, 0, 2, 0, 213618, -569925},    {0, 1, 0, 0, -185116, 48888},     {0, 0, 0, 2, -114332, -3149},
+    {2, 0, -2, 0, 58793, 246158},     {2, -1, -1, 0, 57066, -152138},   {2, 0, 1, 0, 53322, -170733},
+    {2, -1, 0, 0, 45758, -204586},    {0, 1, -1, 0, -40923, -129620},   {1, 0, 0, 0, -34720, 108743},
+    {0, 1, 1, 0, -30383, 104755},     {2, 0, 0, -2, 15327, 10321},      {0, 0, 1, 2, -12528, 0},
+    {0, 0, 1, -2, 10980, 79661},      {4, 0, -1, 0, 10675, -34782},     {0, 0, 3, 0, 10034, -23210},
+    {4, 0, -2, 0, 8548, -21636},      {2, 1, -1, 0, -7888, 24208},      {2, 1, 0, 0, -6766, 30824},
+    {1, 0, -1, 0, -5163, -8379},      {1, 1, 0, 0, 4987, -16675},       {2, -1, 1, 0, 4036, -12831},
+    {2, 0, 2, 0, 3994, -10445},       {4, 0, 0, 0, 3861, -11650},       {2, 0, -3, 0, 3665, 14403},
+    {0, 1, -2, 0, -2689, -7003},      {2, 0, -1, 2, -2602, 0},          {2, -1, -2, 0, 2390, 10056},
+    {1, 0, 1, 0, -2348, 6322},        {2, -2, 0, 0, 2236, -9884},       {0, 1, 2, 0, -2120, 5751},
+    {0, 2, 0, 0, -2069, 0},           {2, -2, -1, 0, 2048, -4950},      {2, 0, 1, -2, -1773, 4130},
+    {2, 0, 0, 2, -1595, 0},           {4, -1, -1, 0, 1215, -3958},      {0, 0, 2, 2, -1110, 0},
+    {3, 0, -1, 0, -892, 3258},        {2, 1, 1, 0, -810, 2616},         {4, -1, -2, 0, 759, -1897},
+    {0, 2, -1, 0, -713, -2117},       {2, 2, -1, 0, -700, 2354},        {2, 1, -2, 0, 691, 0},
+    {2, -1, 0, -2, 596, 0},           {4, 0, 1, 0, 549, -1423},         {0, 0, 4, 0, 537, -1117},
+    {4, -1, 0, 0, 520, -1571},        {1, 0, -2, 0, -487, -1739},       {2, 1, 0, -2, -399, 0},
+    {0, 0, 2, -2, -381, -4421},       {1, 1, 1, 0, 351, 0},             {3, 0, -2, 0, -340, 0},
+    {4, 0, -3, 0, 330, 0},            {2, -1, 2, 0, 327, 0},            {0, 2, 1, 0, -323, 1165},
+    {1, 1, -1, 0, 299, 0},            {2, 0, 3, 0, 294, 0},             {2, 0, -1, -2, 0, 8752},
+};
+
+// Tabela 47.B: latitude (10^-6 grau, seno); o segundo coeficiente não é usado.
+const ElpTableTerm ELP_LATITUDE[60] = {
+    {0, 0, 0, 1, 5128122, 0}, {0, 0, 1, 1, 280602, 0},  {0, 0, 1, -1, 277693, 0}, {2, 0, 0, -1, 173237, 0},
+    {2, 0, -1, 1, 55413, 0},  {2, 0, -1, -1, 46271, 0}, {2, 0, 0, 1, 32573, 0},   {0, 0, 2, 1, 17198, 0},
+    {2, 0, 1, -1, 9266, 0},   {0, 0, 2, -1, 8822, 0},   {2, -1, 0, -1, 8216, 0},  {2, 0, -2, -1, 4324, 0},
+    {2, 0, 1, 1, 4200, 0},    {2, 1, 0, -1, -3359, 0},  {2, -1, -1, 1, 2463, 0},  {2, -1, 0, 1, 2211, 0},
+    {2, -1, -1, -1, 2065, 0}, {0, 1, -1, -1, -1870, 0}, {4, 0, -1, -1, 1828, 0},  {0, 1, 0, 1, -1794, 0},
+    {0, 0, 0, 3, -1749, 0},   {0, 1, -1, 1, -1565, 0},  {1, 0, 0, 1, -1491, 0},   {0, 1, 1, 1, -1475, 0},
+    {0, 1, 1, -1, -1410, 0},  {0, 1, 0, -1, -1344, 0},  {1, 0, 0, -1, -1335, 0},  {0, 0, 3, 1, 1107, 0},
+    {4, 0, 0, -1, 1021, 0},   {4, 0, -1, 1, 833, 0},    {0, 0, 1, -3, 777, 0},    {4, 0, -2, 1, 671, 0},
+    {2, 0, 0, -3, 607, 0},    {2, 0, 2, -1, 596, 0},    {2, -1, 1, -1, 491, 0},   {2, 0, -2, 1, -451, 0},
+    {0, 0, 3, -1, 439, 0},    {2, 0, 2, 1, 422, 0},     {2, 0, -3, -1, 421, 0},   {2, 1, -1, 1, -366, 0},
+    {2, 1, 0, 1, -351, 0},    {4, 0, 0, 1, 331, 0},     {2, -1, 1, 1, 315, 0},    {2, -2, 0, -1, 302, 0},
+    {0, 0, 1, 3, -283, 0},    {2, 1, 1, -1, -229, 0},   {1, 1, 0, -1, 223, 0},    {1, 1, 0, 1, 223, 0},
+    {0, 1, -2, -1, -220, 0},  {2, 1, -1, -1, -220, 0},  {1, 0, 1, 1, -185, 0},    {2, -1, -2, -1, 181, 0},
+    {0, 1, 2, 1, -177, 0},    {4, 0, -2, -1, 176, 0},   {4, -1, -1, -1, 166, 0},  {1, 0, 1, -1, -164, 0},
+    {4, 0, 1, -1, 132, 0},    {1, 0, -1, -1, -119, 0},  {4, -1, 0, -1, 115, 0},   {2, -2, 0, 1, 107, 0},
+};
+
+const double ELP_MEAN_DISTANCE_KM = 385000.56;
+
+// Monta a série da Lua com os termos cujo corte desvia a direção vista da Terra no máximo
+// 'accuracy' radianos: a longitude e a latitude têm tolerância 'accuracy' / raiz de 2, e a
+// distância, 'accuracy' vezes a distância média.
+inline void buildElpSeries(double accuracy, ElpSeries& series) {
+    series = ElpSeries();
+    const double microdegrees = accuracy / std::sqrt(2.0) * 180.0 / M_PI * 1e6;
+    const double meters = accuracy * ELP_MEAN_DISTANCE_KM * 1e3;
+    double squaredBound = 0.0;
+    for (int coordinate = 0; coordinate < 3; coordinate++) {
+        const ElpTableTerm* table = coordinate == 2 ? ELP_LATITUDE : ELP_LONGITUDE_DISTANCE;
+        std::vector<double> magnitude(60);
+        std::vector<uint32_t> order;
+        for (uint32_t i = 0; i < 60; i++) {
+            magnitude[i] = std::fabs(coordinate == 1 ? (double)table[i].second : (double)table[i].first);
+            if (magnitude[i] > 0.0) order.push_back(i);
+        }
+        series.tableTerms += order.size();
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t i, uint32_t j) { return magnitude[i] > magnitude[j]; });
+        double tail;
+        size_t kept = theoryKeptTerms(magnitude, order, coordinate == 1 ? meters : microdegrees, tail);
+        if (coordinate != 1) squaredBound += tail * tail;
+        for (size_t k = 0; k < kept; k++) {
+            const ElpTableTerm& term = table[order[k]];
+            // Longitude e latitude somam senos: sen x = cos(x - PI/2).
+            series.amplitude.push_back(coordinate == 1 ? term.second : term.first);
+            series.phase.push_back(coordinate == 1 ? 0.0 : -M_PI / 2.0);
+            series.d.push_back(term.d);
+            series.m.push_back(term.m);
+            series.mp.push_back(term.mp);
+            series.f.push_back(term.f);
+        }
+        series.start[coordinate + 1] = (uint32_t)series.size();
+    }
+    series.bound = std::sqrt(squaredBound) * 1e-6 * M_PI / 180.0;
+}
+
+// 1,5 * 2^52: somado a um double de módulo até 2^51, arredonda-o para o inteiro mais próximo,
+// que fica nos bits baixos da mantissa (em complemento de dois, mesmo se for negativo).
+const double THEORY_ROUNDING_SHIFT = 6755399441055744.0;
+
+// Cosseno de x por redução a [-PI/4, PI/4] e os polinômios do Cephes, para as somas escalares.
+// O quadrante n = round(x / (PI/2)) escolhe o polinômio (n ímpar troca pelo seno) e o sinal.
+inline double theoryCos(double x) {
+    double shifted = x * (2.0 / M_PI) + THEORY_ROUNDING_SHIFT;
+    double n = shifted - THEORY_ROUNDING_SHIFT;
+    int64_t q;
+    memcpy(&q, &shifted, sizeof(q));
+    double r = ((x - n * THEORY_HALF_PI1) - n * THEORY_HALF_PI2) - n * THEORY_HALF_PI3;
+    double z = r * r;
+    double sinPoly = THEORY_SIN[0], cosPoly = THEORY_COS[0];
+    for (int i = 1; i < 6; i++) {
+        sinPoly = sinPoly * z + THEORY_SIN[i];
+        cosPoly = cosPoly * z + THEORY_COS[i];
+    }
+    sinPoly = sinPoly * (z * r) + r;
+    cosPoly = cosPoly * (z * z) + (1.0 - 0.5 * z);
+    // Quadrantes 0 a 3: cos, -sen, -cos e sen.
+    double value = (q & 1) ? sinPoly : cosPoly;
+    return ((q + 1) & 2) ? -value : value;
+}
+
+// t^0 a t^VSOP87_MAX_POWER, seguidos de zeros até 8 valores.
+inline void theoryTimePowers(double t, double powers[8]) {
+    powers[0] = 1.0;
+    for (int i = 1; i < 8; i++) powers[i] = i <= VSOP87_MAX_POWER ? powers[i - 1] * t : 0.0;
+}
+
+#ifdef SIMD_HAS_AVX2
+// Cosseno de 4 doubles, como theoryCos().
+SIMD_TARGET_AVX2 inline __m256d theoryCosAVX2(__m256d x) {
+    const __m256d shift = _mm256_set1_pd(THEORY_ROUNDING_SHIFT);
+    __m256d shifted = _mm256_fmadd_pd(x, _mm256_set1_pd(2.0 / M_PI), shift);
+    __m256d n = _mm256_sub_pd(shifted, shift);
+    __m256d r = _mm256_fnmadd_pd(n, _mm256_set1_pd(THEORY_HALF_PI1), x);
+    r = _mm256_fnmadd_pd(n, _mm256_set1_pd(THEORY_HALF_PI2), r);
+    r = _mm256_fnmadd_pd(n, _mm256_set1_pd(THEORY_HALF_PI3), r);
+    __m256d z = _mm256_mul_pd(r, r);
+    __m256d sinPoly = _mm256_set1_pd(THEORY_SIN[0]), cosPoly = _mm256_set1_pd(THEORY_COS[0]);
+    for (int i = 1; i < 6; i++) {
+        sinPoly = _mm256_fmadd_pd(sinPoly, z, _mm256_set1_pd(THEORY_SIN[i]));
+        cosPoly = _mm256_fmadd_pd(cosPoly, z, _mm256_set1_pd(THEORY_COS[i]));
+    }
+    sinPoly = _mm256_fmadd_pd(sinPoly, _mm256_mul_pd(z, r), r);
+    cosPoly = _mm256_fmadd_pd(cosPoly, _mm256_mul_pd(z, z), _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.0)));
+
+    __m256i q = _mm256_castpd_si256(shifted), one = _mm256_set1_epi64x(1);
+    __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(q, one), one));
+    __m256i sign = _mm256_slli_epi64(_mm256_srli_epi64(_mm256_add_epi64(q, one), 1), 63);
+    return _mm256_xor_pd(_mm256_blendv_pd(cosPoly, sinPoly, swap), _mm256_castsi256_pd(sign));
+}
+
+// Soma de a[i] t^p[i] cos(b[i] + c[i] t) para i em [begin, end), 4 termos por vez; retorna o
+// índice do primeiro termo não somado. 'powers' vem de theoryTimePowers().
+SIMD_TARGET_AVX2 inline size_t sumPoissonTermsAVX2(const double* a, const double* b, const double* c,
+                                                     const int64_t* p, size_t begin, size_t end, double t,
+                                                     const double* powers, double& sum) {
+    __m256d total = _mm256_setzero_pd();
+    const __m256d time = _mm256_set1_pd(t);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d argument = _mm256_fmadd_pd(_mm256_loadu_pd(c + i), time, _mm256_loadu_pd(b + i));
+        __m256d scale = _mm256_i64gather_pd(powers, _mm256_loadu_si256((const __m256i*)(p + i)), 8);
+        total = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_loadu_pd(a + i), scale), theoryCosAVX2(argument), total);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, total);
+    sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    return i;
+}
+
+// Como sumPoissonTermsAVX2(), para os termos da Lua: o argumento é d D + m M + m' M' + f F + fase
+// e a amplitude é multiplicada por E^|m|, que para |m| <= 2 é 1 + |m| (E - 1) + |m| (|m| - 1) / 2 (E - 1)^2.
+SIMD_TARGET_AVX2 inline size_t sumLunarTermsAVX2(const ElpSeries& series, size_t begin, size_t end,
+                                                   const double arguments[4], double e, double& sum) {
+    __m256d total = _mm256_setzero_pd();
+    const __m256d argD = _mm256_set1_pd(arguments[0]), argM = _mm256_set1_pd(arguments[1]);
+    const __m256d argMp = _mm256_set1_pd(arguments[2]), argF = _mm256_set1_pd(arguments[3]);
+    const __m256d e1 = _mm256_set1_pd(e - 1.0), half = _mm256_set1_pd(0.5), signMask = _mm256_set1_pd(-0.0);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d m = _mm256_loadu_pd(&series.m[i]);
+        __m256d argument = _mm256_fmadd_pd(_mm256_loadu_pd(&series.d[i]), argD, _mm256_loadu_pd(&series.phase[i]));
+        argument = _mm256_fmadd_pd(m, argM, argument);
+        argument = _mm256_fmadd_pd(_mm256_loadu_pd(&series.mp[i]), argMp, argument);
+        argument = _mm256_fmadd_pd(_mm256_loadu_pd(&series.f[i]), argF, argument);
+        __m256d k = _mm256_andnot_pd(signMask, m);
+        __m256d power = _mm256_mul_pd(_mm256_mul_pd(k, _mm256_sub_pd(k, _mm256_set1_pd(1.0))), half);
+        __m256d factor = _mm256_fmadd_pd(_mm256_fmadd_pd(power, e1, k), e1, _mm256_set1_pd(1.0));
+        __m256d amplitude = _mm256_mul_pd(_mm256_loadu_pd(&series.amplitude[i]), factor);
+        total = _mm256_fmadd_pd(amplitude, theoryCosAVX2(argument), total);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, total);
+    sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    return i;
+}
+#endif
+
+#ifdef SIMD_HAS_AVX512
+SIMD_AVX512_WARNINGS_BEGIN
+
+// Cosseno de 8 doubles, como theoryCos().
+SIMD_TARGET_AVX512 inline __m512d theoryCosAVX512(__m512d x) {
+    const __m512d shift = _mm512_set1_pd(THEORY_ROUNDING_SHIFT);
+    __m512d shifted = _mm512_fmadd_pd(x, _mm512_set1_pd(2.0 / M_PI), shift);
+    __m512d n = _mm512_sub_pd(shifted, shift);
+    __m512d r = _mm512_fnmadd_pd(n, _mm512_set1_pd(THEORY_HALF_PI1), x);
+    r = _mm512_fnmadd_pd(n, _mm512_set1_pd(THEORY_HALF_PI2), r);
+    r = _mm512_fnmadd_pd(n, _mm512_set1_pd(THEORY_HALF_PI3), r);
+    __m512d z = _mm512_mul_pd(r, r);
+    __m512d sinPoly = _mm512_set1_pd(THEORY_SIN[0]), cosPoly = _mm512_set1_pd(THEORY_COS[0]);
+    for (int i = 1; i < 6; i++) {
+        sinPoly = _mm512_fmadd_pd(sinPoly, z, _mm512_set1_pd(THEORY_SIN[i]));
+        cosPoly = _mm512_fmadd_pd(cosPoly, z, _mm512_set1_pd(THEORY_COS[i]));
+    }
+    sinPoly = _mm512_fmadd_pd(sinPoly, _mm512_mul_pd(z, r), r);
+    cosPoly = _mm512_fmadd_pd(cosPoly, _mm512_mul_pd(z, z), _mm512_fnmadd_pd(_mm512_set1_pd(0.5), z, _mm512_set1_pd(1.0)));
+
+    __m512i q = _mm512_castpd_si512(shifted), one = _mm512_set1_epi64(1);
+    __mmask8 swap = _mm512_test_epi64_mask(q, one);
+    __m512i sign = _mm512_slli_epi64(_mm512_srli_epi64(_mm512_add_epi64(q, one), 1), 63);
+    return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(_mm512_mask_blend_pd(swap, cosPoly, sinPoly)), sign));
+}
+
+// Como sumPoissonTermsAVX2(), 8 termos por vez; a potência de t sai de uma permutação.
+SIMD_TARGET_AVX512 inline size_t sumPoissonTermsAVX512(const double* a, const double* b, const double* c,
+                                                         const int64_t* p, size_t begin, size_t end, double t,
+                                                         const double* powers, double& sum) {
+    __m512d total = _mm512_setzero_pd();
+    const __m512d time = _mm512_set1_pd(t), table = _mm512_loadu_pd(powers);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d argument = _mm512_fmadd_pd(_mm512_loadu_pd(c + i), time, _mm512_loadu_pd(b + i));
+        __m512d scale = _mm512_permutexvar_pd(_mm512_loadu_si512(p + i), table);
+        total = _mm512_fmadd_pd(_mm512_mul_pd(_mm512_loadu_pd(a + i), scale), theoryCosAVX512(argument), total);
+    }
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, total);
+    sum += ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    return i;
+}
+
+// Como sumLunarTermsAVX2(), 8 termos por vez.
+SIMD_TARGET_AVX512 inline size_t sumLunarTermsAVX512(const ElpSeries& series, size_t begin, size_t end,
+                                                       const double arguments[4], double e, double& sum) {
+    __m512d total = _mm512_setzero_pd();
+    const __m512d argD = _mm512_set1_pd(arguments[0]), argM = _mm512_set1_pd(arguments[1]);
+    const __m512d argMp = _mm512_set1_pd(arguments[2]), argF = _mm512_set1_pd(arguments[3]);
+    const __m512d e1 = _mm512_set1_pd(e - 1.0), half = _mm512_set1_pd(0.5);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d m = _mm512_loadu_pd(&series.m[i]);
+        __m512d argument = _mm512_fmadd_pd(_mm512_loadu_pd(&series.d[i]), argD, _mm512_loadu_pd(&series.phase[i]));
+        argument = _mm512_fmadd_pd(m, argM, argument);
+        argument = _mm512_fmadd_pd(_mm512_loadu_pd(&series.mp[i]), argMp, argument);
+        argument = _mm512_fmadd_pd(_mm512_loadu_pd(&series.f[i]), argF, argument);
+        __m512d k = _mm512_abs_pd(m);
+        __m512d power = _mm512_mul_pd(_mm512_mul_pd(k, _mm512_sub_pd(k, _mm512_set1_pd(1.0))), half);
+        __m512d factor = _mm512_fmadd_pd(_mm512_fmadd_pd(power, e1, k), e1, _mm512_set1_pd(1.0));
+        __m512d amplitude = _mm512_mul_pd(_mm512_loadu_pd(&series.amplitude[i]), factor);
+        total = _mm512_fmadd_pd(amplitude, theoryCosAVX512(argument), total);
+    }
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, total);
+    sum += ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    return i;
+}
+SIMD_AVX512_WARNINGS_END
+#endif
+
+// Soma dos termos [begin, end) de uma série da VSOP87 no instante t (milênios desde J2000).
+inline double sumPoissonTerms(const Vsop87Series& series, size_t begin, size_t end, double t, SimdKernel kernel) {
+    double powers[8];
+    theoryTimePowers(t, powers);
+    const double *a = series.amplitude.data(), *b = series.phase.data(), *c = series.frequency.data();
+    const int64_t* p = series.power.data();
+    double sum = 0.0;
+    size_t done = begin;
+#ifdef SIMD_HAS_AVX512
+    if (kernel == SimdKernel::AVX512) done = sumPoissonTermsAVX512(a, b, c, p, begin, end, t, powers, sum);
+#endif
+#ifdef SIMD_HAS_AVX2
+    if (kernel == SimdKernel::AVX2) done = sumPoissonTermsAVX2(a, b, c, p, begin, end, t, powers, sum);
+#endif
+    for (size_t i = done; i < end; i++) sum += a[i] * powers[p[i]] * theoryCos(b[i] + c[i] * t);
+    return sum;
+}
+
+// Leva um vetor da eclíptica e do equinócio da data, 'centuries' séculos julianos depois de
+// J2000, para J2000 (Meeus, cap. 21, com a data como época inicial): gira em torno do polo da
+// eclíptica até o nó Pi entre as duas eclípticas, inclina pelo ângulo eta entre elas e volta
+// pela longitude do nó mais a precessão geral p.
+inline void eclipticOfDateToJ2000(double centuries, double position[3]) {
+    const double T = centuries, t = -centuries, arcsecond = 1.0 / ARCSECONDS_PER_RADIAN;
+    double eta = ((47.0029 - 0.06603 * T + 0.000598 * T * T) * t + (-0.03302 + 0.000598 * T) * t * t +
+                  0.000060 * t * t * t) * arcsecond;
+    double node = 174.876384 * M_PI / 180.0 +
+                  (3289.4789 * T + 0.60622 * T * T - (869.8089 + 0.50491 * T) * t + 0.03536 * t * t) * arcsecond;
+    double p = ((5029.0966 + 2.22226 * T - 0.000042 * T * T) * t + (1.11113 - 0.000042 * T) * t * t -
+                0.000006 * t * t * t) * arcsecond;
+    double c = std::cos(node), s = std::sin(node);
+    double x = c * position[0] + s * position[1], y = -s * position[0] + c * position[1], z = position[2];
+    double ce = std::cos(eta), se = std::sin(eta);
+    double y2 = ce * y + se * z, z2 = -se * y + ce * z;
+    c = std::cos(node + p);
+    s = std::sin(node + p);
+    position[0] = c * x - s * y2;
+    position[1] = s * x + c * y2;
+    position[2] = z2;
+}
+
+// Posição heliocêntrica (UA, eclíptica e equinócio J2000) de um planeta no instante 'days'.
+inline void evaluateVsop87(const Vsop87Series& series, double days, double position[3],
+                           SimdKernel kernel = detectSimdKernel()) {
+    double t = days / DAYS_PER_JULIAN_MILLENNIUM;
+    double coordinates[3];
+    for (int c = 0; c < 3; c++) coordinates[c] = sumPoissonTerms(series, series.start[c], series.start[c + 1], t, kernel);
+    if (series.spherical) {
+        double l = coordinates[0], b = coordinates[1], r = coordinates[2];
+        position[0] = r * std::cos(b) * std::cos(l);
+        position[1] = r * std::cos(b) * std::sin(l);
+        position[2] = r * std::sin(b);
+    } else {
+        std::copy(coordinates, coordinates + 3, position);
+    }
+    if (series.ofDate) eclipticOfDateToJ2000(t * 10.0, position);
+}
+
+// Soma dos termos [begin, end) da Lua com os argumentos fundamentais (D, M, M', F) e o fator
+// de excentricidade E.
+inline double sumLunarTerms(const ElpSeries& series, size_t begin, size_t end, const double arguments[4], double e,
+                            SimdKernel kernel) {
+    double sum = 0.0;
+    size_t done = begin;
+#ifdef SIMD_HAS_AVX512
+    if (kernel == SimdKernel::AVX512) done = sumLunarTermsAVX512(series, begin, end, arguments, e, sum);
+#endif
+#ifdef SIMD_HAS_AVX2
+    if (kernel == SimdKernel::AVX2) done = sumLunarTermsAVX2(series, begin, end, arguments, e, sum);
+#endif
+    for (size_t i = done; i < end; i++) {
+        double argument = series.d[i] * arguments[0] + series.m[i] * arguments[1] + series.mp[i] * arguments[2] +
+                          series.f[i] * arguments[3] + series.phase[i];
+        double k = std::fabs(series.m[i]);
+        double factor = k == 0.0 ? 1.0 : k == 1.0 ? e : e * e;
+        sum += series.amplitude[i] * factor * theoryCos(argument);
+    }
+    return sum;
+}
+
+// Posição geocêntrica da Lua (km, eclíptica e equinócio J2000) no instante 'days' (Meeus, cap. 47).
+inline void evaluateElp(const ElpSeries& series, double days, double position[3],
+                        SimdKernel kernel = detectSimdKernel()) {
+    const double degree = M_PI / 180.0;
+    double t = days / 36525.0, t2 = t * t, t3 = t2 * t, t4 = t3 * t;
+    // Argumentos fundamentais, em graus: longitude média da Lua, elongação média, anomalias médias
+    // do Sol e da Lua e argumento de latitude.
+    double meanLongitude = 218.3164477 + 481267.88123421 * t - 0.0015786 * t2 + t3 / 538841.0 - t4 / 65194000.0;
+    double d = 297.8501921 + 445267.1114034 * t - 0.0018819 * t2 + t3 / 545868.0 - t4 / 113065000.0;
+    double m = 357.5291092 + 35999.0502909 * t - 0.0001536 * t2 + t3 / 24490000.0;
+    double mp = 134.9633964 + 477198.8675055 * t + 0.0087414 * t2 + t3 / 69699.0 - t4 / 14712000.0;
+    double f = 93.2720950 + 483202.0175233 * t - 0.0036539 * t2 - t3 / 3526000.0 + t4 / 863310000.0;
+    double a1 = (119.75 + 131.849 * t) * degree, a2 = (53.09 + 479264.290 * t) * degree;
+    double a3 = (313.45 + 481266.484 * t) * degree;
+    double e = 1.0 - 0.002516 * t - 0.0000074 * t2;
+    // Reduzidos a uma volta antes de virar radianos, para não perder precisão nos múltiplos.
+    const double arguments[4] = {std::fmod(d, 360.0) * degree, std::fmod(m, 360.0) * degree,
+                                 std::fmod(mp, 360.0) * degree, std::fmod(f, 360.0) * degree};
+    double l = std::fmod(meanLongitude, 360.0) * degree;
+
+    double sums[3];
+    for (int c = 0; c < 3; c++) sums[c] = sumLunarTerms(series, series.start[c], series.start[c + 1], arguments, e, kernel);
+    // Termos aditivos de Vênus (A1), de Júpiter (A2) e do achatamento da Terra (L' - F, A3).
+    sums[0] += 3958.0 * std::sin(a1) + 1962.0 * std::sin(l - arguments[3]) + 318.0 * std::sin(a2);
+    sums[2] += -2235.0 * std::sin(l) + 382.0 * std::sin(a3) + 175.0 * std::sin(a1 - arguments[3]) +
+               175.0 * std::sin(a1 + arguments[3]) + 127.0 * std::sin(l - arguments[2]) -
+               115.0 * std::sin(l + arguments[2]);
+
+    double longitude = l + sums[0] * 1e-6 * degree;
+    double latitude = sums[2] * 1e-6 * degree;
+    double distance = ELP_MEAN_DISTANCE_KM + sums[1] * 1e-3;
+    position[0] = distance * std::cos(latitude) * std::cos(longitude);
+    position[1] = distance * std::cos(latitude) * std::sin(longitude);
+    position[2] = distance * std::sin(latitude);
+    eclipticOfDateToJ2000(t, position);
+}
@@ -0,0 +1,316 @@
+/*
+ * =================================================================================================
+ * REGISTRO DE SESSÃO (ENTRADAS E RELÓGIO)
+ *
+ * Arquivo binário com tudo o que muda um quadro de uma sessão interativa: as teclas e o tamanho
+ * da janela, com o instante de cada um, e, a cada quadro, o instante em que ele foi desenhado, os
+ * relógios dos dois passos da simulação entre os quais ele foi interpolado e a posição dele entre
+ * os dois. Reproduzir o arquivo refaz a mesma sequência de quadros, com as mesmas entradas antes
+ * dos mesmos quadros, nos mesmos instantes dentro do quadro, e a mesma interpolação entre os
+ * mesmos passos, independente de quem apertou as teclas e de quanto tempo cada quadro levou na
+ * gravação. No modo N-corpos, em que o estado depende do caminho da integração, cada estado
+ * publicado pela thread de simulação também é gravado, com o que a volta dela fez (um passo
+ * normal ou parte de um salto), para que a reprodução refaça a mesma integração.
+ *
+ * Layout (little-endian):
+ *   SessionHeader
+ *   char command[commandBytes]: linha de comando da gravação, para conferir na reprodução
+ *   registros, cada um com um byte de tipo (SessionEventType), os nanossegundos desde o registro
+ *   anterior e os campos, em varint:
+ *     Frame:      os dois relógios, cada um com a diferença de ticks em zigzag (o primeiro em
+ *                 relação ao do quadro anterior, o segundo em relação ao primeiro) e a fração
+ *                 em 8 bytes (o double exato), e a posição entre eles em 4 bytes (o float)
+ *     Key:        a tecla (um byte) e x, y em zigzag
+ *     SpecialKey: a tecla, x e y em zigzag
+ *     Reshape:    largura e altura
+ *     Step:       um byte de SESSION_STEP_*, a diferença de ticks do relógio publicado em zigzag (em
+ *                 relação ao do Step anterior) e a fração em 8 bytes, e, com SESSION_STEP_NEW_SEEK,
+ *                 o destino do salto em 8 bytes (o double exato)
+ *
+ * Um quadro custa cerca de 23 bytes, um estado publicado, 12, e uma tecla, 10. Uma gravação interrompida (o programa morto
+ * no meio da escrita) é lida até o último registro completo.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "simulation_clock.h"
+#include "trajectory_store.h"
+
+const char SESSION_LOG_MAGIC[8] = {'S', 'S', 'L', 'O', 'G', 0, 0, 0};
+const uint32_t SESSION_LOG_VERSION = 3; // A 2 deu instante às entradas; a 3, os dois passos aos quadros.
+
+struct SessionHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t commandBytes;
+    double startDays;           // --date, em dias desde J2000.
+    float cameraAngle, cameraDistance, animationSpeed;
+    int32_t width, height;      // Tamanho da janela no início.
+    uint32_t reserved;
+};
+static_assert(sizeof(SessionHeader) == 48, "SessionHeader precisa ter 48 bytes, sem preenchimento");
+
+enum class SessionEventType : uint8_t { Frame = 1, Key = 2, SpecialKey = 3, Reshape = 4, Step = 5 };
+
+// O que a volta da thread de simulação que publicou um estado (Step) fez.
+const uint8_t SESSION_STEP_SEEK = 1;         // Integrou em direção a um salto, em vez de um passo normal,
+const uint8_t SESSION_STEP_SEEK_REACHED = 2; // chegou ao destino (e seguiu com um passo normal)
+const uint8_t SESSION_STEP_NEW_SEEK = 4;     // e começou o salto para 'seekDays' nesta volta.
+
+struct SessionEvent {
+    SessionEventType type;
+    int key = 0, x = 0, y = 0;   // No Reshape, x e y são a largura e a altura.
+    uint64_t elapsedNs = 0;      // Nanossegundos desde o início da gravação.
+    SimulationClock previousClock, clock; // Frame: relógios dos passos anterior e seguinte ao quadro
+    float alpha = 0.0f;                   // e a posição do quadro entre eles, de 0 a 1. Step: relógio publicado.
+    uint8_t stepFlags = 0;                // Step: SESSION_STEP_* e, com SESSION_STEP_NEW_SEEK, o destino
+    double seekDays = 0.0;                // do salto, em dias desde J2000.
+};
+
+// Gravação. Os registros são acumulados em memória e escritos em blocos de FLUSH_BYTES; close()
+// escreve o resto. O 'elapsedNs' de cada registro, em nanossegundos desde o início da gravação,
+// não diminui de um registro para o outro.
+class SessionRecorder {
+public:
+    ~SessionRecorder() { close(); }
+
+    bool open(const char* path, SessionHeader header, const std::string& command) {
+        close();
+        file = std::fopen(path, "wb");
+        if (!file) return false;
+        std::memcpy(header.magic, SESSION_LOG_MAGIC, sizeof(header.magic));
+        header.version = SESSION_LOG_VERSION;
+        header.commandBytes = (uint32_t)command.size();
+        header.reserved = 0;
+        failed = std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+                 std::fwrite(command.data(), 1, command.size(), file) != command.size();
+        written = sizeof(header) + command.size();
+        lastNs = 0;
+        lastTicks = lastStepTicks = 0;
+        frames = 0;
+        used = 0;
+        return !failed;
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    void key(uint64_t elapsedNs, unsigned char value, int x, int y) {
+        uint8_t* p = begin(SessionEventType::Key, elapsedNs);
+        *p++ = value;
+        writeVarint(p, zigzagEncode(x));
+        writeVarint(p, zigzagEncode(y));
+        commit(p);
+    }
+
+    void specialKey(uint64_t elapsedNs, int value, int x, int y) {
+        uint8_t* p = begin(SessionEventType::SpecialKey, elapsedNs);
+        writeVarint(p, zigzagEncode(value));
+        writeVarint(p, zigzagEncode(x));
+        writeVarint(p, zigzagEncode(y));
+        commit(p);
+    }
+
+    void reshape(uint64_t elapsedNs, int width, int height) {
+        uint8_t* p = begin(SessionEventType::Reshape, elapsedNs);
+        writeVarint(p, (uint64_t)std::max(width, 0));
+        writeVarint(p, (uint64_t)std::max(height, 0));
+        commit(p);
+    }
+
+    void frame(uint64_t elapsedNs, const SimulationClock& previousClock, const SimulationClock& clock, float alpha) {
+        uint8_t* p = begin(SessionEventType::Frame, elapsedNs);
+        writeVarint(p, zigzagEncode(previousClock.ticks - lastTicks));
+        std::memcpy(p, &previousClock.fraction, sizeof(double));
+        p += sizeof(double);
+        writeVarint(p, zigzagEncode(clock.ticks - previousClock.ticks));
+        std::memcpy(p, &clock.fraction, sizeof(double));
+        p += sizeof(double);
+        std::memcpy(p, &alpha, sizeof(float));
+        p += sizeof(float);
+        commit(p);
+        lastTicks = previousClock.ticks;
+        frames++;
+    }
+
+    void step(uint64_t elapsedNs, const SimulationClock& clock, uint8_t flags, double seekDays) {
+        uint8_t* p = begin(SessionEventType::Step, elapsedNs);
+        *p++ = flags;
+        writeVarint(p, zigzagEncode(clock.ticks - lastStepTicks));
+        std::memcpy(p, &clock.fraction, sizeof(double));
+        p += sizeof(double);
+        if (flags & SESSION_STEP_NEW_SEEK) {
+            std::memcpy(p, &seekDays, sizeof(double));
+            p += sizeof(double);
+        }
+        commit(p);
+        lastStepTicks = clock.ticks;
+    }
+
+    // Escreve o que falta e fecha o arquivo. Retorna false se alguma escrita falhou.
+    bool close() {
+        if (!file) return !failed;
+        flush();
+        failed = std::fclose(file) != 0 || failed;
+        file = nullptr;
+        return !failed;
+    }
+
+    uint64_t frameCount() const { return frames; }
+    uint64_t bytesWritten() const { return written + used; }
+
+private:
+    static const size_t FLUSH_BYTES = 64 * 1024;
+    static const size_t MAX_RECORD_BYTES = 64; // O quadro, o maior registro, tem até 51.
+
+    std::FILE* file = nullptr;
+    std::vector<uint8_t> buffer;
+    size_t used = 0;
+    uint64_t written = 0, frames = 0, lastNs = 0;
+    int64_t lastTicks = 0, lastStepTicks = 0;
+    bool failed = false;
+
+    // Reserva espaço para um registro e escreve o tipo e o instante.
+    uint8_t* begin(SessionEventType type, uint64_t elapsedNs) {
+        if (buffer.size() < used + MAX_RECORD_BYTES) buffer.resize(std::max(2 * buffer.size(), used + MAX_RECORD_BYTES));
+        uint8_t* p = buffer.data() + used;
+        *p++ = (uint8_t)type;
+        writeVarint(p, elapsedNs - lastNs);
+        lastNs = elapsedNs;
+        return p;
+    }
+
+    void commit(uint8_t* end) {
+        used = end - buffer.data();
+        if (used >= FLUSH_BYTES) flush();
+    }
+
+    void flush() {
+        if (used && file && std::fwrite(buffer.data(), 1, used, file) != used) failed = true;
+        written += used;
+        used = 0;
+    }
+};
+
+// Reprodução: o arquivo inteiro é lido na abertura e os registros saem um a um por next().
+class SessionPlayer {
+public:
+    bool open(const char* path) {
+        data.clear();
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file) return false;
+        uint8_t chunk[65536];
+        size_t count;
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + count);
+        std::fclose(file);
+        if (data.size() < sizeof(SessionHeader)) return false;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, SESSION_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != SESSION_LOG_VERSION || data.size() - sizeof(header) < header.commandBytes) {
+            return false;
+        }
+        command.assign((const char*)data.data() + sizeof(header), header.commandBytes);
+        position = sizeof(header) + header.commandBytes;
+        elapsedNs = 0;
+        ticks = stepTicks = 0;
+        truncated = false;
+        return true;
+    }
+
+    const SessionHeader& sessionHeader() const { return header; }
+    const std::string& commandLine() const { return command; }
+    // Se a leitura parou em um registro incompleto ou desconhecido.
+    bool wasTruncated() const { return truncated; }
+
+    // Lê o próximo registro. Retorna false no fim do arquivo ou em um registro inválido.
+    bool next(SessionEvent& event) {
+        if (position >= data.size()) return false;
+        const uint8_t* p = data.data() + position;
+        const uint8_t* end = data.data() + data.size();
+        event = SessionEvent();
+        event.type = (SessionEventType)*p++;
+        uint64_t delta = 0, a = 0, b = 0, c = 0;
+        bool ok = readVarint(p, end, delta);
+        elapsedNs += delta;
+        event.elapsedNs = elapsedNs;
+        switch (event.type) {
+            case SessionEventType::Frame:
+                ok = ok && readVarint(p, end, a) && end - p >= (ptrdiff_t)sizeof(double);
+                if (!ok) break;
+                ticks += zigzagDecode(a);
+                event.previousClock.ticks = ticks;
+                std::memcpy(&event.previousClock.fraction, p, sizeof(double));
+                p += sizeof(double);
+                ok = readVarint(p, end, b) && end - p >= (ptrdiff_t)(sizeof(double) + sizeof(float));
+                if (!ok) break;
+                event.clock.ticks = ticks + zigzagDecode(b);
+                std::memcpy(&event.clock.fraction, p, sizeof(double));
+                p += sizeof(double);
+                std::memcpy(&event.alpha, p, sizeof(float));
+                p += sizeof(float);
+                break;
+            case SessionEventType::Key:
+                ok = ok && p < end;
+                if (!ok) break;
+                event.key = *p++;
+                ok = readVarint(p, end, b) && readVarint(p, end, c);
+                event.x = (int)zigzagDecode(b);
+                event.y = (int)zigzagDecode(c);
+                break;
+            case SessionEventType::SpecialKey:
+                ok = ok && readVarint(p, end, a) && readVarint(p, end, b) && readVarint(p, end, c);
+                event.key = (int)zigzagDecode(a);
+                event.x = (int)zigzagDecode(b);
+                event.y = (int)zigzagDecode(c);
+                break;
+            case SessionEventType::Reshape:
+                ok = ok && readVarint(p, end, a) && readVarint(p, end, b);
+                event.x = (int)a;
+                event.y = (int)b;
+                break;
+            case SessionEventType::Step:
+                ok = ok && p < end;
+                if (!ok) break;
+                event.stepFlags = *p++;
+                ok = readVarint(p, end, a) && end - p >= (ptrdiff_t)sizeof(double);
+                if (!ok) break;
+                stepTicks += zigzagDecode(a);
+                event.clock.ticks = stepTicks;
+                std::memcpy(&event.clock.fraction, p, sizeof(double));
+                p += sizeof(double);
+                if (event.stepFlags & SESSION_STEP_NEW_SEEK) {
+                    ok = end - p >= (ptrdiff_t)sizeof(double);
+                    if (!ok) break;
+                    std::memcpy(&event.seekDays, p, sizeof(double));
+                    p += sizeof(double);
+                }
+                break;
+            default:
+                ok = false;
+        }
+        if (!ok) {
+            truncated = true;
+            position = data.size();
+            return false;
+        }
+        position = p - data.data();
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> data;
+    SessionHeader header{};
+    std::string command;
+    size_t position = 0;
+    uint64_t elapsedNs = 0;
+    int64_t ticks = 0, stepTicks = 0;
+    bool truncated = false;
+};
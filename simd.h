@@ -0,0 +1,47 @@
+/*
+ * =================================================================================================
+ * CONJUNTOS DE INSTRUÇÕES SIMD
+ *
+ * O que é comum aos núcleos vetorizados dos módulos: os atributos que compilam uma função para
+ * AVX2 ou AVX-512 sem exigir a opção do compilador no programa todo, a escolha do conjunto em
+ * tempo de execução e o controle dos falsos avisos dos intrínsecos de AVX-512.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_HAS_AVX2 1
+#define SIMD_HAS_AVX512 1
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+// Os intrínsecos de AVX-512 do GCC 12 iniciam o operando "undefined" com ele mesmo, o que gera
+// falsos avisos de variável não inicializada em -O2. As funções AVX-512 ficam entre estas duas
+// macros.
+#if defined(__GNUC__) && !defined(__clang__)
+#define SIMD_AVX512_WARNINGS_BEGIN \
+    _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define SIMD_AVX512_WARNINGS_END _Pragma("GCC diagnostic pop")
+#else
+#define SIMD_AVX512_WARNINGS_BEGIN
+#define SIMD_AVX512_WARNINGS_END
+#endif
+
+// Conjunto de instruções usado por um núcleo.
+enum class SimdKernel { Scalar, AVX2, AVX512 };
+
+// Conjunto de instruções mais rápido disponível nesta CPU.
+inline SimdKernel detectSimdKernel() {
+#ifdef SIMD_HAS_AVX512
+    if (__builtin_cpu_supports("avx512f")) return SimdKernel::AVX512;
+#endif
+#ifdef SIMD_HAS_AVX2
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdKernel::AVX2;
+#endif
+    return SimdKernel::Scalar;
+}
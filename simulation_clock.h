@@ -0,0 +1,76 @@
+/*
+ * =================================================================================================
+ * RELÓGIO DA SIMULAÇÃO
+ *
+ * Tempo da animação guardado como um número inteiro de unidades mais uma fração em [0, 1), em
+ * vez de um float que cresce sem limite. Os ângulos são calculados com a parte inteira reduzida
+ * exatamente módulo uma volta antes de qualquer conversão para float, então a precisão não
+ * depende de quanto tempo já passou, mesmo em acelerações de 10^7x.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Dia juliano da época J2000 (1 de janeiro de 2000, 12h TT), o instante 0 do relógio.
+const double J2000_JULIAN_DAY = 2451545.0;
+
+// Dia juliano de uma data do calendário gregoriano às 0h; 'day' pode ter fração (Meeus, cap. 7).
+inline double julianDayFromCalendar(int year, int month, double day) {
+    if (month <= 2) {
+        year--;
+        month += 12;
+    }
+    int a = year / 100, b = 2 - a + a / 4;
+    return std::floor(365.25 * (year + 4716)) + std::floor(30.6001 * (month + 1)) + day + b - 1524.5;
+}
+
+// Data do calendário gregoriano de um dia juliano, inverso de julianDayFromCalendar(); 'day'
+// sai com a fração do dia (Meeus, cap. 7).
+inline void calendarFromJulianDay(double julianDay, int& year, int& month, double& day) {
+    double z = std::floor(julianDay + 0.5), f = julianDay + 0.5 - z;
+    double alpha = std::floor((z - 1867216.25) / 36524.25);
+    double a = z + 1 + alpha - std::floor(alpha / 4);
+    double b = a + 1524, c = std::floor((b - 122.1) / 365.25);
+    double d = std::floor(365.25 * c), e = std::floor((b - d) / 30.6001);
+    day = b - d - std::floor(30.6001 * e) + f;
+    month = (int)(e < 14 ? e - 1 : e - 13);
+    year = (int)(month > 2 ? c - 4716 : c - 4715);
+}
+
+struct SimulationClock {
+    int64_t ticks = 0;     // Unidades inteiras de tempo da animação.
+    double fraction = 0.0; // Fração da unidade atual, em [0, 1).
+
+    // Avança 'units' unidades de tempo (não negativo).
+    void advance(double units) {
+        double total = fraction + units;
+        double whole = std::floor(total);
+        ticks += (int64_t)whole;
+        fraction = total - whole;
+    }
+
+    // Tempo total em unidades, só para exibição: perde precisão quando ticks é grande.
+    double units() const { return (double)ticks + fraction; }
+
+    bool operator==(const SimulationClock& other) const { return ticks == other.ticks && fraction == other.fraction; }
+    bool operator!=(const SimulationClock& other) const { return !(*this == other); }
+};
+
+// Reduz um ângulo em graus para [0, 360).
+inline double wrapDegrees(double degrees) {
+    degrees = std::fmod(degrees, 360.0);
+    return degrees < 0.0 ? degrees + 360.0 : degrees;
+}
+
+// Ângulo em graus, em [0, 360), de um movimento de 'degreesPerUnit' graus por unidade de tempo.
+// O produto ticks * degreesPerUnit é separado em parte alta e erro exato (fma) e cada parte é
+// reduzida módulo 360 antes da soma, então o resultado não perde precisão com o tempo.
+inline float clockAngle(const SimulationClock& clock, double degreesPerUnit) {
+    double ticks = (double)clock.ticks; // Exato até 2^53 unidades.
+    double high = ticks * degreesPerUnit;
+    double low = std::fma(ticks, degreesPerUnit, -high);
+    return (float)wrapDegrees(std::fmod(high, 360.0) + std::fmod(low + clock.fraction * degreesPerUnit, 360.0));
+}
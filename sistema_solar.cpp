@@ -15,11 +15,41 @@
  * =================================================================================================
  */
 
+#define GL_GLEXT_PROTOTYPES // Expõe os protótipos de VBO/IBO (GL 1.5+) declarados em glext.h.
 #include <GL/glut.h>
 #include <iostream> 
 #include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
 
+#include "thread_pool.h"
+#include "triple_buffer.h"
+#include "frame_pacer.h"
+#include "simulation_clock.h"
+#include "kepler.h"
+#include "belt.h"
+#include "nbody.h"
+#include "ephemeris.h"
+#include "planetary_theory.h"
+#include "trajectory_store.h"
+#include "event_search.h"
+#include "timeline.h"
+#include "session_log.h"
+#include "mipmap.h"
+#include "catalog.h"
+#include "texture_compression.h"
+#include "asset_pack.h"
+// A implementação do stb_image vem depois dos cabeçalhos que já incluem a sua interface.
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -30,10 +60,20 @@ using namespace std;
 // Variáveis da Câmera Orbital.
 float g_CameraAngle = 0.0f;    // Ângulo da câmera em torno da origem (do Sol).
 float g_CameraDistance = 100.0f; // Distância da câmera até a origem.
+const float CAMERA_HEIGHT = 40.0f; // Altura fixa da câmera acima do plano das órbitas.
+const float FIELD_OF_VIEW = 45.0f; // Abertura vertical da projeção perspectiva, em graus.
+int g_WindowWidth = 1280;          // Largura e altura da janela em pixels, atualizadas em reshape().
+int g_WindowHeight = 720;
 
-// Variáveis da Animação.
-float g_AnimationTime = 0.0f; // Um timer global que avança a cada quadro.
-float g_AnimationSpeed = 1.0f;  // Um multiplicador para acelerar ou desacelerar o tempo.
+// Ritmo dos quadros (frame_pacer.h). A taxa alvo é definida pela opção --fps; 0 desliga o limite.
+FramePacer g_FramePacer;
+double g_TargetFps = 60.0;
+
+// Variáveis da Animação. O relógio da simulação pertence à thread de simulação (ver SEÇÃO DE
+// SIMULAÇÃO); a velocidade é alterada pelo teclado e lida por ela a cada passo.
+atomic<float> g_AnimationSpeed{1.0f}; // Um multiplicador para acelerar ou desacelerar o tempo.
+const float MIN_ANIMATION_SPEED = 1e-3f, MAX_ANIMATION_SPEED = 1e7f; // Limites das teclas '+' e '-'.
+double g_StartDays = 0.0; // Instante inicial da animação em dias desde J2000 (--date).
 
 // Organiza todas as propriedades de um corpo celeste.
 struct CelestialBody {
@@ -41,154 +81,3441 @@ struct CelestialBody {
     float distance;      // Distância do corpo que ele orbita.
     float orbitSpeed;    // Período orbital em dias terrestres. Um valor maior significa órbita mais lenta.
     float rotationSpeed; // Período de rotação em seu eixo.
-    GLuint textureID;    // ID numérico pro OpenGL atribuir uma textura carregada.
+    float mass;          // Em massas solares; usada só no modo N-corpos.
+    int textureLayer;    // Camada do corpo no array de texturas (ver startTextureLoading).
+    OrbitalElements orbit; // Elementos orbitais, com o semieixo maior na escala da cena.
+};
+
+// Declaração das variáveis que irão armazenar os dados do sistema (preenchidas a partir do
+// catálogo em initBodies).
+CelestialBody g_Sun;
+vector<CelestialBody> g_Planets; // Vetor para guardar todos os planetas.
+CelestialBody g_Moon;            // Variável separada para a Lua.
+int g_MoonPlanet = -1;           // Índice em g_Planets do planeta orbitado pela Lua.
+int g_RingPlanet = -1;           // Índice em g_Planets do planeta com anéis.
+int g_RingLayer = -1;            // Camada de textura dos anéis.
+KeplerBatch g_PlanetOrbits;      // Órbitas dos planetas, na mesma ordem de g_Planets.
+KeplerBatch g_MoonOrbit;         // Órbita da Lua em torno do seu planeta.
+AssetPack g_AssetPack;           // Pacote de assets mapeado; vazio se ausente ou desatualizado.
+
+// --- SEÇÃO DE MALHAS ---
+
+// Vértice intercalado usado por todas as malhas: posição, normal e coordenada de textura.
+struct MeshVertex {
+    float px, py, pz;
+    float nx, ny, nz;
+    float s, t;
+};
+
+// Malha construída uma única vez em init(). Em contextos com VBO (GL 1.5+) os dados ficam
+// em buffers na GPU; em contextos GL 1.x eles são compilados em uma display list.
+struct Mesh {
+    GLuint vbo = 0;         // Buffer de vértices.
+    GLuint ibo = 0;         // Buffer de índices.
+    GLuint displayList = 0; // Caminho alternativo para GL 1.x.
+    GLsizei indexCount = 0; // Quantidade de índices (triângulos * 3).
+};
+
+Mesh g_SphereMesh; // Esfera de raio 1, escalada para cada corpo celeste.
+Mesh g_RingMesh;   // Coroa circular de raio externo 1 para os anéis de Saturno.
+bool g_HasVBO = false; // Indica se o contexto suporta vertex buffer objects.
+
+// --- SEÇÃO DE FUNÇÕES UTILITÁRIAS ---
+
+// Calcula a posição da câmera (X, Z) em um círculo ao redor da origem. A altura é CAMERA_HEIGHT.
+void cameraPosition(float& camX, float& camZ) {
+    camX = g_CameraDistance * cos(g_CameraAngle * M_PI / 180.0f);
+    camZ = g_CameraDistance * sin(g_CameraAngle * M_PI / 180.0f);
+}
+
+// Gerador congruencial de números em (0, 1). A sequência depende só da semente, então discos,
+// esferas e amostras dos benchmarks são os mesmos em toda execução.
+struct SeededRandom {
+    unsigned seed;
+
+    explicit SeededRandom(unsigned initialSeed) : seed(initialSeed) {}
+
+    double operator()() {
+        seed = seed * 1664525u + 1013904223u;
+        return ((seed >> 8) + 0.5) * (1.0 / 16777216.0);
+    }
+};
+
+// Verifica se a versão do contexto OpenGL atual é pelo menos major.minor.
+bool glVersionAtLeast(int major, int minor) {
+    const char* version = (const char*)glGetString(GL_VERSION);
+    int ctxMajor = 0, ctxMinor = 0;
+    if (!version || sscanf(version, "%d.%d", &ctxMajor, &ctxMinor) != 2) return false;
+    return ctxMajor > major || (ctxMajor == major && ctxMinor >= minor);
+}
+
+// Verifica se o contexto OpenGL atual anuncia uma extensão.
+bool glHasExtension(const char* name) {
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    if (!extensions) return false;
+    size_t length = strlen(name);
+    for (const char* p = strstr(extensions, name); p; p = strstr(p + length, name)) {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) return true;
+    }
+    return false;
+}
+
+// --- SEÇÃO DE TEXTURAS ---
+
+// Todas as imagens são reamostradas para um tamanho comum e empacotadas como camadas de um
+// único GL_TEXTURE_2D_ARRAY, de modo que nenhum corpo precise de glBindTexture próprio.
+// Contextos sem arrays de textura (GL < 3.0) recebem uma textura 2D por camada.
+//
+// O carregamento é assíncrono: as threads de trabalho decodificam as imagens e geram os
+// mipmaps em paralelo, e a thread do OpenGL envia os resultados aos poucos, por prioridade.
+// Enquanto a imagem completa não chega, cada camada mostra uma versão de baixa resolução.
+//
+// No caminho com array, só os níveis a partir de RESIDENCY_TIERS ficam sempre na GPU. Os níveis
+// mais detalhados (0 a RESIDENCY_TIERS - 1) ficam em arrays de "vagas", um por nível, divididas
+// entre as camadas conforme o tamanho de cada corpo na tela (ver SEÇÃO DE RESIDÊNCIA).
+const int MAX_TEXTURE_LAYERS = 64;     // Mesmo tamanho do vetor u_LayerMinLod no shader.
+const int PLACEHOLDER_MAX_WIDTH = 64;  // Largura máxima da versão provisória de cada camada.
+const double UPLOAD_BUDGET_MS = 4.0;   // Tempo máximo gasto com envios a cada quadro.
+const int RESIDENCY_TIERS = 3;         // Níveis com residência sob demanda (mesmo valor do shader).
+
+// Com GL_EXT_texture_compression_s3tc, as camadas ficam na GPU codificadas em BC3 (DXT5), com
+// 4x menos memória que RGBA8. A opção --no-compression desliga a compressão.
+bool g_CompressTextures = true;
+GLenum g_TextureFormat = GL_RGBA8; // GL_RGBA8 ou GL_COMPRESSED_RGBA_S3TC_DXT5_EXT.
+
+// Orçamento de memória de textura, em MB (opção --texture-budget).
+float g_TextureBudgetMB = 24.0f;
+
+// Origem de um resultado produzido pelas threads de trabalho.
+enum class TextureResultKind {
+    Placeholder, // Versão provisória de baixa resolução.
+    Full,        // Cadeia completa do carregamento inicial.
+    Stream,      // Níveis detalhados pedidos de volta pela residência.
+};
+
+// Níveis produzidos por uma thread de trabalho, aguardando o envio pela thread do OpenGL.
+struct TextureResult {
+    int layer;
+    int firstLevel;          // Nível de mipmap de levels[0]; os seguintes vêm em sequência.
+    TextureResultKind kind;
+    vector<MipLevel> levels;
+    double decodeMs, mipMs, encodeMs; // Tempos medidos na thread de trabalho.
+    int stagingSlot = -1;             // Vaga do anel de PBOs com os níveis, ou -1 (memória do programa).
+    vector<size_t> stagingOffsets;    // Deslocamento de cada nível dentro do PBO.
+};
+
+// Estado de cada camada do ponto de vista da thread do OpenGL.
+struct TextureLayer {
+    string filename;
+    float minLod = 0.0f;     // Nível mais detalhado disponível; o shader não amostra abaixo dele.
+    int baseLevel = 0;       // Nível mais detalhado já enviado para o array base (ou a textura 2D).
+    bool complete = false;   // A cadeia completa do carregamento inicial já chegou.
+    double decodeMs = 0.0, mipMs = 0.0, encodeMs = 0.0, uploadMs = 0.0;
+    int slot[RESIDENCY_TIERS] = {-1, -1, -1}; // Vaga ocupada em cada nível detalhado, ou -1.
+    int wantedLevel = 0;     // Nível necessário no quadro atual, segundo a residência.
+    bool streaming = false;  // Há um pedido de níveis detalhados em andamento.
+    chrono::steady_clock::time_point streamStart;
+    const PackTexture* packTexture = nullptr; // Entrada no pacote de assets, se ele estiver aberto.
+};
+
+// Um nível detalhado: um array com uma vaga por camada que cabe no orçamento.
+struct DetailTier {
+    GLuint texture = 0;
+    int width = 0, height = 0;
+    size_t slotBytes = 0;
+    vector<int> slotLayer;         // Camada dona de cada vaga, ou -1.
+    vector<bool> slotReady;        // O nível já foi enviado para a vaga.
+    vector<unsigned> slotLastUsed; // Último quadro em que a vaga foi necessária.
+};
+
+// Contadores expostos pela residência (tecla 'r').
+struct ResidencyStats {
+    unsigned evictions = 0, streamIns = 0;
+    double streamInTotalMs = 0.0, streamInMaxMs = 0.0;
+};
+
+vector<TextureLayer> g_Layers;
+GLuint g_TextureArray = 0;         // Array base com todas as camadas (GL 3.0+).
+vector<GLuint> g_LayerTextures;    // Uma textura 2D por camada (caminho alternativo).
+int g_LayerWidth = 0, g_LayerHeight = 0, g_LayerLevels = 0;
+bool g_LayerLodDirty = true;       // Indica que u_LayerMinLod precisa ser reenviado ao shader.
+int g_PendingLayers = 0;           // Camadas cuja cadeia completa ainda não foi enviada.
+chrono::steady_clock::time_point g_TextureLoadStart;
+
+DetailTier g_DetailTiers[RESIDENCY_TIERS];
+int g_TierCount = 0;               // Níveis detalhados em uso; 0 no caminho sem array.
+ResidencyStats g_Residency;
+int g_PackSkip = 0;                // Nível do pacote que corresponde ao nível 0 das camadas.
+
+mutex g_TextureResultsMutex;
+vector<TextureResult> g_TextureResults; // Protegido por g_TextureResultsMutex.
+
+// Anel de PBOs para os envios de textura. Com GL_ARB_buffer_storage, um único
+// GL_PIXEL_UNPACK_BUFFER fica mapeado de forma persistente durante todo o programa, dividido em
+// vagas do tamanho de uma cadeia de mipmaps completa. As threads de trabalho copiam os níveis
+// prontos direto para uma vaga livre, e a thread do OpenGL só emite glTexSubImage a partir do
+// PBO, sem copiar nada. A vaga volta a ficar livre quando o fence colocado depois do envio é
+// sinalizado. Sem a extensão (ou sem vaga livre), os níveis são enviados da memória do programa.
+const size_t STAGING_RING_BYTES = 32 << 20;
+
+struct StagingSlot {
+    GLsync fence = nullptr;  // Fence do último envio feito a partir da vaga, ou nullptr.
+    size_t bytes = 0;        // Bytes enviados nesse envio.
+    chrono::steady_clock::time_point issued;
+};
+
+// Contadores dos envios de textura (tecla 'u').
+struct UploadStats {
+    size_t stagedBytes = 0, directBytes = 0; // Enviados a partir do PBO / da memória do programa.
+    unsigned stagingMisses = 0;   // Resultados que não encontraram vaga livre no anel.
+    double issueMs = 0.0;         // Tempo da thread do OpenGL emitindo envios a partir do PBO.
+    unsigned stagedTicks = 0;     // Quadros com pelo menos um envio a partir do PBO.
+    size_t fencedBytes = 0;       // Bytes cujos fences já foram sinalizados...
+    double fencedMs = 0.0;        // ...e o tempo somado entre a emissão e a sinalização.
+    double clientMsPerMB = 0.0;   // Custo medido de um envio síncrono a partir da memória do programa.
+};
+
+GLuint g_StagingBuffer = 0;
+unsigned char* g_StagingMemory = nullptr; // Mapeamento persistente de g_StagingBuffer.
+size_t g_StagingSlotSize = 0;
+vector<StagingSlot> g_StagingSlots;
+mutex g_StagingMutex;
+vector<int> g_FreeStagingSlots;           // Protegido por g_StagingMutex.
+UploadStats g_Upload;                     // stagingMisses é protegido por g_StagingMutex.
+
+// Milissegundos decorridos desde 'start'.
+double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Função que registra uma imagem como uma nova camada de textura e retorna o índice da camada.
+// A decodificação e o envio para a GPU começam em startTextureLoading().
+int loadTexture(const char* filename) {
+    TextureLayer layer;
+    layer.filename = filename;
+    g_Layers.push_back(layer);
+    return (int)g_Layers.size() - 1;
+}
+
+// Quantidade de níveis de uma cadeia de mipmaps completa (até 1x1).
+int mipLevelCount(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = max(width / 2, 1);
+        height = max(height / 2, 1);
+        levels++;
+    }
+    return levels;
+}
+
+// Retira uma vaga livre do anel de PBOs para 'bytes' bytes, ou retorna -1 se não houver anel,
+// os bytes não couberem numa vaga ou todas estiverem em uso. Chamada pelas threads de trabalho.
+int acquireStagingSlot(size_t bytes) {
+    if (!g_StagingMemory || bytes > g_StagingSlotSize) return -1;
+    lock_guard<mutex> lock(g_StagingMutex);
+    if (g_FreeStagingSlots.empty()) {
+        g_Upload.stagingMisses++;
+        return -1;
+    }
+    int slot = g_FreeStagingSlots.back();
+    g_FreeStagingSlots.pop_back();
+    return slot;
+}
+
+// Move os níveis de um resultado para uma vaga livre do anel de PBOs. Sem vaga, os níveis
+// continuam na memória do programa.
+void stageTextureResult(TextureResult& result) {
+    size_t total = 0;
+    for (const MipLevel& level : result.levels) total += level.pixels.size();
+    int slot = acquireStagingSlot(total);
+    if (slot < 0) return;
+    size_t offset = (size_t)slot * g_StagingSlotSize;
+    for (MipLevel& level : result.levels) {
+        memcpy(g_StagingMemory + offset, level.pixels.data(), level.pixels.size());
+        result.stagingOffsets.push_back(offset);
+        offset += level.pixels.size();
+        vector<unsigned char>().swap(level.pixels);
+    }
+    result.stagingSlot = slot;
+}
+
+// Entrega um resultado para a thread do OpenGL. As versões provisórias são pequenas e vão
+// direto da memória do programa, sem ocupar uma vaga do anel.
+void postTextureResult(TextureResult result) {
+    if (result.kind != TextureResultKind::Placeholder && result.stagingSlot < 0) stageTextureResult(result);
+    lock_guard<mutex> lock(g_TextureResultsMutex);
+    g_TextureResults.push_back(move(result));
+}
+
+// Tarefa executada em uma thread de trabalho: decodifica a imagem da camada, publica uma versão
+// provisória de baixa resolução e, em seguida, a cadeia de mipmaps completa. Com 'compress', os
+// níveis são publicados já codificados em BC3.
+void decodeTextureJob(int layer, string filename, int width, int height, bool compress) {
+    auto start = chrono::steady_clock::now();
+    int imageWidth, imageHeight, nrChannels;
+    // Todas as camadas compartilham o formato RGBA, então a imagem é expandida na decodificação.
+    unsigned char* data = stbi_load(filename.c_str(), &imageWidth, &imageHeight, &nrChannels, 4);
+    MipLevel base;
+    if (data) {
+        base = {imageWidth, imageHeight, vector<unsigned char>(data, data + (size_t)imageWidth * imageHeight * 4)};
+        stbi_image_free(data);
+    } else {
+        cerr << "Falha ao carregar textura: " << filename << endl;
+        base = {1, 1, {255, 255, 255, 255}}; // Camada branca, como um corpo sem textura.
+    }
+    double decodeMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    if (base.width != width || base.height != height) base = resampleImage(base, width, height);
+
+    // Versão provisória: o primeiro nível com largura até PLACEHOLDER_MAX_WIDTH, obtido direto do
+    // nível 0 por reamostragem, mais os níveis menores que ele.
+    int placeholderLevel = 0;
+    int placeholderWidth = width, placeholderHeight = height;
+    while (placeholderWidth > PLACEHOLDER_MAX_WIDTH) {
+        placeholderWidth = max(placeholderWidth / 2, 1);
+        placeholderHeight = max(placeholderHeight / 2, 1);
+        placeholderLevel++;
+    }
+    if (placeholderLevel > 0) {
+        vector<MipLevel> thumbnail = generateMipChain(resampleImage(base, placeholderWidth, placeholderHeight));
+        if (compress) thumbnail = compressMipChainBC3(thumbnail);
+        postTextureResult({layer, placeholderLevel, TextureResultKind::Placeholder, move(thumbnail), decodeMs, 0.0, 0.0, -1, {}});
+    }
+
+    TextureResult result = {layer, 0, TextureResultKind::Full, generateMipChain(base), decodeMs, 0.0, 0.0, -1, {}};
+    result.mipMs = elapsedMs(start);
+    if (compress) {
+        start = chrono::steady_clock::now();
+        result.levels = compressMipChainBC3(result.levels);
+        result.encodeMs = elapsedMs(start);
+    }
+    postTextureResult(move(result));
+}
+
+// Tarefa executada em uma thread de trabalho: produz de novo os níveis [firstLevel, lastLevel] de
+// uma camada cujos níveis detalhados foram descartados. Com o pacote de assets aberto, os níveis
+// são copiados do mapeamento; sem ele, a imagem é decodificada outra vez.
+void streamTextureJob(int layer, string filename, const unsigned char* packBase, const PackTexture* packTexture,
+                      int firstLevel, int lastLevel, int width, int height, bool compress) {
+    TextureResult result = {layer, firstLevel, TextureResultKind::Stream, {}, 0.0, 0.0, 0.0, -1, {}};
+    if (packTexture) {
+        // Os níveis são copiados do mapeamento direto para uma vaga do anel de PBOs, se houver.
+        size_t total = 0;
+        int w = width, h = height;
+        for (int level = 0; level <= lastLevel; level++) {
+            if (level >= firstLevel) total += compress ? bc3LevelSize(w, h) : (size_t)w * h * 4;
+            w = max(w / 2, 1);
+            h = max(h / 2, 1);
+        }
+        result.stagingSlot = acquireStagingSlot(total);
+        size_t stagingOffset = result.stagingSlot >= 0 ? (size_t)result.stagingSlot * g_StagingSlotSize : 0;
+        for (int level = 0; level <= lastLevel; level++) {
+            if (level >= firstLevel) {
+                uint64_t offset = compress ? packTexture->blockOffset[g_PackSkip + level]
+                                           : packTexture->levelOffset[g_PackSkip + level];
+                size_t size = compress ? bc3LevelSize(width, height) : (size_t)width * height * 4;
+                if (result.stagingSlot >= 0) {
+                    memcpy(g_StagingMemory + stagingOffset, packBase + offset, size);
+                    result.stagingOffsets.push_back(stagingOffset);
+                    stagingOffset += size;
+                    result.levels.push_back({width, height, {}});
+                } else {
+                    result.levels.push_back({width, height, vector<unsigned char>(packBase + offset, packBase + offset + size)});
+                }
+            }
+            width = max(width / 2, 1);
+            height = max(height / 2, 1);
+        }
+    } else {
+        vector<MipLevel> levels = generateMipChain(decodeLayerImage(filename.c_str(), width, height));
+        for (int level = firstLevel; level <= lastLevel; level++) {
+            result.levels.push_back(compress ? compressLevelBC3(levels[level]) : move(levels[level]));
+        }
+    }
+    postTextureResult(move(result));
+}
+
+// Bytes ocupados por um nível width x height de uma camada no formato atual.
+size_t textureLevelSize(int width, int height) {
+    if (g_TextureFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) return bc3LevelSize(width, height);
+    return (size_t)width * height * 4;
+}
+
+// Envia um nível de mipmap de uma camada para a GPU, em RGBA8 ou já codificado em BC3,
+// conforme g_TextureFormat. Os níveis detalhados vão para a vaga da camada no array do nível;
+// retorna false se a camada não tiver vaga nesse nível.
+bool uploadTextureLevel(int layer, int level, int width, int height, const unsigned char* pixels) {
+    bool compressed = g_TextureFormat != GL_RGBA8;
+    GLsizei size = (GLsizei)textureLevelSize(width, height);
+    if (g_TextureArray) {
+        GLuint texture = g_TextureArray;
+        int target = level - g_TierCount, z = layer;
+        if (level < g_TierCount) {
+            z = g_Layers[layer].slot[level];
+            if (z < 0) return false;
+            texture = g_DetailTiers[level].texture;
+            target = 0;
+        }
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        if (compressed) {
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, target, 0, 0, z, width, height, 1,
+                                      g_TextureFormat, size, pixels);
+        } else {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, target, 0, 0, z, width, height, 1,
+                            GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+    } else {
+        glBindTexture(GL_TEXTURE_2D, g_LayerTextures[layer]);
+        if (compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, g_TextureFormat, width, height, 0, size, pixels);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+    }
+    return true;
+}
+
+// Recalcula o nível mais detalhado que pode ser amostrado em uma camada: o do array base,
+// estendido pelos níveis detalhados prontos em sequência.
+void updateLayerMinLod(int layer) {
+    TextureLayer& state = g_Layers[layer];
+    int minLod = state.baseLevel;
+    while (minLod > 0 && minLod <= g_TierCount) {
+        int slot = state.slot[minLod - 1];
+        if (slot < 0 || !g_DetailTiers[minLod - 1].slotReady[slot]) break;
+        minLod--;
+    }
+    if (state.minLod == (float)minLod) return;
+    state.minLod = (float)minLod;
+    if (g_TextureArray) {
+        g_LayerLodDirty = true;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, g_LayerTextures[layer]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, minLod);
+    }
+}
+
+// Envia níveis de mipmap de uma camada para a GPU. Os níveis detalhados só são enviados se a
+// camada tiver vaga reservada para eles. Com 'stagingOffsets', os pixels estão no PBO ligado em
+// GL_PIXEL_UNPACK_BUFFER e o ponteiro passado ao OpenGL é o deslocamento dentro dele.
+void uploadTextureLevels(int layer, int firstLevel, const vector<MipLevel>& levels,
+                         const vector<size_t>* stagingOffsets = nullptr) {
+    TextureLayer& state = g_Layers[layer];
+    for (size_t i = 0; i < levels.size(); i++) {
+        const MipLevel& level = levels[i];
+        int target = firstLevel + (int)i;
+        const unsigned char* pixels = stagingOffsets ? (const unsigned char*)(uintptr_t)(*stagingOffsets)[i]
+                                                     : level.pixels.data();
+        if (!uploadTextureLevel(layer, target, level.width, level.height, pixels)) continue;
+        if (target < g_TierCount) g_DetailTiers[target].slotReady[state.slot[target]] = true;
+    }
+    state.baseLevel = min(state.baseLevel, max(firstLevel, g_TierCount));
+    updateLayerMinLod(layer);
+}
+
+// Associa cada camada à sua entrada no pacote de assets. Retorna false se o pacote não tiver
+// alguma das texturas ou não tiver um nível com o tamanho das camadas (por exemplo, quando o
+// driver limita o tamanho máximo).
+bool bindLayersToPack(const AssetPack& pack) {
+    int packWidth = pack.header->layerWidth, packHeight = pack.header->layerHeight;
+    g_PackSkip = 0;
+    while ((packWidth != g_LayerWidth || packHeight != g_LayerHeight) && (packWidth > 1 || packHeight > 1)) {
+        packWidth = max(packWidth / 2, 1);
+        packHeight = max(packHeight / 2, 1);
+        g_PackSkip++;
+    }
+    if (packWidth != g_LayerWidth || packHeight != g_LayerHeight) return false;
+
+    for (const auto& layer : g_Layers) {
+        const PackTexture* texture = findPackTexture(pack, layer.filename.c_str());
+        if (!texture || (int)texture->levelCount != g_PackSkip + g_LayerLevels) return false;
+    }
+    for (auto& layer : g_Layers) layer.packTexture = findPackTexture(pack, layer.filename.c_str());
+    return true;
+}
+
+// Envia as camadas direto do pacote de assets mapeado, sem decodificação. No caminho com array,
+// só os níveis do array base são enviados; os detalhados vêm depois, conforme a residência.
+void uploadLayersFromPack(const AssetPack& pack) {
+    const char* base = (const char*)pack.mapping;
+    for (size_t layer = 0; layer < g_Layers.size(); layer++) {
+        auto start = chrono::steady_clock::now();
+        const PackTexture& texture = *g_Layers[layer].packTexture;
+        int width = g_LayerWidth, height = g_LayerHeight;
+        for (int level = 0; level < g_LayerLevels; level++) {
+            if (level >= g_TierCount) {
+                uint64_t offset = g_TextureFormat == GL_RGBA8 ? texture.levelOffset[g_PackSkip + level]
+                                                              : texture.blockOffset[g_PackSkip + level];
+                uploadTextureLevel((int)layer, level, width, height, (const unsigned char*)base + offset);
+                g_Upload.directBytes += textureLevelSize(width, height);
+            }
+            width = max(width / 2, 1);
+            height = max(height / 2, 1);
+        }
+        g_Layers[layer].baseLevel = g_TierCount;
+        g_Layers[layer].complete = true;
+        g_Layers[layer].uploadMs = elapsedMs(start);
+        updateLayerMinLod((int)layer);
+    }
+}
+
+// Configura repetição e filtragem com mipmaps para o alvo de textura atualmente ligado.
+void setTextureParameters(GLenum target) {
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+// Reserva um GL_TEXTURE_2D_ARRAY com 'levels' níveis a partir de width x height.
+GLuint allocateTextureArray(int width, int height, int depth, int levels) {
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    setTextureParameters(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    for (int level = 0; level < levels; level++) {
+        if (g_TextureFormat == GL_RGBA8) {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, width, height, depth, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        } else {
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, g_TextureFormat, width, height, depth, 0,
+                                   (GLsizei)(textureLevelSize(width, height) * depth), nullptr);
+        }
+        width = max(width / 2, 1);
+        height = max(height / 2, 1);
+    }
+    return texture;
+}
+
+// Bytes dos níveis [firstLevel, g_LayerLevels) de uma camada.
+size_t layerChainBytes(int firstLevel) {
+    size_t bytes = 0;
+    int width = g_LayerWidth, height = g_LayerHeight;
+    for (int level = 0; level < g_LayerLevels; level++) {
+        if (level >= firstLevel) bytes += textureLevelSize(width, height);
+        width = max(width / 2, 1);
+        height = max(height / 2, 1);
+    }
+    return bytes;
+}
+
+// Memória de textura reservada na GPU (array base e vagas de todos os níveis), em MB.
+double textureMemoryMB() {
+    size_t bytes = layerChainBytes(g_TierCount) * g_Layers.size();
+    for (int tier = 0; tier < g_TierCount; tier++) {
+        bytes += g_DetailTiers[tier].slotBytes * g_DetailTiers[tier].slotLayer.size();
+    }
+    return bytes / (1024.0 * 1024.0);
+}
+
+// Memória de textura ocupada por níveis realmente enviados, em MB.
+double residentTextureMB() {
+    size_t bytes = layerChainBytes(g_TierCount) * g_Layers.size();
+    for (int tier = 0; tier < g_TierCount; tier++) {
+        const DetailTier& detail = g_DetailTiers[tier];
+        for (bool ready : detail.slotReady) bytes += ready ? detail.slotBytes : 0;
+    }
+    return bytes / (1024.0 * 1024.0);
+}
+
+// Divide o orçamento de memória entre os níveis detalhados. O array base é sempre reservado; o
+// restante é distribuído em rodadas, uma vaga por nível do menos para o mais detalhado, até
+// acabar o orçamento ou cada nível ter uma vaga por camada.
+void allocateDetailTiers(int layerCount) {
+    g_TierCount = min(RESIDENCY_TIERS, g_LayerLevels - 1);
+    double remaining = g_TextureBudgetMB * 1024.0 * 1024.0 - (double)layerChainBytes(g_TierCount) * layerCount;
+    int slots[RESIDENCY_TIERS] = {0, 0, 0};
+    for (int tier = 0; tier < g_TierCount; tier++) {
+        DetailTier& detail = g_DetailTiers[tier];
+        detail.width = max(g_LayerWidth >> tier, 1);
+        detail.height = max(g_LayerHeight >> tier, 1);
+        detail.slotBytes = textureLevelSize(detail.width, detail.height);
+    }
+    for (bool grew = true; grew;) {
+        grew = false;
+        for (int tier = g_TierCount - 1; tier >= 0; tier--) {
+            if (slots[tier] == layerCount || remaining < g_DetailTiers[tier].slotBytes) continue;
+            slots[tier]++;
+            remaining -= g_DetailTiers[tier].slotBytes;
+            grew = true;
+        }
+    }
+    for (int tier = 0; tier < g_TierCount; tier++) {
+        DetailTier& detail = g_DetailTiers[tier];
+        detail.slotLayer.assign(slots[tier], -1);
+        detail.slotReady.assign(slots[tier], false);
+        detail.slotLastUsed.assign(slots[tier], 0);
+        if (slots[tier] > 0) detail.texture = allocateTextureArray(detail.width, detail.height, slots[tier], 1);
+    }
+}
+
+// Mede o custo de um envio síncrono a partir da memória do programa (1 MB em RGBA8), usado como
+// referência para estimar o tempo que o anel de PBOs poupa à thread do OpenGL.
+double measureClientUploadMsPerMB() {
+    const int size = 512;
+    vector<unsigned char> pixels((size_t)size * size * 4, 128);
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glFinish();
+    auto start = chrono::steady_clock::now();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glFinish();
+    double ms = elapsedMs(start);
+    glDeleteTextures(1, &texture);
+    return ms;
+}
+
+// Cria o anel de PBOs com vagas do tamanho de uma cadeia completa no formato atual. Exige
+// GL_ARB_buffer_storage (núcleo no GL 4.4) para o mapeamento persistente; sem ele, os envios
+// continuam saindo da memória do programa.
+void createStagingRing() {
+    if (!glVersionAtLeast(4, 4) && !glHasExtension("GL_ARB_buffer_storage")) return;
+    g_StagingSlotSize = layerChainBytes(0);
+    int slotCount = (int)max<size_t>(2, STAGING_RING_BYTES / g_StagingSlotSize);
+    GLsizeiptr bytes = (GLsizeiptr)(g_StagingSlotSize * slotCount);
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &g_StagingBuffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, g_StagingBuffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, flags);
+    g_StagingMemory = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, flags);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!g_StagingMemory) {
+        glDeleteBuffers(1, &g_StagingBuffer);
+        g_StagingBuffer = 0;
+        return;
+    }
+    g_StagingSlots.resize(slotCount);
+    for (int slot = slotCount - 1; slot >= 0; slot--) g_FreeStagingSlots.push_back(slot);
+    g_Upload.clientMsPerMB = measureClientUploadMsPerMB();
+    cout << "Anel de PBOs: " << slotCount << " vagas de " << g_StagingSlotSize / (1024.0 * 1024.0) << " MB" << endl;
+}
+
+// Devolve ao anel as vagas cujos envios a GPU já consumiu. Chamada pela thread do OpenGL.
+void reclaimStagingSlots() {
+    for (size_t slot = 0; slot < g_StagingSlots.size(); slot++) {
+        StagingSlot& staging = g_StagingSlots[slot];
+        if (!staging.fence || glClientWaitSync(staging.fence, 0, 0) == GL_TIMEOUT_EXPIRED) continue;
+        glDeleteSync(staging.fence);
+        staging.fence = nullptr;
+        g_Upload.fencedBytes += staging.bytes;
+        g_Upload.fencedMs += elapsedMs(staging.issued);
+        lock_guard<mutex> lock(g_StagingMutex);
+        g_FreeStagingSlots.push_back((int)slot);
+    }
+}
+
+// Reserva a memória de textura de todas as camadas e as preenche a partir do pacote de assets.
+// Sem pacote válido, preenche cada camada com um texel cinza e dispara a decodificação das
+// imagens em ordem de prioridade (menor valor primeiro).
+// Chamada uma vez, depois do último loadTexture() e de initInstancing().
+void startTextureLoading(bool useArray, const vector<float>& layerPriority) {
+    g_TextureLoadStart = chrono::steady_clock::now();
+
+    // Só os cabeçalhos são lidos aqui; o tamanho comum é o da maior imagem, limitado pelo driver.
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    for (const auto& layer : g_Layers) {
+        int width = 1, height = 1, nrChannels;
+        stbi_info(layer.filename.c_str(), &width, &height, &nrChannels);
+        g_LayerWidth = max(g_LayerWidth, width);
+        g_LayerHeight = max(g_LayerHeight, height);
+    }
+    g_LayerWidth = min(g_LayerWidth, (int)maxSize);
+    g_LayerHeight = min(g_LayerHeight, (int)maxSize);
+    // Sem suporte a texturas NPOT, o tamanho é reduzido à potência de dois mais próxima abaixo.
+    if (!useArray && !glVersionAtLeast(2, 0) && !glHasExtension("GL_ARB_texture_non_power_of_two")) {
+        while (g_LayerWidth & (g_LayerWidth - 1)) g_LayerWidth &= g_LayerWidth - 1;
+        while (g_LayerHeight & (g_LayerHeight - 1)) g_LayerHeight &= g_LayerHeight - 1;
+    }
+    g_LayerLevels = mipLevelCount(g_LayerWidth, g_LayerHeight);
+    bool s3tc = glHasExtension("GL_EXT_texture_compression_s3tc");
+    g_TextureFormat = g_CompressTextures && s3tc ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_RGBA8;
+
+    GLsizei layerCount = (GLsizei)g_Layers.size();
+    if (useArray && layerCount <= MAX_TEXTURE_LAYERS) {
+        allocateDetailTiers(layerCount);
+        g_TextureArray = allocateTextureArray(max(g_LayerWidth >> g_TierCount, 1), max(g_LayerHeight >> g_TierCount, 1),
+                                              layerCount, g_LayerLevels - g_TierCount);
+    } else {
+        g_LayerTextures.resize(layerCount);
+        glGenTextures(layerCount, g_LayerTextures.data());
+        for (GLuint texture : g_LayerTextures) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            setTextureParameters(GL_TEXTURE_2D);
+        }
+    }
+    for (auto& layer : g_Layers) layer.baseLevel = g_LayerLevels;
+    createStagingRing();
+
+    // Com um pacote de assets válido, as camadas são enviadas agora, direto do mapeamento. O
+    // pacote continua mapeado enquanto houver níveis detalhados a trazer de volta.
+    if (g_AssetPack.mapping && bindLayersToPack(g_AssetPack)) {
+        uploadLayersFromPack(g_AssetPack);
+        if (g_TierCount == 0) closeAssetPack(g_AssetPack);
+        cout << "Texturas carregadas do pacote " << DEFAULT_PACK_PATH << " em " << elapsedMs(g_TextureLoadStart)
+             << " ms (" << textureMemoryMB() << " MB de textura reservados)" << endl;
+        return;
+    }
+    closeAssetPack(g_AssetPack);
+    for (auto& layer : g_Layers) layer.packTexture = nullptr;
+
+    // Até a versão provisória chegar, cada camada é um único texel cinza no último nível.
+    vector<MipLevel> grey = {{1, 1, {128, 128, 128, 255}}};
+    bool compress = g_TextureFormat != GL_RGBA8;
+    if (compress) grey = compressMipChainBC3(grey);
+    for (int layer = 0; layer < layerCount; layer++) {
+        uploadTextureLevels(layer, g_LayerLevels - 1, grey);
+    }
+
+    vector<int> order(layerCount);
+    for (int layer = 0; layer < layerCount; layer++) order[layer] = layer;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return layerPriority[a] < layerPriority[b]; });
+    for (int layer : order) {
+        string filename = g_Layers[layer].filename;
+        int width = g_LayerWidth, height = g_LayerHeight;
+        workerPool().submit([=] { decodeTextureJob(layer, filename, width, height, compress); });
+    }
+    g_PendingLayers = layerCount;
+
+    // Pacote ausente ou desatualizado: é refeito em segundo plano, depois das decodificações,
+    // para que a próxima inicialização não precise decodificar nada.
+    workerPool().submit([] {
+        if (bakeAssetPack(DEFAULT_PACK_PATH, BODY_CATALOG, BODY_CATALOG_SIZE, false)) {
+            cout << "Pacote de assets " << DEFAULT_PACK_PATH << " atualizado" << endl;
+        }
+    });
+}
+
+// Envia para a GPU os resultados prontos, respeitando UPLOAD_BUDGET_MS. As versões provisórias
+// vão primeiro; depois, cadeias completas e níveis detalhados seguem a prioridade de cada
+// camada (menor valor primeiro). Chamada pela thread do OpenGL a cada quadro.
+void pumpTextureUploads(const vector<float>& layerPriority) {
+    reclaimStagingSlots();
+    vector<TextureResult> ready;
+    {
+        lock_guard<mutex> lock(g_TextureResultsMutex);
+        ready.swap(g_TextureResults);
+    }
+    if (ready.empty()) return;
+    stable_sort(ready.begin(), ready.end(), [&](const TextureResult& a, const TextureResult& b) {
+        bool placeholderA = a.kind == TextureResultKind::Placeholder;
+        bool placeholderB = b.kind == TextureResultKind::Placeholder;
+        if (placeholderA != placeholderB) return placeholderA;
+        return layerPriority[a.layer] < layerPriority[b.layer];
+    });
+
+    auto budgetStart = chrono::steady_clock::now();
+    size_t next = 0;
+    bool staged = false;
+    while (next < ready.size() && (next == 0 || elapsedMs(budgetStart) < UPLOAD_BUDGET_MS)) {
+        TextureResult& result = ready[next++];
+        TextureLayer& layer = g_Layers[result.layer];
+        // Uma versão provisória que chega depois da cadeia completa é descartada.
+        if (result.kind == TextureResultKind::Placeholder && layer.complete) continue;
+
+        auto start = chrono::steady_clock::now();
+        if (result.stagingSlot >= 0) {
+            // Os envios a partir do PBO retornam sem esperar a cópia; o fence marca quando a
+            // vaga pode ser reescrita.
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, g_StagingBuffer);
+            uploadTextureLevels(result.layer, result.firstLevel, result.levels, &result.stagingOffsets);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            StagingSlot& staging = g_StagingSlots[result.stagingSlot];
+            staging.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            staging.issued = chrono::steady_clock::now();
+            staging.bytes = 0;
+            for (const MipLevel& level : result.levels) staging.bytes += textureLevelSize(level.width, level.height);
+            g_Upload.stagedBytes += staging.bytes;
+            g_Upload.issueMs += elapsedMs(start);
+            staged = true;
+        } else {
+            uploadTextureLevels(result.layer, result.firstLevel, result.levels);
+            for (const MipLevel& level : result.levels) g_Upload.directBytes += level.pixels.size();
+        }
+        if (result.kind == TextureResultKind::Stream) {
+            double latencyMs = elapsedMs(layer.streamStart);
+            layer.streaming = false;
+            g_Residency.streamIns++;
+            g_Residency.streamInTotalMs += latencyMs;
+            g_Residency.streamInMaxMs = max(g_Residency.streamInMaxMs, latencyMs);
+            continue;
+        }
+        layer.uploadMs += elapsedMs(start);
+        if (result.kind != TextureResultKind::Full) continue;
+
+        layer.complete = true;
+        layer.decodeMs = result.decodeMs;
+        layer.mipMs = result.mipMs;
+        layer.encodeMs = result.encodeMs;
+        cout << "Textura " << layer.filename << ": decodificacao " << layer.decodeMs << " ms, mipmaps "
+             << layer.mipMs << " ms, compressao " << layer.encodeMs << " ms, envio " << layer.uploadMs << " ms"
+             << endl;
+        if (--g_PendingLayers == 0) {
+            cout << "Todas as texturas carregadas em " << elapsedMs(g_TextureLoadStart) << " ms ("
+                 << textureMemoryMB() << " MB de textura reservados)" << endl;
+        }
+    }
+
+    if (staged) g_Upload.stagedTicks++;
+
+    // O que não coube no orçamento volta para a fila.
+    if (next < ready.size()) {
+        lock_guard<mutex> lock(g_TextureResultsMutex);
+        for (; next < ready.size(); next++) g_TextureResults.push_back(move(ready[next]));
+    }
+}
+
+// Liga a textura de uma camada no caminho de pipeline fixo.
+void bindLayerTexture(int layer) {
+    glBindTexture(GL_TEXTURE_2D, g_LayerTextures[layer]);
+}
+
+// Gera uma esfera unitária com a mesma topologia e coordenadas de textura do gluSphere
+// (eixo dos polos em Z, 's' ao redor do equador e 't' de +Z para -Z).
+void buildSphere(int slices, int stacks, vector<MeshVertex>& vertices, vector<GLuint>& indices) {
+    for (int i = 0; i <= stacks; i++) {
+        float rho = i * M_PI / stacks;
+        for (int j = 0; j <= slices; j++) {
+            float theta = (j == slices) ? 0.0f : j * 2.0f * M_PI / slices;
+            float x = -sin(theta) * sin(rho);
+            float y = cos(theta) * sin(rho);
+            float z = cos(rho);
+            vertices.push_back({x, y, z, x, y, z, (float)j / slices, 1.0f - (float)i / stacks});
+        }
+    }
+    for (int i = 0; i < stacks; i++) {
+        for (int j = 0; j < slices; j++) {
+            GLuint a = i * (slices + 1) + j; // Vértice na pilha atual.
+            GLuint b = a + slices + 1;       // Vértice correspondente na próxima pilha.
+            indices.insert(indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+}
+
+// Gera uma coroa circular de raio externo 1 no plano XZ, com a normal apontando para +Y.
+// A coordenada 's' cresce do raio interno para o externo, acompanhando a textura em faixa dos anéis.
+void buildRing(float innerRatio, int slices, vector<MeshVertex>& vertices, vector<GLuint>& indices) {
+    for (int j = 0; j <= slices; j++) {
+        float theta = (j == slices) ? 0.0f : j * 2.0f * M_PI / slices;
+        float c = cos(theta), sn = sin(theta);
+        float t = (float)j / slices;
+        vertices.push_back({innerRatio * c, 0.0f, innerRatio * sn, 0.0f, 1.0f, 0.0f, 0.0f, t});
+        vertices.push_back({c, 0.0f, sn, 0.0f, 1.0f, 0.0f, 1.0f, t});
+    }
+    for (int j = 0; j < slices; j++) {
+        GLuint a = 2 * j; // Vértice interno da fatia atual.
+        indices.insert(indices.end(), {a, a + 1, a + 2, a + 2, a + 1, a + 3});
+    }
+}
+
+// Aponta os vertex arrays para os dados intercalados (um ponteiro real ou um deslocamento no VBO).
+void setMeshPointers(const MeshVertex* base) {
+    glVertexPointer(3, GL_FLOAT, sizeof(MeshVertex), &base->px);
+    glNormalPointer(GL_FLOAT, sizeof(MeshVertex), &base->nx);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(MeshVertex), &base->s);
+}
+
+// Envia a malha para a GPU. Sem suporte a VBO, grava o desenho em uma display list.
+Mesh uploadMesh(const vector<MeshVertex>& vertices, const vector<GLuint>& indices) {
+    Mesh mesh;
+    mesh.indexCount = (GLsizei)indices.size();
+    if (g_HasVBO) {
+        glGenBuffers(1, &mesh.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(MeshVertex), vertices.data(), GL_STATIC_DRAW);
+        glGenBuffers(1, &mesh.ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        // Vertex arrays existem desde o GL 1.1; a display list copia os dados no momento da compilação.
+        mesh.displayList = glGenLists(1);
+        setMeshPointers(vertices.data());
+        glNewList(mesh.displayList, GL_COMPILE);
+        glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, indices.data());
+        glEndList();
+    }
+    return mesh;
+}
+
+// Desenha uma malha previamente enviada com uploadMesh().
+void drawMesh(const Mesh& mesh) {
+    if (mesh.displayList) {
+        glCallList(mesh.displayList);
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+    setMeshPointers(nullptr);
+    glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// Desenha a esfera unitária compartilhada escalada para o raio pedido.
+void drawSphere(float radius) {
+    glPushMatrix();
+    glScalef(radius, radius, radius);
+    drawMesh(g_SphereMesh);
+    glPopMatrix();
+}
+
+// Constrói as malhas compartilhadas. Chamada uma vez em init(), após os dados dos planetas.
+void initMeshes() {
+    g_HasVBO = glVersionAtLeast(1, 5);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    vector<MeshVertex> vertices;
+    vector<GLuint> indices;
+    buildSphere(50, 50, vertices, indices);
+    g_SphereMesh = uploadMesh(vertices, indices);
+
+    // Os anéis vão de (raio de Saturno + 0.5) até (raio de Saturno + 4.0).
+    if (g_RingPlanet >= 0) {
+        const CelestialBody& saturn = g_Planets[g_RingPlanet];
+        vertices.clear();
+        indices.clear();
+        buildRing((saturn.radius + 0.5f) / (saturn.radius + 4.0f), 50, vertices, indices);
+        g_RingMesh = uploadMesh(vertices, indices);
+    }
+}
+
+// Libera os buffers e display lists das malhas.
+void destroyMeshes() {
+    for (Mesh* mesh : {&g_SphereMesh, &g_RingMesh}) {
+        if (mesh->vbo) glDeleteBuffers(1, &mesh->vbo);
+        if (mesh->ibo) glDeleteBuffers(1, &mesh->ibo);
+        if (mesh->displayList) glDeleteLists(mesh->displayList, 1);
+        *mesh = Mesh();
+    }
+}
+
+// --- SEÇÃO DE ÓRBITAS ---
+
+// Cada órbita é pré-calculada em vários níveis de detalhe (16, 32, ..., 1024 segmentos),
+// todos guardados em um único buffer. A cada quadro escolhe-se um nível por órbita.
+const int ORBIT_LOD_COUNT = 7;
+const int ORBIT_MIN_SEGMENTS = 16;
+const float ORBIT_MAX_ERROR_PX = 0.5f; // Erro máximo tolerado entre a corda e o círculo, em pixels.
+
+struct OrbitPath {
+    float radius;                 // Raio da órbita, usado para estimar o tamanho na tela.
+    GLint first[ORBIT_LOD_COUNT]; // Primeiro vértice de cada nível de detalhe no buffer.
 };
 
-// Declaração das variáveis que irão armazenar os dados do sistema.
-vector<CelestialBody> g_Planets; // Vetor para guardar todos os planetas.
-CelestialBody g_Moon;            // Variável separada para a Lua.
-GLuint g_SunTexture, g_RingTexture, g_EarthTexture; // IDs para texturas especiais.
-GLUquadric* g_Quad; // Um objeto quadric da GLU, para mapear texturas em esferas.
+vector<OrbitPath> g_Orbits;
+vector<float> g_OrbitVertices; // Posições (x, y, z); usadas diretamente quando não há VBO.
+GLuint g_OrbitVBO = 0;
+bool g_HasMultiDraw = false; // glMultiDrawArrays existe a partir do GL 1.4.
+
+// Quantidade de segmentos de um nível de detalhe.
+int orbitSegments(int lod) {
+    return ORBIT_MIN_SEGMENTS << lod;
+}
+
+// Pré-calcula as órbitas de todos os planetas. Chamada uma vez em init().
+void bakeOrbits() {
+    g_HasMultiDraw = glVersionAtLeast(1, 4);
+    g_Orbits.clear();
+    g_OrbitVertices.clear();
+    for (size_t planet = 0; planet < g_Planets.size(); planet++) {
+        OrbitPath orbit;
+        orbit.radius = g_Planets[planet].distance; // Semieixo maior da elipse.
+        for (int lod = 0; lod < ORBIT_LOD_COUNT; lod++) {
+            int segments = orbitSegments(lod);
+            orbit.first[lod] = (GLint)(g_OrbitVertices.size() / 3);
+            // Faixa de linhas fechada: o último vértice repete o primeiro. Os vértices são
+            // espaçados igualmente na anomalia excêntrica.
+            for (int i = 0; i <= segments; i++) {
+                double anomaly = (i == segments) ? 0.0 : i * 2.0 * M_PI / segments;
+                float x, y, z;
+                g_PlanetOrbits.orbitPoint(planet, anomaly, x, y, z);
+                g_OrbitVertices.insert(g_OrbitVertices.end(), {x, y, z});
+            }
+        }
+        g_Orbits.push_back(orbit);
+    }
+    if (g_HasVBO) {
+        glGenBuffers(1, &g_OrbitVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, g_OrbitVBO);
+        glBufferData(GL_ARRAY_BUFFER, g_OrbitVertices.size() * sizeof(float), g_OrbitVertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+// Escolhe o nível de detalhe de uma órbita a partir do seu tamanho projetado na tela.
+// O erro de uma corda de N segmentos é r * (1 - cos(PI / N)) ~ r * PI^2 / (2 * N^2);
+// projetado a partir do ponto da órbita mais próximo da câmera, ele deve ficar abaixo de ORBIT_MAX_ERROR_PX.
+int selectOrbitLOD(const OrbitPath& orbit, float camX, float camY, float camZ) {
+    float focalPx = (g_WindowHeight * 0.5f) / tan(FIELD_OF_VIEW * 0.5f * M_PI / 180.0f);
+    float horizontal = sqrt(camX * camX + camZ * camZ) - orbit.radius;
+    float nearest = fmax(sqrt(horizontal * horizontal + camY * camY), 1.0f);
+    float needed = M_PI * sqrt(orbit.radius * focalPx / (2.0f * nearest * ORBIT_MAX_ERROR_PX));
+    int lod = 0;
+    while (lod < ORBIT_LOD_COUNT - 1 && orbitSegments(lod) < needed) lod++;
+    return lod;
+}
+
+// Desenha todas as órbitas com uma única chamada de desenho e uma única troca de estados.
+void drawOrbits(float camX, float camY, float camZ) {
+    vector<GLint> first(g_Orbits.size());
+    vector<GLsizei> count(g_Orbits.size());
+    for (size_t i = 0; i < g_Orbits.size(); i++) {
+        int lod = selectOrbitLOD(g_Orbits[i], camX, camY, camZ);
+        first[i] = g_Orbits[i].first[lod];
+        count[i] = orbitSegments(lod) + 1;
+    }
+
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_LIGHTING);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glColor3f(0.3f, 0.3f, 0.3f);
+
+    if (g_OrbitVBO) glBindBuffer(GL_ARRAY_BUFFER, g_OrbitVBO);
+    glVertexPointer(3, GL_FLOAT, 0, g_OrbitVBO ? nullptr : g_OrbitVertices.data());
+    if (g_HasMultiDraw) {
+        glMultiDrawArrays(GL_LINE_STRIP, first.data(), count.data(), (GLsizei)first.size());
+    } else {
+        for (size_t i = 0; i < first.size(); i++) glDrawArrays(GL_LINE_STRIP, first[i], count[i]);
+    }
+    if (g_OrbitVBO) glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Restaura a cor branca para que o Sol e os anéis (desenhados sem iluminação) não herdem o cinza.
+    glColor3f(1.0f, 1.0f, 1.0f);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnable(GL_LIGHTING);
+    glEnable(GL_TEXTURE_2D);
+}
+
+// --- SEÇÃO DO MODO N-CORPOS ---
+
+// Com --nbody, o Sol, os planetas e a Lua deixam de seguir as órbitas keplerianas e passam a ser
+// integrados pela gravitação mútua (nbody.h), junto com um disco de planetesimais. A integração
+// é feita em UA e dias, com as massas e os elementos do catálogo; para desenhar, as distâncias
+// ao Sol passam pela escala da cena (auToSceneDistance) e a Lua fica na distância do catálogo
+// em torno da Terra.
+const double NBODY_TIME_STEP = 0.25;  // Dias por passo do leapfrog (cerca de 110 por órbita da Lua).
+const int NBODY_MAX_SUBSTEPS = 8;     // Passos do leapfrog por passo da simulação, no máximo.
+const double NBODY_SOFTENING = 1e-5;  // UA; bem menor que a distância Terra-Lua (2,6e-3 UA).
+const double NBODY_DISC_MASS = 1e-5;  // Massa total do disco de planetesimais, em massas solares.
+const double NBODY_DISC_INNER = 2.0, NBODY_DISC_OUTER = 3.6; // Bordas do disco, em UA.
+// Até este número de corpos a soma direta vetorizada é mais rápida que a árvore (--bench-nbody).
+const size_t NBODY_DIRECT_LIMIT = 8192;
+
+// Tolerância do integrador adaptativo: com ela, 1000 anos dos planetas e da Lua saem mais
+// precisos que com o leapfrog de NBODY_TIME_STEP (--bench-integrators).
+const double NBODY_ADAPTIVE_TOLERANCE = 1e-10;
+// Passos individuais: o nível 0 usa NBODY_BLOCK_MAX_STEP dias e cada nível seguinte a metade,
+// até NBODY_BLOCK_LEVELS. Com NBODY_BLOCK_ACCURACY os erros ficam perto dos do leapfrog de
+// NBODY_TIME_STEP: a Lua e Mercúrio descem a 1/8 e 1/16 de dia, Urano e Netuno usam 32 dias e o
+// disco, 4 a 8 dias (--bench-integrators).
+const double NBODY_BLOCK_MAX_STEP = 32.0;
+const int NBODY_BLOCK_LEVELS = 12;
+const double NBODY_BLOCK_ACCURACY = 0.01;
+
+// Cálculo de forças do modo N-corpos (--nbody-forces).
+enum class NBodyForces { Auto, Direct, Tree };
+
+// Integrador do modo N-corpos (--integrator).
+enum class NBodyIntegrator { Leapfrog, Adaptive, Block };
+
+bool g_NBodyMode = false;
+size_t g_NBodyParticles = 0;  // Planetesimais pedidos com --nbody.
+double g_NBodyTheta = 0.5;    // Ângulo de abertura da árvore de Barnes-Hut (--theta).
+NBodyForces g_NBodyForces = NBodyForces::Auto;
+NBodyIntegrator g_NBodyIntegrator = NBodyIntegrator::Leapfrog;
+// Estado da integração; só a thread de simulação o usa depois de startSimulation(). Os
+// primeiros corpos são o Sol, os planetas (na ordem de g_Planets) e a Lua; depois vêm as
+// partículas do disco.
+NBodySystem g_NBody;
+BarnesHutTree g_NBodyTree;
+BulirschStoer g_NBodyAdaptive(NBODY_ADAPTIVE_TOLERANCE);
+BlockTimesteps g_NBodyBlock(NBODY_BLOCK_MAX_STEP, NBODY_BLOCK_LEVELS, NBODY_BLOCK_ACCURACY);
+// Contadores da integração, publicados pela thread de simulação para a tecla 'N'.
+atomic<uint64_t> g_NBodySteps{0}, g_NBodyRejected{0}, g_NBodyEvaluations{0};
+atomic<double> g_NBodyStep{0.0}, g_NBodyEnergyDrift{0.0};
+double g_NBodyInitialEnergy = 0.0;
+size_t g_NBodyMajorCount = 0;     // Sol, planetas e Lua.
+int g_NBodyMoon = -1;             // Índice da Lua em g_NBody.
+double g_NBodyMoonScale = 0.0;    // Unidades da cena por UA na órbita da Lua.
+double g_NBodyTimeOffset = 0.0;   // Dias que a integração deixou de acompanhar o relógio.
+uint64_t g_NBodyInteractions = 0; // Interações entre pares calculadas; só a thread que integra usa.
+function<double(double)> g_AuToScene;
+
+// Função que leva uma distância ao Sol em UA para a escala da cena, interpolando linearmente
+// entre os planetas (o semieixo real de cada um vem do período, pela terceira lei de Kepler).
+// Antes do primeiro planeta a escala é proporcional; depois do último, segue o último segmento.
+function<double(double)> auToSceneDistance() {
+    vector<pair<double, double>> points; // (UA, distância na cena), em ordem crescente.
+    for (const auto& planet : g_Planets) points.push_back({pow(planet.orbitSpeed / 365.25, 2.0 / 3.0), planet.distance});
+    sort(points.begin(), points.end());
+    return [points](double au) {
+        if (points.size() < 2) return au * (points.empty() ? 20.0 : points[0].second / points[0].first);
+        if (au <= points[0].first) return au * points[0].second / points[0].first;
+        size_t segment = 1;
+        while (segment < points.size() - 1 && points[segment].first < au) segment++;
+        const auto& a = points[segment - 1];
+        const auto& b = points[segment];
+        return a.second + (au - a.first) * (b.second - a.second) / (b.first - a.first);
+    };
+}
+
+// Semieixo maior em UA de uma órbita de 'period' dias em torno de um centro com parâmetro 'mu'.
+double semiMajorAxisFromPeriod(double period, double mu) {
+    double meanMotion = 2.0 * M_PI / period;
+    return cbrt(mu / (meanMotion * meanMotion));
+}
+
+// Se as forças de um sistema de 'count' corpos vêm da soma direta (ou da árvore).
+bool nbodyUsesDirectSum(size_t count) {
+    return g_NBodyForces == NBodyForces::Direct || (g_NBodyForces == NBodyForces::Auto && count <= NBODY_DIRECT_LIMIT);
+}
+
+// Forças do modo N-corpos: soma direta em sistemas pequenos, árvore nos grandes.
+void nbodyForces(NBodySystem& system) {
+    if (nbodyUsesDirectSum(system.size())) {
+        directForces(system);
+        g_NBodyInteractions += (uint64_t)system.size() * system.size();
+    } else {
+        g_NBodyTree(system);
+        g_NBodyInteractions += g_NBodyTree.interactionCount();
+    }
+}
+
+// Forças só de alguns corpos, para os passos individuais. A soma direta desses alvos custa
+// alvos * n interações; até o custo da soma direta completa no limite da árvore ela é usada
+// mesmo em sistemas grandes, em vez de remontar a árvore para poucos alvos.
+void nbodyPartialForces(NBodySystem& system, const vector<uint32_t>& targets) {
+    size_t n = system.size();
+    if (nbodyUsesDirectSum(n) ||
+        (g_NBodyForces == NBodyForces::Auto && targets.size() * n <= NBODY_DIRECT_LIMIT * NBODY_DIRECT_LIMIT)) {
+        directForces(system, targets);
+        g_NBodyInteractions += (uint64_t)targets.size() * n;
+    } else {
+        g_NBodyTree(system, targets);
+        g_NBodyInteractions += g_NBodyTree.interactionCount();
+    }
+}
+
+// Nome do integrador do modo N-corpos, para as mensagens.
+const char* nbodyIntegratorName() {
+    switch (g_NBodyIntegrator) {
+        case NBodyIntegrator::Adaptive: return "Bulirsch-Stoer adaptativo";
+        case NBodyIntegrator::Block: return "passos individuais em blocos";
+        default: return "leapfrog";
+    }
+}
+
+// Monta o sistema inicial a partir do catálogo. Chamada em init(), antes de startSimulation().
+void initNBody() {
+    g_NBody = NBodySystem();
+    g_NBody.softening = NBODY_SOFTENING;
+    g_NBody.reserve(g_Planets.size() + 2 + g_NBodyParticles);
+    g_NBodyTree.setOpeningAngle(g_NBodyTheta);
+    g_AuToScene = auToSceneDistance();
+
+    const double origin[3] = {0.0, 0.0, 0.0};
+    g_NBody.add(origin, origin, g_Sun.mass);
+    double sunMu = GAUSS_GRAVITY * g_Sun.mass;
+    for (const auto& planet : g_Planets) {
+        const OrbitalElements& orbit = planet.orbit;
+        double mu = sunMu + GAUSS_GRAVITY * planet.mass;
+        double position[3], velocity[3];
+        stateFromElements(semiMajorAxisFromPeriod(orbit.period, mu), orbit.eccentricity, orbit.inclination,
+                          orbit.ascendingNode, orbit.argPeriapsis, orbit.meanAnomaly, mu, position, velocity);
+        g_NBody.add(position, velocity, planet.mass);
+    }
+    g_NBodyMoon = -1;
+    if (g_MoonPlanet >= 0) {
+        const CelestialBody& earth = g_Planets[g_MoonPlanet];
+        size_t earthIndex = 1 + g_MoonPlanet;
+        double mu = GAUSS_GRAVITY * (earth.mass + g_Moon.mass);
+        double a = semiMajorAxisFromPeriod(g_Moon.orbit.period, mu);
+        double position[3], velocity[3];
+        stateFromElements(a, g_Moon.orbit.eccentricity, g_Moon.orbit.inclination, g_Moon.orbit.ascendingNode,
+                          g_Moon.orbit.argPeriapsis, g_Moon.orbit.meanAnomaly, mu, position, velocity);
+        position[0] += g_NBody.x[earthIndex];
+        position[1] += g_NBody.y[earthIndex];
+        position[2] += g_NBody.z[earthIndex];
+        velocity[0] += g_NBody.vx[earthIndex];
+        velocity[1] += g_NBody.vy[earthIndex];
+        velocity[2] += g_NBody.vz[earthIndex];
+        g_NBodyMoon = (int)g_NBody.size();
+        g_NBody.add(position, velocity, g_Moon.mass);
+        g_NBodyMoonScale = g_Moon.distance / a;
+    }
+    g_NBodyMajorCount = g_NBody.size();
+    g_NBodyTimeOffset = g_StartDays; // Os elementos do catálogo valem no início da animação.
+
+    // Disco de planetesimais com densidade superficial uniforme, órbitas quase circulares e
+    // pouco inclinadas. O gerador é fixo, então o disco é o mesmo em toda execução.
+    SeededRandom random(2024);
+    double particleMass = g_NBodyParticles ? NBODY_DISC_MASS / g_NBodyParticles : 0.0;
+    for (size_t i = 0; i < g_NBodyParticles; i++) {
+        double inner2 = NBODY_DISC_INNER * NBODY_DISC_INNER, outer2 = NBODY_DISC_OUTER * NBODY_DISC_OUTER;
+        double a = sqrt(inner2 + (outer2 - inner2) * random());
+        double e = 0.02 * sqrt(-2.0 * log(random())); // Distribuição de Rayleigh.
+        double inclination = 1.0 * sqrt(-2.0 * log(random()));
+        double position[3], velocity[3];
+        stateFromElements(a, min(e, 0.5), inclination, 360.0 * random(), 360.0 * random(), 360.0 * random(),
+                          sunMu, position, velocity);
+        g_NBody.add(position, velocity, particleMass);
+    }
+    g_NBody.moveToBarycenter();
+    nbodyForces(g_NBody);
+    g_NBodyInitialEnergy = totalEnergy(g_NBody);
+    printf("Modo N-corpos: %zu corpos, forcas por %s, integrador %s\n", g_NBody.size(),
+           nbodyUsesDirectSum(g_NBody.size()) ? "soma direta" : "arvore de Barnes-Hut",
+           nbodyIntegratorName());
+}
+
+// Dá até 'maxSteps' passos do integrador (leapfrog de NBODY_TIME_STEP, adaptativo ou passos
+// individuais) em direção ao instante 'target' da integração e atualiza os contadores. Retorna
+// false se parou antes por causa do limite.
+bool stepNBody(double target, uint64_t maxSteps) {
+    bool reached;
+    if (g_NBodyIntegrator == NBodyIntegrator::Adaptive) {
+        reached = g_NBodyAdaptive.advance(g_NBody, target, nbodyForces, maxSteps);
+        g_NBodySteps = g_NBodyAdaptive.stepsTaken();
+        g_NBodyRejected = g_NBodyAdaptive.stepsRejected();
+        g_NBodyEvaluations = g_NBodyAdaptive.forceEvaluations();
+        g_NBodyStep = g_NBodyAdaptive.nextStep();
+    } else if (g_NBodyIntegrator == NBodyIntegrator::Block) {
+        // Os subpassos seguem o corpo mais rápido e são mais curtos que o passo do leapfrog, mas
+        // só os corpos que fecham o passo calculam forças neles.
+        reached = g_NBodyBlock.advance(g_NBody, target, nbodyPartialForces, 4 * maxSteps);
+        g_NBodySteps = g_NBodyBlock.substepsTaken();
+        g_NBodyEvaluations = g_NBodyBlock.forceEvaluations();
+        g_NBodyStep = g_NBodyBlock.smallestStep();
+    } else {
+        uint64_t steps = 0;
+        while (g_NBody.time + NBODY_TIME_STEP <= target && steps < maxSteps) {
+            leapfrogStep(g_NBody, NBODY_TIME_STEP, nbodyForces);
+            steps++;
+        }
+        reached = g_NBody.time + NBODY_TIME_STEP > target;
+        g_NBodySteps += steps;
+        g_NBodyEvaluations += steps;
+        g_NBodyStep = NBODY_TIME_STEP;
+    }
+    return reached;
+}
+
+// Mostra os contadores da integração do modo N-corpos.
+void printNBodyStats() {
+    if (!g_NBodyMode) return;
+    if (g_NBodyIntegrator == NBodyIntegrator::Block) {
+        // Aqui as avaliações contam corpos, e o passo é o menor em uso.
+        printf("N-corpos (%s): %llu subpassos, %llu avaliacoes de forca por corpo, menor passo %.4g dias\n",
+               nbodyIntegratorName(), (unsigned long long)g_NBodySteps.load(),
+               (unsigned long long)g_NBodyEvaluations.load(), g_NBodyStep.load());
+    } else {
+        printf("N-corpos (%s): %llu passos, %llu rejeitados, %llu avaliacoes de forca, passo atual %.4g dias\n",
+               nbodyIntegratorName(), (unsigned long long)g_NBodySteps.load(),
+               (unsigned long long)g_NBodyRejected.load(), (unsigned long long)g_NBodyEvaluations.load(),
+               g_NBodyStep.load());
+    }
+    if (g_NBody.size() == g_NBodyMajorCount) printf("  deriva relativa da energia: %.3g\n", g_NBodyEnergyDrift.load());
+}
+
+// Posição na cena do corpo 'index' do sistema, relativa ao Sol. A eclíptica (x, y, z) vira
+// (x, z, -y) na cena, como em kepler.h.
+void nbodyScenePosition(size_t index, float& x, float& y, float& z) {
+    double dx = g_NBody.x[index] - g_NBody.x[0], dy = g_NBody.y[index] - g_NBody.y[0];
+    double dz = g_NBody.z[index] - g_NBody.z[0];
+    double distance = sqrt(dx * dx + dy * dy + dz * dz);
+    double scale = distance > 0.0 ? g_AuToScene(distance) / distance : 0.0;
+    x = (float)(dx * scale);
+    y = (float)(dz * scale);
+    z = (float)(-dy * scale);
+}
+
+// Posições na cena das partículas do disco, gravadas em 'vertices' (x, y, z).
+void nbodyParticlePositions(vector<float>& vertices) {
+    size_t count = g_NBody.size() - g_NBodyMajorCount;
+    vertices.resize(count * 3);
+    workerPool().parallelFor(count, 16384, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            nbodyScenePosition(g_NBodyMajorCount + i, vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]);
+        }
+    });
+}
+
+// --- SEÇÃO DA LINHA DO TEMPO ---
+
+// No modo N-corpos o estado só existe no instante em que a integração está, e chegar a outro
+// instante exigiria integrar tudo no caminho. A integração grava checkpoints (timeline.h) a cada
+// TIMELINE_CHECKPOINT_INTERACTIONS interações de força ao longo do caminho integrado, entre cerca
+// de 5 e 20 ms de trabalho conforme o integrador e a quantidade de corpos; contar interações em
+// vez de medir o tempo põe os checkpoints nos mesmos passos em toda execução. Cada checkpoint leva
+// também o estado do integrador, então os passos individuais gravam no meio dos passos, sem
+// esperar todos os corpos se sincronizarem, e qualquer integrador continua de um checkpoint
+// exatamente como da primeira vez. O arquivo dos checkpoints cabe em TIMELINE_DISK_BYTES: ao
+// passar disso, o espaçamento dobra em toda a linha do tempo, igual em todo o trecho integrado.
+//
+// Um salto do relógio (teclas '[' e ']', '<' e '>') para um instante até o último checkpoint
+// restaura o último checkpoint antes do destino e integra só o resto, no máximo um espaçamento:
+// enquanto ele não dobrou, menos de 50 ms com até alguns milhares de corpos, e
+// printTimelineStats mostra o custo estimado. Um destino além do último checkpoint não é um
+// salto: a integração precisa passar por todo o caminho até ele, e avança no máximo
+// TIMELINE_SEEK_BUDGET_MS por volta da simulação, com o relógio parado, os estados publicados
+// normalmente e checkpoints gravados no caminho; o avanço é anunciado e acompanhado à parte.
+// Nos outros modos as posições saem direto do instante e o salto é imediato.
+const uint64_t TIMELINE_CHECKPOINT_INTERACTIONS = uint64_t(1) << 23;
+const double TIMELINE_SEEK_BUDGET_MS = 40.0;
+const size_t TIMELINE_RING_BYTES = size_t(256) << 20; // Memória do anel de checkpoints.
+const size_t TIMELINE_DISK_BYTES = size_t(2) << 30;   // Arquivo temporário dos checkpoints.
+const double TIMELINE_SEEK_DAYS = 3652.5;             // Salto das teclas '[' e ']' (10 anos).
+
+// Resultado de uma volta de seekNBody().
+enum class SeekProgress {
+    Reached,   // O estado está no destino.
+    Seeking,   // Salto: o destino está no trecho coberto, falta integrar o resto.
+    Advancing, // Avanço: o destino está além do último checkpoint.
+};
+
+CheckpointTimeline g_Timeline;
+uint64_t g_TimelineWork = 0;       // Interações do caminho integrado até o estado atual.
+double g_TimelineStepMs = 0.0;     // Duração do último passo do integrador.
+double g_TimelineWorkMs = 0.0;     // Tempo e interações de todos os passos, para estimar o custo
+uint64_t g_TimelineWorkDone = 0;   // de um espaçamento.
+vector<double> g_TimelineIntegrator; // Estado do integrador de um checkpoint.
+// Último salto concluído no modo N-corpos: duração total desde o pedido, somando todas as voltas
+// da simulação gastas, e o maior total desde o início.
+atomic<double> g_TimelineSeekMs{0.0};
+atomic<double> g_TimelineSeekWorstMs{0.0};
+atomic<int> g_TimelineSeekRounds{0};
+// Avanço em andamento ou último concluído: dias pedidos e já integrados, duração e se terminou.
+atomic<double> g_TimelineAdvanceDays{0.0}, g_TimelineAdvanceDone{0.0}, g_TimelineAdvanceMs{0.0};
+atomic<bool> g_TimelineAdvancing{false};
+
+// Guarda em 'state' o estado do integrador em uso que decide os passos seguintes.
+void saveNBodyIntegrator(vector<double>& state) {
+    if (g_NBodyIntegrator == NBodyIntegrator::Adaptive) {
+        state.resize(BulirschStoer::STATE_SIZE);
+        g_NBodyAdaptive.saveState(state.data());
+    } else if (g_NBodyIntegrator == NBodyIntegrator::Block) {
+        state.resize(BlockTimesteps::stateSize(g_NBody.size()));
+        g_NBodyBlock.saveState(state.data());
+    } else {
+        state.clear(); // O leapfrog de passo fixo não tem estado.
+    }
+}
+
+// Volta o integrador em uso ao estado guardado por saveNBodyIntegrator().
+void loadNBodyIntegrator(const vector<double>& state) {
+    if (g_NBodyIntegrator == NBodyIntegrator::Adaptive) g_NBodyAdaptive.loadState(state.data());
+    if (g_NBodyIntegrator == NBodyIntegrator::Block) g_NBodyBlock.loadState(state.data());
+}
+
+// Abre a linha do tempo com o estado inicial. Chamada em init(), depois de initNBody().
+void initTimeline() {
+    saveNBodyIntegrator(g_TimelineIntegrator);
+    if (!g_Timeline.open(g_NBody.size(), g_TimelineIntegrator.size(), TIMELINE_CHECKPOINT_INTERACTIONS,
+                         TIMELINE_RING_BYTES, TIMELINE_DISK_BYTES)) {
+        cerr << "Nao foi possivel criar o arquivo dos checkpoints; eles ficam so na memoria" << endl;
+    }
+    g_TimelineWork = 0;
+    g_Timeline.record(g_NBody, g_TimelineIntegrator, g_TimelineWork);
+}
+
+// Grava um checkpoint se ele está vencido e o estado passou do trecho coberto.
+void recordCheckpoint() {
+    if (!g_Timeline.due(g_TimelineWork)) return;
+    saveNBodyIntegrator(g_TimelineIntegrator);
+    g_Timeline.record(g_NBody, g_TimelineIntegrator, g_TimelineWork);
+}
+
+// Integra até o instante 'target' da integração em no máximo 'maxSteps' passos, gravando os
+// checkpoints no caminho. Retorna false se parou antes por causa do limite.
+bool integrateNBody(double target, uint64_t maxSteps) {
+    // Um passo por vez, para que um checkpoint fique a no máximo um passo depois do múltiplo do
+    // espaçamento.
+    for (uint64_t taken = 0; taken < maxSteps; taken++) {
+        uint64_t interactions = g_NBodyInteractions;
+        auto start = chrono::steady_clock::now();
+        bool reached = stepNBody(target, 1);
+        g_TimelineStepMs = elapsedMs(start);
+        g_TimelineWork += g_NBodyInteractions - interactions;
+        g_TimelineWorkMs += g_TimelineStepMs;
+        g_TimelineWorkDone += g_NBodyInteractions - interactions;
+        recordCheckpoint();
+        if (reached) return true;
+    }
+    return false;
+}
+
+// Avança a integração até o instante 'days' do relógio. Se ela não acompanhar (muitos corpos,
+// aceleração alta), o atraso além de NBODY_MAX_SUBSTEPS passos é descartado em vez de acumulado.
+void advanceNBody(double days) {
+    double target = days - g_NBodyTimeOffset;
+    if (!integrateNBody(target, NBODY_MAX_SUBSTEPS)) g_NBodyTimeOffset += target - g_NBody.time;
+    // A energia custa O(n^2); só é acompanhada sem o disco de partículas, e com os passos
+    // individuais só quando todos os corpos estão no mesmo instante.
+    if (g_NBody.size() == g_NBodyMajorCount &&
+        (g_NBodyIntegrator != NBodyIntegrator::Block || g_NBodyBlock.synchronized())) {
+        g_NBodyEnergyDrift = fabs(totalEnergy(g_NBody) / g_NBodyInitialEnergy - 1.0);
+    }
+}
+
+// Restaura, para um salto ao instante 'target' da integração, o último checkpoint antes dele se o
+// estado atual estiver depois do destino ou antes do checkpoint, e diz em 'restored' se restaurou.
+// Retorna false se o destino está antes do estado e não há checkpoint antes dele: o estado fica
+// onde está.
+bool seekRestore(double target, bool& restored) {
+    restored = false;
+    if (target >= g_NBody.time && g_Timeline.latestBefore(target) <= g_NBody.time) return true;
+    restored = g_Timeline.restore(target, g_NBody, g_TimelineIntegrator, g_TimelineWork);
+    if (restored) loadNBodyIntegrator(g_TimelineIntegrator);
+    return restored || target >= g_NBody.time;
+}
+
+// Leva a integração em direção ao instante 'days' do relógio, em no máximo
+// TIMELINE_SEEK_BUDGET_MS, e diz em 'progress' se chegou, se é um salto ou um avanço. Restaura
+// um checkpoint como seekRestore(); antes do início da integração, o destino é o início. Os passos param quando o
+// seguinte, com a duração do último, passaria do orçamento, mas sem restauração há sempre pelo
+// menos um, para que a busca avance mesmo com passos mais longos que ele. Retorna o instante do
+// relógio alcançado.
+double seekNBody(double days, SeekProgress& progress) {
+    auto deadline = chrono::steady_clock::now() +
+                    chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, milli>(TIMELINE_SEEK_BUDGET_MS));
+    double target = max(days - g_NBodyTimeOffset, 0.0);
+    bool restored;
+    if (!seekRestore(target, restored)) {
+        progress = SeekProgress::Reached; // Sem checkpoint antes do destino: fica onde está.
+        return g_NBody.time + g_NBodyTimeOffset;
+    }
+    auto stepCost = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, milli>(g_TimelineStepMs));
+    bool reached = false;
+    for (bool first = !restored; !reached; first = false) {
+        if (!first && chrono::steady_clock::now() + stepCost > deadline) break;
+        reached = integrateNBody(target, 1);
+    }
+    if (reached) {
+        progress = SeekProgress::Reached;
+        return target + g_NBodyTimeOffset;
+    }
+    progress = target > g_Timeline.latest() ? SeekProgress::Advancing : SeekProgress::Seeking;
+    return g_NBody.time + g_NBodyTimeOffset;
+}
+
+// Mostra os checkpoints guardados, o custo de voltar a um instante já integrado e o último salto
+// e o último avanço do modo N-corpos.
+void printTimelineStats() {
+    if (!g_NBodyMode) return;
+    CheckpointTimeline::Stats stats = g_Timeline.stats();
+    double spacingMs = g_TimelineWorkDone > 0 ? stats.spacing * g_TimelineWorkMs / g_TimelineWorkDone : 0.0;
+    printf("Linha do tempo: %zu checkpoints de %.1f KB, limite %zu (%zu no anel de %zu, %zu no disco em %zu "
+           "registros, %zu aceitos, %zu rareados, %zu perdidos, %zu descartados)\n",
+           stats.checkpoints, stats.recordBytes / 1024.0, stats.capacity, stats.inMemory, stats.slots, stats.onDisk,
+           stats.fileRecords, stats.accepted, stats.thinned, stats.lost, stats.dropped);
+    printf("  um checkpoint a cada %llu interacoes (%llu vezes o intervalo inicial): voltar custa no maximo cerca "
+           "de %.1f ms\n",
+           (unsigned long long)stats.spacing, (unsigned long long)(stats.spacing / TIMELINE_CHECKPOINT_INTERACTIONS),
+           spacingMs);
+    printf("  ultimo salto: %.1f ms no total em %d voltas, pior salto: %.1f ms\n", g_TimelineSeekMs.load(),
+           g_TimelineSeekRounds.load(), g_TimelineSeekWorstMs.load());
+    if (g_TimelineAdvancing) {
+        printf("  avanco em andamento: %.0f de %.0f dias em %.1f s\n", g_TimelineAdvanceDone.load(),
+               g_TimelineAdvanceDays.load(), g_TimelineAdvanceMs.load() / 1000.0);
+    } else if (g_TimelineAdvanceDays > 0.0) {
+        printf("  ultimo avanco: %.0f dias em %.1f s\n", g_TimelineAdvanceDays.load(),
+               g_TimelineAdvanceMs.load() / 1000.0);
+    }
+}
+
+// --- SEÇÃO DE EFEMÉRIDES ---
+
+// Com --ephemeris, as posições dos planetas e da Lua vêm de um arquivo de efemérides do JPL
+// (ephemeris.h) em vez das órbitas keplerianas do catálogo. As posições heliocêntricas são
+// giradas do equador para a eclíptica de J2000 e passam pela mesma escala da cena do modo
+// N-corpos; a Lua fica na distância do catálogo em torno da Terra. Corpos ausentes do arquivo, ou
+// instantes fora da sua cobertura, continuam nas órbitas keplerianas.
+const double KM_PER_AU = 149597870.7;
+const double J2000_OBLIQUITY = 23.4392911 * M_PI / 180.0; // Inclinação da eclíptica no equador.
+const double MOON_MEAN_DISTANCE_KM = 384400.0;
+
+string g_EphemerisPath; // Arquivo passado por --ephemeris; vazio quando não há efemérides.
+Ephemeris g_Ephemeris;  // Só lido depois de initEphemeris().
+bool g_EphemerisMode = false;
+vector<int> g_PlanetNaif; // Código NAIF de cada planeta de g_Planets; -1 se desconhecido.
+
+// Código NAIF de um corpo do catálogo. Os planetas usam os baricentros dos seus sistemas, que
+// estão em todos os arquivos; a Terra, separada da Lua, usa o próprio código.
+int naifBodyId(const string& name) {
+    static const pair<const char*, int> ids[] = {
+        {"sun", NAIF_SUN}, {"mercury", 1}, {"venus", 2}, {"earth", NAIF_EARTH}, {"mars", 4},
+        {"jupiter", 5}, {"saturn", 6}, {"uranus", 7}, {"neptune", 8}, {"moon", NAIF_MOON},
+    };
+    for (const auto& id : ids) {
+        if (name == id.first) return id.second;
+    }
+    return -1;
+}
+
+// Leva um vetor equatorial J2000 em km para a eclíptica J2000 em UA.
+void equatorialToEcliptic(const double equatorial[3], double ecliptic[3]) {
+    double c = cos(J2000_OBLIQUITY), s = sin(J2000_OBLIQUITY);
+    ecliptic[0] = equatorial[0] / KM_PER_AU;
+    ecliptic[1] = (c * equatorial[1] + s * equatorial[2]) / KM_PER_AU;
+    ecliptic[2] = (-s * equatorial[1] + c * equatorial[2]) / KM_PER_AU;
+}
+
+// Posição na cena de um vetor heliocêntrico da eclíptica J2000 em UA, com a escala de distâncias
+// do modo N-corpos. A eclíptica (x, y, z) vira (x, z, -y) na cena, como em kepler.h.
+void eclipticToScene(const double p[3], float& x, float& y, float& z) {
+    double distance = sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+    double scale = distance > 0.0 ? g_AuToScene(distance) / distance : 0.0;
+    x = (float)(p[0] * scale);
+    y = (float)(p[2] * scale);
+    z = (float)(-p[1] * scale);
+}
+
+// Conferência de um arquivo de --ephemeris com uma fonte independente dele: as séries completas
+// embutidas da VSOP87D nos planetas e da ELP na Lua, que ficam a menos de 2' do DE entre 1800 e
+// 2200. Um erro de leitura (unidade, referencial, corpo ou registro trocado) dá graus. O desvio
+// de um corpo é a distância entre as duas posições dividida pela distância ao centro, em
+// segundos de arco.
+struct EphemerisCheckBody {
+    const char* name;
+    int target, center;
+};
+const EphemerisCheckBody EPHEMERIS_CHECK_BODIES[] = {
+    {"Mercurio", 1, NAIF_SUN}, {"Venus", 2, NAIF_SUN},   {"Terra", NAIF_EARTH, NAIF_SUN},
+    {"Marte", 4, NAIF_SUN},    {"Jupiter", 5, NAIF_SUN}, {"Saturno", 6, NAIF_SUN},
+    {"Urano", 7, NAIF_SUN},    {"Netuno", 8, NAIF_SUN},  {"Lua", NAIF_MOON, NAIF_EARTH},
+};
+const size_t EPHEMERIS_CHECK_COUNT = sizeof(EPHEMERIS_CHECK_BODIES) / sizeof(EPHEMERIS_CHECK_BODIES[0]);
+const double EPHEMERIS_CHECK_TOLERANCE = 300.0; // Segundos de arco; a tabela erra até ~1,5'.
+const double EPHEMERIS_CHECK_SPAN = 200.0 * 365.25; // Dias de J2000 conferidos para cada lado.
+
+// Maior desvio de cada corpo de EPHEMERIS_CHECK_BODIES em 'epochs' instantes igualmente espaçados
+// da cobertura do arquivo, limitada a EPHEMERIS_CHECK_SPAN; NaN nos corpos que o arquivo não tem.
+// Retorna false se a cobertura não tiver nenhum instante no intervalo. Fica na seção de teorias
+// analíticas.
+bool checkEphemeris(const Ephemeris& ephemeris, size_t epochs, double* deviation);
+
+// Abre o arquivo de --ephemeris e o confere com as teorias analíticas (checkEphemeris), avisando
+// dos corpos que se afastam delas. Chamada em init(), depois de initBodies().
+void initEphemeris() {
+    auto start = chrono::steady_clock::now();
+    if (!openEphemeris(g_EphemerisPath.c_str(), g_Ephemeris)) {
+        cerr << "Nao foi possivel ler as efemerides: " << g_EphemerisPath << endl;
+        return;
+    }
+    g_EphemerisMode = true;
+    g_AuToScene = auToSceneDistance();
+    double first, last;
+    ephemerisCommonCoverage(g_Ephemeris, first, last);
+    printf("Efemerides: %zu series de %s em %.1f ms, cobertura comum de %.0f a %.0f (anos)\n",
+           g_Ephemeris.series.size(), g_EphemerisPath.c_str(), elapsedMs(start), 2000.0 + first / 365.25,
+           2000.0 + last / 365.25);
+    double deviation[EPHEMERIS_CHECK_COUNT];
+    if (!checkEphemeris(g_Ephemeris, 16, deviation)) return;
+    for (size_t b = 0; b < EPHEMERIS_CHECK_COUNT; b++) {
+        if (deviation[b] > EPHEMERIS_CHECK_TOLERANCE) {
+            cerr << "Aviso: " << EPHEMERIS_CHECK_BODIES[b].name << " das efemerides se afasta " << (long)deviation[b]
+                 << "\" da VSOP87/ELP; o arquivo pode ter sido lido errado" << endl;
+        }
+    }
+}
+
+// Sobrescreve as posições na cena dos planetas que o arquivo cobre no instante 'days'.
+void ephemerisPlanetPositions(double days, float* x, float* y, float* z) {
+    for (size_t i = 0; i < g_Planets.size() && i < g_PlanetNaif.size(); i++) {
+        double equatorial[3], p[3];
+        if (!ephemerisPosition(g_Ephemeris, g_PlanetNaif[i], NAIF_SUN, days, equatorial) || std::isnan(equatorial[0])) {
+            continue;
+        }
+        equatorialToEcliptic(equatorial, p);
+        eclipticToScene(p, x[i], y[i], z[i]);
+    }
+}
+
+// Posição na cena da Lua em relação à Terra no instante 'days'. Retorna false se o arquivo não a
+// cobrir.
+bool ephemerisMoonOffset(double days, float& x, float& y, float& z) {
+    double equatorial[3], p[3];
+    if (!ephemerisPosition(g_Ephemeris, NAIF_MOON, NAIF_EARTH, days, equatorial) || std::isnan(equatorial[0])) {
+        return false;
+    }
+    equatorialToEcliptic(equatorial, p);
+    double scale = g_Moon.distance * KM_PER_AU / MOON_MEAN_DISTANCE_KM;
+    x = (float)(p[0] * scale);
+    y = (float)(p[2] * scale);
+    z = (float)(-p[1] * scale);
+    return true;
+}
+
+// --- SEÇÃO DE TEORIAS ANALÍTICAS ---
+
+// Com --analytic, as posições dos planetas vêm da VSOP87 e a da Lua da ELP (planetary_theory.h),
+// sem arquivo de efemérides binário. Os menores termos são descartados na carga enquanto o erro
+// do corte, somado ao da série, couber em --accuracy segundos de arco. A série da Lua e a tabela da VSOP87D dos planetas são embutidas; os
+// arquivos oficiais da VSOP87 na pasta de --vsop87, quando existem, têm precedência sobre a
+// tabela, para precisões além da dela. Com --ephemeris, as efemérides têm precedência onde
+// cobrem o instante.
+bool g_AnalyticMode = false;
+string g_Vsop87Path = "VSOP87";   // Pasta com os arquivos VSOP87A.mer, VSOP87D.ear...
+double g_TheoryAccuracy = 10.0;   // Precisão pedida, em segundos de arco.
+// Precisão das tabelas embutidas, em segundos de arco: a truncagem da VSOP87D de Meeus fica a
+// menos de 1" das rotinas da IAU na Terra, e a da ELP, com 60 termos por coordenada, erra até
+// cerca de 10" na Lua. Cortar termos só pode piorar isso.
+const double VSOP87_TABLE_ACCURACY = 1.0;
+const double ELP_TABLE_ACCURACY = 10.0;
+vector<Vsop87Series> g_PlanetTheories; // Série de cada planeta de g_Planets; vazia se não houver.
+ElpSeries g_MoonTheory;
+SimdKernel g_SimdKernel = SimdKernel::Scalar;
+
+// Extensão dos arquivos da VSOP87 de um corpo, pelo código NAIF; nullptr se não houver.
+const char* vsop87Extension(int naif) {
+    switch (naif) {
+    case 1: return "mer";
+    case 2: return "ven";
+    case NAIF_EARTH: return "ear";
+    case 4: return "mar";
+    case 5: return "jup";
+    case 6: return "sat";
+    case 7: return "ura";
+    case 8: return "nep";
+    default: return nullptr;
+    }
+}
+
+// Número do planeta na VSOP87 (1 a 8, de Mercúrio a Netuno) pelo código NAIF; 0 se não houver.
+int vsop87Planet(int naif) {
+    if (naif == NAIF_EARTH) return 3;
+    return naif >= 1 && naif <= 8 ? naif : 0;
+}
+
+// Lê a série de um planeta da pasta 'folder', na primeira versão encontrada: A (retangular, J2000)
+// é a mais barata de avaliar, D (esférica, da data) a mais cara.
+bool loadPlanetTheory(const string& folder, int naif, double accuracy, Vsop87Series& series) {
+    const char* extension = vsop87Extension(naif);
+    if (!extension) return false;
+    for (char version : {'A', 'B', 'C', 'D'}) {
+        string path = folder + "/VSOP87" + version + "." + extension;
+        if (loadVsop87(path.c_str(), accuracy, series)) return true;
+    }
+    return false;
+}
+
+// Tolerância do corte, em radianos, para que uma série de precisão 'floor' somada ao corte fique
+// dentro da precisão pedida 'requested' (as duas em segundos de arco); zero mantém todos os termos.
+double theoryTolerance(double requested, double floor) {
+    return max(requested - floor, 0.0) / ARCSECONDS_PER_RADIAN;
+}
+
+// Monta as séries dos planetas, dos arquivos de --vsop87 ou da tabela embutida, e a da Lua.
+// Uma precisão pedida além da que as tabelas embutidas alcançam gera um aviso e fica na delas.
+// Chamada em init(), depois de initBodies().
+void initAnalytic() {
+    auto start = chrono::steady_clock::now();
+    g_PlanetTheories.assign(g_Planets.size(), Vsop87Series());
+    size_t fromFiles = 0, embedded = 0, terms = 0, sourceTerms = 0;
+    double planetBound = 0.0; // Segundos de arco.
+    for (size_t i = 0; i < g_Planets.size() && i < g_PlanetNaif.size(); i++) {
+        Vsop87Series& series = g_PlanetTheories[i];
+        double floor = 0.0;
+        if (loadPlanetTheory(g_Vsop87Path, g_PlanetNaif[i], theoryTolerance(g_TheoryAccuracy, 0.0), series)) {
+            fromFiles++;
+        } else if (buildEmbeddedVsop87(vsop87Planet(g_PlanetNaif[i]),
+                                       theoryTolerance(g_TheoryAccuracy, VSOP87_TABLE_ACCURACY), series)) {
+            embedded++;
+            floor = VSOP87_TABLE_ACCURACY;
+        } else {
+            continue;
+        }
+        terms += series.size();
+        sourceTerms += series.sourceTerms;
+        planetBound = max(planetBound, floor + series.bound * ARCSECONDS_PER_RADIAN);
+    }
+    buildElpSeries(theoryTolerance(g_TheoryAccuracy, ELP_TABLE_ACCURACY), g_MoonTheory);
+    double moonBound = ELP_TABLE_ACCURACY + g_MoonTheory.bound * ARCSECONDS_PER_RADIAN;
+    if (embedded > 0 && g_TheoryAccuracy < VSOP87_TABLE_ACCURACY) {
+        fprintf(stderr, "Aviso: a tabela embutida da VSOP87 nao passa de %g\"; os arquivos oficiais em %s iriam alem\n",
+                VSOP87_TABLE_ACCURACY, g_Vsop87Path.c_str());
+    }
+    if (g_TheoryAccuracy < ELP_TABLE_ACCURACY) {
+        fprintf(stderr, "Aviso: a tabela embutida da ELP nao passa de %g\" na Lua\n", ELP_TABLE_ACCURACY);
+    }
+    g_SimdKernel = detectSimdKernel();
+    g_AnalyticMode = true;
+    g_AuToScene = auToSceneDistance();
+    printf("VSOP87: %zu planetas dos arquivos de %s e %zu da tabela embutida, %zu de %zu termos, em %.1f ms\n",
+           fromFiles, g_Vsop87Path.c_str(), embedded, terms, sourceTerms, elapsedMs(start));
+    printf("ELP: %zu de %zu termos da Lua\n", g_MoonTheory.size(), g_MoonTheory.tableTerms);
+    printf("Precisao pedida: %g\"; alcancada: planetas %.3g\", Lua %.3g\" (ate mil anos de J2000 nos planetas e "
+           "cem na Lua)\n", g_TheoryAccuracy, planetBound, moonBound);
+}
+
+// Sobrescreve as posições na cena dos planetas que têm série no instante 'days'.
+void analyticPlanetPositions(double days, float* x, float* y, float* z) {
+    for (size_t i = 0; i < g_PlanetTheories.size(); i++) {
+        if (g_PlanetTheories[i].size() == 0) continue;
+        double p[3];
+        evaluateVsop87(g_PlanetTheories[i], days, p, g_SimdKernel);
+        eclipticToScene(p, x[i], y[i], z[i]);
+    }
+}
+
+// Posição na cena da Lua em relação à Terra no instante 'days', na distância do catálogo.
+void analyticMoonOffset(double days, float& x, float& y, float& z) {
+    double p[3];
+    evaluateElp(g_MoonTheory, days, p, g_SimdKernel);
+    double scale = g_Moon.distance / MOON_MEAN_DISTANCE_KM;
+    x = (float)(p[0] * scale);
+    y = (float)(p[2] * scale);
+    z = (float)(-p[1] * scale);
+}
+
+// Declarada na seção de efemérides; fica aqui por usar as séries das teorias analíticas.
+bool checkEphemeris(const Ephemeris& ephemeris, size_t epochs, double* deviation) {
+    double first, last;
+    if (!ephemerisCommonCoverage(ephemeris, first, last)) return false;
+    first = max(first, -EPHEMERIS_CHECK_SPAN);
+    last = min(last, EPHEMERIS_CHECK_SPAN);
+    if (first > last) return false;
+    vector<Vsop87Series> planets(EPHEMERIS_CHECK_COUNT - 1);
+    for (size_t b = 0; b + 1 < EPHEMERIS_CHECK_COUNT; b++) {
+        buildEmbeddedVsop87(vsop87Planet(EPHEMERIS_CHECK_BODIES[b].target), 0.0, planets[b]);
+    }
+    ElpSeries moon;
+    buildElpSeries(0.0, moon);
+
+    for (size_t b = 0; b < EPHEMERIS_CHECK_COUNT; b++) {
+        const EphemerisCheckBody& body = EPHEMERIS_CHECK_BODIES[b];
+        deviation[b] = std::numeric_limits<double>::quiet_NaN();
+        for (size_t e = 0; e < epochs; e++) {
+            double days = epochs > 1 ? first + (last - first) * e / (epochs - 1) : 0.5 * (first + last);
+            double equatorial[3], file[3], theory[3];
+            if (!ephemerisPosition(ephemeris, body.target, body.center, days, equatorial) ||
+                std::isnan(equatorial[0])) {
+                break;
+            }
+            equatorialToEcliptic(equatorial, file);
+            if (body.target == NAIF_MOON) {
+                evaluateElp(moon, days, theory, SimdKernel::Scalar);
+                for (int axis = 0; axis < 3; axis++) theory[axis] /= KM_PER_AU;
+            } else {
+                evaluateVsop87(planets[b], days, theory, SimdKernel::Scalar);
+            }
+            double dx = file[0] - theory[0], dy = file[1] - theory[1], dz = file[2] - theory[2];
+            double distance = sqrt(theory[0] * theory[0] + theory[1] * theory[1] + theory[2] * theory[2]);
+            double arcseconds = sqrt(dx * dx + dy * dy + dz * dz) / distance * ARCSECONDS_PER_RADIAN;
+            deviation[b] = e == 0 ? arcseconds : max(deviation[b], arcseconds);
+        }
+    }
+    return true;
+}
+
+// --- SEÇÃO DE POSIÇÕES HELIOCÊNTRICAS ---
+
+// Posições físicas dos corpos, em UA na eclíptica J2000 em relação ao Sol, para os cálculos em
+// lote, que não passam pela escala da cena. O modelo é o mesmo da animação: as órbitas
+// keplerianas do catálogo, com o semieixo maior tirado do período como no modo N-corpos,
+// substituídas pelas teorias analíticas e pelas efemérides onde houver. As órbitas keplerianas
+// são resolvidas em double (KeplerOrbit), não pelos lotes em float da cena. Só lê estado montado
+// em initHeliocentricModel(), então pode ser chamado de várias threads ao mesmo tempo.
+vector<string> g_BodyNames;                         // Sol, planetas e Lua, na ordem de g_BodyInstances.
+vector<KeplerOrbit> g_PlanetOrbitsAu, g_MoonOrbitAu; // Como g_PlanetOrbits e g_MoonOrbit, em UA.
+
+// Monta as órbitas em UA. Chamada depois de initBodies() e das efemérides e teorias analíticas.
+void initHeliocentricModel() {
+    g_PlanetOrbitsAu.clear();
+    g_MoonOrbitAu.clear();
+    double sunMu = GAUSS_GRAVITY * g_Sun.mass;
+    for (const auto& planet : g_Planets) {
+        OrbitalElements orbit = planet.orbit;
+        orbit.semiMajorAxis = semiMajorAxisFromPeriod(orbit.period, sunMu + GAUSS_GRAVITY * planet.mass);
+        g_PlanetOrbitsAu.push_back(KeplerOrbit(orbit));
+    }
+    if (g_MoonPlanet >= 0 && g_MoonOrbit.size() > 0) {
+        OrbitalElements orbit = g_Moon.orbit;
+        double mu = GAUSS_GRAVITY * (g_Planets[g_MoonPlanet].mass + g_Moon.mass);
+        orbit.semiMajorAxis = semiMajorAxisFromPeriod(orbit.period, mu);
+        g_MoonOrbitAu.push_back(KeplerOrbit(orbit));
+    }
+}
+
+// Posições de todos os corpos de g_BodyNames no instante 'days', (x, y, z) de cada um em
+// sequência em 'xyz'.
+void heliocentricPositions(double days, double* xyz) {
+    size_t planetCount = g_PlanetOrbitsAu.size();
+    xyz[0] = xyz[1] = xyz[2] = 0.0;
+    for (size_t i = 0; i < planetCount; i++) {
+        double* p = xyz + 3 * (1 + i);
+        double equatorial[3];
+        if (g_EphemerisMode && ephemerisPosition(g_Ephemeris, g_PlanetNaif[i], NAIF_SUN, days, equatorial) &&
+            !std::isnan(equatorial[0])) {
+            equatorialToEcliptic(equatorial, p);
+        } else if (g_AnalyticMode && g_PlanetTheories[i].size() > 0) {
+            evaluateVsop87(g_PlanetTheories[i], days, p, g_SimdKernel);
+        } else {
+            g_PlanetOrbitsAu[i].position(days, p);
+        }
+    }
+    if (g_MoonOrbitAu.size() == 0) return;
+    double* moon = xyz + 3 * (1 + planetCount);
+    const double* earth = xyz + 3 * (1 + g_MoonPlanet);
+    double equatorial[3];
+    if (g_EphemerisMode && ephemerisPosition(g_Ephemeris, NAIF_MOON, NAIF_EARTH, days, equatorial) &&
+        !std::isnan(equatorial[0])) {
+        equatorialToEcliptic(equatorial, moon);
+    } else if (g_AnalyticMode) {
+        evaluateElp(g_MoonTheory, days, moon, g_SimdKernel);
+        for (int axis = 0; axis < 3; axis++) moon[axis] /= KM_PER_AU;
+    } else {
+        g_MoonOrbitAu[0].position(days, moon);
+    }
+    for (int axis = 0; axis < 3; axis++) moon[axis] += earth[axis];
+}
+
+// --- SEÇÃO DE EXPORTAÇÃO ---
+
+// Com --export, o programa roda sem janela: avalia as posições heliocêntricas de todos os corpos
+// de --date até --until, a cada --step dias, em todas as threads, e grava um CSV (arquivo .csv)
+// ou o armazém colunar de trajectory_store.h (qualquer outro nome). Os instantes são divididos em
+// lotes de blocos: as threads avaliam e codificam um lote enquanto outra thread grava o anterior.
+const double EXPORT_QUANTUM = 1e-9;     // UA (0,15 km): resolução das posições gravadas.
+const size_t EXPORT_BLOCKS_PER_THREAD = 4; // Blocos de cada thread por lote.
+
+string g_ExportPath;                    // Arquivo de --export; vazio fora do modo de exportação.
+double g_ExportEndDays = NAN;           // --until; por padrão, 100 anos depois do início.
+double g_ExportStep = 1.0;              // --step, em dias.
+
+// Acrescenta 'value' a 'out' com 'decimals' casas (até 9). Feito à mão porque o printf domina o
+// tempo da exportação em CSV.
+void appendFixed(string& out, double value, int decimals) {
+    static const uint64_t POWERS[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    double product = value * POWERS[decimals];
+    int64_t scaled = (int64_t)(product + (product < 0.0 ? -0.5 : 0.5));
+    if (scaled < 0) out += '-';
+    uint64_t magnitude = scaled < 0 ? -(uint64_t)scaled : (uint64_t)scaled;
+    uint64_t integer = magnitude / POWERS[decimals], fraction = magnitude % POWERS[decimals];
+    char digits[32];
+    int n = 0;
+    for (int i = 0; i < decimals; i++, fraction /= 10) digits[n++] = (char)('0' + fraction % 10);
+    if (decimals > 0) digits[n++] = '.';
+    do {
+        digits[n++] = (char)('0' + integer % 10);
+        integer /= 10;
+    } while (integer > 0);
+    while (n > 0) out += digits[--n];
+}
+
+// Linhas do CSV de 'count' instantes a partir de 'first': o instante em dias desde J2000 e
+// (x, y, z) de cada corpo, em UA.
+void formatCsvRows(const double* xyz, uint64_t first, size_t count, size_t bodies, vector<uint8_t>& out) {
+    string text;
+    text.reserve(count * (16 + bodies * 3 * 14));
+    for (size_t s = 0; s < count; s++) {
+        appendFixed(text, g_StartDays + (first + s) * g_ExportStep, 6);
+        for (size_t c = 0; c < bodies * 3; c++) {
+            text += ',';
+            appendFixed(text, xyz[s * bodies * 3 + c], 9);
+        }
+        text += '\n';
+    }
+    out.assign(text.begin(), text.end());
+}
+
+// Roda a exportação e retorna o código de saída do programa.
+int exportTrajectories() {
+    initHeliocentricModel();
+    const size_t bodies = g_BodyNames.size();
+    const double end = std::isnan(g_ExportEndDays) ? g_StartDays + 36525.0 : g_ExportEndDays;
+    if (!(g_ExportStep > 0.0) || !(end >= g_StartDays)) {
+        cerr << "Intervalo de exportacao invalido" << endl;
+        return 1;
+    }
+    const uint64_t samples = (uint64_t)floor((end - g_StartDays) / g_ExportStep + 1e-9) + 1;
+    const uint64_t blockSamples = TRAJECTORY_BLOCK_SAMPLES;
+    const uint64_t blockCount = (samples + blockSamples - 1) / blockSamples;
+    const string& path = g_ExportPath;
+    bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+
+    FILE* csvFile = nullptr;
+    TrajectoryWriter writer;
+    if (csv) {
+        csvFile = fopen(path.c_str(), "wb");
+        if (csvFile) {
+            string header = "dias";
+            for (const string& name : g_BodyNames) header += "," + name + "_x," + name + "_y," + name + "_z";
+            header += '\n';
+            fwrite(header.data(), 1, header.size(), csvFile);
+        }
+    }
+    if (csv ? !csvFile
+            : !beginTrajectoryStore(path.c_str(), g_BodyNames, g_StartDays, g_ExportStep, samples,
+                                    (uint32_t)blockSamples, EXPORT_QUANTUM, writer)) {
+        cerr << "Nao foi possivel criar: " << path << endl;
+        return 1;
+    }
+    printf("Exportando %llu instantes de %zu corpos (%.6g a %.6g dias desde J2000) para %s\n",
+           (unsigned long long)samples, bodies, g_StartDays, g_StartDays + (samples - 1) * g_ExportStep, path.c_str());
+
+    // Dois lotes: um sendo preenchido pelas threads de trabalho e o outro sendo gravado.
+    const size_t batchBlocks = (workerPool().size() + 1) * EXPORT_BLOCKS_PER_THREAD;
+    vector<vector<uint8_t>> batches[2] = {vector<vector<uint8_t>>(batchBlocks), vector<vector<uint8_t>>(batchBlocks)};
+    thread output;
+    bool ok = true;
+    uint64_t bytes = 0;
+    auto start = chrono::steady_clock::now();
+    for (uint64_t first = 0, batch = 0; first < blockCount; first += batchBlocks, batch ^= 1) {
+        size_t count = (size_t)min<uint64_t>(batchBlocks, blockCount - first);
+        vector<vector<uint8_t>>& encoded = batches[batch];
+        workerPool().parallelFor(count, 1, [&](size_t begin, size_t stop) {
+            vector<double> xyz(blockSamples * bodies * 3);
+            for (size_t b = begin; b < stop; b++) {
+                uint64_t firstSample = (first + b) * blockSamples;
+                size_t n = (size_t)min<uint64_t>(blockSamples, samples - firstSample);
+                for (size_t s = 0; s < n; s++) {
+                    heliocentricPositions(g_StartDays + (firstSample + s) * g_ExportStep, &xyz[s * bodies * 3]);
+                }
+                if (csv) {
+                    formatCsvRows(xyz.data(), firstSample, n, bodies, encoded[b]);
+                } else {
+                    encodeTrajectoryBlock(xyz.data(), n, (uint32_t)bodies, EXPORT_QUANTUM, encoded[b]);
+                }
+            }
+        });
+        if (output.joinable()) output.join();
+        output = thread([&, count, batch]() {
+            for (size_t b = 0; b < count && ok; b++) {
+                const vector<uint8_t>& block = batches[batch][b];
+                ok = csv ? fwrite(block.data(), 1, block.size(), csvFile) == block.size()
+                         : appendTrajectoryBlock(writer, block);
+                bytes += block.size();
+            }
+        });
+    }
+    if (output.joinable()) output.join();
+    ok = (csv ? fclose(csvFile) == 0 : finishTrajectoryStore(writer)) && ok;
+    double ms = elapsedMs(start);
+    if (!ok) {
+        cerr << "Falha ao gravar: " << path << endl;
+        return 1;
+    }
+    double coordinates = (double)samples * bodies * 3;
+    printf("%.1f s, %.2f M instantes/s (%u threads), %.1f MB, %.2f bytes por coordenada\n", ms / 1e3,
+           samples / (ms * 1e3), workerPool().size() + 1, bytes / 1e6, bytes / coordinates);
+
+    // Buscas aleatórias no arquivo gravado: o tempo de cada uma e, numa segunda passada, o desvio
+    // em relação ao modelo.
+    TrajectoryStore store;
+    if (csv || !openTrajectoryStore(path.c_str(), store)) return 0;
+    const int SEEKS = 10000, CHECKS = 1000;
+    SeededRandom random(12345);
+    auto randomSeek = [&](uint64_t& sample, uint32_t& body) {
+        sample = (uint64_t)(random() * samples);
+        body = (uint32_t)(random() * bodies);
+    };
+    double position[3];
+    bool decoded = true;
+    volatile double sink = 0.0; // Para que as buscas medidas não sejam eliminadas.
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < SEEKS; i++) {
+        uint64_t sample;
+        uint32_t body;
+        randomSeek(sample, body);
+        decoded = trajectoryPosition(store, body, sample, position) && decoded;
+        sink = position[0];
+    }
+    double seekUs = elapsedMs(start) * 1e3 / SEEKS;
+    double maxError = 0.0;
+    vector<double> expected(bodies * 3);
+    for (int i = 0; i < CHECKS; i++) {
+        uint64_t sample;
+        uint32_t body;
+        randomSeek(sample, body);
+        decoded = trajectoryPosition(store, body, sample, position) && decoded;
+        heliocentricPositions(store.header->startDays + sample * store.header->stepDays, expected.data());
+        for (int axis = 0; axis < 3; axis++) maxError = max(maxError, fabs(position[axis] - expected[body * 3 + axis]));
+    }
+    (void)sink;
+    if (!decoded) cerr << "Colunas corrompidas em " << path << endl;
+    printf("Busca aleatoria: %.2f us por posicao, desvio maximo %.2g UA\n", seekUs, maxError);
+    closeTrajectoryStore(store);
+    return 0;
+}
+
+// --- SEÇÃO DE EVENTOS ---
+
+// Conjunções, oposições, eclipses, ocultações e trânsitos do modelo heliocêntrico
+// (event_search.h). Com --events, a busca roda sem janela, de --date até --until, e grava um CSV;
+// com --jumps, roda no início do programa e as teclas '<' e '>' levam o relógio ao evento
+// anterior ou ao seguinte.
+const double SUN_RADIUS_KM = 695700.0;
+const double EARTH_RADIUS_KM = 6378.137;
+const double MOON_RADIUS_KM = 1737.4;
+
+string g_EventsPath;                 // CSV de --events; vazio fora da busca sem janela.
+bool g_EventJumps = false;           // --jumps.
+vector<AstronomicalEvent> g_Events;  // Eventos de --jumps, em ordem de tempo.
+
+// Corpos do modelo heliocêntrico que a busca precisa reconhecer. A Lua só conta se orbitar a
+// Terra.
+EventBodies eventBodies() {
+    EventBodies bodies;
+    bodies.count = g_BodyNames.size();
+    bodies.sun = 0;
+    for (size_t i = 0; i < g_PlanetNaif.size(); i++) {
+        if (g_PlanetNaif[i] == NAIF_EARTH) bodies.earth = (int)(1 + i);
+    }
+    if (g_MoonPlanet >= 0 && 1 + g_MoonPlanet == bodies.earth) bodies.moon = (int)(1 + g_Planets.size());
+    bodies.sunRadius = SUN_RADIUS_KM / KM_PER_AU;
+    bodies.earthRadius = EARTH_RADIUS_KM / KM_PER_AU;
+    bodies.moonRadius = MOON_RADIUS_KM / KM_PER_AU;
+    return bodies;
+}
+
+// Eventos entre 'from' e 'to' (dias desde J2000). Monta o modelo heliocêntrico antes.
+vector<AstronomicalEvent> findEvents(double from, double to) {
+    initHeliocentricModel();
+    EventBodies bodies = eventBodies();
+    if (bodies.earth < 0) {
+        cerr << "O catalogo nao tem a Terra; nao ha eventos a procurar" << endl;
+        return {};
+    }
+    return searchEvents(heliocentricPositions, bodies, from, to);
+}
+
+// Data e hora (TT) de um instante, como AAAA-MM-DD HH:MM.
+string formatEventDate(double days) {
+    int year, month;
+    double day;
+    calendarFromJulianDay(J2000_JULIAN_DAY + days + 0.5 / 1440.0, year, month, day); // Arredonda o minuto.
+    int minutes = (int)((day - floor(day)) * 1440.0);
+    char text[32];
+    snprintf(text, sizeof(text), "%04d-%02d-%02d %02d:%02d", year, month, (int)floor(day), minutes / 60, minutes % 60);
+    return text;
+}
+
+// Descrição de um evento em uma linha, para o terminal.
+string describeEvent(const AstronomicalEvent& event) {
+    string text = formatEventDate(event.days) + "  " + eventKindName(event.kind);
+    if (event.detail != EventDetail::None) text += string(" ") + eventDetailName(event.detail);
+    char separation[48];
+    snprintf(separation, sizeof(separation), " (separacao %.4f graus)", event.separation * 180.0 / M_PI);
+    return text + ": " + g_BodyNames[event.first] + " e " + g_BodyNames[event.second] + separation;
+}
+
+// Roda a busca de --events e retorna o código de saída do programa.
+int writeEvents() {
+    const double end = std::isnan(g_ExportEndDays) ? g_StartDays + 365250.0 : g_ExportEndDays;
+    auto start = chrono::steady_clock::now();
+    vector<AstronomicalEvent> events = findEvents(g_StartDays, end);
+    double ms = elapsedMs(start);
+    FILE* file = fopen(g_EventsPath.c_str(), "w");
+    if (!file) {
+        cerr << "Nao foi possivel criar: " << g_EventsPath << endl;
+        return 1;
+    }
+    fprintf(file, "dias,data,tipo,detalhe,corpo1,corpo2,separacao_graus\n");
+    size_t counts[6] = {};
+    for (const AstronomicalEvent& event : events) {
+        fprintf(file, "%.6f,%s,%s,%s,%s,%s,%.6f\n", event.days, formatEventDate(event.days).c_str(),
+                eventKindName(event.kind), eventDetailName(event.detail), g_BodyNames[event.first].c_str(),
+                g_BodyNames[event.second].c_str(), event.separation * 180.0 / M_PI);
+        counts[(int)event.kind]++;
+    }
+    bool ok = fclose(file) == 0;
+    printf("%zu eventos em %.0f anos, %.2f s (%u threads):", events.size(), (end - g_StartDays) / 365.25, ms / 1e3,
+           workerPool().size() + 1);
+    for (int kind = 0; kind < 6; kind++) printf(" %zu %s;", counts[kind], eventKindName((EventKind)kind));
+    printf("\n");
+    if (!ok) cerr << "Falha ao gravar: " << g_EventsPath << endl;
+    return ok ? 0 : 1;
+}
+
+// Procura os eventos de --jumps. Chamada em init(), depois das efemérides e teorias analíticas.
+void initEventJumps() {
+    const double end = std::isnan(g_ExportEndDays) ? g_StartDays + 36525.0 : g_ExportEndDays;
+    auto start = chrono::steady_clock::now();
+    g_Events = findEvents(g_StartDays, end);
+    printf("Eventos: %zu ate %s, em %.0f ms; '<' e '>' saltam entre eles\n", g_Events.size(),
+           formatEventDate(end).c_str(), elapsedMs(start));
+}
+
+// --- SEÇÃO DE INSTÂNCIAS ---
+
+// Dados de cada esfera desenhada no quadro. São calculados uma vez por quadro e usados tanto
+// pelo desenho instanciado (como buffer de instâncias) quanto pelo desenho corpo a corpo.
+struct BodyInstance {
+    float x, y, z;  // Posição do centro do corpo no mundo.
+    float radius;   // Escala aplicada à esfera unitária.
+    float heading;  // Orientação em torno do eixo Y, em graus (órbita + rotação própria).
+    float layer;    // Camada do array de texturas.
+    float lit;      // 1 para corpos iluminados pelo Sol, 0 para o próprio Sol e os anéis.
+};
+
+vector<BodyInstance> g_BodyInstances; // Esferas: Sol, planetas e Lua, nessa ordem.
+vector<BodyInstance> g_RingInstances; // Anéis, desenhados com a malha de coroa circular.
+const int PLANET_INSTANCE_BASE = 1;   // Índice do primeiro planeta em g_BodyInstances.
+
+// Programa GLSL do caminho instanciado; 0 quando o contexto não suporta GL 3.3.
+GLuint g_InstancedProgram = 0;
+GLint g_LayerMinLodLocation = -1, g_LayerSlotsLocation = -1, g_TierCountLocation = -1, g_LayerSizeLocation = -1;
+GLuint g_InstanceVBO = 0;
+
+// Dias terrestres por unidade de tempo da animação: na velocidade 1 a Terra dá uma volta a cada
+// 360 unidades.
+const double DAYS_PER_ANIMATION_UNIT = 365.0 / 360.0;
+
+// Dias desde a época J2000 no instante 'clock'.
+double clockDays(const SimulationClock& clock) {
+    return clock.ticks * DAYS_PER_ANIMATION_UNIT + clock.fraction * DAYS_PER_ANIMATION_UNIT;
+}
+
+// Relógio no instante 'days' desde a época J2000.
+SimulationClock clockAtDays(double days) {
+    SimulationClock clock;
+    double units = days / DAYS_PER_ANIMATION_UNIT;
+    clock.ticks = (int64_t)floor(units);
+    clock.fraction = units - floor(units);
+    return clock;
+}
+
+// Longitude, em graus, do vetor (x, z) no plano XZ, no mesmo sentido de glRotatef em torno de +Y.
+float headingOf(float x, float z) {
+    return atan2(-z, x) * 180.0f / M_PI;
+}
+
+// Calcula a posição e a orientação de todas as esferas no instante 'clock' da animação. As
+// posições vêm das órbitas keplerianas (kepler.h), das teorias analíticas ou das efemérides, ou do estado atual da
+// integração no modo N-corpos, e os ângulos de rotação de clockAngle(), já reduzidos a uma volta, para não perder
+// precisão com o tempo.
+void computeBodyInstances(const SimulationClock& clock, vector<BodyInstance>& bodies, vector<BodyInstance>& rings) {
+    bodies.clear();
+    rings.clear();
+    double days = clockDays(clock);
+
+    // --- Sol ---
+    float sunRotationAngle = clockAngle(clock, 365.0 / g_Sun.rotationSpeed); // Cálculo da rotação do Sol.
+    bodies.push_back({0.0f, 0.0f, 0.0f, g_Sun.radius, sunRotationAngle, (float)g_Sun.textureLayer, 0.0f});
+
+    // --- Planetas ---
+    size_t planetCount = g_Planets.size();
+    vector<float> x(planetCount), y(planetCount), z(planetCount);
+    if (g_NBodyMode) {
+        for (size_t i = 0; i < planetCount; i++) nbodyScenePosition(1 + i, x[i], y[i], z[i]);
+    } else {
+        solveKeplerPositions(g_PlanetOrbits, days, x.data(), y.data(), z.data(), 0, planetCount);
+        if (g_AnalyticMode) analyticPlanetPositions(days, x.data(), y.data(), z.data());
+        if (g_EphemerisMode) ephemerisPlanetPositions(days, x.data(), y.data(), z.data());
+    }
+    for (size_t i = 0; i < planetCount; i++) {
+        const CelestialBody& planet = g_Planets[i];
+        // Ângulo da rotação própria: baseado no tempo e período de rotação do planeta.
+        // O fator 30.0 foi ajustado para uma melhor visualização.
+        float rotationAngle = clockAngle(clock, 30.0 / planet.rotationSpeed);
+
+        // A orientação soma a longitude do planeta na órbita e a rotação própria, como
+        // glRotatef(longitude) + glTranslatef(distance) + glRotatef(rotationAngle) fazia.
+        float heading = (float)wrapDegrees(headingOf(x[i], z[i]) + rotationAngle);
+        bodies.push_back({x[i], y[i], z[i], planet.radius, heading, (float)planet.textureLayer, 1.0f});
+    }
+
+    // --- Anéis de Saturno ---
+    // Vão de (raio de Saturno + 0.5) até (raio de Saturno + 4.0); a malha tem raio externo 1.
+    if (g_RingPlanet >= 0) {
+        BodyInstance ring = bodies[PLANET_INSTANCE_BASE + g_RingPlanet];
+        ring.radius += 4.0f;
+        ring.layer = (float)g_RingLayer;
+        ring.lit = 0.0f;
+        rings.push_back(ring);
+    }
+
+    // --- Lua ---
+    // A órbita da Lua é relativa à Terra. Ela mantém sempre a mesma face voltada para a Terra,
+    // então sua orientação acompanha a longitude na órbita.
+    if (g_MoonPlanet >= 0 && g_MoonOrbit.size() > 0) {
+        const BodyInstance& earth = bodies[PLANET_INSTANCE_BASE + g_MoonPlanet];
+        float offsetX, offsetY, offsetZ;
+        if (g_NBodyMode && g_NBodyMoon >= 0) {
+            size_t earthIndex = 1 + g_MoonPlanet;
+            offsetX = (float)((g_NBody.x[g_NBodyMoon] - g_NBody.x[earthIndex]) * g_NBodyMoonScale);
+            offsetY = (float)((g_NBody.z[g_NBodyMoon] - g_NBody.z[earthIndex]) * g_NBodyMoonScale);
+            offsetZ = (float)(-(g_NBody.y[g_NBodyMoon] - g_NBody.y[earthIndex]) * g_NBodyMoonScale);
+        } else if (!g_EphemerisMode || !ephemerisMoonOffset(days, offsetX, offsetY, offsetZ)) {
+            if (g_AnalyticMode) {
+                analyticMoonOffset(days, offsetX, offsetY, offsetZ);
+            } else {
+                solveKeplerPositions(g_MoonOrbit, days, &offsetX, &offsetY, &offsetZ, 0, 1);
+            }
+        }
+        bodies.push_back({earth.x + offsetX, earth.y + offsetY, earth.z + offsetZ, g_Moon.radius,
+                          (float)wrapDegrees(headingOf(offsetX, offsetZ)), (float)g_Moon.textureLayer, 1.0f});
+    }
+}
+
+// --- SEÇÃO DE SIMULAÇÃO ---
+
+// A simulação roda em uma thread própria, com passo fixo de 1/SIMULATION_RATE segundo,
+// independente do timer do GLUT e do tempo de desenho de cada quadro. Cada passo publica o
+// estado anterior e o atual em um triple buffer; o desenho interpola entre os dois conforme o
+// instante em que o quadro é desenhado. Se a thread atrasar (um passo mais pesado, o sistema
+// ocupado), os passos vencidos são executados em seguida e só o último é publicado, então o
+// tempo simulado nunca fica para trás do relógio. No modo N-corpos a integração é feita uma vez
+// por volta, até o tempo do último passo vencido, porque uma avaliação de forças pode levar mais
+// que um passo inteiro.
+const int SIMULATION_RATE = 120; // Passos por segundo.
+// Avanço do tempo da animação por segundo na velocidade 1: uma unidade a cada 16 ms, o mesmo
+// ritmo de quando o tempo avançava a cada tick do timer.
+const float ANIMATION_UNITS_PER_SECOND = 62.5f;
+
+// Estado publicado pela thread de simulação a cada passo.
+struct SimulationState {
+    uint64_t step = 0;                          // Passos executados até este estado.
+    uint64_t sequence = 0;                      // Estados publicados antes deste.
+    SimulationClock previousClock, clock;       // Tempo da animação no passo anterior e neste.
+    chrono::steady_clock::time_point stepTime;  // Instante do relógio que corresponde ao passo.
+    vector<BodyInstance> previousBodies, bodies; // Esferas no passo anterior e neste.
+    vector<BodyInstance> previousRings, rings;
+    vector<float> particles;                    // Partículas do modo N-corpos (x, y, z).
+    float alpha = NAN;                          // Na reprodução, a posição gravada do quadro entre
+                                                // os dois passos; NaN ao vivo.
+};
+
+TripleBuffer<SimulationState> g_SimulationStates;
+SimulationClock g_FrameClock; // Tempo da animação no quadro atual, entre os dois últimos passos.
+float g_FrameAlpha = 0.0f;    // Posição do quadro atual entre os dois passos, de 0 a 1.
+// Instante, em dias desde J2000, para onde o relógio deve saltar, pedido pela thread do GLUT; NaN
+// quando não há pedido. A thread de simulação o consome no início de cada volta.
+atomic<double> g_ClockJumpDays{NAN};
+thread g_SimulationThread;
+atomic<bool> g_SimulationStopping{false};
+// Com --record no modo N-corpos, o que cada volta da simulação fez, até a thread do OpenGL
+// gravar no registro de sessão os estados que ela desenhou (recordSessionFrame).
+struct PublishedStep {
+    uint64_t sequence;
+    SimulationClock clock;
+    uint8_t flags;     // SESSION_STEP_*.
+    double seekDays;   // Destino, com SESSION_STEP_NEW_SEEK.
+};
+bool g_RecordingSteps = false; // Definido antes de a thread de simulação começar.
+mutex g_PublishedStepsMutex;
+vector<PublishedStep> g_PublishedSteps;
+
+// Intervalo entre dois passos da simulação.
+chrono::steady_clock::duration simulationStep() {
+    return chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(1.0 / SIMULATION_RATE));
+}
+
+// Laço da thread de simulação.
+void simulationLoop(chrono::steady_clock::time_point start) {
+    const auto step = simulationStep();
+    SimulationClock clock = clockAtDays(g_StartDays);
+    uint64_t steps = 0;
+    vector<BodyInstance> previousBodies, bodies, previousRings, rings;
+    vector<float> particles;
+    computeBodyInstances(clock, bodies, rings);
+    if (g_NBodyMode) nbodyParticlePositions(particles);
+    SimulationClock publishedClock = clock;
+    auto nextStep = start + step;
+    double seekDays = NAN; // Destino de um salto ou avanço ainda não alcançado.
+    auto seekStart = start;
+    int seekRounds = 0;
+    double seekFrom = 0.0;    // Instante do relógio quando o salto ou avanço foi pedido.
+    bool advancing = false;
+    uint64_t sequence = 0;
+    while (!g_SimulationStopping.load(memory_order_relaxed)) {
+        this_thread::sleep_until(nextStep);
+        uint8_t stepFlags = 0;
+        double jump = g_ClockJumpDays.exchange(NAN, memory_order_relaxed);
+        if (!std::isnan(jump)) {
+            stepFlags |= SESSION_STEP_NEW_SEEK;
+            seekDays = jump;
+            seekStart = chrono::steady_clock::now();
+            seekRounds = 0;
+            seekFrom = clockDays(clock);
+            advancing = false;
+            g_TimelineAdvancing = false;
+        }
+        if (!std::isnan(seekDays)) {
+            // Depois de um salto não há o que interpolar: o estado anterior é o próprio destino.
+            SeekProgress progress = SeekProgress::Reached;
+            double days = g_NBodyMode ? seekNBody(seekDays, progress) : seekDays;
+            seekRounds++;
+            stepFlags |= SESSION_STEP_SEEK | (progress == SeekProgress::Reached ? SESSION_STEP_SEEK_REACHED : 0);
+            // Um destino além do último checkpoint vira um avanço, anunciado e medido à parte.
+            if (progress == SeekProgress::Advancing && !advancing) {
+                advancing = true;
+                g_TimelineAdvanceDays = seekDays - seekFrom;
+                g_TimelineAdvancing = true;
+                printf("Destino alem do trecho integrado: avancando a integracao %.0f dias ate la\n", seekDays - seekFrom);
+            }
+            if (advancing) {
+                g_TimelineAdvanceDone = days - seekFrom;
+                g_TimelineAdvanceMs = elapsedMs(seekStart);
+            }
+            if (progress == SeekProgress::Reached) {
+                seekDays = NAN;
+                double seekMs = elapsedMs(seekStart);
+                if (advancing) {
+                    g_TimelineAdvancing = false;
+                    printf("Avanco concluido: %.0f dias em %.1f s\n", g_TimelineAdvanceDays.load(), seekMs / 1000.0);
+                } else {
+                    g_TimelineSeekMs = seekMs;
+                    g_TimelineSeekRounds = seekRounds;
+                    if (seekMs > g_TimelineSeekWorstMs) g_TimelineSeekWorstMs = seekMs;
+                }
+            }
+            clock = publishedClock = clockAtDays(days);
+            computeBodyInstances(clock, bodies, rings);
+            if (g_NBodyMode) nbodyParticlePositions(particles);
+            previousBodies = bodies;
+            previousRings = rings;
+        }
+        auto stepTime = nextStep;
+        SimulationClock previousClock = clock;
+        // Enquanto um salto não chega ao destino, o relógio fica parado.
+        if (!std::isnan(seekDays)) nextStep = chrono::steady_clock::now() + step;
+        while (chrono::steady_clock::now() >= nextStep) {
+            stepTime = nextStep;
+            nextStep += step;
+            steps++;
+            previousClock = clock;
+            clock.advance((double)g_AnimationSpeed.load(memory_order_relaxed) * ANIMATION_UNITS_PER_SECOND / SIMULATION_RATE);
+            if (g_NBodyMode) continue;
+            previousBodies.swap(bodies);
+            previousRings.swap(rings);
+            computeBodyInstances(clock, bodies, rings);
+        }
+        if (g_NBodyMode && std::isnan(seekDays)) {
+            // As posições anteriores são as do último estado publicado, e o relógio também.
+            previousClock = publishedClock;
+            previousBodies.swap(bodies);
+            previousRings.swap(rings);
+            advanceNBody(clockDays(clock));
+            computeBodyInstances(clock, bodies, rings);
+            nbodyParticlePositions(particles);
+        }
+
+        sequence++;
+        if (g_RecordingSteps && g_NBodyMode) {
+            lock_guard<mutex> lock(g_PublishedStepsMutex);
+            g_PublishedSteps.push_back({sequence, clock, stepFlags, jump});
+        }
+        SimulationState& state = g_SimulationStates.writeBuffer();
+        state.step = steps;
+        state.sequence = sequence;
+        state.previousClock = previousClock;
+        state.clock = clock;
+        state.stepTime = stepTime;
+        state.previousBodies = previousBodies;
+        state.bodies = bodies;
+        state.previousRings = previousRings;
+        state.rings = rings;
+        state.particles = particles;
+        g_SimulationStates.publish();
+        publishedClock = clock;
+    }
+}
+
+// Para a thread de simulação e espera ela terminar.
+void stopSimulation() {
+    if (!g_SimulationThread.joinable()) return;
+    g_SimulationStopping = true;
+    g_SimulationThread.join();
+}
+
+// Inicia a thread de simulação. Chamada uma vez, em init(), depois de initBodies(). O estado
+// inicial é calculado aqui mesmo, para que as instâncias já existam antes do primeiro quadro.
+void startSimulation() {
+    auto start = chrono::steady_clock::now();
+    SimulationState& state = g_SimulationStates.writeBuffer();
+    state.stepTime = start;
+    computeBodyInstances(clockAtDays(g_StartDays), state.bodies, state.rings);
+    state.previousBodies = state.bodies;
+    state.previousRings = state.rings;
+    g_SimulationStates.publish();
+    g_SimulationStates.update();
+    g_BodyInstances = state.bodies;
+    g_RingInstances = state.rings;
+    g_SimulationThread = thread(simulationLoop, start);
+    atexit(stopSimulation); // O GLUT encerra o programa com exit().
+}
+
+// Interpola entre duas listas de instâncias com a mesma ordem. As posições são interpoladas
+// linearmente e levadas de volta à distância interpolada do Sol, para que a corda entre dois
+// passos não corte a órbita quando a aceleração é alta. As orientações, que vêm reduzidas a
+// [0, 360), seguem o caminho mais curto entre os dois passos.
+void interpolateInstances(const vector<BodyInstance>& from, const vector<BodyInstance>& to, float alpha,
+                          vector<BodyInstance>& result) {
+    result = to;
+    if (from.size() != to.size()) return;
+    for (size_t i = 0; i < to.size(); i++) {
+        float x = from[i].x + (to[i].x - from[i].x) * alpha;
+        float y = from[i].y + (to[i].y - from[i].y) * alpha;
+        float z = from[i].z + (to[i].z - from[i].z) * alpha;
+        float fromDistance = sqrt(from[i].x * from[i].x + from[i].y * from[i].y + from[i].z * from[i].z);
+        float toDistance = sqrt(to[i].x * to[i].x + to[i].y * to[i].y + to[i].z * to[i].z);
+        float distance = sqrt(x * x + y * y + z * z);
+        // Perto de meia volta entre os passos, a corda passa pelo Sol e a direção se perde.
+        if (distance < 0.05f * toDistance) continue;
+        float scale = distance > 0.0f ? (fromDistance + (toDistance - fromDistance) * alpha) / distance : 1.0f;
+        result[i].x = x * scale;
+        result[i].y = y * scale;
+        result[i].z = z * scale;
+        float turn = (float)remainder(to[i].heading - from[i].heading, 360.0);
+        result[i].heading = (float)wrapDegrees(from[i].heading + turn * alpha);
+    }
+}
+
+// Atualiza g_BodyInstances, g_RingInstances, g_FrameClock e g_FrameAlpha para o instante atual
+// a partir do último estado publicado pela simulação. O quadro mostra o mundo com um passo de
+// atraso: entre o passo anterior e o último, conforme o tempo decorrido desde ele, ou, na
+// reprodução, na posição gravada.
+void updateBodyInstances() {
+    g_SimulationStates.update();
+    const SimulationState& state = g_SimulationStates.readBuffer();
+    auto step = simulationStep();
+    float alpha = state.alpha;
+    if (std::isnan(alpha)) {
+        alpha = (float)((chrono::steady_clock::now() - state.stepTime) / chrono::duration<double>(step));
+        alpha = clamp(alpha, 0.0f, 1.0f);
+    }
+    g_FrameAlpha = alpha;
+    interpolateInstances(state.previousBodies, state.bodies, alpha, g_BodyInstances);
+    interpolateInstances(state.previousRings, state.rings, alpha, g_RingInstances);
+    double stepUnits = (double)(state.clock.ticks - state.previousClock.ticks) +
+                       (state.clock.fraction - state.previousClock.fraction);
+    g_FrameClock = state.previousClock;
+    g_FrameClock.advance(stepUnits * alpha);
+}
+
+// Shaders do caminho instanciado. A iluminação reproduz o pipeline fixo (luz pontual
+// GL_LIGHT0 e material padrão), calculada por fragmento.
+const char* INSTANCED_VERTEX_SHADER = R"(
+#version 130
+in vec3 a_Position;
+in vec3 a_Normal;
+in vec2 a_TexCoord;
+in vec4 a_Placement;  // xyz: posição do corpo, w: raio.
+in vec3 a_Attributes; // x: orientação em graus, y: camada de textura, z: iluminado.
+out vec3 v_TexCoord;
+out vec3 v_Normal;
+out vec3 v_EyePosition;
+flat out float v_Lit;
+
+// Rotação em torno de Y, igual à de glRotatef(angle, 0, 1, 0).
+vec3 rotateY(vec3 v, float c, float s) {
+    return vec3(c * v.x + s * v.z, v.y, -s * v.x + c * v.z);
+}
+
+void main() {
+    float angle = radians(a_Attributes.x);
+    float c = cos(angle), s = sin(angle);
+    vec4 world = vec4(rotateY(a_Position, c, s) * a_Placement.w + a_Placement.xyz, 1.0);
+    vec4 eye = gl_ModelViewMatrix * world; // A modelview contém apenas a câmera.
+    v_TexCoord = vec3(a_TexCoord, a_Attributes.y);
+    v_Normal = mat3(gl_ModelViewMatrix) * rotateY(a_Normal, c, s);
+    v_EyePosition = eye.xyz;
+    v_Lit = a_Attributes.z;
+    gl_Position = gl_ProjectionMatrix * eye;
+}
+)";
+
+const char* INSTANCED_FRAGMENT_SHADER = R"(
+#version 130
+uniform sampler2DArray u_Textures;  // Array base: níveis a partir de u_TierCount.
+uniform sampler2DArray u_Detail0;   // Vagas dos níveis detalhados 0, 1 e 2.
+uniform sampler2DArray u_Detail1;
+uniform sampler2DArray u_Detail2;
+uniform int u_TierCount;
+uniform vec2 u_LayerSize;           // Tamanho do nível 0 das camadas, em texels.
+uniform float u_LayerMinLod[64];    // Nível mais detalhado disponível de cada camada.
+uniform ivec3 u_LayerSlots[64];     // Vaga de cada camada nos níveis detalhados.
+in vec3 v_TexCoord;
+in vec3 v_Normal;
+in vec3 v_EyePosition;
+flat in float v_Lit;
+
+// Amostra um único nível de mipmap de uma camada, esteja ele no array base ou em uma vaga.
+vec4 sampleLevel(vec2 uv, int layer, int level) {
+    if (level >= u_TierCount) return textureLod(u_Textures, vec3(uv, layer), float(level - u_TierCount));
+    ivec3 slots = u_LayerSlots[layer];
+    if (level == 0) return textureLod(u_Detail0, vec3(uv, slots.x), 0.0);
+    if (level == 1) return textureLod(u_Detail1, vec3(uv, slots.y), 0.0);
+    return textureLod(u_Detail2, vec3(uv, slots.z), 0.0);
+}
+
+// Amostra a camada com o nível de mipmap usual, mas sem descer abaixo do que está disponível.
+// Entre os níveis detalhados, que ficam em texturas separadas, a interpolação é feita aqui.
+vec4 sampleLayer(vec3 coord) {
+    int layer = int(coord.z + 0.5);
+    vec2 texels = coord.xy * u_LayerSize;
+    vec2 dx = dFdx(texels), dy = dFdy(texels);
+    float lod = max(0.5 * log2(max(dot(dx, dx), dot(dy, dy))), u_LayerMinLod[layer]);
+    if (lod >= float(u_TierCount)) return textureLod(u_Textures, coord, lod - float(u_TierCount));
+    int level = int(lod);
+    return mix(sampleLevel(coord.xy, layer, level), sampleLevel(coord.xy, layer, level + 1), lod - float(level));
+}
+
+void main() {
+    vec4 color = vec4(1.0);
+    if (v_Lit > 0.5) {
+        vec3 N = normalize(v_Normal);
+        vec3 L = normalize(gl_LightSource[0].position.xyz - v_EyePosition);
+        color = gl_LightModel.ambient * gl_FrontMaterial.ambient
+              + gl_LightSource[0].ambient * gl_FrontMaterial.ambient
+              + gl_LightSource[0].diffuse * gl_FrontMaterial.diffuse * max(dot(N, L), 0.0);
+        color.a = gl_FrontMaterial.diffuse.a;
+    }
+    gl_FragColor = color * sampleLayer(v_TexCoord);
+}
+)";
+
+// Compila um shader; em caso de erro, mostra o log e retorna 0.
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        cerr << "Falha ao compilar shader: " << log << endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Prepara o caminho instanciado. Sem GL 3.3 (ou se os shaders falharem) o desenho
+// continua sendo feito corpo a corpo com o pipeline fixo.
+void initInstancing() {
+    if (!glVersionAtLeast(3, 3)) return;
+
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, INSTANCED_VERTEX_SHADER);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, INSTANCED_FRAGMENT_SHADER);
+    if (!vertexShader || !fragmentShader) return;
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glBindAttribLocation(program, 0, "a_Position");
+    glBindAttribLocation(program, 1, "a_Normal");
+    glBindAttribLocation(program, 2, "a_TexCoord");
+    glBindAttribLocation(program, 3, "a_Placement");
+    glBindAttribLocation(program, 4, "a_Attributes");
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        cerr << "Falha ao ligar o programa de instancias: " << log << endl;
+        glDeleteProgram(program);
+        return;
+    }
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "u_Textures"), 0);
+    glUniform1i(glGetUniformLocation(program, "u_Detail0"), 1);
+    glUniform1i(glGetUniformLocation(program, "u_Detail1"), 2);
+    glUniform1i(glGetUniformLocation(program, "u_Detail2"), 3);
+    g_LayerMinLodLocation = glGetUniformLocation(program, "u_LayerMinLod");
+    g_LayerSlotsLocation = glGetUniformLocation(program, "u_LayerSlots");
+    g_TierCountLocation = glGetUniformLocation(program, "u_TierCount");
+    g_LayerSizeLocation = glGetUniformLocation(program, "u_LayerSize");
+    glUseProgram(0);
+
+    g_InstancedProgram = program;
+    glGenBuffers(1, &g_InstanceVBO);
+}
+
+// Desenha instâncias uma a uma com o pipeline fixo (caminho para contextos antigos).
+void drawInstancesFixed(const vector<BodyInstance>& instances, const Mesh& mesh) {
+    for (const auto& body : instances) {
+        glPushMatrix();
+        glTranslatef(body.x, body.y, body.z);
+        glRotatef(body.heading, 0.0f, 1.0f, 0.0f);
+        glScalef(body.radius, body.radius, body.radius);
+        if (!body.lit) glDisable(GL_LIGHTING);
+        bindLayerTexture((int)body.layer);
+        drawMesh(mesh);
+        if (!body.lit) glEnable(GL_LIGHTING);
+        glPopMatrix();
+    }
+}
+
+// Desenha 'count' instâncias de uma malha, lidas a partir da instância 'first' do buffer.
+void drawMeshInstanced(const Mesh& mesh, size_t first, size_t count) {
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, px));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, nx));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, s));
+
+    size_t base = first * sizeof(BodyInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, g_InstanceVBO);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), (void*)(base + offsetof(BodyInstance, x)));
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(BodyInstance), (void*)(base + offsetof(BodyInstance, heading)));
+    glDrawElementsInstanced(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, nullptr, (GLsizei)count);
+}
+
+// Desenha todas as esferas com uma única chamada glDrawElementsInstanced e os anéis com outra.
+// Cada instância escolhe sua camada no array de texturas, que fica ligado o quadro inteiro.
+void drawBodiesInstanced() {
+    size_t sphereCount = g_BodyInstances.size();
+    size_t ringCount = g_RingInstances.size();
+    glBindBuffer(GL_ARRAY_BUFFER, g_InstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, (sphereCount + ringCount) * sizeof(BodyInstance), nullptr,
+                 GL_STREAM_DRAW); // Descarta o conteúdo do quadro anterior.
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sphereCount * sizeof(BodyInstance), g_BodyInstances.data());
+    glBufferSubData(GL_ARRAY_BUFFER, sphereCount * sizeof(BodyInstance), ringCount * sizeof(BodyInstance),
+                    g_RingInstances.data());
+
+    // O caminho instanciado usa apenas atributos genéricos.
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glUseProgram(g_InstancedProgram);
+    for (int tier = 0; tier < g_TierCount; tier++) {
+        glActiveTexture(GL_TEXTURE1 + tier);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, g_DetailTiers[tier].texture);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, g_TextureArray);
+    if (g_LayerLodDirty) {
+        float minLod[MAX_TEXTURE_LAYERS];
+        GLint slots[MAX_TEXTURE_LAYERS][RESIDENCY_TIERS];
+        for (size_t layer = 0; layer < g_Layers.size(); layer++) {
+            minLod[layer] = g_Layers[layer].minLod;
+            for (int tier = 0; tier < RESIDENCY_TIERS; tier++) slots[layer][tier] = max(g_Layers[layer].slot[tier], 0);
+        }
+        glUniform1fv(g_LayerMinLodLocation, (GLsizei)g_Layers.size(), minLod);
+        glUniform3iv(g_LayerSlotsLocation, (GLsizei)g_Layers.size(), &slots[0][0]);
+        glUniform1i(g_TierCountLocation, g_TierCount);
+        glUniform2f(g_LayerSizeLocation, (float)g_LayerWidth, (float)g_LayerHeight);
+        g_LayerLodDirty = false;
+    }
+    for (GLuint attribute = 0; attribute <= 4; attribute++) glEnableVertexAttribArray(attribute);
+    glVertexAttribDivisor(3, 1);
+    glVertexAttribDivisor(4, 1);
+
+    drawMeshInstanced(g_SphereMesh, 0, sphereCount);
+    // Os anéis são desenhados por último, depois das esferas opacas, por causa da transparência.
+    drawMeshInstanced(g_RingMesh, sphereCount, ringCount);
+
+    glVertexAttribDivisor(3, 0);
+    glVertexAttribDivisor(4, 0);
+    for (GLuint attribute = 0; attribute <= 4; attribute++) glDisableVertexAttribArray(attribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+}
+
+// --- SEÇÃO DE NUVENS DE PONTOS ---
+
+// Conjuntos grandes de pontos (cinturão de asteroides, partículas do modo N-corpos) recalculados
+// a cada quadro. Os pontos são gravados direto no VBO e desenhados como point sprites. Com
+// GL_ARB_buffer_storage o VBO tem uma seção por quadro em voo, mapeada de forma persistente;
+// sem ele, é realocado a cada quadro.
+const int POINT_BUFFER_SECTIONS = 3; // Quadros que a GPU pode estar lendo enquanto o próximo é escrito.
+const int POINT_SPRITE_SIZE = 16;
+
+struct PointCloud {
+    GLuint vbo = 0;
+    float* memory = nullptr; // VBO mapeado de forma persistente; nulo no caminho com glBufferData.
+    GLsync fences[POINT_BUFFER_SECTIONS] = {};
+    int section = 0;         // Seção do VBO persistente escrita neste quadro.
+    size_t capacity = 0;     // Pontos que cabem em cada seção.
+    vector<float> vertices;  // Vértices na memória do cliente, quando não há VBO.
+};
+
+GLuint g_PointSprite = 0; // Disco com borda suave; 0 sem suporte a point sprites.
+
+// Cria a textura dos pontos. Point sprites existem a partir do GL 2.0.
+void initPointSprite() {
+    if (!glVersionAtLeast(2, 0) && !glHasExtension("GL_ARB_point_sprite")) return;
+    unsigned char sprite[POINT_SPRITE_SIZE * POINT_SPRITE_SIZE * 4];
+    for (int y = 0; y < POINT_SPRITE_SIZE; y++) {
+        for (int x = 0; x < POINT_SPRITE_SIZE; x++) {
+            float dx = (x + 0.5f) / POINT_SPRITE_SIZE * 2.0f - 1.0f, dy = (y + 0.5f) / POINT_SPRITE_SIZE * 2.0f - 1.0f;
+            float alpha = clamp(1.0f - sqrt(dx * dx + dy * dy), 0.0f, 1.0f);
+            unsigned char* texel = sprite + (y * POINT_SPRITE_SIZE + x) * 4;
+            texel[0] = texel[1] = texel[2] = 255;
+            texel[3] = (unsigned char)(alpha * 255.0f);
+        }
+    }
+    glGenTextures(1, &g_PointSprite);
+    glBindTexture(GL_TEXTURE_2D, g_PointSprite);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, POINT_SPRITE_SIZE, POINT_SPRITE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, sprite);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Libera os buffers da nuvem e os recria para 'count' pontos.
+void resizePointCloud(PointCloud& cloud, size_t count) {
+    for (GLsync& fence : cloud.fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (cloud.vbo) glDeleteBuffers(1, &cloud.vbo); // Também desfaz o mapeamento persistente.
+    cloud = PointCloud();
+    cloud.capacity = count;
+    size_t bytes = count * 3 * sizeof(float);
+    if (g_HasVBO && (glVersionAtLeast(4, 4) || glHasExtension("GL_ARB_buffer_storage"))) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &cloud.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, cloud.vbo);
+        glBufferStorage(GL_ARRAY_BUFFER, bytes * POINT_BUFFER_SECTIONS, nullptr, flags);
+        cloud.memory = (float*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes * POINT_BUFFER_SECTIONS, flags);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (!cloud.memory) {
+            glDeleteBuffers(1, &cloud.vbo);
+            cloud.vbo = 0;
+        }
+    }
+    if (!cloud.vbo && g_HasVBO) glGenBuffers(1, &cloud.vbo);
+    if (!cloud.vbo) cloud.vertices.resize(count * 3);
+}
+
+// Desenha 'count' pontos com a cor 'color'; fill(vertices) grava as posições (x, y, z) de todos.
+// Chamada depois dos corpos opacos: os pontos são translúcidos e não escrevem no buffer de
+// profundidade.
+void drawPointCloud(PointCloud& cloud, size_t count, const function<void(float*)>& fill, const GLfloat color[4],
+                    float pointSize) {
+    if (count == 0) return;
+    if (count > cloud.capacity) resizePointCloud(cloud, count);
+
+    size_t bytes = count * 3 * sizeof(float);
+    const float* pointer = nullptr;
+    if (cloud.memory) {
+        // Espera a GPU terminar o quadro que usou esta seção, POINT_BUFFER_SECTIONS quadros atrás.
+        GLsync& fence = cloud.fences[cloud.section];
+        if (fence) {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+        size_t first = (size_t)cloud.section * cloud.capacity * 3;
+        fill(cloud.memory + first);
+        pointer = (const float*)(first * sizeof(float));
+        glBindBuffer(GL_ARRAY_BUFFER, cloud.vbo);
+    } else if (cloud.vbo) {
+        glBindBuffer(GL_ARRAY_BUFFER, cloud.vbo);
+        glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW); // Descarta o quadro anterior sem esperar a GPU.
+        float* memory = (float*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+        if (!memory) {
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            return;
+        }
+        fill(memory);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    } else {
+        fill(cloud.vertices.data());
+        pointer = cloud.vertices.data();
+    }
+
+    glDisable(GL_LIGHTING);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDepthMask(GL_FALSE);
+    if (g_PointSprite) {
+        glBindTexture(GL_TEXTURE_2D, g_PointSprite);
+        glEnable(GL_POINT_SPRITE);
+        glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_TRUE);
+        glPointSize(pointSize);
+    } else {
+        glDisable(GL_TEXTURE_2D);
+        glPointSize(1.0f);
+    }
+    glColor4fv(color);
+
+    glVertexPointer(3, GL_FLOAT, 0, pointer);
+    glDrawArrays(GL_POINTS, 0, (GLsizei)count);
+    if (cloud.memory) {
+        cloud.fences[cloud.section] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        cloud.section = (cloud.section + 1) % POINT_BUFFER_SECTIONS;
+    }
+    if (cloud.vbo) glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    if (g_PointSprite) {
+        glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_FALSE);
+        glDisable(GL_POINT_SPRITE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glPointSize(1.0f);
+    glDepthMask(GL_TRUE);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnable(GL_LIGHTING);
+    glEnable(GL_TEXTURE_2D);
+}
+
+// Partículas do modo N-corpos, na posição do último estado publicado pela simulação.
+const GLfloat NBODY_PARTICLE_COLOR[4] = {0.6f, 0.75f, 1.0f, 0.5f};
+
+PointCloud g_ParticlePoints;
+
+void drawNBodyParticles() {
+    const vector<float>& particles = g_SimulationStates.readBuffer().particles;
+    drawPointCloud(g_ParticlePoints, particles.size() / 3,
+                   [&particles](float* vertices) { memcpy(vertices, particles.data(), particles.size() * sizeof(float)); },
+                   NBODY_PARTICLE_COLOR, 2.0f);
+}
+
+// --- SEÇÃO DO CINTURÃO DE ASTEROIDES ---
+
+// Corpos menores lidos de um arquivo no formato MPCORB (belt.h). A leitura roda no pool de
+// trabalho e a thread do OpenGL assume o lote quando ela termina. A cada quadro as posições de
+// todos os corpos são calculadas no instante do quadro, divididas entre as threads de trabalho,
+// e gravadas direto na nuvem de pontos.
+const char* const DEFAULT_BELT_PATH = "MPCORB.DAT";
+const size_t BELT_GRAIN = 16384; // Corpos por bloco do parallelFor.
+const GLfloat BELT_COLOR[4] = {0.75f, 0.7f, 0.6f, 0.35f};
+
+string g_BeltPath = DEFAULT_BELT_PATH;
+KeplerBatch g_LoadedBelt;         // Preenchido pela tarefa de leitura.
+atomic<bool> g_BeltLoaded{false}; // g_LoadedBelt está pronto para a thread do OpenGL.
+KeplerBatch g_Belt;               // Corpos desenhados; só a thread do OpenGL o altera.
+PointCloud g_BeltPoints;
+
+// Dispara a leitura do arquivo do cinturão no pool de trabalho. Sem o arquivo padrão, a cena
+// fica sem cinturão; um caminho passado por --belt que não abre é avisado.
+void startBeltLoading() {
+    function<double(double)> toScene = auToSceneDistance();
+    string path = g_BeltPath;
+    workerPool().submit([toScene, path] {
+        auto start = chrono::steady_clock::now();
+        long count = loadMpcorb(path.c_str(), toScene, g_LoadedBelt);
+        if (count < 0) {
+            if (path != DEFAULT_BELT_PATH) cerr << "Nao foi possivel abrir o arquivo do cinturao: " << path << endl;
+            return;
+        }
+        printf("Cinturao: %ld corpos lidos de %s em %.0f ms (%.0f MB de elementos)\n", count, path.c_str(),
+               elapsedMs(start), count * (2 * sizeof(double) + 7 * sizeof(float)) / (1024.0 * 1024.0));
+        if (count > 0) g_BeltLoaded.store(true, memory_order_release);
+    });
+}
+
+// Calcula a posição de todos os corpos no instante 'days' e as grava em 'vertices' (x, y, z).
+void propagateBelt(double days, float* vertices) {
+    SimdKernel kernel = detectSimdKernel();
+    workerPool().parallelFor(g_Belt.size(), BELT_GRAIN, [&](size_t begin, size_t end) {
+        solveKeplerPositionsInterleaved(g_Belt, days, vertices + 3 * begin, begin, end, kernel);
+    });
+}
+
+// Desenha o cinturão no instante 'days'.
+void drawBelt(double days) {
+    if (g_BeltLoaded.exchange(false, memory_order_acquire)) g_Belt = move(g_LoadedBelt);
+    drawPointCloud(g_BeltPoints, g_Belt.size(), [days](float* vertices) { propagateBelt(days, vertices); },
+                   BELT_COLOR, 2.0f);
+}
+
+// --- SEÇÃO DE RESIDÊNCIA DE TEXTURAS ---
+
+// A cada tick, estima quantos texels de cada camada caem em um pixel da tela e decide de qual
+// nível de detalhe ela precisa. Os níveis detalhados ocupam vagas compartilhadas, reservadas
+// dentro do orçamento de memória; quando não há vaga livre, a vaga usada há mais tempo (e que
+// não é necessária no quadro atual) é liberada. Níveis liberados voltam do pacote de assets,
+// ou de uma nova decodificação, quando a câmera se aproxima outra vez.
+
+unsigned g_ResidencyFrame = 0;
+
+// Nível de mipmap necessário para um corpo: o primeiro em que um texel cobre pelo menos um pixel
+// no centro do disco visível, onde metade da largura da textura ocupa o diâmetro do corpo.
+// Corpos fora do campo de visão só precisam do array base.
+int requiredTextureLevel(const BodyInstance& body, float camX, float camZ) {
+    float dx = body.x - camX, dy = body.y - CAMERA_HEIGHT, dz = body.z - camZ;
+    float distance = sqrt(dx * dx + dy * dy + dz * dz);
+    if (distance <= body.radius) return 0;
+
+    // A câmera sempre olha para a origem (ver display()).
+    float cameraDistance = sqrt(camX * camX + CAMERA_HEIGHT * CAMERA_HEIGHT + camZ * camZ);
+    float cosAngle = -(dx * camX + dy * CAMERA_HEIGHT + dz * camZ) / (distance * cameraDistance);
+    float tanHalfFov = tan(FIELD_OF_VIEW * 0.5f * M_PI / 180.0f);
+    float aspect = (float)g_WindowWidth / g_WindowHeight;
+    float halfDiagonal = atan(tanHalfFov * sqrt(1.0f + aspect * aspect));
+    if (acos(clamp(cosAngle, -1.0f, 1.0f)) - asin(body.radius / distance) > halfDiagonal) return g_TierCount;
+
+    float diameterPx = body.radius / (distance * tanHalfFov) * g_WindowHeight;
+    float texelsPerPixel = 0.5f * g_LayerWidth / max(diameterPx, 1e-3f);
+    return min(max((int)floor(log2(max(texelsPerPixel, 1.0f))), 0), g_TierCount);
+}
+
+// Libera a vaga 'slot' do nível 'tier'. As vagas mais detalhadas da mesma camada também são
+// liberadas, já que não podem ser amostradas sem ela.
+void releaseDetailSlot(int tier, int slot) {
+    int layer = g_DetailTiers[tier].slotLayer[slot];
+    for (int finer = tier; finer >= 0; finer--) {
+        int finerSlot = g_Layers[layer].slot[finer];
+        if (finerSlot < 0) continue;
+        g_DetailTiers[finer].slotLayer[finerSlot] = -1;
+        g_DetailTiers[finer].slotReady[finerSlot] = false;
+        g_Layers[layer].slot[finer] = -1;
+    }
+    updateLayerMinLod(layer);
+    g_LayerLodDirty = true;
+}
+
+// Procura uma vaga no nível 'tier': uma livre ou, se não houver, a usada há mais tempo entre as
+// que não foram necessárias no quadro atual. Retorna -1 se todas estiverem em uso.
+int acquireDetailSlot(int tier) {
+    DetailTier& detail = g_DetailTiers[tier];
+    int victim = -1;
+    for (int slot = 0; slot < (int)detail.slotLayer.size(); slot++) {
+        if (detail.slotLayer[slot] < 0) return slot;
+        if (detail.slotLastUsed[slot] < g_ResidencyFrame &&
+            (victim < 0 || detail.slotLastUsed[slot] < detail.slotLastUsed[victim])) {
+            victim = slot;
+        }
+    }
+    if (victim >= 0) {
+        releaseDetailSlot(tier, victim);
+        g_Residency.evictions++;
+    }
+    return victim;
+}
+
+// Reserva as vagas de que cada camada precisa no quadro atual e pede os níveis que faltam.
+// Camadas mais prioritárias (menor valor) reservam primeiro. Chamada pela thread do OpenGL a
+// cada quadro, antes de pumpTextureUploads().
+void updateTextureResidency(const vector<float>& layerPriority) {
+    if (g_TierCount == 0) return;
+    g_ResidencyFrame++;
+    float camX, camZ;
+    cameraPosition(camX, camZ);
+    for (auto& layer : g_Layers) layer.wantedLevel = g_TierCount;
+    for (const auto* instances : {&g_BodyInstances, &g_RingInstances}) {
+        for (const auto& body : *instances) {
+            int& wanted = g_Layers[(int)body.layer].wantedLevel;
+            wanted = min(wanted, requiredTextureLevel(body, camX, camZ));
+        }
+    }
+
+    vector<int> order(g_Layers.size());
+    for (size_t layer = 0; layer < order.size(); layer++) order[layer] = (int)layer;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return layerPriority[a] < layerPriority[b]; });
+    bool compress = g_TextureFormat != GL_RGBA8;
+    for (int layer : order) {
+        TextureLayer& state = g_Layers[layer];
+        for (int tier = g_TierCount - 1; tier >= state.wantedLevel; tier--) {
+            DetailTier& detail = g_DetailTiers[tier];
+            int slot = state.slot[tier];
+            if (slot < 0) {
+                slot = acquireDetailSlot(tier);
+                if (slot < 0) break; // Orçamento esgotado neste nível.
+                detail.slotLayer[slot] = layer;
+                detail.slotReady[slot] = false;
+                state.slot[tier] = slot;
+                g_LayerLodDirty = true;
+            }
+            detail.slotLastUsed[slot] = g_ResidencyFrame;
+        }
+
+        // Antes da cadeia completa chegar, é ela que preenche as vagas reservadas.
+        if (!state.complete || state.streaming) continue;
+        int firstLevel = g_TierCount, lastLevel = -1;
+        for (int tier = 0; tier < g_TierCount; tier++) {
+            int slot = state.slot[tier];
+            if (slot >= 0 && !g_DetailTiers[tier].slotReady[slot]) {
+                firstLevel = min(firstLevel, tier);
+                lastLevel = tier;
+            }
+        }
+        if (lastLevel < 0) continue;
+        state.streaming = true;
+        state.streamStart = chrono::steady_clock::now();
+        string filename = state.filename;
+        const PackTexture* packTexture = state.packTexture;
+        const unsigned char* packBase = (const unsigned char*)g_AssetPack.mapping;
+        int width = g_LayerWidth, height = g_LayerHeight;
+        workerPool().submit([=] {
+            streamTextureJob(layer, filename, packBase, packTexture, firstLevel, lastLevel, width, height, compress);
+        });
+    }
+}
+
+// Mostra os contadores da residência de texturas (tecla 'r').
+void printResidencyStats() {
+    cout << "Residencia de texturas: " << residentTextureMB() << " MB residentes de " << textureMemoryMB()
+         << " MB reservados (orcamento " << g_TextureBudgetMB << " MB)" << endl;
+    for (int tier = 0; tier < g_TierCount; tier++) {
+        const DetailTier& detail = g_DetailTiers[tier];
+        int used = (int)count(detail.slotReady.begin(), detail.slotReady.end(), true);
+        cout << "  nivel " << tier << " (" << detail.width << "x" << detail.height << "): " << used << " de "
+             << detail.slotLayer.size() << " vagas ocupadas" << endl;
+    }
+    double averageMs = g_Residency.streamIns ? g_Residency.streamInTotalMs / g_Residency.streamIns : 0.0;
+    cout << "  descartes: " << g_Residency.evictions << ", recarregamentos: " << g_Residency.streamIns
+         << " (latencia media " << averageMs << " ms, maxima " << g_Residency.streamInMaxMs << " ms)" << endl;
+}
+
+// Mostra os contadores dos envios de textura (tecla 'u'). A banda do anel de PBOs é medida da
+// emissão de cada envio até a sinalização do seu fence. O tempo poupado por tick é a cópia que a
+// thread do OpenGL deixou de fazer, estimada com o custo medido por measureClientUploadMsPerMB();
+// o tempo de emissão medido inclui as esperas do driver por texturas ainda em uso pelo quadro
+// anterior, que existem com ou sem PBO.
+void printUploadStats() {
+    const double mb = 1024.0 * 1024.0;
+    if (!g_StagingMemory) {
+        cout << "Envio de texturas: sem anel de PBOs, " << g_Upload.directBytes / mb
+             << " MB enviados da memoria do programa" << endl;
+        return;
+    }
+    unsigned misses;
+    {
+        lock_guard<mutex> lock(g_StagingMutex);
+        misses = g_Upload.stagingMisses;
+    }
+    double bandwidth = g_Upload.fencedMs > 0.0 ? (g_Upload.fencedBytes / mb) / (g_Upload.fencedMs / 1000.0) : 0.0;
+    double ticks = max(g_Upload.stagedTicks, 1u);
+    cout << "Envio de texturas: " << g_Upload.stagedBytes / mb << " MB pelo anel de PBOs, "
+         << g_Upload.directBytes / mb << " MB da memoria do programa, " << misses << " sem vaga livre" << endl;
+    cout << "  banda ate o fence: " << bandwidth << " MB/s; emissao: " << g_Upload.issueMs / ticks
+         << " ms por tick com envios; copia evitada: " << g_Upload.stagedBytes / mb * g_Upload.clientMsPerMB / ticks
+         << " ms por tick (" << g_Upload.clientMsPerMB << " ms/MB)" << endl;
+}
 
-// --- SEÇÃO DE FUNÇÕES UTILITÁRIAS ---
+// --- SEÇÃO DE GRAVAÇÃO E REPRODUÇÃO ---
 
-// Função que carrega uma imagem e a transforma em uma textura OpenGL.
-GLuint loadTexture(const char* filename) {
-    GLuint texture;
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(filename, &width, &height, &nrChannels, 0);
-    if (data) {
-        glGenTextures(1, &texture);        // Gera um ID para a textura.
-        glBindTexture(GL_TEXTURE_2D, texture); // Seleciona a textura para configurar.
+// Com --record, as teclas, o tamanho da janela e, a cada quadro, os passos da simulação entre os
+// quais ele foi interpolado são gravados em um registro de sessão (session_log.h), cada um com o
+// seu instante. Com --replay, o registro é reproduzido: as teclas gravadas são aplicadas antes dos
+// mesmos quadros, nos mesmos instantes, e cada quadro é interpolado entre os mesmos passos, na
+// mesma posição, calculados em uma thread própria no lugar da de simulação; as teclas de verdade
+// são ignoradas, a não ser 'q' e ESC. As
+// entradas e os quadros seguem os instantes da gravação ou, com --replay-fast, vêm o mais rápido
+// possível. Com --frame-times, o tempo de cada quadro reproduzido vai para um CSV, para comparar
+// versões do programa com a mesma sessão.
+string g_RecordPath, g_ReplayPath, g_FrameTimesPath;
+bool g_ReplayFast = false;
+string g_SessionCommand; // Linha de comando sem as opções de gravação e reprodução.
+SessionRecorder g_Recorder;
+SessionPlayer g_Player;
+bool g_Replaying = false;
+chrono::steady_clock::time_point g_SessionStart;
 
-        // Configura como a textura se repetirá ou será fixada nas bordas.
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        // Configura o filtro para quando a textura é minificada ou magnificada (melhora a qualidade).
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+// Tempo de um quadro reproduzido: do início de display() até a troca de buffers, e desde o fim
+// do quadro anterior.
+struct FrameTime {
+    double days;
+    double drawMs, intervalMs;
+};
+vector<FrameTime> g_FrameTimes;
+uint64_t g_ReplayFrames = 0;
+bool g_ReplayFramePending = false; // Um quadro reproduzido foi publicado e ainda não desenhado.
+chrono::steady_clock::time_point g_LastFrameEnd;
 
-        GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB; // Checa se a imagem tem transparência (alpha).
+void keyboard(unsigned char key, int x, int y); // SEÇÃO DE CONFIGURAÇÃO E CALLBACKS.
+void specialKeys(int key, int x, int y);
 
-        // Envia os dados da imagem para a GPU e gera mipmaps (versões menores da textura para performance).
-        gluBuild2DMipmaps(GL_TEXTURE_2D, format, width, height, format, GL_UNSIGNED_BYTE, data);
-        stbi_image_free(data);
+// Linha de comando guardada no registro: os argumentos sem as opções de gravação e reprodução.
+string sessionCommandLine(int argc, char** argv) {
+    string command;
+    for (int i = 1; i < argc; i++) {
+        bool withValue = strcmp(argv[i], "--record") == 0 || strcmp(argv[i], "--replay") == 0 ||
+                         strcmp(argv[i], "--frame-times") == 0;
+        if (withValue && i + 1 < argc) {
+            i++;
+            continue;
+        }
+        if (strcmp(argv[i], "--replay-fast") == 0) continue;
+        if (!command.empty()) command += ' ';
+        command += argv[i];
+    }
+    return command;
+}
+
+// Fecha o registro de --record no fim do programa.
+void closeSession() {
+    if (!g_Recorder.isOpen()) return;
+    uint64_t frames = g_Recorder.frameCount(), bytes = g_Recorder.bytesWritten();
+    if (g_Recorder.close()) {
+        printf("Sessao gravada: %llu quadros, %.1f KB em %s\n", (unsigned long long)frames, bytes / 1024.0,
+               g_RecordPath.c_str());
     } else {
-        cerr << "Falha ao carregar textura: " << filename << endl;
-        return 0;
+        cerr << "Falha ao gravar: " << g_RecordPath << endl;
     }
-    return texture;
 }
 
-// Função para desenhar uma linha circular que representa a órbita.
-void drawOrbit(float radius) {
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glColor3f(0.3f, 0.3f, 0.3f);
-    glBegin(GL_LINE_STRIP);
-    // Loop de 0 a 360 graus para criar um círculo.
-    for (int i = 0; i <= 360; i++) {
-        float angle = i * M_PI / 180.0f; // Converte o grau para radianos.
-        // Calcula a posição (x, z) no círculo usando trigonometria. Y é 0 para ser no plano.
-        glVertex3f(radius * cos(angle), 0.0f, radius * sin(angle));
-    }
-    glEnd();
-    glEnable(GL_LIGHTING);
-    glEnable(GL_TEXTURE_2D);
+// Abre o registro de --record ou de --replay. Chamada em init(), antes de iniciar a simulação;
+// na reprodução, a câmera, a velocidade e o tamanho da janela voltam aos do início da gravação.
+void initSession() {
+    if (!g_ReplayPath.empty()) {
+        if (!g_Player.open(g_ReplayPath.c_str())) {
+            cerr << "Registro de sessao invalido: " << g_ReplayPath << endl;
+            exit(1);
+        }
+        if (g_Player.commandLine() != g_SessionCommand) {
+            cerr << "Aviso: a sessao foi gravada com outras opcoes: " << g_Player.commandLine() << endl;
+        }
+        const SessionHeader& header = g_Player.sessionHeader();
+        g_CameraAngle = header.cameraAngle;
+        g_CameraDistance = header.cameraDistance;
+        g_AnimationSpeed = header.animationSpeed;
+        glutReshapeWindow(header.width, header.height);
+        g_Replaying = true;
+    } else if (!g_RecordPath.empty()) {
+        SessionHeader header{};
+        header.startDays = g_StartDays;
+        header.cameraAngle = g_CameraAngle;
+        header.cameraDistance = g_CameraDistance;
+        header.animationSpeed = g_AnimationSpeed;
+        header.width = g_WindowWidth;
+        header.height = g_WindowHeight;
+        if (g_Recorder.open(g_RecordPath.c_str(), header, g_SessionCommand)) {
+            g_RecordingSteps = g_NBodyMode;
+            atexit(closeSession); // O GLUT encerra o programa com exit().
+        } else {
+            cerr << "Nao foi possivel criar: " << g_RecordPath << endl;
+        }
+    }
+    g_SessionStart = chrono::steady_clock::now();
+}
+
+// Nanossegundos desde o início da sessão, o instante dos registros gravados.
+uint64_t sessionElapsedNs() {
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - g_SessionStart).count();
+}
+
+// Grava os passos entre os quais o quadro atual foi interpolado e a posição dele entre os dois,
+// depois dos estados publicados até o desenhado, no modo N-corpos. Chamada em display(), depois
+// de updateBodyInstances().
+void recordSessionFrame() {
+    if (!g_Recorder.isOpen()) return;
+    const SimulationState& state = g_SimulationStates.readBuffer();
+    uint64_t elapsed = sessionElapsedNs();
+    if (g_RecordingSteps) {
+        lock_guard<mutex> lock(g_PublishedStepsMutex);
+        size_t written = 0;
+        for (; written < g_PublishedSteps.size() && g_PublishedSteps[written].sequence <= state.sequence; written++) {
+            const PublishedStep& step = g_PublishedSteps[written];
+            g_Recorder.step(elapsed, step.clock, step.flags, step.seekDays);
+        }
+        g_PublishedSteps.erase(g_PublishedSteps.begin(), g_PublishedSteps.begin() + written);
+    }
+    g_Recorder.frame(elapsed, state.previousClock, state.clock, g_FrameAlpha);
+}
+
+// Na reprodução, a thread de simulação dá lugar a uma thread que calcula, a pedido, o estado dos
+// dois passos de cada quadro gravado, e o publica com a posição gravada do quadro entre eles; o
+// desenho interpola como ao vivo. Enquanto ela calcula, a thread do OpenGL só espera. Fora do
+// modo N-corpos, cada estado sai direto do relógio. No modo N-corpos, a thread refaz, na ordem,
+// o que cada volta da simulação gravada fez até o estado desenhado: um passo normal por
+// advanceNBody(), com o mesmo limite de passos e o mesmo atraso descartado, ou parte de um salto,
+// com a mesma restauração de seekNBody() e um passo do integrador por vez até o estado em que a
+// volta parou, ao vivo pelo orçamento de tempo. A integração é a mesma da gravação, com todos os
+// integradores, e os quadros saem bit a bit iguais aos gravados.
+struct ReplayRequest {
+    uint64_t frame = 0;                   // Número do quadro, a partir de 1; 0 sem pedido.
+    vector<SessionEvent> steps;           // Estados publicados até o do quadro (Step).
+    SimulationClock previousClock, clock;
+    float alpha = 0.0f;
+};
+mutex g_ReplayMutex;
+condition_variable g_ReplayWake;          // Um pedido novo, para a thread de reprodução.
+condition_variable g_ReplayReady;         // Um estado publicado, para a thread do OpenGL.
+ReplayRequest g_ReplayRequest;
+uint64_t g_ReplayPublished = 0;           // Último quadro publicado; protegido por g_ReplayMutex.
+atomic<bool> g_ReplayFailed{false};
+SessionEvent g_ReplayFrameEvent;          // Quadro lido do registro e ainda não publicado.
+vector<SessionEvent> g_ReplaySteps;       // Estados publicados lidos antes dele.
+bool g_ReplayFrameWaiting = false;
+
+// Integra em direção ao destino 'seekDays' (dias do relógio) do salto em andamento, um passo do
+// integrador por vez, como seekNBody() depois de seekRestore(), até chegar, se 'reach', ou até o
+// estado publicado com o relógio 'clock'. Retorna false se a integração não avançar ou chegar ao
+// destino sem encontrar o estado, em vez de repetir o passo para sempre.
+bool replaySeek(double seekDays, bool reach, const SimulationClock& clock) {
+    double target = max(seekDays - g_NBodyTimeOffset, 0.0);
+    while (!g_SimulationStopping.load(memory_order_relaxed)) {
+        if (!reach && clockAtDays(g_NBody.time + g_NBodyTimeOffset) == clock) return true;
+        double before = g_NBody.time;
+        if (integrateNBody(target, 1)) return reach;
+        if (g_NBody.time == before) return false;
+    }
+    return true;
+}
+
+// Laço da thread de reprodução: refaz as voltas gravadas até o estado de cada quadro pedido, ou,
+// fora do modo N-corpos, calcula os dois passos dele (o primeiro é reaproveitado quando é o último
+// calculado), e publica o estado com o número do quadro.
+void replayLoop() {
+    SimulationClock previousClock, clock = clockAtDays(g_StartDays);
+    previousClock = clock;
+    vector<BodyInstance> previousBodies, bodies, previousRings, rings;
+    vector<float> particles;
+    computeBodyInstances(clock, bodies, rings);
+    previousBodies = bodies;
+    previousRings = rings;
+    double seekDays = NAN; // Destino do salto em andamento.
+    uint64_t done = 0;
+    while (true) {
+        ReplayRequest request;
+        {
+            unique_lock<mutex> lock(g_ReplayMutex);
+            // Com espera limitada, para ver o pedido de parada de stopSimulation().
+            while (g_ReplayRequest.frame == done) {
+                if (g_SimulationStopping.load(memory_order_relaxed)) return;
+                g_ReplayWake.wait_for(lock, chrono::milliseconds(20));
+            }
+            request = move(g_ReplayRequest);
+            g_ReplayRequest.frame = request.frame;
+        }
+        bool failed = false;
+        if (g_NBodyMode) {
+            for (const SessionEvent& step : request.steps) {
+                // Os mesmos estados e os mesmos relógios anteriores da volta ao vivo.
+                previousClock = clock;
+                previousBodies.swap(bodies);
+                previousRings.swap(rings);
+                if (step.stepFlags & SESSION_STEP_NEW_SEEK) seekDays = step.seekDays;
+                if (step.stepFlags & SESSION_STEP_SEEK) {
+                    bool reached = step.stepFlags & SESSION_STEP_SEEK_REACHED;
+                    double target = max(seekDays - g_NBodyTimeOffset, 0.0);
+                    bool restored;
+                    if (!seekRestore(target, restored)) {
+                        clock = clockAtDays(g_NBody.time + g_NBodyTimeOffset); // Ficou onde estava.
+                    } else {
+                        failed = !replaySeek(seekDays, reached, step.clock);
+                        clock = reached ? clockAtDays(target + g_NBodyTimeOffset) : step.clock;
+                    }
+                    if (reached) seekDays = NAN;
+                    computeBodyInstances(clock, bodies, rings);
+                    previousClock = clock;
+                    previousBodies = bodies;
+                    previousRings = rings;
+                    if (failed) break;
+                    if (!reached) continue;
+                }
+                advanceNBody(clockDays(step.clock));
+                clock = step.clock;
+                computeBodyInstances(clock, bodies, rings);
+            }
+            nbodyParticlePositions(particles);
+            if (failed || previousClock != request.previousClock || clock != request.clock) {
+                cerr << "A reproducao saiu do caminho gravado no quadro " << request.frame << endl;
+                failed = true;
+            }
+        } else {
+            if (request.previousClock == clock) {
+                previousBodies.swap(bodies);
+                previousRings.swap(rings);
+            } else if (request.previousClock != previousClock) {
+                computeBodyInstances(request.previousClock, previousBodies, previousRings);
+            }
+            previousClock = request.previousClock;
+            clock = request.clock;
+            computeBodyInstances(clock, bodies, rings);
+        }
+
+        SimulationState& state = g_SimulationStates.writeBuffer();
+        state.step = state.sequence = request.frame;
+        state.previousClock = request.previousClock;
+        state.clock = request.clock;
+        state.stepTime = chrono::steady_clock::now();
+        state.previousBodies = previousBodies;
+        state.bodies = bodies;
+        state.previousRings = previousRings;
+        state.rings = rings;
+        state.particles = particles;
+        state.alpha = request.alpha;
+        g_SimulationStates.publish();
+        {
+            lock_guard<mutex> lock(g_ReplayMutex);
+            g_ReplayPublished = done = request.frame;
+            if (failed) g_ReplayFailed = true;
+        }
+        g_ReplayReady.notify_one();
+        if (failed) return;
+    }
+}
+
+// Substitui startSimulation() na reprodução: publica o estado inicial e inicia a thread de
+// reprodução.
+void startReplay() {
+    SimulationState& state = g_SimulationStates.writeBuffer();
+    state.stepTime = chrono::steady_clock::now();
+    state.previousClock = state.clock = clockAtDays(g_StartDays);
+    computeBodyInstances(state.clock, state.bodies, state.rings);
+    state.previousBodies = state.bodies;
+    state.previousRings = state.rings;
+    if (g_NBodyMode) nbodyParticlePositions(state.particles);
+    state.alpha = 1.0f;
+    g_SimulationStates.publish();
+    g_SimulationStates.update();
+    g_BodyInstances = state.bodies;
+    g_RingInstances = state.rings;
+    g_SimulationThread = thread(replayLoop);
+    atexit(stopSimulation); // O GLUT encerra o programa com exit().
+}
+
+// Aplica as entradas gravadas antes do próximo quadro, pede o estado dele à thread de reprodução
+// e espera que ele seja publicado; sem --replay-fast, cada entrada e o quadro esperam o seu
+// instante. A espera dura no máximo TIMELINE_SEEK_BUDGET_MS por volta, para que a janela continue
+// respondendo, e o quadro só é marcado para desenho quando o estado chega. Retorna false no fim
+// do registro ou se a reprodução falhou.
+bool replayFrame() {
+    while (!g_ReplayFrameWaiting) {
+        SessionEvent event;
+        if (!g_Player.next(event)) return false;
+        if (!g_ReplayFast && event.type != SessionEventType::Frame) {
+            this_thread::sleep_until(g_SessionStart + chrono::nanoseconds(event.elapsedNs));
+        }
+        switch (event.type) {
+            case SessionEventType::Key: keyboard((unsigned char)event.key, event.x, event.y); break;
+            case SessionEventType::SpecialKey: specialKeys(event.key, event.x, event.y); break;
+            case SessionEventType::Reshape: glutReshapeWindow(event.x, event.y); break;
+            case SessionEventType::Step: g_ReplaySteps.push_back(event); break;
+            case SessionEventType::Frame:
+                g_ReplayFrameEvent = event;
+                g_ReplayFrameWaiting = true;
+                {
+                    lock_guard<mutex> lock(g_ReplayMutex);
+                    g_ReplayRequest = {g_ReplayFrames + 1, move(g_ReplaySteps), event.previousClock, event.clock,
+                                       event.alpha};
+                }
+                g_ReplaySteps.clear();
+                g_ReplayWake.notify_one();
+                break;
+        }
+    }
+    {
+        unique_lock<mutex> lock(g_ReplayMutex);
+        auto budget = chrono::duration<double, milli>(TIMELINE_SEEK_BUDGET_MS);
+        bool ready = g_ReplayReady.wait_for(lock, budget, [] { return g_ReplayPublished > g_ReplayFrames; });
+        if (g_ReplayFailed) return false;
+        if (!ready) return true;
+    }
+    g_ReplayFrameWaiting = false;
+    if (!g_ReplayFast) this_thread::sleep_until(g_SessionStart + chrono::nanoseconds(g_ReplayFrameEvent.elapsedNs));
+    g_ReplayFrames++;
+    g_ReplayFramePending = true;
+    return true;
+}
+
+// Mede o quadro reproduzido que acabou de ser desenhado. Chamada no fim de display().
+void noteReplayFrame(chrono::steady_clock::time_point start) {
+    if (!g_ReplayFramePending) return; // Um redesenho pedido pelo sistema, fora da sessão.
+    g_ReplayFramePending = false;
+    auto now = chrono::steady_clock::now();
+    double interval = g_FrameTimes.empty() ? 0.0 : chrono::duration<double, milli>(now - g_LastFrameEnd).count();
+    g_FrameTimes.push_back({clockDays(g_FrameClock), chrono::duration<double, milli>(now - start).count(), interval});
+    g_LastFrameEnd = now;
+}
+
+// Fim da reprodução: mostra o resumo dos tempos, grava o CSV de --frame-times e encerra.
+void finishReplay() {
+    if (g_Player.wasTruncated()) cerr << "O registro de sessao termina em um registro incompleto" << endl;
+    if (g_ReplayFailed) cerr << "Reproducao interrompida no quadro " << g_ReplayFrames + 1 << endl;
+    double total = elapsedMs(g_SessionStart);
+    vector<double> draw;
+    for (const FrameTime& frame : g_FrameTimes) draw.push_back(frame.drawMs);
+    sort(draw.begin(), draw.end());
+    double mean = 0.0;
+    for (double ms : draw) mean += ms;
+    if (!draw.empty()) {
+        mean /= draw.size();
+        printf("Reproducao: %zu quadros em %.2f s; desenho medio %.3f ms, mediana %.3f ms, p99 %.3f ms, maximo %.3f ms\n",
+               draw.size(), total / 1e3, mean, draw[draw.size() / 2], draw[min(draw.size() - 1, draw.size() * 99 / 100)],
+               draw.back());
+    }
+    if (!g_FrameTimesPath.empty()) {
+        FILE* file = fopen(g_FrameTimesPath.c_str(), "w");
+        if (file) {
+            fprintf(file, "quadro,dias,desenho_ms,intervalo_ms\n");
+            for (size_t i = 0; i < g_FrameTimes.size(); i++) {
+                const FrameTime& frame = g_FrameTimes[i];
+                fprintf(file, "%zu,%.17g,%.4f,%.4f\n", i, frame.days, frame.drawMs, frame.intervalMs);
+            }
+        }
+        if (!file || fclose(file) != 0) cerr << "Falha ao gravar: " << g_FrameTimesPath << endl;
+    }
+    keyboard('q', 0, 0);
 }
 
 // --- SEÇÃO DE RENDERIZAÇÃO ---
 
-// Função principal de desenho, chamada a cada quadro pela timer.
+// Função principal de desenho, chamada a cada quadro depois de idle().
 void display() {
+    auto frameStart = chrono::steady_clock::now();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
     // --- LÓGICA DA CÂMERA ORBITAL ---
-    // Calcula a posição da câmera (X, Z) em um círculo ao redor da origem.
-    float camX = g_CameraDistance * cos(g_CameraAngle * M_PI / 180.0f);
-    float camZ = g_CameraDistance * sin(g_CameraAngle * M_PI / 180.0f);
+    float camX, camZ;
+    cameraPosition(camX, camZ);
     // Posiciona e orienta a câmera.
-    gluLookAt(camX, 40.0, camZ,   // Posição da Câmera. Y=40 para uma visão de cima.
+    gluLookAt(camX, CAMERA_HEIGHT, camZ, // Posição da Câmera. Y=40 para uma visão de cima.
               0.0, 0.0, 0.0,   // Ponto para onde a câmera olha: o Sol.
               0.0, 1.0, 0.0);  // Vetor up.
 
     GLfloat light_position[] = {0.0, 0.0, 0.0, 1.0};
     glLightfv(GL_LIGHT0, GL_POSITION, light_position);
 
-    // --- DESENHO DO SOL ---
-    glPushMatrix();
-    float sunRotationAngle = g_AnimationTime * (365.0f / 25.38f); // Cálculo da rotação do Sol.
-    glRotatef(sunRotationAngle, 0.0f, 1.0f, 0.0f);
-    glDisable(GL_LIGHTING);
-    glBindTexture(GL_TEXTURE_2D, g_SunTexture);
-    gluSphere(g_Quad, 5.0f, 50, 50);
-    glEnable(GL_LIGHTING);
-    glPopMatrix();
-
     // --- DESENHO DAS ÓRBITAS ---
     // Desenha todas as linhas de órbita estáticas, centradas no Sol.
-    for (const auto& planet : g_Planets) {
-        drawOrbit(planet.distance);
+    drawOrbits(camX, CAMERA_HEIGHT, camZ);
+
+    // --- DESENHO DO SOL, DOS PLANETAS, DA LUA E DOS ANÉIS DE SATURNO ---
+    updateBodyInstances();
+    recordSessionFrame();
+    if (g_InstancedProgram) {
+        drawBodiesInstanced();
+    } else {
+        drawInstancesFixed(g_BodyInstances, g_SphereMesh);
+        // Os anéis são desenhados por último, depois das esferas opacas, por causa da transparência.
+        drawInstancesFixed(g_RingInstances, g_RingMesh);
     }
 
-    // --- DESENHO DOS PLANETAS ---
-    for (const auto& planet : g_Planets) {
-        glPushMatrix();
+    // --- DESENHO DO CINTURÃO DE ASTEROIDES ---
+    drawBelt(clockDays(g_FrameClock));
+    drawNBodyParticles();
 
-        // --- Cálculos de Animação ---
-        // Ângulo da órbita: baseado no tempo e no período orbital do planeta.
-        // O fator 365.0 normaliza a velocidade em relação à Terra.
-        float orbitAngle = g_AnimationTime * (365.0f / planet.orbitSpeed);
-        // Ângulo da rotação própria: baseado no tempo e período de rotação do planeta.
-        // O fator 30.0 foi ajustado para uma melhor visualização.
-        float rotationAngle = g_AnimationTime * (30.0f / planet.rotationSpeed);
-
-        // --- Aplicação das Transformações ---
-        // 1. Rotação do sistema de coordenadas ao redor do Sol. Define a posição na órbita.
-        glRotatef(orbitAngle, 0.0f, 1.0f, 0.0f);
-        // 2. Translação ao longo do novo eixo X para afastar o planeta do Sol.
-        glTranslatef(planet.distance, 0.0f, 0.0f);
-        // 3. Rotação do planeta em seu próprio eixo.
-        glRotatef(rotationAngle, 0.0f, 1.0f, 0.0f);
-        
-        // --- Desenho ---
-        glBindTexture(GL_TEXTURE_2D, planet.textureID);
-        gluSphere(g_Quad, planet.radius, 50, 50);
-
-        // --- Caso Especial: Desenho da Lua da Terra ---
-        if (planet.textureID == g_EarthTexture) {
-            glPushMatrix();
-
-            // As transformações da Lua são relativas ao sistema de coordenadas da Terra.
-            float moonOrbitAngle = g_AnimationTime * (365.0f / g_Moon.orbitSpeed);
-            glRotatef(moonOrbitAngle, 0.0f, 1.0f, 0.0f);
-            glTranslatef(g_Moon.distance, 0.0f, 0.0f);
-    
-            glBindTexture(GL_TEXTURE_2D, g_Moon.textureID);
-            gluSphere(g_Quad, g_Moon.radius, 30, 30);
+    // Apresenta o quadro que foi desenhado em segundo plano (double buffering).
+    glutSwapBuffers();
+    g_FramePacer.frameSubmitted();
+    noteReplayFrame(frameStart);
+}
 
-            glPopMatrix();
-        }
+// --- SEÇÃO DE CONFIGURAÇÃO E CALLBACKS ---
 
-        // --- Caso Especial: Anéis de Saturno ---
-        if (planet.textureID == g_Planets[5].textureID) {
-            glDisable(GL_LIGHTING);
-            glBindTexture(GL_TEXTURE_2D, g_RingTexture);
-            glRotatef(90, 1.0f, 0.0f, 0.0f);
-            gluDisk(g_Quad, planet.radius + 0.5f, planet.radius + 4.0f, 50, 1); // Desenha um disco vazado.
-            glEnable(GL_LIGHTING);
+// Prioridade de carregamento de cada camada de textura (menor valor primeiro): o Sol vem antes
+// de tudo, depois as camadas cujos corpos estão mais próximos da câmera.
+vector<float> textureLayerPriorities() {
+    float camX, camZ;
+    cameraPosition(camX, camZ);
+    vector<float> priority(g_Layers.size(), 1e30f);
+    for (const auto* instances : {&g_BodyInstances, &g_RingInstances}) {
+        for (const auto& body : *instances) {
+            float dx = body.x - camX, dy = body.y - CAMERA_HEIGHT, dz = body.z - camZ;
+            float distance = sqrt(dx * dx + dy * dy + dz * dz) - body.radius;
+            float& layerPriority = priority[(int)body.layer];
+            layerPriority = min(layerPriority, distance);
         }
-
-        glPopMatrix();
     }
-
-    // Apresenta o quadro que foi desenhado em segundo plano (double buffering).
-    glutSwapBuffers();
+    priority[g_Sun.textureLayer] = -1.0f;
+    return priority;
 }
 
-// --- SEÇÃO DE CONFIGURAÇÃO E CALLBACKS ---
+void initBodies(const CatalogEntry* catalog, int count);
 
 void init() {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -207,54 +3534,201 @@ void init() {
     glEnable(GL_TEXTURE_2D);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Fórmula padrão para transparência.
-    
-    // Criação do objeto quadric.
-    g_Quad = gluNewQuadric();
-    gluQuadricTexture(g_Quad, GL_TRUE); // Habilita a geração de coordenadas de textura para o quadric.
-
-    // Carregamento das texturas.
-    g_SunTexture = loadTexture("sun.jpg");
-    g_RingTexture = loadTexture("saturn_ring.png");
-    g_EarthTexture = loadTexture("earth.jpg"); // Guardamos o ID da Terra para a comparação da Lua.
-
-    // Inicialização dos dados dos planetas e da Lua com valores.
-    // {raio, distância, período orbital, período de rotação, textura}
-    g_Planets = {
-        {0.5f, 10.0f, 88.0f, 58.6f, loadTexture("mercury.jpg")},
-        {0.9f, 15.0f, 225.0f, -243.0f, loadTexture("venus.jpg")},
-        {1.0f, 20.0f, 365.0f, 1.0f, g_EarthTexture},
-        {0.7f, 28.0f, 687.0f, 1.03f, loadTexture("mars.jpg")},
-        {4.0f, 45.0f, 4333.0f, 0.41f, loadTexture("jupiter.jpg")},
-        {3.5f, 65.0f, 10759.0f, 0.44f, loadTexture("saturn.jpg")},
-        {2.5f, 80.0f, 30687.0f, -0.72f, loadTexture("uranus.jpg")},
-        {2.3f, 95.0f, 60190.0f, 0.67f, loadTexture("neptune.jpg")}
-    };
-    g_Moon = {0.3f, 2.5f, 27.3f, 27.3f, loadTexture("moon.jpg")};
+    // As malhas são escaladas uniformemente; reescalar as normais mantém a iluminação correta.
+    glEnable(glVersionAtLeast(1, 2) ? GL_RESCALE_NORMAL : GL_NORMALIZE);
+
+    // O pacote de assets só é usado se o hash do conteúdo de origem (catálogo e imagens) bater.
+    // Nesse caso o catálogo também vem dele.
+    auto packStart = chrono::steady_clock::now();
+    uint64_t assetHash = computeAssetHash(BODY_CATALOG, BODY_CATALOG_SIZE);
+    if (openAssetPack(DEFAULT_PACK_PATH, assetHash, g_AssetPack)) {
+        cout << "Pacote de assets aberto em " << elapsedMs(packStart) << " ms" << endl;
+        initBodies(g_AssetPack.catalog, (int)g_AssetPack.header->catalogCount);
+    } else {
+        cout << "Pacote de assets ausente ou desatualizado; decodificando as imagens" << endl;
+        initBodies(BODY_CATALOG, BODY_CATALOG_SIZE);
+    }
+
+    // Geometria compartilhada: gerada uma única vez em vez de a cada quadro.
+    initMeshes();
+    bakeOrbits();
+    initInstancing();
+    initPointSprite();
+    if (g_AnalyticMode) initAnalytic();
+    if (!g_EphemerisPath.empty()) initEphemeris();
+    if (g_EventJumps) initEventJumps();
+    if (g_NBodyMode) {
+        initNBody();
+        initTimeline();
+    }
+
+    // Empacota todas as imagens em um array de texturas, lido pelo shader do caminho instanciado.
+    // As imagens são decodificadas em segundo plano; os corpos mais próximos da câmera vêm primeiro.
+    initSession();
+    if (g_Replaying) {
+        startReplay();
+    } else {
+        startSimulation();
+    }
+    startTextureLoading(g_InstancedProgram != 0, textureLayerPriorities());
+    startBeltLoading(); // Depois das texturas, que têm prioridade no pool.
+}
+
+// Elementos orbitais de uma entrada do catálogo, com a distância como semieixo maior.
+OrbitalElements orbitalElements(const CatalogEntry& entry) {
+    return {entry.distance, entry.eccentricity, entry.inclination, entry.ascendingNode,
+            entry.argPeriapsis, entry.meanAnomaly, entry.orbitSpeed};
+}
+
+// Registra as camadas de textura e os dados dos corpos a partir do catálogo (catalog.h).
+void initBodies(const CatalogEntry* catalog, int count) {
+    g_Planets.clear();
+    g_PlanetNaif.clear();
+    g_BodyNames.clear();
+    g_PlanetOrbits = KeplerBatch();
+    g_MoonOrbit = KeplerBatch();
+    g_MoonPlanet = g_RingPlanet = g_RingLayer = -1;
+    // Planetas que são pais da Lua e dos anéis, resolvidos depois que todos foram lidos.
+    string sunName, moonName, moonParent, ringParent;
+    vector<string> planetNames;
+    for (int i = 0; i < count; i++) {
+        const CatalogEntry& entry = catalog[i];
+        CelestialBody body = {entry.radius, entry.distance, entry.orbitSpeed, entry.rotationSpeed, entry.mass,
+                              loadTexture(entry.texture), orbitalElements(entry)};
+        switch (entry.kind) {
+            case BODY_SUN:
+                g_Sun = body;
+                sunName = entry.name;
+                break;
+            case BODY_PLANET:
+                g_Planets.push_back(body);
+                g_PlanetOrbits.add(body.orbit);
+                planetNames.push_back(entry.name);
+                g_PlanetNaif.push_back(naifBodyId(entry.name));
+                break;
+            case BODY_MOON:
+                g_Moon = body;
+                g_MoonOrbit.add(body.orbit);
+                moonName = entry.name;
+                moonParent = entry.parent;
+                break;
+            case BODY_RING:
+                g_RingLayer = body.textureLayer;
+                ringParent = entry.parent;
+                break;
+        }
+    }
+    for (int i = 0; i < (int)planetNames.size(); i++) {
+        if (planetNames[i] == moonParent) g_MoonPlanet = i;
+        if (planetNames[i] == ringParent) g_RingPlanet = i;
+    }
+    g_BodyNames.push_back(sunName);
+    g_BodyNames.insert(g_BodyNames.end(), planetNames.begin(), planetNames.end());
+    if (g_MoonPlanet >= 0) g_BodyNames.push_back(moonName);
 }
 
 void reshape(int w, int h) {
     if (h == 0) h = 1;
+    g_WindowWidth = w;
+    g_WindowHeight = h;
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     glViewport(0, 0, w, h);
-    gluPerspective(45, (float)w / h, 1, 1000);
+    gluPerspective(FIELD_OF_VIEW, (float)w / h, 1, 1000);
 }
 
-// Função de callback do timer, responsável por animar a cena.
-void timer(int value) {
-    g_AnimationTime += g_AnimationSpeed; // Avança o relógio da simulação.
+// Função de callback ociosa do GLUT, responsável por pedir os quadros da animação. Espera o
+// instante do próximo quadro segundo g_FramePacer, em vez de re-armar um glutTimerFunc, cujo
+// atraso se acumularia com o tempo de desenho. O tempo da simulação avança sozinho, pelo
+// relógio, na thread de simulação. Na reprodução de uma sessão, o quadro seguinte vem do
+// registro.
+void idle() {
+    if (!g_Replaying) {
+        g_FramePacer.waitForNextFrame();
+    } else if (!replayFrame()) {
+        finishReplay();
+    }
+    vector<float> layerPriority = textureLayerPriorities();
+    updateTextureResidency(layerPriority); // Decide quais níveis detalhados cada camada precisa.
+    pumpTextureUploads(layerPriority); // Envia as texturas que já foram decodificadas.
+    if (g_Replaying && !g_ReplayFramePending) return; // O estado do quadro ainda não chegou.
     glutPostRedisplay(); // Solicita ao GLUT que redesenhe a tela.
-    glutTimerFunc(16, timer, 0); // Pede para ser chamada novamente em ~16ms.
+}
+
+// Mostra a regularidade dos quadros desde a última chamada (tecla 'f'): o intervalo médio entre
+// quadros, a tremulação e o erro em relação ao intervalo alvo.
+void printPacingStats() {
+    PacingStats stats = g_FramePacer.stats();
+    double fps = stats.meanMs > 0.0 ? 1000.0 / stats.meanMs : 0.0;
+    cout << "Ritmo dos quadros: " << stats.frames << " quadros, " << fps << " fps (alvo: ";
+    if (stats.targetMs > 0.0) cout << g_FramePacer.targetFps() << " fps)"; else cout << "sem limite)";
+    cout << endl;
+    cout << "  intervalo medio " << stats.meanMs << " ms, desvio padrao " << stats.stdDevMs << " ms; erro medio "
+         << stats.meanErrorMs << " ms, p99 " << stats.p99ErrorMs << " ms, maximo " << stats.maxErrorMs << " ms" << endl;
+    g_FramePacer.reset();
+}
+
+// Salta para o primeiro evento de --jumps depois (direction > 0) ou antes (direction < 0) do
+// instante do quadro atual.
+void jumpToEvent(int direction) {
+    if (g_Events.empty()) return;
+    // Um minuto de folga, para que o salto seguinte não caia no mesmo evento.
+    const double margin = 1.0 / 1440.0;
+    double now = clockDays(g_FrameClock);
+    const AstronomicalEvent* target = nullptr;
+    if (direction > 0) {
+        auto next = upper_bound(g_Events.begin(), g_Events.end(), now + margin,
+                                [](double days, const AstronomicalEvent& event) { return days < event.days; });
+        if (next != g_Events.end()) target = &*next;
+    } else {
+        auto next = lower_bound(g_Events.begin(), g_Events.end(), now - margin,
+                                [](const AstronomicalEvent& event, double days) { return event.days < days; });
+        if (next != g_Events.begin()) target = &*(next - 1);
+    }
+    if (!target) {
+        cout << "Nao ha mais eventos nessa direcao" << endl;
+        return;
+    }
+    g_ClockJumpDays.store(target->days, memory_order_relaxed);
+    cout << describeEvent(*target) << endl;
+}
+
+// Salta 'days' dias a partir do instante do quadro atual.
+void seekBy(double days) {
+    g_ClockJumpDays.store(clockDays(g_FrameClock) + days, memory_order_relaxed);
 }
 
 void keyboard(unsigned char key, int x, int y) {
     switch(key) {
         case 'q': case 27: // 'q' ou ESC para sair.
-            gluDeleteQuadric(g_Quad);
+            stopSimulation();
+            destroyMeshes();
+            if (g_OrbitVBO) glDeleteBuffers(1, &g_OrbitVBO);
+            if (g_InstanceVBO) glDeleteBuffers(1, &g_InstanceVBO);
+            if (g_InstancedProgram) glDeleteProgram(g_InstancedProgram);
+            if (g_TextureArray) glDeleteTextures(1, &g_TextureArray);
+            for (auto& tier : g_DetailTiers) {
+                if (tier.texture) glDeleteTextures(1, &tier.texture);
+            }
+            closeAssetPack(g_AssetPack);
+            // g_StagingBuffer não é apagado: alguma thread de trabalho pode estar copiando para o
+            // mapeamento; ele é liberado junto com o contexto.
+            if (!g_LayerTextures.empty()) glDeleteTextures((GLsizei)g_LayerTextures.size(), g_LayerTextures.data());
             exit(0);
             break;
-        case '+': g_AnimationSpeed *= 1.5; break; // Acelera a simulação.
-        case '-': g_AnimationSpeed /= 1.5; break; // Desacelera a simulação.
+        case 'r': printResidencyStats(); break; // Mostra os contadores da residência de texturas.
+        case 'u': printUploadStats(); break;    // Mostra os contadores dos envios de textura.
+        case 'f': printPacingStats(); break;    // Mostra a regularidade dos quadros.
+        case 'n':                               // Mostra os contadores do modo N-corpos.
+            printNBodyStats();
+            printTimelineStats();
+            break;
+        case '+': g_AnimationSpeed = min(g_AnimationSpeed * 1.5f, MAX_ANIMATION_SPEED); break; // Acelera a simulação.
+        case '-': g_AnimationSpeed = max(g_AnimationSpeed / 1.5f, MIN_ANIMATION_SPEED); break; // Desacelera a simulação.
+        case '>': jumpToEvent(1); break;  // Salta para o próximo evento (--jumps).
+        case '<': jumpToEvent(-1); break; // Salta para o evento anterior.
+        case '[': seekBy(-TIMELINE_SEEK_DAYS); break; // Volta 10 anos.
+        case ']': seekBy(TIMELINE_SEEK_DAYS); break;  // Avança 10 anos.
     }
 }
 
@@ -267,18 +3741,863 @@ void specialKeys(int key, int x, int y) {
     }
 }
 
+// Callbacks de entrada registrados no GLUT. Com --record, cada entrada é gravada antes de ser
+// aplicada (menos a de sair, que só encerra o registro); na reprodução, as entradas vêm do
+// registro e as de verdade são ignoradas, a não ser as de sair.
+void keyboardInput(unsigned char key, int x, int y) {
+    bool quit = key == 'q' || key == 27;
+    if (g_Replaying && !quit) return;
+    if (g_Recorder.isOpen() && !quit) g_Recorder.key(sessionElapsedNs(), key, x, y);
+    keyboard(key, x, y);
+}
+
+void specialKeysInput(int key, int x, int y) {
+    if (g_Replaying) return;
+    if (g_Recorder.isOpen()) g_Recorder.specialKey(sessionElapsedNs(), key, x, y);
+    specialKeys(key, x, y);
+}
+
+void reshapeInput(int w, int h) {
+    if (g_Recorder.isOpen()) g_Recorder.reshape(sessionElapsedNs(), w, h);
+    reshape(w, h);
+}
+
+// --- SEÇÃO DE BENCHMARKS ---
+
+// Compara o gluBuild2DMipmaps com o gerador próprio (mipmap.h) nas texturas do projeto.
+// A coluna "GLU" e a coluna "+envio" incluem o envio de todos os níveis para a GPU.
+void benchmarkMipmaps() {
+    initBodies(BODY_CATALOG, BODY_CATALOG_SIZE);
+    const char* kernelNames[] = {"escalar", "SSE2", "AVX2"};
+    MipmapKernel best = detectMipmapKernel();
+    cout << "Threads de trabalho: " << workerPool().size() << ", kernel: " << kernelNames[(int)best] << endl;
+    cout << "textura               GLU(ms)  escalar(ms)  SSE2(ms)  AVX2(ms)  +envio(ms)" << endl;
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    double totalGlu = 0.0, totalOwn = 0.0;
+    for (const auto& layer : g_Layers) {
+        int width, height, nrChannels;
+        unsigned char* data = stbi_load(layer.filename.c_str(), &width, &height, &nrChannels, 0);
+        if (!data) continue;
+        GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
+
+        auto start = chrono::steady_clock::now();
+        gluBuild2DMipmaps(GL_TEXTURE_2D, format, width, height, format, GL_UNSIGNED_BYTE, data);
+        glFinish();
+        double gluMs = elapsedMs(start);
+        stbi_image_free(data);
+
+        MipLevel base = {width, height, {}};
+        data = stbi_load(layer.filename.c_str(), &width, &height, &nrChannels, 4);
+        base.pixels.assign(data, data + (size_t)width * height * 4);
+        stbi_image_free(data);
+
+        double kernelMs[3] = {-1.0, -1.0, -1.0};
+        for (int kernel = 0; kernel <= (int)best; kernel++) {
+            start = chrono::steady_clock::now();
+            generateMipChain(base, (MipmapKernel)kernel);
+            kernelMs[kernel] = elapsedMs(start);
+        }
+
+        start = chrono::steady_clock::now();
+        vector<MipLevel> levels = generateMipChain(base, best);
+        for (size_t level = 0; level < levels.size(); level++) {
+            glTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_RGBA8, levels[level].width, levels[level].height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, levels[level].pixels.data());
+        }
+        glFinish();
+        double ownMs = elapsedMs(start);
+
+        totalGlu += gluMs;
+        totalOwn += ownMs;
+        printf("%-20s %8.1f %12.1f %9.1f %9.1f %11.1f\n", layer.filename.c_str(), gluMs,
+               kernelMs[0], kernelMs[1], kernelMs[2], ownMs);
+    }
+    glDeleteTextures(1, &texture);
+    printf("total: GLU %.1f ms, gerador proprio %.1f ms (%.1fx)\n", totalGlu, totalOwn, totalGlu / totalOwn);
+}
+
+// Mede o solucionador de Kepler (kepler.h) em um milhão de órbitas aleatórias, com cada
+// conjunto de instruções em uma thread, e compara as posições com as da versão escalar.
+void benchmarkKepler() {
+    const size_t ORBITS = 1000000;
+    const int REPEATS = 5;
+    KeplerBatch batch;
+    batch.reserve(ORBITS);
+    SeededRandom random(12345);
+    for (size_t i = 0; i < ORBITS; i++) {
+        // Excentricidades de cinturão de asteroides, com alguns corpos quase parabólicos.
+        double eccentricity = (i % 100 == 0) ? 0.97 * random() : 0.35 * random();
+        batch.add({20.0 + 30.0 * random(), eccentricity, 30.0 * random(), 360.0 * random(), 360.0 * random(),
+                   360.0 * random(), 1000.0 + 3000.0 * random()});
+    }
+
+    const char* kernelNames[] = {"escalar", "AVX2", "AVX-512"};
+    SimdKernel best = detectSimdKernel();
+    vector<float> referenceX(ORBITS), referenceY(ORBITS), referenceZ(ORBITS);
+    vector<float> x(ORBITS), y(ORBITS), z(ORBITS);
+    const double days = 123456.789;
+    cout << "Orbitas: " << ORBITS << ", kernel: " << kernelNames[(int)best] << endl;
+    for (int kernel = 0; kernel <= (int)best; kernel++) {
+        auto start = chrono::steady_clock::now();
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            solveKeplerPositions(batch, days + repeat, x.data(), y.data(), z.data(), 0, ORBITS, (SimdKernel)kernel);
+        }
+        double ms = elapsedMs(start);
+        solveKeplerPositions(batch, days, x.data(), y.data(), z.data(), 0, ORBITS, (SimdKernel)kernel);
+        if (kernel == 0) {
+            referenceX = x;
+            referenceY = y;
+            referenceZ = z;
+        }
+        double maxError = 0.0;
+        for (size_t i = 0; i < ORBITS; i++) {
+            double dx = x[i] - referenceX[i], dy = y[i] - referenceY[i], dz = z[i] - referenceZ[i];
+            maxError = max(maxError, sqrt(dx * dx + dy * dy + dz * dz));
+        }
+        printf("%-8s %8.1f ms  %7.1f M posicoes/s por thread  desvio maximo %.2g\n", kernelNames[kernel],
+               ms / REPEATS, ORBITS * REPEATS / (ms * 1e3), maxError);
+    }
+
+    // Todas as threads de trabalho, como faria uma população grande de corpos menores.
+    auto start = chrono::steady_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        workerPool().parallelFor(ORBITS, 16384, [&](size_t begin, size_t end) {
+            solveKeplerPositions(batch, days + repeat, x.data(), y.data(), z.data(), begin, end, best);
+        });
+    }
+    double ms = elapsedMs(start);
+    printf("%u threads: %.1f ms, %.1f M posicoes/s\n", workerPool().size() + 1, ms / REPEATS,
+           ORBITS * REPEATS / (ms * 1e3));
+}
+
+// Mede a avaliação das efemérides de 'path' com cada conjunto de instruções (--bench-ephemeris):
+// posições dos planetas em relação ao Sol e da Lua em relação à Terra em instantes aleatórios da
+// cobertura do arquivo, em avaliações corpo-instante por segundo, e o maior desvio em relação ao
+// código escalar. Depois confere o arquivo com as teorias analíticas (checkEphemeris).
+void benchmarkEphemeris(const char* path) {
+    const size_t EPOCHS = 200000;
+    const int REPEATS = 5;
+    const pair<int, int> ALL_BODIES[] = {{1, NAIF_SUN}, {2, NAIF_SUN}, {NAIF_EARTH, NAIF_SUN}, {4, NAIF_SUN},
+                                         {5, NAIF_SUN}, {6, NAIF_SUN}, {7, NAIF_SUN}, {8, NAIF_SUN},
+                                         {NAIF_MOON, NAIF_EARTH}};
+    Ephemeris ephemeris;
+    auto start = chrono::steady_clock::now();
+    if (!openEphemeris(path, ephemeris)) {
+        cerr << "Nao foi possivel ler as efemerides: " << path << endl;
+        return;
+    }
+    double first, last;
+    if (!ephemerisCommonCoverage(ephemeris, first, last)) {
+        cerr << "Os corpos do arquivo nao tem cobertura em comum" << endl;
+        closeEphemeris(ephemeris);
+        return;
+    }
+    printf("Efemerides: %zu series mapeadas em %.2f ms, cobertura comum de %.0f dias\n", ephemeris.series.size(),
+           elapsedMs(start), last - first);
+
+    SeededRandom random(12345);
+    vector<double> days(EPOCHS);
+    for (double& day : days) day = first + (last - first) * random();
+    // Uma passada antes das medidas, para que todo o arquivo já esteja na memória; corpos
+    // ausentes do arquivo ficam de fora.
+    vector<double> x(EPOCHS), y(EPOCHS), z(EPOCHS);
+    vector<pair<int, int>> bodies;
+    for (const auto& body : ALL_BODIES) {
+        if (ephemerisPositions(ephemeris, body.first, body.second, days.data(), EPOCHS, x.data(), y.data(), z.data())) {
+            bodies.push_back(body);
+        }
+    }
+    const size_t BODIES = bodies.size();
+    printf("Corpos avaliados: %zu\n", BODIES);
+
+    const char* kernelNames[] = {"escalar", "AVX2", "AVX-512"};
+    SimdKernel best = detectSimdKernel();
+    vector<double> reference(3 * EPOCHS * BODIES);
+    for (int kernel = 0; kernel <= (int)best; kernel++) {
+        double maxError = 0.0;
+        start = chrono::steady_clock::now();
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            for (size_t b = 0; b < BODIES; b++) {
+                ephemerisPositions(ephemeris, bodies[b].first, bodies[b].second, days.data(), EPOCHS, x.data(),
+                                   y.data(), z.data(), (SimdKernel)kernel);
+                if (repeat > 0) continue;
+                double* saved = reference.data() + 3 * EPOCHS * b;
+                for (size_t i = 0; i < EPOCHS; i++) {
+                    if (kernel == 0) {
+                        saved[3 * i] = x[i];
+                        saved[3 * i + 1] = y[i];
+                        saved[3 * i + 2] = z[i];
+                    }
+                    double dx = x[i] - saved[3 * i], dy = y[i] - saved[3 * i + 1], dz = z[i] - saved[3 * i + 2];
+                    maxError = max(maxError, sqrt(dx * dx + dy * dy + dz * dz));
+                }
+            }
+        }
+        double ms = elapsedMs(start); // Inclui a comparação da primeira repetição.
+        printf("%-8s %8.1f ms  %7.1f M avaliacoes corpo-instante/s por thread  desvio maximo %.2g km\n",
+               kernelNames[kernel], ms / REPEATS, EPOCHS * BODIES * REPEATS / (ms * 1e3), maxError);
+    }
+
+    // Todas as threads de trabalho, cada uma com um bloco de instantes.
+    start = chrono::steady_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        workerPool().parallelFor(EPOCHS, 4096, [&](size_t begin, size_t end) {
+            for (const auto& body : bodies) {
+                ephemerisPositions(ephemeris, body.first, body.second, days.data() + begin, end - begin,
+                                   x.data() + begin, y.data() + begin, z.data() + begin, best);
+            }
+        });
+    }
+    double ms = elapsedMs(start);
+    printf("%u threads: %.1f ms, %.1f M avaliacoes corpo-instante/s\n", workerPool().size() + 1, ms / REPEATS,
+           EPOCHS * BODIES * REPEATS / (ms * 1e3));
+
+    // Conferência com as teorias analíticas: o tempo não importa, a leitura do arquivo sim.
+    double deviation[EPHEMERIS_CHECK_COUNT];
+    if (checkEphemeris(ephemeris, 2000, deviation)) {
+        printf("Desvio maximo em relacao a VSOP87/ELP entre %.0f e %.0f:\n",
+               2000.0 + max(first, -EPHEMERIS_CHECK_SPAN) / 365.25, 2000.0 + min(last, EPHEMERIS_CHECK_SPAN) / 365.25);
+        for (size_t b = 0; b < EPHEMERIS_CHECK_COUNT; b++) {
+            if (std::isnan(deviation[b])) continue;
+            printf("  %-9s %9.1f\"%s\n", EPHEMERIS_CHECK_BODIES[b].name, deviation[b],
+                   deviation[b] > EPHEMERIS_CHECK_TOLERANCE ? "  DIVERGE" : "");
+        }
+    }
+    closeEphemeris(ephemeris);
+}
+
+// Confere a leitura de um arquivo de efemérides com os valores de referência que o JPL publica
+// junto com cada DE (--check-testpo <efemérides> <testpo>). Depois da linha "EOT", cada linha de um
+// testpo.NNN traz o DE, a data, o dia juliano (TDB), o alvo, o centro, a coordenada (1 a 3 posição,
+// 4 a 6 velocidade) e o valor, em UA no referencial equatorial J2000. Os corpos são os do JPL: 1 a
+// 9 Mercúrio a Plutão (3 a Terra), 10 a Lua, 11 o Sol, 12 o baricentro do Sistema Solar e 13 o
+// baricentro Terra-Lua. Só as posições são conferidas, já que o leitor não avalia velocidades;
+// nutações, librações e TT - TDB (14 a 17) e os instantes fora da cobertura ficam de fora. Retorna
+// false se alguma posição se afastar mais que o testeph do JPL aceita ou se nenhuma for conferida.
+const double TESTPO_TOLERANCE_AU = 1e-13;
+
+bool checkTestpo(const char* ephemerisPath, const char* testpoPath) {
+    const int TESTPO_BODIES = 14;
+    const int naif[TESTPO_BODIES] = {-1, 1, 2, NAIF_EARTH, 4, 5, 6, 7, 8, 9, NAIF_MOON, NAIF_SUN,
+                                     NAIF_SOLAR_SYSTEM_BARYCENTER, NAIF_EARTH_MOON_BARYCENTER};
+    const char* names[TESTPO_BODIES] = {"",       "Mercurio", "Venus", "Terra", "Marte", "Jupiter",    "Saturno",
+                                        "Urano",  "Netuno",   "Plutao", "Lua",  "Sol",   "Baricentro", "Terra-Lua"};
+    Ephemeris ephemeris;
+    if (!openEphemeris(ephemerisPath, ephemeris)) {
+        cerr << "Nao foi possivel ler as efemerides: " << ephemerisPath << endl;
+        return false;
+    }
+    FILE* file = fopen(testpoPath, "r");
+    if (!file) {
+        cerr << "Nao foi possivel abrir " << testpoPath << endl;
+        closeEphemeris(ephemeris);
+        return false;
+    }
+    // Os valores usam a UA do próprio DE, que mudou no DE430; o SPK não a traz e fica na da IAU.
+    double kmPerAu = ephemeris.kmPerAu > 1.49e8 && ephemeris.kmPerAu < 1.5e8 ? ephemeris.kmPerAu : KM_PER_AU;
+    size_t checked[TESTPO_BODIES] = {}, failed[TESTPO_BODIES] = {}, skipped = 0, reported = 0;
+    double maxError[TESTPO_BODIES] = {};
+    bool data = false;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (!data) {
+            data = strncmp(line, "EOT", 3) == 0;
+            continue;
+        }
+        int de, target, center, coordinate;
+        char date[32];
+        double julianDay, value, position[3];
+        if (sscanf(line, "%d %31s %lf %d %d %d %lf", &de, date, &julianDay, &target, &center, &coordinate, &value) != 7) {
+            continue;
+        }
+        if (target < 1 || target >= TESTPO_BODIES || center < 1 || center >= TESTPO_BODIES || coordinate < 1 ||
+            coordinate > 3 ||
+            !ephemerisPosition(ephemeris, naif[target], naif[center], julianDay - J2000_JULIAN_DAY, position) ||
+            std::isnan(position[0])) {
+            skipped++;
+            continue;
+        }
+        double computed = position[coordinate - 1] / kmPerAu, error = fabs(computed - value);
+        checked[target]++;
+        maxError[target] = max(maxError[target], error);
+        if (error > TESTPO_TOLERANCE_AU) {
+            failed[target]++;
+            if (reported++ < 10) {
+                printf("Diverge: %s %d em relacao a %d, coordenada %d: %.17g UA, esperado %.17g\n", date, target,
+                       center, coordinate, computed, value);
+            }
+        }
+    }
+    fclose(file);
+    closeEphemeris(ephemeris);
+
+    size_t total = 0, totalFailed = 0;
+    printf("Posicoes conferidas com %s (UA de %.3f km):\n", testpoPath, kmPerAu);
+    for (int body = 1; body < TESTPO_BODIES; body++) {
+        if (!checked[body]) continue;
+        printf("  %-10s %7zu  maior diferenca %.2g UA%s\n", names[body], checked[body], maxError[body],
+               failed[body] ? "  DIVERGE" : "");
+        total += checked[body];
+        totalFailed += failed[body];
+    }
+    printf("%zu posicoes, %zu acima de %.0e UA; %zu linhas ignoradas (velocidades, outros itens ou fora da "
+           "cobertura)\n", total, totalFailed, TESTPO_TOLERANCE_AU, skipped);
+    return total > 0 && totalFailed == 0;
+}
+
+// Mede as teorias analíticas (--bench-analytic [pasta]): para cada precisão e cada origem das
+// séries dos planetas (a tabela embutida e, se houver, os arquivos de 'folder'), cortadas como
+// em initAnalytic(), os termos mantidos, o tempo de um quadro (os oito planetas e a Lua) com
+// cada conjunto de instruções e o maior desvio angular, visto do Sol ou da Terra, em relação às
+// séries completas, em instantes aleatórios de 1900 a 2100, ao lado do limite calculado do
+// corte. A referência são os arquivos completos, se os oito existirem, ou a tabela inteira, que
+// então só mede o corte; a precisão da própria tabela vem de VSOP87_TABLE_ACCURACY.
+void benchmarkAnalytic(const char* folder) {
+    const int NAIF_PLANETS[] = {1, 2, NAIF_EARTH, 4, 5, 6, 7, 8};
+    const double ACCURACIES[] = {1.0, 10.0, 60.0}; // Segundos de arco.
+    const size_t EPOCHS = 2000;
+
+    SeededRandom random(12345);
+    vector<double> days(EPOCHS);
+    for (double& day : days) day = 73050.0 * (random() - 0.5);
+
+    // Séries dos oito planetas com a tolerância 'accuracy' (radianos), dos arquivos ou da tabela;
+    // retorna false se faltar algum arquivo.
+    auto buildPlanets = [&](bool files, double accuracy, vector<Vsop87Series>& planets) {
+        planets.assign(size(NAIF_PLANETS), Vsop87Series());
+        for (size_t b = 0; b < planets.size(); b++) {
+            bool built = files ? loadPlanetTheory(folder, NAIF_PLANETS[b], accuracy, planets[b])
+                               : buildEmbeddedVsop87(vsop87Planet(NAIF_PLANETS[b]), accuracy, planets[b]);
+            if (!built) return false;
+        }
+        return true;
+    };
+
+    // Referência: as séries completas, avaliadas pelo código escalar.
+    vector<Vsop87Series> complete;
+    bool haveFiles = buildPlanets(true, 0.0, complete);
+    if (haveFiles) {
+        printf("Referencia: series completas dos arquivos de %s\n", folder);
+    } else {
+        buildPlanets(false, 0.0, complete);
+        printf("Referencia: tabela embutida inteira (sem os oito arquivos em %s)\n", folder);
+    }
+    ElpSeries completeMoon;
+    buildElpSeries(0.0, completeMoon);
+    const size_t bodies = complete.size() + 1;
+    vector<double> reference(3 * EPOCHS * bodies);
+    for (size_t e = 0; e < EPOCHS; e++) {
+        for (size_t b = 0; b < complete.size(); b++) {
+            evaluateVsop87(complete[b], days[e], &reference[3 * (e * bodies + b)], SimdKernel::Scalar);
+        }
+        evaluateElp(completeMoon, days[e], &reference[3 * (e * bodies + complete.size())], SimdKernel::Scalar);
+    }
+    // Ângulo, em segundos de arco, entre dois vetores.
+    auto angle = [](const double* u, const double* v) {
+        double cx = u[1] * v[2] - u[2] * v[1], cy = u[2] * v[0] - u[0] * v[2], cz = u[0] * v[1] - u[1] * v[0];
+        double dot = u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+        return atan2(sqrt(cx * cx + cy * cy + cz * cz), dot) * ARCSECONDS_PER_RADIAN;
+    };
+
+    const char* kernelNames[] = {"escalar", "AVX2", "AVX-512"};
+    SimdKernel best = detectSimdKernel();
+    for (double accuracy : ACCURACIES) {
+        ElpSeries moon;
+        buildElpSeries(theoryTolerance(accuracy, ELP_TABLE_ACCURACY), moon);
+        printf("Precisao %g\": %zu de %zu termos da Lua, corte ate %.3g\" (com a tabela, %.3g\")\n", accuracy,
+               moon.size(), moon.tableTerms, moon.bound * ARCSECONDS_PER_RADIAN,
+               ELP_TABLE_ACCURACY + moon.bound * ARCSECONDS_PER_RADIAN);
+        for (bool files : {false, true}) {
+            if (files && !haveFiles) continue;
+            vector<Vsop87Series> planets;
+            buildPlanets(files, theoryTolerance(accuracy, files ? 0.0 : VSOP87_TABLE_ACCURACY), planets);
+            size_t terms = 0, sourceTerms = 0;
+            double bound = 0.0;
+            for (const Vsop87Series& series : planets) {
+                terms += series.size();
+                sourceTerms += series.sourceTerms;
+                bound = max(bound, series.bound * ARCSECONDS_PER_RADIAN);
+            }
+            printf("  %s: %zu de %zu termos dos planetas, corte ate %.3g\" (com a origem, %.3g\")\n",
+                   files ? "arquivos" : "tabela embutida", terms, sourceTerms, bound,
+                   (files ? 0.0 : VSOP87_TABLE_ACCURACY) + bound);
+            for (int kernel = 0; kernel <= (int)best; kernel++) {
+                double maxPlanet = 0.0, maxMoon = 0.0, position[3];
+                auto start = chrono::steady_clock::now();
+                for (size_t e = 0; e < EPOCHS; e++) {
+                    const double* saved = &reference[3 * e * bodies];
+                    for (size_t b = 0; b < planets.size(); b++) {
+                        evaluateVsop87(planets[b], days[e], position, (SimdKernel)kernel);
+                        maxPlanet = max(maxPlanet, angle(position, saved + 3 * b));
+                    }
+                    evaluateElp(moon, days[e], position, (SimdKernel)kernel);
+                    maxMoon = max(maxMoon, angle(position, saved + 3 * planets.size()));
+                }
+                double ms = elapsedMs(start); // Inclui a comparação, desprezível perto das somas.
+                printf("    %-8s %8.2f us/quadro  desvio maximo: planetas %.3g\", Lua %.3g\"\n", kernelNames[kernel],
+                       ms * 1e3 / EPOCHS, maxPlanet, maxMoon);
+            }
+        }
+    }
+}
+
+// Esfera de Plummer de 'n' corpos de massa total 1 / G, em repouso, com amortecimento 0,01. A
+// sequência de números é fixa, então a esfera é a mesma em toda execução.
+NBodySystem plummerSphere(size_t n) {
+    SeededRandom random(12345);
+    NBodySystem system;
+    system.softening = 0.01;
+    system.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        // Raio pela inversa da massa acumulada e direção uniforme na esfera.
+        double r = 1.0 / sqrt(pow(random(), -2.0 / 3.0) - 1.0);
+        double cosTheta = 2.0 * random() - 1.0, phi = 2.0 * M_PI * random();
+        double sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+        const double position[3] = {r * sinTheta * cos(phi), r * sinTheta * sin(phi), r * cosTheta};
+        const double velocity[3] = {0.0, 0.0, 0.0};
+        system.add(position, velocity, 1.0 / (GAUSS_GRAVITY * n));
+    }
+    return system;
+}
+
+// Mede a soma direta das forças (gravity.h) com cada conjunto de instruções, em esferas de
+// Plummer de tamanhos crescentes (--bench-gravity): interações por segundo, GFLOP/s (pela
+// convenção de GRAVITY_FLOPS_PER_INTERACTION) e desvio em relação à versão escalar.
+void benchmarkGravity() {
+    const size_t SIZES[] = {256, 1000, 3000, 10000, 30000};
+    const char* kernelNames[] = {"escalar", "AVX2", "AVX-512"};
+    SimdKernel best = detectSimdKernel();
+    cout << "Soma direta, kernel: " << kernelNames[(int)best] << ", " << workerPool().size() + 1 << " threads" << endl;
+    printf("%8s %-8s %10s %14s %9s %12s\n", "N", "kernel", "ms", "interacoes/s", "GFLOP/s", "desvio rel.");
+    for (size_t n : SIZES) {
+        NBodySystem system = plummerSphere(n);
+        vector<double> referenceX, referenceY, referenceZ;
+        for (int kernel = 0; kernel <= (int)best; kernel++) {
+            // Repete até somar pelo menos 200 ms, para os tamanhos pequenos.
+            int repeats = 0;
+            auto start = chrono::steady_clock::now();
+            do {
+                directForces(system, (SimdKernel)kernel);
+                repeats++;
+            } while (elapsedMs(start) < 200.0);
+            double ms = elapsedMs(start) / repeats;
+            if (kernel == 0) {
+                referenceX = system.ax;
+                referenceY = system.ay;
+                referenceZ = system.az;
+            }
+            double maxError = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                double dx = system.ax[i] - referenceX[i], dy = system.ay[i] - referenceY[i];
+                double dz = system.az[i] - referenceZ[i];
+                double exact = referenceX[i] * referenceX[i] + referenceY[i] * referenceY[i] + referenceZ[i] * referenceZ[i];
+                maxError = max(maxError, sqrt((dx * dx + dy * dy + dz * dz) / exact));
+            }
+            double interactions = (double)n * n / (ms * 1e-3);
+            printf("%8zu %-8s %10.3f %14.3g %9.2f %12.2e\n", n, kernelNames[kernel], ms, interactions,
+                   interactions * GRAVITY_FLOPS_PER_INTERACTION * 1e-9, maxError);
+        }
+    }
+}
+
+// Mede a árvore de Barnes-Hut contra a soma direta em esferas de Plummer de tamanhos crescentes
+// (--bench-nbody): tempo de construção e de cálculo das forças, erro relativo da aceleração
+// em uma amostra de corpos e o tamanho a partir do qual a árvore fica mais rápida. A soma
+// direta completa só é medida até DIRECT_LIMIT corpos; acima disso, só a amostra é calculada.
+void benchmarkNBody() {
+    const size_t SIZES[] = {1000, 3000, 10000, 30000, 100000, 300000, 1000000};
+    const size_t DIRECT_LIMIT = 30000;
+    const size_t SAMPLES = 1000;
+
+    cout << "Esfera de Plummer, theta " << g_NBodyTheta << ", " << workerPool().size() + 1 << " threads" << endl;
+    printf("%8s %10s %10s %10s %10s %12s\n", "N", "arvore ms", "forcas ms", "direta ms", "erro rel.", "interacoes");
+    size_t crossover = 0;
+    for (size_t n : SIZES) {
+        NBodySystem system = plummerSphere(n);
+        BarnesHutTree tree(g_NBodyTheta);
+        auto start = chrono::steady_clock::now();
+        tree.build(system);
+        double buildMs = elapsedMs(start);
+        start = chrono::steady_clock::now();
+        tree.accelerations(system);
+        double forceMs = elapsedMs(start);
+        size_t samples = min(n, SAMPLES);
+        vector<double> ax(system.ax.begin(), system.ax.begin() + samples);
+        vector<double> ay(system.ay.begin(), system.ay.begin() + samples);
+        vector<double> az(system.az.begin(), system.az.begin() + samples);
+
+        double directMs = -1.0;
+        if (n <= DIRECT_LIMIT) {
+            start = chrono::steady_clock::now();
+            directForces(system);
+            directMs = elapsedMs(start);
+            if (!crossover && buildMs + forceMs < directMs) crossover = n;
+        } else {
+            // Os corpos foram sorteados sem ordem, então os primeiros servem de amostra.
+            workerPool().parallelFor(samples, 16, [&](size_t begin, size_t end) {
+                directAccelerations(system, begin, end);
+            });
+        }
+        double errorSum = 0.0;
+        for (size_t i = 0; i < samples; i++) {
+            double dx = ax[i] - system.ax[i], dy = ay[i] - system.ay[i], dz = az[i] - system.az[i];
+            double exact = system.ax[i] * system.ax[i] + system.ay[i] * system.ay[i] + system.az[i] * system.az[i];
+            errorSum += sqrt((dx * dx + dy * dy + dz * dz) / exact);
+        }
+        char direct[32] = "-";
+        if (directMs >= 0.0) snprintf(direct, sizeof(direct), "%.1f", directMs);
+        printf("%8zu %10.1f %10.1f %10s %10.2e %12.3g\n", n, buildMs, forceMs, direct, errorSum / samples,
+               (double)tree.interactionCount());
+    }
+    if (crossover) {
+        printf("A arvore fica mais rapida que a soma direta a partir de N = %zu\n", crossover);
+    } else {
+        printf("A soma direta foi mais rapida em todos os tamanhos medidos (ate N = %zu)\n", DIRECT_LIMIT);
+    }
+}
+
+// Compara o leapfrog de passo fixo, o Bulirsch-Stoer adaptativo e os passos individuais em 1000
+// anos do Sol, dos planetas e da Lua (--bench-integrators). O erro é medido contra uma
+// integração de referência com tolerância bem menor: posição da Lua em relação à Terra, maior
+// erro de posição entre os planetas e deriva relativa da energia. As avaliações de força contam
+// corpos (um cálculo de forças do sistema inteiro conta n), para comparar com os passos
+// individuais. A duração é múltipla do maior passo dos blocos, para todos os corpos terminarem
+// juntos no fim.
+void benchmarkIntegrators() {
+    const double DAYS = floor(1000.0 * 365.25 / NBODY_BLOCK_MAX_STEP) * NBODY_BLOCK_MAX_STEP;
+    initBodies(BODY_CATALOG, BODY_CATALOG_SIZE);
+    g_NBodyParticles = 0;
+    initNBody();
+    const NBodySystem initial = g_NBody;
+    const size_t earth = 1 + g_MoonPlanet, moon = (size_t)g_NBodyMoon;
+    ForceSolver forces = [](NBodySystem& system) { directForces(system, detectSimdKernel()); };
+    PartialForceSolver partialForces = [](NBodySystem& system, const vector<uint32_t>& targets) {
+        directForces(system, targets, detectSimdKernel());
+    };
+    const uint64_t bodies = initial.size();
+    double initialEnergy = totalEnergy(initial);
+
+    auto start = chrono::steady_clock::now();
+    NBodySystem reference = initial;
+    BulirschStoer referenceIntegrator(1e-15, 0.1);
+    referenceIntegrator.advance(reference, DAYS, forces);
+    printf("Referencia: Bulirsch-Stoer, tolerancia 1e-15, %llu passos, %.0f ms\n",
+           (unsigned long long)referenceIntegrator.stepsTaken(), elapsedMs(start));
+    printf("%-26s %11s %9s %10s %9s %12s %12s %10s\n", "integrador", "aval. forca", "passos", "rejeitados", "ms",
+           "erro Lua", "erro planetas", "energia");
+
+    // Erros do estado 'system' depois de 1000 anos, em relação à referência.
+    auto report = [&](const char* name, const NBodySystem& system, uint64_t evaluations, uint64_t steps,
+                      uint64_t rejectedSteps, double ms) {
+        auto offset = [](const NBodySystem& s, size_t a, size_t b, int k) {
+            const vector<double>* axes[3] = {&s.x, &s.y, &s.z};
+            return (*axes[k])[a] - (*axes[k])[b];
+        };
+        double moonError = 0.0, moonDistance = 0.0;
+        for (int k = 0; k < 3; k++) {
+            double difference = offset(system, moon, earth, k) - offset(reference, moon, earth, k);
+            moonError += difference * difference;
+            moonDistance += offset(reference, moon, earth, k) * offset(reference, moon, earth, k);
+        }
+        double planetError = 0.0;
+        for (size_t i = 1; i < g_NBodyMajorCount; i++) {
+            if (i == moon) continue;
+            double squared = 0.0;
+            for (int k = 0; k < 3; k++) {
+                double difference = offset(system, i, 0, k) - offset(reference, i, 0, k);
+                squared += difference * difference;
+            }
+            planetError = max(planetError, sqrt(squared));
+        }
+        double drift = fabs(totalEnergy(system) / initialEnergy - 1.0);
+        // O erro da Lua é relativo à distância Terra-Lua; o dos planetas, em UA.
+        printf("%-26s %11llu %9llu %10llu %9.0f %12.2e %12.2e %10.2e\n", name, (unsigned long long)evaluations,
+               (unsigned long long)steps, (unsigned long long)rejectedSteps, ms, sqrt(moonError / moonDistance),
+               planetError, drift);
+    };
+
+    uint64_t leapfrogEvaluations = 0;
+    for (double dt : {NBODY_TIME_STEP, NBODY_TIME_STEP / 4.0}) {
+        NBodySystem system = initial;
+        start = chrono::steady_clock::now();
+        uint64_t steps = (uint64_t)llround(DAYS / dt);
+        for (uint64_t step = 0; step < steps; step++) leapfrogStep(system, dt, forces);
+        char name[64];
+        snprintf(name, sizeof(name), "leapfrog, passo %.4g dias", dt);
+        report(name, system, steps * bodies, steps, 0, elapsedMs(start));
+        if (!leapfrogEvaluations) leapfrogEvaluations = steps * bodies;
+    }
+    for (double tolerance : {1e-8, 1e-10, 1e-12}) {
+        NBodySystem system = initial;
+        BulirschStoer integrator(tolerance);
+        start = chrono::steady_clock::now();
+        integrator.advance(system, DAYS, forces);
+        char name[64];
+        snprintf(name, sizeof(name), "Bulirsch-Stoer, tol. %.0e", tolerance);
+        report(name, system, integrator.forceEvaluations() * bodies, integrator.stepsTaken(),
+               integrator.stepsRejected(), elapsedMs(start));
+        printf("%26s avaliacoes de forca: %.1f%% das do leapfrog de %.2g dias\n", "",
+               100.0 * integrator.forceEvaluations() * bodies / leapfrogEvaluations, NBODY_TIME_STEP);
+    }
+    for (double accuracy : {0.005, 0.01, 0.02}) {
+        NBodySystem system = initial;
+        BlockTimesteps integrator(NBODY_BLOCK_MAX_STEP, NBODY_BLOCK_LEVELS, accuracy);
+        start = chrono::steady_clock::now();
+        integrator.advance(system, DAYS, partialForces);
+        char name[64];
+        snprintf(name, sizeof(name), "blocos, eta %.3g", accuracy);
+        report(name, system, integrator.forceEvaluations(), integrator.substepsTaken(), 0, elapsedMs(start));
+        printf("%26s avaliacoes de forca: %.1f%% das do leapfrog de %.2g dias\n", "",
+               100.0 * integrator.forceEvaluations() / leapfrogEvaluations, NBODY_TIME_STEP);
+    }
+
+    // Com o disco de planetesimais, quase todos os corpos têm órbitas de anos: a diferença
+    // entre um passo global no ritmo da Lua e os passos individuais é bem maior. A referência é
+    // o leapfrog com um quarto do passo.
+    const size_t DISC_PARTICLES = 500;
+    const double DISC_DAYS = floor(10.0 * 365.25 / NBODY_BLOCK_MAX_STEP) * NBODY_BLOCK_MAX_STEP;
+    g_NBodyParticles = DISC_PARTICLES;
+    initNBody();
+    const NBodySystem disc = g_NBody;
+    size_t n = disc.size();
+    auto leapfrog = [&](double dt) {
+        NBodySystem system = disc;
+        uint64_t steps = (uint64_t)llround(DISC_DAYS / dt);
+        for (uint64_t step = 0; step < steps; step++) leapfrogStep(system, dt, forces);
+        return system;
+    };
+    start = chrono::steady_clock::now();
+    const NBodySystem discReference = leapfrog(NBODY_TIME_STEP / 4.0);
+    printf("\nDisco de %zu planetesimais, %.0f dias; referencia: leapfrog de %.4g dias, %.0f ms\n", DISC_PARTICLES,
+           DISC_DAYS, NBODY_TIME_STEP / 4.0, elapsedMs(start));
+    printf("%-26s %11s %9s %14s %14s %10s\n", "integrador", "aval. forca", "ms", "erro planetas", "erro disco",
+           "energia");
+    double discEnergy = totalEnergy(disc);
+    auto discReport = [&](const char* name, const NBodySystem& system, uint64_t evaluations, double ms) {
+        double planetError = 0.0, particleError = 0.0;
+        for (size_t i = 1; i < n; i++) {
+            double error = sqrt(pow(system.x[i] - discReference.x[i], 2) + pow(system.y[i] - discReference.y[i], 2) +
+                                pow(system.z[i] - discReference.z[i], 2));
+            double& largest = i < g_NBodyMajorCount ? planetError : particleError;
+            largest = max(largest, error);
+        }
+        printf("%-26s %11llu %9.0f %14.2e %14.2e %10.2e\n", name, (unsigned long long)evaluations, ms, planetError,
+               particleError, fabs(totalEnergy(system) / discEnergy - 1.0));
+    };
+    start = chrono::steady_clock::now();
+    NBodySystem global = leapfrog(NBODY_TIME_STEP);
+    uint64_t globalEvaluations = (uint64_t)llround(DISC_DAYS / NBODY_TIME_STEP) * n;
+    discReport("leapfrog, passo 0.25 dias", global, globalEvaluations, elapsedMs(start));
+    for (double accuracy : {NBODY_BLOCK_ACCURACY, 0.03}) {
+        NBodySystem system = disc;
+        BlockTimesteps integrator(NBODY_BLOCK_MAX_STEP, NBODY_BLOCK_LEVELS, accuracy);
+        start = chrono::steady_clock::now();
+        integrator.advance(system, DISC_DAYS, partialForces);
+        char name[64];
+        snprintf(name, sizeof(name), "blocos, eta %.3g", accuracy);
+        discReport(name, system, integrator.forceEvaluations(), elapsedMs(start));
+        printf("%26s avaliacoes de forca: %.1f%% das do leapfrog; corpos por nivel:", "",
+               100.0 * integrator.forceEvaluations() / globalEvaluations);
+        for (size_t count : integrator.levelCounts()) printf(" %zu", count);
+        printf("\n");
+    }
+}
+
 int main(int argc, char** argv) {
-    glutInit(&argc, argv);
-    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
-    glutInitWindowSize(1280, 720);
-    glutInitWindowPosition(100, 100);
-    glutCreateWindow("Sistema Solar");
+    // A exportação, a busca de eventos, a conferência das efemérides e os benchmarks que só usam a
+    // CPU rodam sem janela (e sem servidor gráfico).
+    static const char* const HEADLESS_OPTIONS[] = {"--export",         "--events",        "--bench-kepler",
+                                                   "--bench-ephemeris", "--bench-analytic", "--bench-gravity",
+                                                   "--bench-integrators", "--bench-nbody", "--check-testpo"};
+    bool headless = false;
+    for (int i = 1; i < argc; i++) {
+        for (const char* option : HEADLESS_OPTIONS) headless = headless || strcmp(argv[i], option) == 0;
+    }
+    if (!headless) {
+        glutInit(&argc, argv);
+        glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
+        glutInitWindowSize(1280, 720);
+        glutInitWindowPosition(100, 100);
+        glutCreateWindow("Sistema Solar");
+    }
+
+    // Opções de linha de comando (as opções do GLUT já foram removidas por glutInit).
+    g_SessionCommand = sessionCommandLine(argc, argv);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench-mipmaps") == 0) {
+            benchmarkMipmaps();
+            return 0;
+        }
+        if (strcmp(argv[i], "--bench-kepler") == 0) {
+            benchmarkKepler();
+            return 0;
+        }
+        if (strcmp(argv[i], "--bench-ephemeris") == 0 && i + 1 < argc) {
+            benchmarkEphemeris(argv[i + 1]);
+            return 0;
+        }
+        if (strcmp(argv[i], "--check-testpo") == 0 && i + 2 < argc) {
+            return checkTestpo(argv[i + 1], argv[i + 2]) ? 0 : 1;
+        }
+        if (strcmp(argv[i], "--bench-analytic") == 0) {
+            benchmarkAnalytic(i + 1 < argc ? argv[i + 1] : g_Vsop87Path.c_str());
+            return 0;
+        }
+        if (strcmp(argv[i], "--bench-gravity") == 0) {
+            benchmarkGravity();
+            return 0;
+        }
+        if (strcmp(argv[i], "--bench-integrators") == 0) {
+            benchmarkIntegrators();
+            return 0;
+        }
+        if (strcmp(argv[i], "--bench-nbody") == 0) {
+            benchmarkNBody();
+            return 0;
+        }
+        if (strcmp(argv[i], "--no-compression") == 0) {
+            g_CompressTextures = false;
+            continue;
+        }
+        if (strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc) {
+            g_TextureBudgetMB = (float)atof(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--belt") == 0 && i + 1 < argc) {
+            g_BeltPath = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--ephemeris") == 0 && i + 1 < argc) {
+            g_EphemerisPath = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--analytic") == 0) {
+            g_AnalyticMode = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--vsop87") == 0 && i + 1 < argc) {
+            g_AnalyticMode = true;
+            g_Vsop87Path = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--accuracy") == 0 && i + 1 < argc) {
+            g_TheoryAccuracy = max(atof(argv[++i]), 0.0);
+            continue;
+        }
+        if (strcmp(argv[i], "--date") == 0 && i + 1 < argc) {
+            int year, month;
+            double day;
+            const char* value = argv[++i];
+            if (sscanf(value, "%d-%d-%lf", &year, &month, &day) == 3 && month >= 1 && month <= 12) {
+                g_StartDays = julianDayFromCalendar(year, month, day) - J2000_JULIAN_DAY;
+            } else {
+                cerr << "Valor invalido para --date (use AAAA-MM-DD): " << value << endl;
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            g_ExportPath = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            g_EventsPath = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--jumps") == 0) {
+            g_EventJumps = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--until") == 0 && i + 1 < argc) {
+            int year, month;
+            double day;
+            const char* value = argv[++i];
+            if (sscanf(value, "%d-%d-%lf", &year, &month, &day) == 3 && month >= 1 && month <= 12) {
+                g_ExportEndDays = julianDayFromCalendar(year, month, day) - J2000_JULIAN_DAY;
+            } else {
+                cerr << "Valor invalido para --until (use AAAA-MM-DD): " << value << endl;
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) {
+            g_ExportStep = atof(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--nbody") == 0 && i + 1 < argc) {
+            g_NBodyMode = true;
+            g_NBodyParticles = (size_t)max(atol(argv[++i]), 0L);
+            continue;
+        }
+        if (strcmp(argv[i], "--nbody-forces") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            if (strcmp(value, "direct") == 0) {
+                g_NBodyForces = NBodyForces::Direct;
+            } else if (strcmp(value, "tree") == 0) {
+                g_NBodyForces = NBodyForces::Tree;
+            } else if (strcmp(value, "auto") == 0) {
+                g_NBodyForces = NBodyForces::Auto;
+            } else {
+                cerr << "Valor invalido para --nbody-forces: " << value << endl;
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--integrator") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            if (strcmp(value, "leapfrog") == 0) {
+                g_NBodyIntegrator = NBodyIntegrator::Leapfrog;
+            } else if (strcmp(value, "adaptive") == 0) {
+                g_NBodyIntegrator = NBodyIntegrator::Adaptive;
+            } else if (strcmp(value, "block") == 0) {
+                g_NBodyIntegrator = NBodyIntegrator::Block;
+            } else {
+                cerr << "Valor invalido para --integrator: " << value << endl;
+            }
+            continue;
+        }
+        if (strcmp(argv[i], "--theta") == 0 && i + 1 < argc) {
+            g_NBodyTheta = max(atof(argv[++i]), 0.0);
+            continue;
+        }
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            g_RecordPath = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            g_ReplayPath = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--replay-fast") == 0) {
+            g_ReplayFast = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--frame-times") == 0 && i + 1 < argc) {
+            g_FrameTimesPath = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            g_TargetFps = max(atof(argv[++i]), 0.0);
+            continue;
+        }
+        cerr << "Opcao desconhecida: " << argv[i] << endl;
+    }
+
+    if (headless) {
+        initBodies(BODY_CATALOG, BODY_CATALOG_SIZE);
+        if (g_AnalyticMode) initAnalytic();
+        if (!g_EphemerisPath.empty()) initEphemeris();
+        int status = g_EventsPath.empty() ? 0 : writeEvents();
+        if (status == 0 && !g_ExportPath.empty()) status = exportTrajectories();
+        return status;
+    }
     init();
     glutDisplayFunc(display);
-    glutReshapeFunc(reshape);
-    glutKeyboardFunc(keyboard);
-    glutSpecialFunc(specialKeys);
-    glutTimerFunc(0, timer, 0); // Inicia o timer da animação.
+    glutReshapeFunc(reshapeInput);
+    glutKeyboardFunc(keyboardInput);
+    glutSpecialFunc(specialKeysInput);
+    g_FramePacer.setTargetFps(g_TargetFps);
+    glutIdleFunc(idle); // Inicia a animação.
     glutMainLoop();
     return 0;
 }
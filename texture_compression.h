@@ -0,0 +1,261 @@
+/*
+ * =================================================================================================
+ * COMPRESSÃO DE TEXTURAS EM BLOCOS (BC3 / DXT5)
+ *
+ * Codificador usado quando o driver oferece GL_EXT_texture_compression_s3tc. Cada bloco de 4x4
+ * texels RGBA8 (64 bytes) vira 16 bytes: 8 de alfa (dois extremos e índices de 3 bits) e 8 de cor
+ * no formato BC1 (dois extremos RGB565 e índices de 2 bits), ou seja, 4x menos memória de textura.
+ *
+ * Os extremos de cor vêm da caixa envolvente do bloco, encolhida em 1/16 de cada lado e com a
+ * diagonal escolhida pelo sinal da covariância entre os canais. Cada texel recebe a cor da paleta
+ * mais próxima (distância de Manhattan). A escolha dos índices tem versão SSE2, que produz
+ * exatamente os mesmos bytes da versão escalar, e os blocos de cada nível são divididos entre as
+ * threads do pool.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "mipmap.h"
+#include "thread_pool.h"
+
+const int BC3_BLOCK_BYTES = 16;
+
+// Tamanho em bytes de um nível width x height codificado em BC3.
+inline size_t bc3LevelSize(int width, int height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * BC3_BLOCK_BYTES;
+}
+
+// Copia o bloco 4x4 com origem no texel (x, y). Nas bordas de níveis menores que 4 texels ou
+// com tamanho não múltiplo de 4, a última linha e a última coluna são repetidas.
+inline void bcLoadBlock(const MipLevel& level, int x, int y, unsigned char block[64]) {
+    for (int row = 0; row < 4; row++) {
+        const unsigned char* src = &level.pixels[(size_t)std::min(y + row, level.height - 1) * level.width * 4];
+        for (int column = 0; column < 4; column++) {
+            memcpy(block + (row * 4 + column) * 4, src + std::min(x + column, level.width - 1) * 4, 4);
+        }
+    }
+}
+
+// Extremos e paleta de um bloco, calculados a partir do mínimo e do máximo de cada canal.
+struct BcPalette {
+    uint16_t color0, color1;     // Extremos RGB565, com color0 > color1 (modo de 4 cores).
+    unsigned char colors[4][4];  // Paleta RGBA8 na ordem dos índices; alfa zerado.
+    unsigned char alpha0, alpha1; // Extremos de alfa, com alpha0 >= alpha1.
+};
+
+inline uint16_t bcPack565(const int color[3]) {
+    return (uint16_t)(((color[0] * 31 + 127) / 255) << 11 | ((color[1] * 63 + 127) / 255) << 5 |
+                      ((color[2] * 31 + 127) / 255));
+}
+
+// Expande RGB565 para RGB888 repetindo os bits mais significativos.
+inline void bcUnpack565(uint16_t packed, unsigned char color[4]) {
+    int r = packed >> 11, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (unsigned char)(r << 3 | r >> 2);
+    color[1] = (unsigned char)(g << 2 | g >> 4);
+    color[2] = (unsigned char)(b << 3 | b >> 2);
+    color[3] = 0;
+}
+
+inline BcPalette bcBuildPalette(const unsigned char block[64], const unsigned char minimum[4],
+                                const unsigned char maximum[4]) {
+    int low[3], high[3];
+    for (int c = 0; c < 3; c++) {
+        int inset = (maximum[c] - minimum[c]) >> 4;
+        low[c] = minimum[c] + inset;
+        high[c] = maximum[c] - inset;
+    }
+    // A caixa envolvente tem quatro diagonais; quando verde ou azul crescem enquanto o vermelho
+    // diminui, a diagonal certa liga o mínimo de um canal ao máximo do outro.
+    int center[3] = {minimum[0] + maximum[0], minimum[1] + maximum[1], minimum[2] + maximum[2]};
+    int covarianceRG = 0, covarianceRB = 0;
+    for (int i = 0; i < 16; i++) {
+        int r = 2 * block[4 * i] - center[0];
+        covarianceRG += r * (2 * block[4 * i + 1] - center[1]);
+        covarianceRB += r * (2 * block[4 * i + 2] - center[2]);
+    }
+    if (covarianceRG < 0) std::swap(low[1], high[1]);
+    if (covarianceRB < 0) std::swap(low[2], high[2]);
+
+    BcPalette palette;
+    palette.color0 = bcPack565(high);
+    palette.color1 = bcPack565(low);
+    if (palette.color0 < palette.color1) std::swap(palette.color0, palette.color1);
+    bcUnpack565(palette.color0, palette.colors[0]);
+    bcUnpack565(palette.color1, palette.colors[1]);
+    for (int c = 0; c < 4; c++) {
+        palette.colors[2][c] = (unsigned char)((2 * palette.colors[0][c] + palette.colors[1][c]) / 3);
+        palette.colors[3][c] = (unsigned char)((palette.colors[0][c] + 2 * palette.colors[1][c]) / 3);
+    }
+    palette.alpha0 = maximum[3];
+    palette.alpha1 = minimum[3];
+    return palette;
+}
+
+// Converte a posição t (0 = alpha1 ... 7 = alpha0) na paleta de alfa para o índice do formato,
+// onde 0 e 1 são os extremos e 2..7 os valores interpolados de alpha0 para alpha1.
+inline int bcAlphaIndex(int t) {
+    int index = (8 - t) & 7;
+    return index < 2 ? index ^ 1 : index;
+}
+
+// Grava o bloco BC3: alfa (extremos + 16 índices de 3 bits) seguido da cor BC1.
+inline void bcWriteBlock(const BcPalette& palette, const int colorIndex[16], const int alphaIndex[16],
+                         unsigned char out[16]) {
+    out[0] = palette.alpha0;
+    out[1] = palette.alpha1;
+    uint64_t alphaBits = 0;
+    for (int i = 0; i < 16; i++) alphaBits |= (uint64_t)alphaIndex[i] << (3 * i);
+    for (int i = 0; i < 6; i++) out[2 + i] = (unsigned char)(alphaBits >> (8 * i));
+    out[8] = (unsigned char)palette.color0;
+    out[9] = (unsigned char)(palette.color0 >> 8);
+    out[10] = (unsigned char)palette.color1;
+    out[11] = (unsigned char)(palette.color1 >> 8);
+    uint32_t colorBits = 0;
+    for (int i = 0; i < 16; i++) colorBits |= (uint32_t)colorIndex[i] << (2 * i);
+    memcpy(out + 12, &colorBits, 4);
+}
+
+inline void bcEncodeBlockScalar(const unsigned char block[64], unsigned char out[16]) {
+    unsigned char minimum[4] = {255, 255, 255, 255}, maximum[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            minimum[c] = std::min(minimum[c], block[4 * i + c]);
+            maximum[c] = std::max(maximum[c], block[4 * i + c]);
+        }
+    }
+    BcPalette palette = bcBuildPalette(block, minimum, maximum);
+
+    int colorIndex[16], alphaIndex[16];
+    int alphaRange = palette.alpha0 - palette.alpha1;
+    for (int i = 0; i < 16; i++) {
+        const unsigned char* texel = block + 4 * i;
+        int bestDistance = 1 << 30;
+        for (int k = 0; k < 4; k++) {
+            int distance = abs(texel[0] - palette.colors[k][0]) + abs(texel[1] - palette.colors[k][1]) +
+                           abs(texel[2] - palette.colors[k][2]);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                colorIndex[i] = k;
+            }
+        }
+        // Posição mais próxima entre os 8 valores de alfa: quantos pontos médios o texel passa.
+        int t = 0;
+        for (int k = 1; k <= 7; k++) t += 14 * texel[3] >= 14 * palette.alpha1 + (2 * k - 1) * alphaRange;
+        alphaIndex[i] = alphaRange ? bcAlphaIndex(t) : 0;
+    }
+    bcWriteBlock(palette, colorIndex, alphaIndex, out);
+}
+
+#ifdef MIPMAP_HAS_SSE2
+// Mesma codificação com os 16 texels em quatro registradores: mínimo/máximo, distâncias às
+// quatro cores da paleta e posições de alfa são calculados para 4 ou 8 texels por instrução.
+inline void bcEncodeBlockSSE2(const unsigned char block[64], unsigned char out[16]) {
+    __m128i rows[4];
+    for (int i = 0; i < 4; i++) rows[i] = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+    __m128i low = _mm_min_epu8(_mm_min_epu8(rows[0], rows[1]), _mm_min_epu8(rows[2], rows[3]));
+    __m128i high = _mm_max_epu8(_mm_max_epu8(rows[0], rows[1]), _mm_max_epu8(rows[2], rows[3]));
+    low = _mm_min_epu8(low, _mm_shuffle_epi32(low, _MM_SHUFFLE(1, 0, 3, 2)));
+    low = _mm_min_epu8(low, _mm_shuffle_epi32(low, _MM_SHUFFLE(2, 3, 0, 1)));
+    high = _mm_max_epu8(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(1, 0, 3, 2)));
+    high = _mm_max_epu8(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t minimumBits = (uint32_t)_mm_cvtsi128_si32(low), maximumBits = (uint32_t)_mm_cvtsi128_si32(high);
+    unsigned char minimum[4], maximum[4];
+    memcpy(minimum, &minimumBits, 4);
+    memcpy(maximum, &maximumBits, 4);
+    BcPalette palette = bcBuildPalette(block, minimum, maximum);
+
+    // Índices de cor: distância de Manhattan RGB em lanes de 32 bits, menor índice nos empates.
+    const __m128i rgbMask = _mm_set1_epi32(0x00ffffff);
+    const __m128i byteMask = _mm_set1_epi32(0x00ff00ff);
+    alignas(16) int colorIndex[16], alphaIndex[16];
+    __m128i paletteColors[4];
+    for (int k = 0; k < 4; k++) {
+        uint32_t bits;
+        memcpy(&bits, palette.colors[k], 4);
+        paletteColors[k] = _mm_set1_epi32((int)bits);
+    }
+    for (int i = 0; i < 4; i++) {
+        __m128i texels = _mm_and_si128(rows[i], rgbMask);
+        __m128i best = _mm_set1_epi32(1 << 30), bestIndex = _mm_setzero_si128();
+        for (int k = 0; k < 4; k++) {
+            __m128i difference = _mm_or_si128(_mm_subs_epu8(texels, paletteColors[k]),
+                                              _mm_subs_epu8(paletteColors[k], texels));
+            __m128i pairs = _mm_add_epi16(_mm_and_si128(difference, byteMask),
+                                          _mm_and_si128(_mm_srli_epi32(difference, 8), byteMask));
+            __m128i distance = _mm_add_epi32(_mm_and_si128(pairs, _mm_set1_epi32(0xffff)), _mm_srli_epi32(pairs, 16));
+            __m128i closer = _mm_cmplt_epi32(distance, best);
+            best = _mm_or_si128(_mm_and_si128(closer, distance), _mm_andnot_si128(closer, best));
+            bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(k)), _mm_andnot_si128(closer, bestIndex));
+        }
+        _mm_store_si128((__m128i*)(colorIndex + 4 * i), bestIndex);
+    }
+
+    // Índices de alfa: t = número de limiares 14*alpha1 + (2k-1)*(alpha0-alpha1) atingidos, em 16 bits.
+    int alphaRange = palette.alpha0 - palette.alpha1;
+    if (alphaRange == 0) {
+        memset(alphaIndex, 0, sizeof(alphaIndex));
+    } else {
+        __m128i alpha[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i a = _mm_srli_epi32(rows[2 * half], 24), b = _mm_srli_epi32(rows[2 * half + 1], 24);
+            alpha[half] = _mm_mullo_epi16(_mm_packs_epi32(a, b), _mm_set1_epi16(14));
+        }
+        for (int half = 0; half < 2; half++) {
+            __m128i t = _mm_setzero_si128();
+            for (int k = 1; k <= 7; k++) {
+                // 14*a >= limiar  <=>  14*a > limiar - 1; a máscara vale -1, então é subtraída.
+                __m128i threshold = _mm_set1_epi16((short)(14 * palette.alpha1 + (2 * k - 1) * alphaRange - 1));
+                t = _mm_sub_epi16(t, _mm_cmpgt_epi16(alpha[half], threshold));
+            }
+            // Mesmo mapeamento de bcAlphaIndex: (8 - t) & 7, trocando 0 e 1.
+            __m128i index = _mm_and_si128(_mm_sub_epi16(_mm_set1_epi16(8), t), _mm_set1_epi16(7));
+            index = _mm_xor_si128(index, _mm_and_si128(_mm_cmplt_epi16(index, _mm_set1_epi16(2)), _mm_set1_epi16(1)));
+            alignas(16) short values[8];
+            _mm_store_si128((__m128i*)values, index);
+            for (int i = 0; i < 8; i++) alphaIndex[8 * half + i] = values[i];
+        }
+    }
+    bcWriteBlock(palette, colorIndex, alphaIndex, out);
+}
+#endif
+
+// Codifica um nível RGBA8 inteiro em BC3. As linhas de blocos são divididas entre as threads do
+// pool; o resultado guarda os blocos em 'pixels' e as dimensões originais em width/height.
+inline MipLevel compressLevelBC3(const MipLevel& level, MipmapKernel kernel = detectMipmapKernel()) {
+    int blocksX = (level.width + 3) / 4, blocksY = (level.height + 3) / 4;
+    MipLevel compressed = {level.width, level.height, std::vector<unsigned char>(bc3LevelSize(level.width, level.height))};
+    unsigned char* out = compressed.pixels.data();
+    workerPool().parallelFor((size_t)blocksY, 8, [&, out](size_t rowBegin, size_t rowEnd) {
+        unsigned char block[64];
+        for (size_t by = rowBegin; by < rowEnd; by++) {
+            for (int bx = 0; bx < blocksX; bx++) {
+                bcLoadBlock(level, bx * 4, (int)by * 4, block);
+                unsigned char* dst = out + ((size_t)by * blocksX + bx) * BC3_BLOCK_BYTES;
+#ifdef MIPMAP_HAS_SSE2
+                if (kernel != MipmapKernel::Scalar) {
+                    bcEncodeBlockSSE2(block, dst);
+                    continue;
+                }
+#endif
+                bcEncodeBlockScalar(block, dst);
+            }
+        }
+    });
+    return compressed;
+}
+
+// Codifica todos os níveis de uma cadeia de mipmaps.
+inline std::vector<MipLevel> compressMipChainBC3(const std::vector<MipLevel>& levels,
+                                                 MipmapKernel kernel = detectMipmapKernel()) {
+    std::vector<MipLevel> compressed;
+    for (const MipLevel& level : levels) compressed.push_back(compressLevelBC3(level, kernel));
+    return compressed;
+}
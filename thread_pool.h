@@ -0,0 +1,128 @@
+/*
+ * =================================================================================================
+ * POOL DE THREADS DE TRABALHO
+ *
+ * Usado para tirar do laço principal o trabalho pesado de CPU (decodificação de texturas,
+ * geração de mipmaps, etc.). O pool é criado na primeira chamada de workerPool() e mantém
+ * uma thread a menos que o número de núcleos (no mínimo uma), deixando um núcleo livre para
+ * o GLUT/OpenGL.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount) {
+        for (unsigned i = 0; i < threadCount; i++) workers.emplace_back([this] { workerLoop(); });
+    }
+
+    // Espera as tarefas em andamento terminarem; tarefas ainda na fila são descartadas.
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            jobs.clear();
+        }
+        wakeUp.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    // Enfileira uma tarefa para ser executada por alguma thread do pool.
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        wakeUp.notify_one();
+    }
+
+    // Executa body(begin, end) sobre [0, count) em blocos de até 'grain' índices. A thread que
+    // chama também processa blocos, então a função pode ser usada de dentro de uma tarefa do pool
+    // sem risco de deadlock mesmo com todas as outras threads ocupadas.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+        if (count == 0) return;
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1 || workers.empty()) {
+            body(0, count);
+            return;
+        }
+
+        struct Loop {
+            std::function<void(size_t, size_t)> body;
+            size_t count, grain, chunks;
+            std::atomic<size_t> next{0}, done{0};
+            std::mutex mutex;
+            std::condition_variable finished;
+
+            // Processa blocos até acabarem; avisa quem espera quando o último bloco termina.
+            void run() {
+                size_t chunk;
+                while ((chunk = next.fetch_add(1)) < chunks) {
+                    size_t begin = chunk * grain;
+                    body(begin, std::min(begin + grain, count));
+                    if (done.fetch_add(1) + 1 == chunks) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        finished.notify_all();
+                    }
+                }
+            }
+        };
+        auto loop = std::make_shared<Loop>();
+        loop->body = body;
+        loop->count = count;
+        loop->grain = grain;
+        loop->chunks = chunks;
+
+        size_t helpers = std::min<size_t>(workers.size(), chunks - 1);
+        for (size_t i = 0; i < helpers; i++) submit([loop] { loop->run(); });
+        loop->run();
+
+        std::unique_lock<std::mutex> lock(loop->mutex);
+        loop->finished.wait(lock, [&] { return loop->done.load() == chunks; });
+    }
+
+    // Quantidade de threads de trabalho (sem contar a thread que chama parallelFor).
+    unsigned size() const { return (unsigned)workers.size(); }
+
+private:
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+};
+
+// Pool compartilhado pelo programa inteiro.
+inline ThreadPool& workerPool() {
+    static ThreadPool pool([] {
+        unsigned cores = std::thread::hardware_concurrency();
+        return cores > 1 ? cores - 1 : 1u;
+    }());
+    return pool;
+}
@@ -0,0 +1,389 @@
+/*
+ * =================================================================================================
+ * LINHA DO TEMPO COM CHECKPOINTS
+ *
+ * Cópias periódicas do estado de um NBodySystem (posições, velocidades e acelerações; as massas
+ * não mudam) e do estado do integrador, para voltar a qualquer instante já integrado sem integrar
+ * tudo de novo desde o início: restaura-se o último checkpoint antes do instante e integra-se só o
+ * resto. Com as acelerações, restaurar é só uma cópia, sem avaliar as forças, e com o estado do
+ * integrador a integração continua exatamente como da primeira vez.
+ *
+ * Os checkpoints são espaçados pelo trabalho da integração ao longo do caminho integrado (em
+ * interações de força, contadas por quem chama), não pelo tempo do relógio: um checkpoint é
+ * gravado quando o trabalho passa de um múltiplo do espaçamento. Voltar custa, no pior caso,
+ * integrar um espaçamento.
+ *
+ * Os checkpoints mais recentes ficam em um anel na memória, com tamanho limitado em bytes. Cada
+ * checkpoint gravado no anel entra também na fila de uma thread que o copia para um arquivo
+ * temporário, em registros de tamanho fixo, então um checkpoint que já saiu do anel ainda pode
+ * ser lido do disco. Gravar um checkpoint só copia o estado para uma posição livre do anel; se a
+ * posição seguinte ainda estiver esperando o disco, o checkpoint é descartado em vez de esperar.
+ * Os checkpoints só são aceitos em ordem crescente de tempo: depois de voltar, a integração
+ * repetida não grava de novo o trecho já coberto.
+ *
+ * O arquivo tem um limite em bytes, que dá a quantidade de checkpoints guardados. Ao passar do
+ * limite, o espaçamento dobra em toda a linha do tempo: fica só o primeiro checkpoint de cada
+ * intervalo do espaçamento novo, os seguintes passam a ser gravados nele, e os registros do
+ * arquivo dos que saíram são reusados. O espaçamento é o mesmo em todo o trecho integrado, então
+ * o custo de voltar a qualquer instante também é, e spacing() o informa.
+ *
+ * Só a thread que integra chama record() e restore(); a thread de gravação só lê o anel.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "nbody.h"
+
+class CheckpointTimeline {
+public:
+    struct Stats {
+        size_t checkpoints = 0; // Checkpoints guardados.
+        size_t accepted = 0;    // Checkpoints aceitos desde a abertura.
+        size_t thinned = 0;     // Retirados quando o espaçamento dobrou.
+        size_t inMemory = 0;    // Ainda no anel.
+        size_t onDisk = 0;      // Já gravados no arquivo.
+        size_t lost = 0;        // Saíram do anel sem cópia no disco (falha de gravação ou sem registro).
+        size_t dropped = 0;     // Descartados porque o anel estava esperando o disco.
+        size_t recordBytes = 0;
+        size_t slots = 0;
+        size_t fileRecords = 0; // Registros do arquivo já criados.
+        size_t capacity = 0;    // Limite de checkpoints guardados.
+        uint64_t spacing = 0;   // Trabalho entre dois checkpoints.
+    };
+
+    CheckpointTimeline() = default;
+    CheckpointTimeline(const CheckpointTimeline&) = delete;
+    CheckpointTimeline& operator=(const CheckpointTimeline&) = delete;
+    ~CheckpointTimeline() { close(); }
+
+    // Prepara a linha do tempo para sistemas de 'bodies' corpos, com 'integratorSize' valores do
+    // estado do integrador, um checkpoint a cada 'interval' de trabalho, um anel de até
+    // 'ringBytes' bytes e um arquivo de até 'diskBytes' bytes. Sem arquivo temporário (retorna
+    // false), os checkpoints ficam só no anel, e o limite é o dele.
+    bool open(size_t bodies, size_t integratorSize, uint64_t interval, size_t ringBytes, size_t diskBytes) {
+        close();
+        bodyCount = bodies;
+        integratorValues = integratorSize;
+        recordBytes = (STATE_ARRAYS * bodies + integratorSize) * sizeof(double);
+        baseInterval = std::max<uint64_t>(interval, 1);
+        stride = 1;
+        size_t count = std::min<size_t>(std::max<size_t>(ringBytes / std::max<size_t>(recordBytes, 1), 3), 1024);
+        slots.assign(count, Slot());
+        nextSlot = 0;
+        entries.clear();
+        freeRecords.clear();
+        fileRecords = 0;
+        accepted = thinned = lost = dropped = 0;
+        failed = false;
+        stopping = false;
+        file = std::tmpfile();
+        if (!file) {
+            diskRecords = 0;
+            capacity = count - 1; // Sempre sobra uma posição livre no anel para o seguinte.
+            return false;
+        }
+        diskRecords = std::max<size_t>(diskBytes / std::max<size_t>(recordBytes, 1), 2);
+        capacity = diskRecords;
+        writer = std::thread([this] { writerLoop(); });
+        return true;
+    }
+
+    // Para a thread de gravação e apaga o arquivo temporário.
+    void close() {
+        if (writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            writer.join();
+        }
+        if (file) std::fclose(file);
+        file = nullptr;
+        queue.clear();
+    }
+
+    // Trabalho entre dois checkpoints guardados: o intervalo pedido na abertura, dobrado a cada
+    // vez que o limite foi atingido.
+    uint64_t spacing() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return baseInterval * stride;
+    }
+
+    // Instante do checkpoint mais recente; -infinito se ainda não há nenhum.
+    double latest() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.empty() ? -std::numeric_limits<double>::infinity() : entries.back().time;
+    }
+
+    // Instante do último checkpoint disponível com instante até 'time'; -infinito se não há.
+    double latestBefore(double time) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t index = find(time);
+        return index == 0 ? -std::numeric_limits<double>::infinity() : entries[index - 1].time;
+    }
+
+    // Se um estado com 'work' de trabalho desde o início da integração já passou do múltiplo do
+    // espaçamento seguinte ao do checkpoint mais recente.
+    bool due(uint64_t work) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.empty() || work / (baseInterval * stride) > entries.back().work / (baseInterval * stride);
+    }
+
+    // Guarda o estado do sistema e o do integrador ('integrator', com o tamanho dado na
+    // abertura), a 'work' de trabalho desde o início. Retorna false sem esperar se o checkpoint
+    // não está vencido (due()), se o instante não passa do último checkpoint ou se a posição
+    // seguinte do anel ainda não foi gravada no disco.
+    bool record(const NBodySystem& system, const std::vector<double>& integrator, uint64_t work) {
+        if (system.size() != bodyCount || integrator.size() != integratorValues || !due(work) ||
+            system.time <= latest()) {
+            return false;
+        }
+        size_t index = chooseSlot();
+        Slot& slot = slots[index];
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (slot.writing) {
+                dropped++;
+                return false;
+            }
+            // O checkpoint que estava nesta posição sai do anel; sem cópia no disco, ele se perde.
+            size_t entry = entryOf(slot.sequence);
+            if (entry != NO_ENTRY) {
+                entries[entry].slot = NO_SLOT;
+                if (!entries[entry].onDisk) {
+                    release(entry);
+                    entries.erase(entries.begin() + entry);
+                    lost++;
+                }
+            }
+            slot.sequence = NO_SEQUENCE;
+        }
+        // A posição está livre: a thread de gravação só lê as que estão na fila.
+        slot.state.resize(STATE_ARRAYS * bodyCount + integratorValues);
+        const std::vector<double>* parts[STATE_ARRAYS] = {&system.x,  &system.y,  &system.z,  &system.vx, &system.vy,
+                                                          &system.vz, &system.ax, &system.ay, &system.az};
+        for (int k = 0; k < STATE_ARRAYS; k++) {
+            std::copy(parts[k]->begin(), parts[k]->end(), slot.state.begin() + k * bodyCount);
+        }
+        std::copy(integrator.begin(), integrator.end(), slot.state.begin() + STATE_ARRAYS * bodyCount);
+        bool queued = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.sequence = accepted++;
+            entries.push_back({system.time, work, slot.sequence, index, NO_RECORD, false});
+            thin();
+            // Um registro livre do arquivo, ou um novo enquanto o arquivo cabe no limite. Se o
+            // rareamento tirou o próprio checkpoint novo, não há o que gravar.
+            size_t record = NO_RECORD;
+            bool kept = entryOf(slot.sequence) != NO_ENTRY;
+            if (kept && file && !failed) {
+                if (!freeRecords.empty()) {
+                    record = freeRecords.back();
+                    freeRecords.pop_back();
+                } else if (fileRecords < diskRecords) {
+                    record = fileRecords++;
+                }
+            }
+            if (record != NO_RECORD) {
+                entries.back().record = slot.record = record;
+                slot.writing = queued = true;
+                queue.push_back(index);
+            }
+        }
+        if (queued) wake.notify_one();
+        nextSlot = (index + 1) % slots.size();
+        return true;
+    }
+
+    // Restaura no sistema o último checkpoint disponível com instante até 'time' e devolve o
+    // estado do integrador e o trabalho daquele checkpoint. Retorna false se não há nenhum.
+    bool restore(double time, NBodySystem& system, std::vector<double>& integrator, uint64_t& work) {
+        if (system.size() != bodyCount) return false;
+        Entry entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            size_t index = find(time);
+            if (index == 0) return false;
+            entry = entries[index - 1];
+        }
+        // As posições do anel e os registros livres só são reusados por record(), na mesma thread.
+        const double* state;
+        if (entry.slot != NO_SLOT) {
+            state = slots[entry.slot].state.data();
+        } else {
+            scratch.resize(STATE_ARRAYS * bodyCount + integratorValues);
+            if (pread(fileno(file), scratch.data(), recordBytes, (off_t)(entry.record * recordBytes)) !=
+                (ssize_t)recordBytes) {
+                return false;
+            }
+            state = scratch.data();
+        }
+        std::vector<double>* parts[STATE_ARRAYS] = {&system.x,  &system.y,  &system.z,  &system.vx, &system.vy,
+                                                    &system.vz, &system.ax, &system.ay, &system.az};
+        for (int k = 0; k < STATE_ARRAYS; k++) {
+            std::copy(state + k * bodyCount, state + (k + 1) * bodyCount, parts[k]->begin());
+        }
+        integrator.assign(state + STATE_ARRAYS * bodyCount, state + STATE_ARRAYS * bodyCount + integratorValues);
+        system.time = entry.time;
+        work = entry.work;
+        return true;
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats result;
+        result.checkpoints = entries.size();
+        for (const Entry& entry : entries) {
+            if (entry.slot != NO_SLOT) result.inMemory++;
+            if (entry.onDisk) result.onDisk++;
+        }
+        result.accepted = accepted;
+        result.thinned = thinned;
+        result.lost = lost;
+        result.dropped = dropped;
+        result.recordBytes = recordBytes;
+        result.slots = slots.size();
+        result.fileRecords = fileRecords;
+        result.capacity = capacity;
+        result.spacing = baseInterval * stride;
+        return result;
+    }
+
+private:
+    static const int STATE_ARRAYS = 9; // Posição, velocidade e aceleração.
+    static const size_t NO_ENTRY = SIZE_MAX, NO_SLOT = SIZE_MAX, NO_RECORD = SIZE_MAX;
+    static const uint64_t NO_SEQUENCE = UINT64_MAX;
+
+    struct Entry {
+        double time;
+        uint64_t work;     // Trabalho desde o início da integração.
+        uint64_t sequence; // Ordem de aceitação; liga a entrada à posição do anel.
+        size_t slot;       // Posição no anel, ou NO_SLOT se já foi reescrita.
+        size_t record;     // Registro do arquivo, ou NO_RECORD se não tem.
+        bool onDisk;       // Se o registro já tem o estado.
+    };
+    struct Slot {
+        // x, y, z, vx, vy, vz, ax, ay e az de todos os corpos, um após o outro, e o estado do
+        // integrador.
+        std::vector<double> state;
+        uint64_t sequence = NO_SEQUENCE; // Checkpoint guardado aqui.
+        size_t record = NO_RECORD;  // Registro do arquivo em que ele vai ser gravado.
+        bool writing = false;       // Na fila da thread de gravação.
+    };
+
+    size_t bodyCount = 0, integratorValues = 0, recordBytes = 0;
+    uint64_t baseInterval = 1, stride = 1; // O espaçamento é baseInterval * stride.
+    std::vector<Slot> slots;
+    size_t nextSlot = 0;
+    std::vector<Entry> entries;       // Em ordem crescente de tempo, de trabalho e de sequência.
+    std::vector<size_t> freeRecords;  // Registros do arquivo de checkpoints que saíram.
+    size_t fileRecords = 0, diskRecords = 0, capacity = 0;
+    std::vector<double> scratch;      // Estado lido do disco.
+    std::FILE* file = nullptr;
+    std::deque<size_t> queue;         // Posições do anel esperando a gravação.
+    size_t accepted = 0, thinned = 0, lost = 0, dropped = 0;
+    bool failed = false, stopping = false;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::thread writer;
+
+    // Posição do anel para o próximo checkpoint: a seguinte, em ordem. Sem arquivo, o anel é o
+    // único lugar dos checkpoints, e a escolhida é a próxima que não guarda nenhum.
+    size_t chooseSlot() const {
+        if (file) return nextSlot;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t k = 0; k < slots.size(); k++) {
+            size_t index = (nextSlot + k) % slots.size();
+            if (entryOf(slots[index].sequence) == NO_ENTRY) return index;
+        }
+        return nextSlot;
+    }
+
+    // Quantidade de entradas até a última disponível (no anel ou no disco) com instante até
+    // 'time'. Chamada com o mutex travado.
+    size_t find(double time) const {
+        size_t index = std::upper_bound(entries.begin(), entries.end(), time,
+                                        [](double value, const Entry& e) { return value < e.time; }) -
+                       entries.begin();
+        while (index > 0 && entries[index - 1].slot == NO_SLOT && !entries[index - 1].onDisk) index--;
+        return index;
+    }
+
+    // Índice da entrada do checkpoint 'sequence', ou NO_ENTRY se ele já saiu. Chamada com o mutex
+    // travado.
+    size_t entryOf(uint64_t sequence) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), sequence,
+                                   [](const Entry& e, uint64_t value) { return e.sequence < value; });
+        return it != entries.end() && it->sequence == sequence ? size_t(it - entries.begin()) : NO_ENTRY;
+    }
+
+    // Devolve o registro do arquivo da entrada 'index', que vai sair. Se ele ainda está sendo
+    // gravado, a thread de gravação o devolve ao terminar. Chamada com o mutex travado.
+    void release(size_t index) {
+        const Entry& entry = entries[index];
+        if (entry.record == NO_RECORD) return;
+        bool writing = entry.slot != NO_SLOT && slots[entry.slot].writing;
+        if (!writing) freeRecords.push_back(entry.record);
+    }
+
+    // Dobra o espaçamento até os checkpoints caberem no limite, deixando só o primeiro de cada
+    // intervalo do espaçamento novo. Chamada com o mutex travado.
+    void thin() {
+        while (entries.size() > capacity) {
+            stride *= 2;
+            uint64_t spacing = baseInterval * stride;
+            size_t kept = 0;
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (kept == 0 || entries[i].work / spacing != entries[kept - 1].work / spacing) {
+                    entries[kept++] = entries[i];
+                    continue;
+                }
+                if (entries[i].slot != NO_SLOT) slots[entries[i].slot].sequence = NO_SEQUENCE;
+                release(i);
+                thinned++;
+            }
+            entries.resize(kept);
+        }
+    }
+
+    // Thread de gravação: copia para o disco as posições da fila, na ordem. Depois de uma falha,
+    // os checkpoints seguintes ficam só no anel. O registro de um checkpoint que saiu durante a
+    // gravação volta para a lista dos livres.
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) return;
+            size_t index = queue.front();
+            queue.pop_front();
+            size_t record = slots[index].record;
+            bool skip = failed;
+            lock.unlock();
+            bool ok = !skip && pwrite(fileno(file), slots[index].state.data(), recordBytes,
+                                      (off_t)(record * recordBytes)) == (ssize_t)recordBytes;
+            lock.lock();
+            size_t entry = entryOf(slots[index].sequence);
+            if (entry != NO_ENTRY) {
+                entries[entry].onDisk = ok;
+            } else {
+                freeRecords.push_back(record);
+            }
+            if (!ok) failed = true;
+            slots[index].writing = false;
+        }
+    }
+};
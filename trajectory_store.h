@@ -0,0 +1,337 @@
+/*
+ * =================================================================================================
+ * ARMAZÉM COLUNAR DE TRAJETÓRIAS
+ *
+ * Arquivo compacto com as posições de vários corpos em instantes igualmente espaçados, gravado
+ * pela exportação em lote (--export) e lido com acesso aleatório. As posições são quantizadas em
+ * múltiplos inteiros de 'quantum' e guardadas por coluna (um corpo e um eixo) em blocos de
+ * 'blockSamples' instantes: em cada coluna vem o primeiro valor e depois as diferenças entre
+ * instantes vizinhos, em zigzag (sinal no bit baixo) e varint (7 bits por byte). Como as
+ * trajetórias são suaves, as diferenças são pequenas e cabem em poucos bytes.
+ *
+ * Layout (little-endian):
+ *   TrajectoryHeader
+ *   TrajectoryBody[bodyCount]
+ *   blocos: cada um começa com uint32 columnOffset[bodyCount * 3 + 1], relativos ao início do
+ *           bloco, seguidos das colunas (x, y e z do corpo 0, depois do corpo 1...)
+ *   uint64 blockOffset[blockCount + 1]: índice dos blocos, a partir do início do arquivo; o
+ *           último é o fim do último bloco
+ *
+ * O bloco de um instante sai de uma divisão e o seu deslocamento do índice, então ir a qualquer
+ * instante custa O(1): no máximo 'blockSamples' varints de cada eixo, independente do tamanho do
+ * arquivo. Os blocos são independentes e podem ser codificados em paralelo.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char TRAJECTORY_MAGIC[8] = {'S', 'S', 'T', 'R', 'A', 'J', 0, 0};
+const uint32_t TRAJECTORY_VERSION = 1;
+const uint32_t TRAJECTORY_BLOCK_SAMPLES = 1024; // Padrão: uma busca decodifica até 3 x 1024 varints.
+const uint32_t TRAJECTORY_MAX_BODIES = 1u << 24;  // Limite na leitura, contra cabeçalhos corrompidos.
+
+struct TrajectoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bodyCount;
+    uint32_t blockSamples;
+    uint32_t reserved;
+    double startDays;     // Primeiro instante, em dias desde J2000.
+    double stepDays;      // Intervalo entre instantes.
+    double quantum;       // Unidade das posições quantizadas (UA).
+    uint64_t sampleCount;
+    uint64_t blockCount;
+    uint64_t indexOffset; // Deslocamento do índice dos blocos.
+};
+
+struct TrajectoryBody {
+    char name[16];
+};
+
+// --- Codificação ---
+
+inline uint64_t zigzagEncode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// Grava um varint em 'p' (até 10 bytes) e avança 'p'.
+inline void writeVarint(uint8_t*& p, uint64_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+}
+
+// Lê um varint a partir de 'p', sem passar de 'end', e avança 'p'. Retorna false se os dados
+// acabarem no meio do varint ou se ele passar de 10 bytes.
+inline bool readVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t byte = *p++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Codifica um bloco de 'samples' instantes de 'bodies' corpos. 'xyz' tem as posições de cada
+// instante em sequência, (x, y, z) de cada corpo: xyz[(s * bodies + b) * 3 + eixo].
+inline void encodeTrajectoryBlock(const double* xyz, size_t samples, uint32_t bodies, double quantum,
+                                  std::vector<uint8_t>& out) {
+    const size_t columns = (size_t)bodies * 3;
+    const size_t tableBytes = (columns + 1) * sizeof(uint32_t);
+    out.resize(tableBytes + columns * samples * 10); // Pior caso; cortado no fim.
+    std::vector<uint32_t> offsets(columns + 1);
+    uint8_t* p = out.data() + tableBytes;
+    double inverse = 1.0 / quantum;
+    for (size_t column = 0; column < columns; column++) {
+        offsets[column] = (uint32_t)(p - out.data());
+        int64_t previous = 0;
+        for (size_t s = 0; s < samples; s++) {
+            // Arredondamento para o mais próximo com a conversão do próprio processador (llround
+            // é uma chamada de biblioteca).
+            double scaled = xyz[s * columns + column] * inverse;
+            int64_t value = (int64_t)(scaled + (scaled < 0.0 ? -0.5 : 0.5));
+            writeVarint(p, zigzagEncode(value - previous));
+            previous = value;
+        }
+    }
+    offsets[columns] = (uint32_t)(p - out.data());
+    out.resize(offsets[columns]);
+    memcpy(out.data(), offsets.data(), tableBytes);
+}
+
+// --- Escrita ---
+
+// Arquivo em gravação: os blocos são acrescentados em ordem e o índice e o cabeçalho completos
+// vão no fim. O arquivo é escrito com outro nome e renomeado em finishTrajectoryStore(), como o
+// pacote de assets, então um arquivo interrompido nunca é lido.
+struct TrajectoryWriter {
+    FILE* file = nullptr;
+    std::string path, temporary;
+    TrajectoryHeader header = {};
+    std::vector<uint64_t> blockOffsets;
+    uint64_t offset = 0;
+    bool ok = true;
+};
+
+// Cria o arquivo para 'samples' instantes a partir de 'startDays', a cada 'stepDays', dos
+// corpos 'names'. Retorna false se não puder criar o arquivo.
+inline bool beginTrajectoryStore(const char* path, const std::vector<std::string>& names, double startDays,
+                                 double stepDays, uint64_t samples, uint32_t blockSamples, double quantum,
+                                 TrajectoryWriter& writer) {
+    writer = TrajectoryWriter();
+    writer.path = path;
+    writer.temporary = writer.path + ".tmp";
+    writer.file = fopen(writer.temporary.c_str(), "wb");
+    if (!writer.file) return false;
+    TrajectoryHeader& header = writer.header;
+    memcpy(header.magic, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC));
+    header.version = TRAJECTORY_VERSION;
+    header.bodyCount = (uint32_t)names.size();
+    header.blockSamples = blockSamples;
+    header.startDays = startDays;
+    header.stepDays = stepDays;
+    header.quantum = quantum;
+    header.sampleCount = samples;
+    header.blockCount = (samples + blockSamples - 1) / blockSamples;
+    std::vector<TrajectoryBody> bodies(names.size());
+    for (size_t i = 0; i < names.size(); i++) snprintf(bodies[i].name, sizeof(bodies[i].name), "%s", names[i].c_str());
+    fwrite(&header, sizeof(header), 1, writer.file); // Reescrito no fim com o deslocamento do índice.
+    fwrite(bodies.data(), sizeof(TrajectoryBody), bodies.size(), writer.file);
+    writer.offset = sizeof(header) + sizeof(TrajectoryBody) * bodies.size();
+    return true;
+}
+
+// Acrescenta o próximo bloco, já codificado por encodeTrajectoryBlock().
+inline bool appendTrajectoryBlock(TrajectoryWriter& writer, const std::vector<uint8_t>& block) {
+    writer.blockOffsets.push_back(writer.offset);
+    writer.ok = writer.ok && fwrite(block.data(), 1, block.size(), writer.file) == block.size();
+    writer.offset += block.size();
+    return writer.ok;
+}
+
+// Grava o índice e o cabeçalho e renomeia o arquivo. Retorna false em caso de erro ou se
+// faltarem blocos.
+inline bool finishTrajectoryStore(TrajectoryWriter& writer) {
+    if (!writer.file) return false;
+    bool ok = writer.ok && writer.blockOffsets.size() == writer.header.blockCount;
+    writer.blockOffsets.push_back(writer.offset);
+    // O índice fica alinhado em 8 bytes, para ser lido direto do mapeamento.
+    const char zeros[sizeof(uint64_t)] = {};
+    size_t padding = (sizeof(uint64_t) - writer.offset % sizeof(uint64_t)) % sizeof(uint64_t);
+    fwrite(zeros, 1, padding, writer.file);
+    writer.header.indexOffset = writer.offset + padding;
+    ok = ok && fwrite(writer.blockOffsets.data(), sizeof(uint64_t), writer.blockOffsets.size(), writer.file) ==
+                   writer.blockOffsets.size();
+    fseek(writer.file, 0, SEEK_SET);
+    fwrite(&writer.header, sizeof(writer.header), 1, writer.file);
+    ok = fclose(writer.file) == 0 && ok;
+    writer.file = nullptr;
+    if (!ok || rename(writer.temporary.c_str(), writer.path.c_str()) != 0) {
+        remove(writer.temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// --- Leitura ---
+
+// Arquivo mapeado em memória.
+struct TrajectoryStore {
+    void* mapping = nullptr;
+    size_t size = 0;
+    const TrajectoryHeader* header = nullptr;
+    const TrajectoryBody* bodies = nullptr;
+    const uint64_t* blockOffsets = nullptr;
+};
+
+inline void closeTrajectoryStore(TrajectoryStore& store) {
+    if (store.mapping) munmap(store.mapping, store.size);
+    store = TrajectoryStore();
+}
+
+// Mapeia o arquivo e confere o cabeçalho e o índice. Retorna false se o arquivo não existir ou
+// estiver corrompido.
+inline bool openTrajectoryStore(const char* path, TrajectoryStore& store) {
+    closeTrajectoryStore(store);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(TrajectoryHeader)) {
+        close(fd);
+        return false;
+    }
+    store.size = info.st_size;
+    store.mapping = mmap(nullptr, store.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (store.mapping == MAP_FAILED) {
+        store = TrajectoryStore();
+        return false;
+    }
+    const char* base = (const char*)store.mapping;
+    const TrajectoryHeader* header = (const TrajectoryHeader*)base;
+    uint64_t bodiesEnd = sizeof(TrajectoryHeader) + sizeof(TrajectoryBody) * (uint64_t)header->bodyCount;
+    const uint64_t columns = header->bodyCount * 3ull;
+    bool valid = memcmp(header->magic, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC)) == 0 &&
+                 header->version == TRAJECTORY_VERSION && header->bodyCount <= TRAJECTORY_MAX_BODIES &&
+                 header->blockSamples > 0 && header->quantum > 0.0 &&
+                 header->blockCount <= store.size / sizeof(uint64_t) &&
+                 header->blockCount == header->sampleCount / header->blockSamples +
+                                           (header->sampleCount % header->blockSamples != 0) &&
+                 bodiesEnd <= header->indexOffset && header->indexOffset <= store.size &&
+                 header->indexOffset % sizeof(uint64_t) == 0 &&
+                 header->indexOffset + (header->blockCount + 1) * sizeof(uint64_t) <= store.size;
+    if (valid) {
+        const uint64_t* offsets = (const uint64_t*)(base + header->indexOffset);
+        const uint64_t tableBytes = (columns + 1) * sizeof(uint32_t);
+        for (uint64_t block = 0; valid && block < header->blockCount; block++) {
+            valid = offsets[block] >= bodiesEnd && offsets[block] + tableBytes <= offsets[block + 1] &&
+                    offsets[block + 1] <= header->indexOffset;
+            // As colunas vêm em ordem, depois da tabela, e a última termina no fim do bloco.
+            uint32_t previous = (uint32_t)tableBytes;
+            for (uint64_t column = 0; valid && column <= columns; column++) {
+                uint32_t offset;
+                memcpy(&offset, base + offsets[block] + column * sizeof(uint32_t), sizeof(offset));
+                valid = offset >= previous && offsets[block] + offset <= offsets[block + 1];
+                previous = offset;
+            }
+            valid = valid && offsets[block] + previous == offsets[block + 1];
+        }
+        store.blockOffsets = offsets;
+    }
+    if (!valid) {
+        closeTrajectoryStore(store);
+        return false;
+    }
+    store.header = header;
+    store.bodies = (const TrajectoryBody*)(base + sizeof(TrajectoryHeader));
+    return true;
+}
+
+// Índice do corpo chamado 'name', ou -1.
+inline int trajectoryBodyIndex(const TrajectoryStore& store, const char* name) {
+    for (uint32_t i = 0; i < store.header->bodyCount; i++) {
+        if (strncmp(store.bodies[i].name, name, sizeof(store.bodies[i].name)) == 0) return (int)i;
+    }
+    return -1;
+}
+
+// Instante mais próximo de 'days'. Retorna false fora do intervalo do arquivo.
+inline bool trajectorySampleAt(const TrajectoryStore& store, double days, uint64_t& sample) {
+    const TrajectoryHeader& header = *store.header;
+    double index = std::nearbyint((days - header.startDays) / header.stepDays);
+    if (!(index >= 0.0) || index >= (double)header.sampleCount) return false;
+    sample = (uint64_t)index;
+    return true;
+}
+
+// Início e fim da coluna de 'body' e 'axis' no bloco 'block'. Os deslocamentos da tabela foram
+// conferidos na abertura; o conteúdo das colunas é conferido na decodificação.
+inline const uint8_t* trajectoryColumn(const TrajectoryStore& store, uint64_t block, uint32_t body, int axis,
+                                       const uint8_t*& end) {
+    const uint8_t* start = (const uint8_t*)store.mapping + store.blockOffsets[block];
+    uint32_t offset[2];
+    memcpy(offset, start + ((size_t)body * 3 + axis) * sizeof(uint32_t), sizeof(offset));
+    end = start + offset[1];
+    return start + offset[0];
+}
+
+// Posição de 'body' no instante 'sample', em O(1): só o bloco do instante é decodificado, até ele.
+// Retorna false se a coluna terminar antes do instante (arquivo corrompido).
+inline bool trajectoryPosition(const TrajectoryStore& store, uint32_t body, uint64_t sample, double position[3]) {
+    const TrajectoryHeader& header = *store.header;
+    uint64_t block = sample / header.blockSamples;
+    uint64_t count = sample % header.blockSamples + 1;
+    for (int axis = 0; axis < 3; axis++) {
+        const uint8_t* end;
+        const uint8_t* p = trajectoryColumn(store, block, body, axis, end);
+        int64_t value = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t delta;
+            if (!readVarint(p, end, delta)) return false;
+            value += zigzagDecode(delta);
+        }
+        position[axis] = value * header.quantum;
+    }
+    return true;
+}
+
+// Decodifica todos os instantes do bloco 'block' de 'body' em x, y e z; retorna quantos são, ou 0
+// se alguma coluna terminar antes (arquivo corrompido).
+inline size_t trajectoryBlockPositions(const TrajectoryStore& store, uint32_t body, uint64_t block, double* x,
+                                       double* y, double* z) {
+    const TrajectoryHeader& header = *store.header;
+    size_t count = (size_t)std::min<uint64_t>(header.blockSamples, header.sampleCount - block * header.blockSamples);
+    double* out[3] = {x, y, z};
+    for (int axis = 0; axis < 3; axis++) {
+        const uint8_t* end;
+        const uint8_t* p = trajectoryColumn(store, block, body, axis, end);
+        int64_t value = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint64_t delta;
+            if (!readVarint(p, end, delta)) return 0;
+            value += zigzagDecode(delta);
+            out[axis][i] = value * header.quantum;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,50 @@
+/*
+ * =================================================================================================
+ * TRIPLE BUFFER SEM TRAVAS
+ *
+ * Passa valores de uma thread escritora para uma thread leitora sem mutex: cada lado fica com um
+ * dos três buffers e o terceiro é trocado atomicamente entre eles. O escritor nunca espera o
+ * leitor (um valor publicado e ainda não lido é simplesmente substituído) e o leitor sempre vê o
+ * valor completo mais recente.
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+public:
+    // Buffer em que o escritor monta o próximo valor. Só a thread escritora pode usá-lo.
+    T& writeBuffer() { return buffers[backIndex]; }
+
+    // Publica o valor montado em writeBuffer(). O escritor passa a montar no buffer que estava
+    // no meio, que pode conter um valor antigo.
+    void publish() {
+        int previous = middle.exchange(backIndex | FRESH_BIT, std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+    }
+
+    // Traz para readBuffer() o valor publicado mais recente. Retorna false se nada novo foi
+    // publicado desde a última chamada. Só a thread leitora pode chamá-la.
+    bool update() {
+        // Só o leitor limpa FRESH_BIT, então o valor visto aqui não pode deixar de ser novo.
+        if (!(middle.load(std::memory_order_relaxed) & FRESH_BIT)) return false;
+        int previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    // Último valor trazido por update(). Só a thread leitora pode usá-lo.
+    const T& readBuffer() const { return buffers[frontIndex]; }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH_BIT = 4; // O buffer do meio tem um valor que o leitor ainda não viu.
+
+    T buffers[3];
+    std::atomic<int> middle{1};
+    int backIndex = 0;  // Usado só pelo escritor.
+    int frontIndex = 2; // Usado só pelo leitor.
+};
@@ -0,0 +1,1278 @@
+/*
+ * =================================================================================================
+ * TABELAS EMBUTIDAS DA VSOP87D
+ *
+ * Os termos da VSOP87D (esférica, eclíptica e equinócio da data) publicados por Meeus
+ * (Astronomical Algorithms, 2a ed., apêndice III), para que --analytic funcione sem os arquivos
+ * oficiais: cerca de 2400 termos nos oito planetas. Comparada às funções epv00 e plan94 da IAU
+ * (SOFA/ERFA) de 1800 a 2050, a Terra fica a menos de 1" em longitude; nos outros planetas a
+ * diferença não passa do próprio erro da plan94 (de 4" em Mercúrio a 1,5' em Urano). Os arquivos
+ * da pasta de --vsop87, quando existem, têm precedência e vão além dessa precisão.
+ *
+ * Cada termo é A cos(B + C t), com t em milênios julianos desde J2000 e A em 10^-8 radiano (L e
+ * B) ou 10^-8 UA (R), multiplicado por t^power; coordinate é 0 (L), 1 (B) ou 2 (R).
+ * =================================================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+struct Vsop87TableTerm {
+    signed char coordinate, power;
+    double a, b, c;
+};
+
+struct Vsop87Table {
+    const Vsop87TableTerm* terms;
+    size_t count;
+};
+
+// Mercúrio: 155 termos.
+const Vsop87TableTerm VSOP87D_MERCURY[155] = {
+    {0, 0, 440250710, 0, 0},                      {0, 0, 40989415, 1.48302034, 26087.90314157},
+    {0, 0, 5046294, 4.4778549, 52175.8062831},    {0, 0, 855347, 1.165203, 78263.709425},
+    {0, 0, 165590, 4.119692, 104351.612566},      {0, 0, 34562, 0.77931, 130439.51571},
+    {0, 0, 7583, 3.7135, 156527.4188},            {0, 0, 3560, 1.5120, 1109.3786},
+    {0, 0, 1803, 4.1033, 5661.3320},              {0, 0, 1726, 0.3583, 182615.3220},
+    {0, 0, 1590, 2.9951, 25028.5212},             {0, 0, 1365, 4.5992, 27197.2817},
+    {0, 0, 1017, 0.8803, 31749.2352},             {0, 0, 714, 1.541, 24978.525},
+    {0, 0, 644, 5.303, 21535.950},                {0, 0, 451, 6.050, 51116.424},
+    {0, 0, 404, 3.282, 208703.225},               {0, 0, 352, 5.242, 20426.571},
+    {0, 0, 345, 2.792, 15874.618},                {0, 0, 343, 5.765, 955.600},
+    {0, 0, 339, 5.863, 25558.212},                {0, 0, 325, 1.337, 53285.185},
+    {0, 0, 273, 2.495, 529.691},                  {0, 0, 264, 3.917, 57837.138},
+    {0, 0, 260, 0.987, 4551.953},                 {0, 0, 239, 0.113, 1059.382},
+    {0, 0, 235, 0.267, 11322.664},                {0, 0, 217, 0.660, 13521.751},
+    {0, 0, 209, 2.092, 47623.853},                {0, 0, 183, 2.629, 27043.503},
+    {0, 0, 182, 2.434, 25661.305},                {0, 0, 176, 4.536, 51066.428},
+    {0, 0, 173, 2.452, 24498.830},                {0, 0, 142, 3.360, 37410.567},
+    {0, 0, 138, 0.291, 10213.286},                {0, 0, 125, 3.721, 39609.655},
+    {0, 0, 118, 2.781, 77204.327},                {0, 0, 106, 4.206, 19804.827},
+    {0, 1, 2608814706223, 0, 0},                  {0, 1, 1126008, 6.2170397, 26087.9031416},
+    {0, 1, 303471, 3.055655, 52175.806283},       {0, 1, 80538, 6.10455, 78263.70942},
+    {0, 1, 21245, 2.83532, 104351.61257},         {0, 1, 5592, 5.8268, 130439.5157},
+    {0, 1, 1472, 2.5185, 156527.4188},            {0, 1, 388, 5.480, 182615.322},
+    {0, 1, 352, 3.052, 1109.379},                 {0, 1, 103, 2.149, 208703.225},
+    {0, 1, 94, 6.12, 27197.28},                   {0, 1, 91, 0.00, 24978.52},
+    {0, 1, 52, 5.62, 5661.33},                    {0, 1, 44, 4.57, 25028.52},
+    {0, 1, 28, 3.04, 51066.43},                   {0, 1, 27, 5.09, 234791.13},
+    {0, 2, 53050, 0, 0},                          {0, 2, 16904, 4.69072, 26087.90314},
+    {0, 2, 7397, 1.3474, 52175.8063},             {0, 2, 3018, 4.4564, 78263.7094},
+    {0, 2, 1107, 1.2623, 104351.6126},            {0, 2, 378, 4.320, 130439.516},
+    {0, 2, 123, 1.069, 156527.419},               {0, 2, 39, 4.08, 182615.32},
+    {0, 2, 15, 4.63, 1109.38},                    {0, 2, 12, 0.79, 208703.23},
+    {0, 3, 188, 0.035, 52175.806},                {0, 3, 142, 3.125, 26087.903},
+    {0, 3, 97, 3.00, 78263.71},                   {0, 3, 44, 6.02, 104351.61},
+    {0, 3, 35, 0, 0},                             {0, 3, 18, 2.78, 130439.52},
+    {0, 3, 7, 5.82, 156527.42},                   {0, 3, 3, 2.57, 182615.32},
+    {0, 4, 114, 3.1416, 0},                       {0, 4, 2, 2.03, 26087.90},
+    {0, 4, 2, 1.42, 78263.71},                    {0, 4, 2, 4.50, 52175.81},
+    {0, 4, 1, 4.50, 104351.61},                   {0, 4, 1, 1.27, 130439.52},
+    {0, 5, 1, 3.14, 0},                           {1, 0, 11737529, 1.98357499, 26087.90314157},
+    {1, 0, 2388077, 5.0373896, 52175.8062831},    {1, 0, 1222840, 3.1415927, 0},
+    {1, 0, 543252, 1.796444, 78263.709425},       {1, 0, 129779, 4.832325, 104351.612566},
+    {1, 0, 31867, 1.58088, 130439.51571},         {1, 0, 7963, 4.6097, 156527.4188},
+    {1, 0, 2014, 1.3532, 182615.3220},            {1, 0, 514, 4.378, 208703.225},
+    {1, 0, 209, 2.020, 24978.525},                {1, 0, 208, 4.918, 27197.282},
+    {1, 0, 132, 1.119, 234791.128},               {1, 0, 121, 1.813, 53285.185},
+    {1, 0, 100, 5.657, 20426.571},                {1, 1, 429151, 3.501698, 26087.903142},
+    {1, 1, 146234, 3.141593, 0},                  {1, 1, 22675, 0.01515, 52175.80628},
+    {1, 1, 10895, 0.48540, 78263.70942},          {1, 1, 6353, 3.4294, 104351.6126},
+    {1, 1, 2496, 0.1605, 130439.5157},            {1, 1, 860, 3.185, 156527.419},
+    {1, 1, 278, 6.210, 182615.322},               {1, 1, 86, 2.95, 208703.23},
+    {1, 1, 28, 0.29, 27197.28},                   {1, 1, 26, 5.98, 234791.13},
+    {1, 2, 11831, 4.79066, 26087.90314},          {1, 2, 1914, 0, 0},
+    {1, 2, 1045, 1.2122, 52175.8063},             {1, 2, 266, 4.434, 78263.709},
+    {1, 2, 170, 1.623, 104351.613},               {1, 2, 96, 4.80, 130439.52},
+    {1, 2, 45, 1.61, 156527.42},                  {1, 2, 18, 4.67, 182615.32},
+    {1, 2, 7, 1.43, 208703.23},                   {1, 3, 235, 0.354, 26087.903},
+    {1, 3, 161, 0, 0},                            {1, 3, 19, 4.36, 52175.81},
+    {1, 3, 6, 2.51, 78263.71},                    {1, 3, 5, 6.14, 104351.61},
+    {1, 3, 3, 3.14, 156527.42},                   {1, 3, 2, 6.27, 130439.52},
+    {1, 4, 4, 1.75, 26087.90},                    {1, 4, 1, 3.14, 0},
+    {2, 0, 39528272, 0, 0},                       {2, 0, 7834132, 6.1923372, 26087.9031416},
+    {2, 0, 795526, 2.959897, 52175.806283},       {2, 0, 121282, 6.010642, 78263.709425},
+    {2, 0, 21922, 2.77820, 104351.61257},         {2, 0, 4354, 5.8289, 130439.5157},
+    {2, 0, 918, 2.597, 156527.419},               {2, 0, 290, 1.424, 25028.521},
+    {2, 0, 260, 3.028, 27197.282},                {2, 0, 202, 5.647, 182615.322},
+    {2, 0, 201, 5.592, 31749.235},                {2, 0, 142, 6.253, 24978.525},
+    {2, 0, 100, 3.734, 21535.950},                {2, 1, 217348, 4.656172, 26087.903142},
+    {2, 1, 44142, 1.42386, 52175.80628},          {2, 1, 10094, 4.47466, 78263.70942},
+    {2, 1, 2433, 1.2423, 104351.6126},            {2, 1, 1624, 0, 0},
+    {2, 1, 604, 4.293, 130439.516},               {2, 1, 153, 1.061, 156527.419},
+    {2, 1, 39, 4.11, 182615.32},                  {2, 2, 3118, 3.0823, 26087.9031},
+    {2, 2, 1245, 6.1518, 52175.8063},             {2, 2, 425, 2.926, 78263.709},
+    {2, 2, 136, 5.980, 104351.613},               {2, 2, 42, 2.75, 130439.52},
+    {2, 2, 22, 3.14, 0},                          {2, 2, 13, 5.80, 156527.42},
+    {2, 3, 33, 1.68, 26087.90},                   {2, 3, 24, 4.63, 52175.81},
+    {2, 3, 12, 1.39, 78263.71},                   {2, 3, 5, 4.44, 104351.61},
+    {2, 3, 2, 1.21, 130439.52},
+};
+
+// Vênus: 93 termos.
+const Vsop87TableTerm VSOP87D_VENUS[93] = {
+    {0, 0, 317614667, 0, 0},                   {0, 0, 1353968, 5.5931332, 10213.2855462},
+    {0, 0, 89892, 5.30650, 20426.57109},       {0, 0, 5477, 4.4163, 7860.4194},
+    {0, 0, 3456, 2.6996, 11790.6291},          {0, 0, 2372, 2.9938, 3930.2097},
+    {0, 0, 1664, 4.2502, 1577.3435},           {0, 0, 1438, 4.1575, 9683.5946},
+    {0, 0, 1317, 5.1867, 26.2983},             {0, 0, 1201, 6.1536, 30639.8566},
+    {0, 0, 769, 0.816, 9437.763},              {0, 0, 761, 1.950, 529.691},
+    {0, 0, 708, 1.065, 775.523},               {0, 0, 585, 3.998, 191.448},
+    {0, 0, 500, 4.123, 15720.839},             {0, 0, 429, 3.586, 19367.189},
+    {0, 0, 327, 5.677, 5507.553},              {0, 0, 326, 4.591, 10404.734},
+    {0, 0, 232, 3.163, 9153.904},              {0, 0, 180, 4.653, 1109.379},
+    {0, 0, 155, 5.570, 13521.751},             {0, 0, 128, 4.226, 20.775},
+    {0, 0, 128, 0.962, 5661.332},              {0, 0, 106, 1.537, 801.821},
+    {0, 1, 1021352943053, 0, 0},               {0, 1, 95708, 2.46424, 10213.28555},
+    {0, 1, 14445, 0.51625, 20426.57109},       {0, 1, 213, 1.795, 30639.857},
+    {0, 1, 174, 2.655, 26.298},                {0, 1, 152, 6.106, 1577.344},
+    {0, 1, 82, 5.70, 191.45},                  {0, 1, 70, 2.68, 9437.76},
+    {0, 1, 52, 3.60, 775.52},                  {0, 1, 38, 1.03, 529.69},
+    {0, 1, 30, 1.25, 5507.55},                 {0, 1, 25, 6.11, 10404.73},
+    {0, 2, 54127, 0, 0},                       {0, 2, 3891, 0.3451, 10213.2855},
+    {0, 2, 1338, 2.0201, 20426.5711},          {0, 2, 24, 2.05, 26.30},
+    {0, 2, 19, 3.54, 30639.86},                {0, 2, 10, 3.97, 775.52},
+    {0, 2, 7, 1.52, 1577.34},                  {0, 2, 6, 1.00, 191.45},
+    {0, 3, 136, 4.804, 10213.286},             {0, 3, 78, 3.67, 20426.57},
+    {0, 3, 26, 0, 0},                          {0, 4, 114, 3.1416, 0},
+    {0, 4, 3, 5.21, 20426.57},                 {0, 4, 2, 2.51, 10213.29},
+    {0, 5, 1, 3.14, 0},                        {1, 0, 5923638, 0.2670278, 10213.2855462},
+    {1, 0, 40108, 1.14737, 20426.57109},       {1, 0, 32815, 3.14159, 0},
+    {1, 0, 1011, 1.0895, 30639.8566},          {1, 0, 149, 6.254, 18073.705},
+    {1, 0, 138, 0.860, 1577.344},              {1, 0, 130, 3.672, 9437.763},
+    {1, 0, 120, 3.705, 2352.866},              {1, 0, 108, 4.539, 22003.915},
+    {1, 1, 513348, 1.803643, 10213.285546},    {1, 1, 4380, 3.3862, 20426.5711},
+    {1, 1, 199, 0, 0},                         {1, 1, 197, 2.530, 30639.857},
+    {1, 2, 22378, 3.38509, 10213.28555},       {1, 2, 282, 0, 0},
+    {1, 2, 173, 5.256, 20426.571},             {1, 2, 27, 3.87, 30639.86},
+    {1, 3, 647, 4.992, 10213.286},             {1, 3, 20, 3.14, 0},
+    {1, 3, 6, 0.77, 20426.57},                 {1, 3, 3, 5.44, 30639.86},
+    {1, 4, 14, 0.32, 10213.29},                {2, 0, 72334821, 0, 0},
+    {2, 0, 489824, 4.021518, 10213.285546},    {2, 0, 1658, 4.9021, 20426.5711},
+    {2, 0, 1632, 2.8455, 7860.4194},           {2, 0, 1378, 1.1285, 11790.6291},
+    {2, 0, 498, 2.587, 9683.595},              {2, 0, 374, 1.423, 3930.210},
+    {2, 0, 264, 5.529, 9437.763},              {2, 0, 237, 2.551, 15720.839},
+    {2, 0, 222, 2.013, 19367.189},             {2, 0, 126, 2.728, 1577.344},
+    {2, 0, 119, 3.020, 10404.734},             {2, 1, 34551, 0.89199, 10213.28555},
+    {2, 1, 234, 1.772, 20426.571},             {2, 1, 234, 3.142, 0},
+    {2, 2, 1407, 5.0637, 10213.2855},          {2, 2, 16, 5.47, 20426.57},
+    {2, 2, 13, 0, 0},                          {2, 3, 50, 3.22, 10213.29},
+    {2, 4, 1, 0.92, 10213.29},
+};
+
+// Terra: 195 termos.
+const Vsop87TableTerm VSOP87D_EARTH[195] = {
+    {0, 0, 175347046, 0, 0},                  {0, 0, 3341656, 4.6692568, 6283.0758500},
+    {0, 0, 34894, 4.62610, 12566.15170},      {0, 0, 3497, 2.7441, 5753.3849},
+    {0, 0, 3418, 2.8289, 3.5231},             {0, 0, 3136, 3.6277, 77713.7715},
+    {0, 0, 2676, 4.4181, 7860.4194},          {0, 0, 2343, 6.1352, 3930.2097},
+    {0, 0, 1324, 0.7425, 11506.7698},         {0, 0, 1273, 2.0371, 529.6910},
+    {0, 0, 1199, 1.1096, 1577.3435},          {0, 0, 990, 5.233, 5884.927},
+    {0, 0, 902, 2.045, 26.298},               {0, 0, 857, 3.508, 398.149},
+    {0, 0, 780, 1.179, 5223.694},             {0, 0, 753, 2.533, 5507.553},
+    {0, 0, 505, 4.583, 18849.228},            {0, 0, 492, 4.205, 775.523},
+    {0, 0, 357, 2.920, 0.067},                {0, 0, 317, 5.849, 11790.629},
+    {0, 0, 284, 1.899, 796.298},              {0, 0, 271, 0.315, 10977.079},
+    {0, 0, 243, 0.345, 5486.778},             {0, 0, 206, 4.806, 2544.314},
+    {0, 0, 205, 1.869, 5573.143},             {0, 0, 202, 2.458, 6069.777},
+    {0, 0, 156, 0.833, 213.299},              {0, 0, 132, 3.411, 2942.463},
+    {0, 0, 126, 1.083, 20.775},               {0, 0, 115, 0.645, 0.980},
+    {0, 0, 103, 0.636, 4694.003},             {0, 0, 102, 0.976, 15720.839},
+    {0, 0, 102, 4.267, 7.114},                {0, 0, 99, 6.21, 2146.17},
+    {0, 0, 98, 0.68, 155.42},                 {0, 0, 86, 5.98, 161000.69},
+    {0, 0, 85, 1.30, 6275.96},                {0, 0, 85, 3.67, 71430.70},
+    {0, 0, 80, 1.81, 17260.15},               {0, 0, 79, 3.04, 12036.46},
+    {0, 0, 75, 1.76, 5088.63},                {0, 0, 74, 3.50, 3154.69},
+    {0, 0, 74, 4.68, 801.82},                 {0, 0, 70, 0.83, 9437.76},
+    {0, 0, 62, 3.98, 8827.39},                {0, 0, 61, 1.82, 7084.90},
+    {0, 0, 57, 2.78, 6286.60},                {0, 0, 56, 4.39, 14143.50},
+    {0, 0, 56, 3.47, 6279.55},                {0, 0, 52, 0.19, 12139.55},
+    {0, 0, 52, 1.33, 1748.02},                {0, 0, 51, 0.28, 5856.48},
+    {0, 0, 49, 0.49, 1194.45},                {0, 0, 41, 5.37, 8429.24},
+    {0, 0, 41, 2.40, 19651.05},               {0, 0, 39, 6.17, 10447.39},
+    {0, 0, 37, 6.04, 10213.29},               {0, 0, 37, 2.57, 1059.38},
+    {0, 0, 36, 1.71, 2352.87},                {0, 0, 36, 1.78, 6812.77},
+    {0, 0, 33, 0.59, 17789.85},               {0, 0, 30, 0.44, 83996.85},
+    {0, 0, 30, 2.74, 1349.87},                {0, 0, 25, 3.16, 4690.48},
+    {0, 1, 628331966747, 0, 0},               {0, 1, 206059, 2.678235, 6283.075850},
+    {0, 1, 4303, 2.6351, 12566.1517},         {0, 1, 425, 1.590, 3.523},
+    {0, 1, 119, 5.796, 26.298},               {0, 1, 109, 2.966, 1577.344},
+    {0, 1, 93, 2.59, 18849.23},               {0, 1, 72, 1.14, 529.69},
+    {0, 1, 68, 1.87, 398.15},                 {0, 1, 67, 4.41, 5507.55},
+    {0, 1, 59, 2.89, 5223.69},                {0, 1, 56, 2.17, 155.42},
+    {0, 1, 45, 0.40, 796.30},                 {0, 1, 36, 0.47, 775.52},
+    {0, 1, 29, 2.65, 7.11},                   {0, 1, 21, 5.34, 0.98},
+    {0, 1, 19, 1.85, 5486.78},                {0, 1, 19, 4.97, 213.30},
+    {0, 1, 17, 2.99, 6275.96},                {0, 1, 16, 0.03, 2544.31},
+    {0, 1, 16, 1.43, 2146.17},                {0, 1, 15, 1.21, 10977.08},
+    {0, 1, 12, 2.83, 1748.02},                {0, 1, 12, 3.26, 5088.63},
+    {0, 1, 12, 5.27, 1194.45},                {0, 1, 12, 2.08, 4694.00},
+    {0, 1, 11, 0.77, 553.57},                 {0, 1, 10, 1.30, 6286.60},
+    {0, 1, 10, 4.24, 1349.87},                {0, 1, 9, 2.70, 242.73},
+    {0, 1, 9, 5.64, 951.72},                  {0, 1, 8, 5.30, 2352.87},
+    {0, 1, 6, 2.65, 9437.76},                 {0, 1, 6, 4.67, 4690.48},
+    {0, 2, 52919, 0, 0},                      {0, 2, 8720, 1.0721, 6283.0758},
+    {0, 2, 309, 0.867, 12566.152},            {0, 2, 27, 0.05, 3.52},
+    {0, 2, 16, 5.19, 26.30},                  {0, 2, 16, 3.68, 155.42},
+    {0, 2, 10, 0.76, 18849.23},               {0, 2, 9, 2.06, 77713.77},
+    {0, 2, 7, 0.83, 775.52},                  {0, 2, 5, 4.66, 1577.34},
+    {0, 2, 4, 1.03, 7.11},                    {0, 2, 4, 3.44, 5573.14},
+    {0, 2, 3, 5.14, 796.30},                  {0, 2, 3, 6.05, 5507.55},
+    {0, 2, 3, 1.19, 242.73},                  {0, 2, 3, 6.12, 529.69},
+    {0, 2, 3, 0.31, 398.15},                  {0, 2, 3, 2.28, 553.57},
+    {0, 2, 2, 4.38, 5223.69},                 {0, 2, 2, 3.75, 0.98},
+    {0, 3, 289, 5.844, 6283.076},             {0, 3, 35, 0, 0},
+    {0, 3, 17, 5.49, 12566.15},               {0, 3, 3, 5.20, 155.42},
+    {0, 3, 1, 4.72, 3.52},                    {0, 3, 1, 5.30, 18849.23},
+    {0, 3, 1, 5.97, 242.73},                  {0, 4, 114, 3.142, 0},
+    {0, 4, 8, 4.13, 6283.08},                 {0, 4, 1, 3.84, 12566.15},
+    {0, 5, 1, 3.14, 0},                       {1, 0, 280, 3.199, 84334.662},
+    {1, 0, 102, 5.422, 5507.553},             {1, 0, 80, 3.88, 5223.69},
+    {1, 0, 44, 3.70, 2352.87},                {1, 0, 32, 4.00, 1577.34},
+    {1, 1, 9, 3.90, 5507.55},                 {1, 1, 6, 1.73, 5223.69},
+    {2, 0, 100013989, 0, 0},                  {2, 0, 1670700, 3.0984635, 6283.0758500},
+    {2, 0, 13956, 3.05525, 12566.15170},      {2, 0, 3084, 5.1985, 77713.7715},
+    {2, 0, 1628, 1.1739, 5753.3849},          {2, 0, 1576, 2.8469, 7860.4194},
+    {2, 0, 925, 5.453, 11506.770},            {2, 0, 542, 4.564, 3930.210},
+    {2, 0, 472, 3.661, 5884.927},             {2, 0, 346, 0.964, 5507.553},
+    {2, 0, 329, 5.900, 5223.694},             {2, 0, 307, 0.299, 5573.143},
+    {2, 0, 243, 4.273, 11790.629},            {2, 0, 212, 5.847, 1577.344},
+    {2, 0, 186, 5.022, 10977.079},            {2, 0, 175, 3.012, 18849.228},
+    {2, 0, 110, 5.055, 5486.778},             {2, 0, 98, 0.89, 6069.78},
+    {2, 0, 86, 5.69, 15720.84},               {2, 0, 86, 1.27, 161000.69},
+    {2, 0, 65, 0.27, 17260.15},               {2, 0, 63, 0.92, 529.69},
+    {2, 0, 57, 2.01, 83996.85},               {2, 0, 56, 5.24, 71430.70},
+    {2, 0, 49, 3.25, 2544.31},                {2, 0, 47, 2.58, 775.52},
+    {2, 0, 45, 5.54, 9437.76},                {2, 0, 43, 6.01, 6275.96},
+    {2, 0, 39, 5.36, 4694.00},                {2, 0, 38, 2.39, 8827.39},
+    {2, 0, 37, 0.83, 19651.05},               {2, 0, 37, 4.90, 12139.55},
+    {2, 0, 36, 1.67, 12036.46},               {2, 0, 35, 1.84, 2942.46},
+    {2, 0, 33, 0.24, 7084.90},                {2, 0, 32, 0.18, 5088.63},
+    {2, 0, 32, 1.78, 398.15},                 {2, 0, 28, 1.21, 6286.60},
+    {2, 0, 28, 1.90, 6279.55},                {2, 0, 26, 4.59, 10447.39},
+    {2, 1, 103019, 1.107490, 6283.075850},    {2, 1, 1721, 1.0644, 12566.1517},
+    {2, 1, 702, 3.142, 0},                    {2, 1, 32, 1.02, 18849.23},
+    {2, 1, 31, 2.84, 5507.55},                {2, 1, 25, 1.32, 5223.69},
+    {2, 1, 18, 1.42, 1577.34},                {2, 1, 10, 5.91, 10977.08},
+    {2, 1, 9, 1.42, 6275.96},                 {2, 1, 9, 0.27, 5486.78},
+    {2, 2, 4359, 5.7846, 6283.0758},          {2, 2, 124, 5.579, 12566.152},
+    {2, 2, 12, 3.14, 0},                      {2, 2, 9, 3.63, 77713.77},
+    {2, 2, 6, 1.87, 5573.14},                 {2, 2, 3, 5.47, 18849.23},
+    {2, 3, 145, 4.273, 6283.076},             {2, 3, 7, 3.92, 12566.15},
+    {2, 4, 4, 2.56, 6283.08},
+};
+
+// Marte: 300 termos.
+const Vsop87TableTerm VSOP87D_MARS[300] = {
+    {0, 0, 620347712, 0, 0},                     {0, 0, 18656368, 5.05037100, 3340.61242670},
+    {0, 0, 1108217, 5.4009984, 6681.2248534},    {0, 0, 91798, 5.75479, 10021.83728},
+    {0, 0, 27745, 5.97050, 3.52312},             {0, 0, 12316, 0.84956, 2810.92146},
+    {0, 0, 10610, 2.93959, 2281.23050},          {0, 0, 8927, 4.1570, 0.0173},
+    {0, 0, 8716, 6.1101, 13362.4497},            {0, 0, 7775, 3.3397, 5621.8429},
+    {0, 0, 6798, 0.3646, 398.1490},              {0, 0, 4161, 0.2281, 2942.4634},
+    {0, 0, 3575, 1.6619, 2544.3144},             {0, 0, 3075, 0.8570, 191.4483},
+    {0, 0, 2938, 6.0789, 0.0673},                {0, 0, 2628, 0.6481, 3337.0893},
+    {0, 0, 2580, 0.0300, 3344.1355},             {0, 0, 2389, 5.0390, 796.2980},
+    {0, 0, 1799, 0.6563, 529.6910},              {0, 0, 1546, 2.9158, 1751.5395},
+    {0, 0, 1528, 1.1498, 6151.5339},             {0, 0, 1286, 3.0680, 2146.1654},
+    {0, 0, 1264, 3.6228, 5092.1520},             {0, 0, 1025, 3.6933, 8962.4553},
+    {0, 0, 892, 0.183, 16703.062},               {0, 0, 859, 2.401, 2914.014},
+    {0, 0, 833, 4.495, 3340.630},                {0, 0, 833, 2.464, 3340.595},
+    {0, 0, 749, 3.822, 155.420},                 {0, 0, 724, 0.675, 3738.761},
+    {0, 0, 713, 3.663, 1059.382},                {0, 0, 655, 0.489, 3127.313},
+    {0, 0, 636, 2.922, 8432.764},                {0, 0, 553, 4.475, 1748.016},
+    {0, 0, 550, 3.810, 0.980},                   {0, 0, 472, 3.625, 1194.447},
+    {0, 0, 426, 0.554, 6283.076},                {0, 0, 415, 0.497, 213.299},
+    {0, 0, 312, 0.999, 6677.702},                {0, 0, 307, 0.381, 6684.748},
+    {0, 0, 302, 4.486, 3532.061},                {0, 0, 299, 2.783, 6254.627},
+    {0, 0, 293, 4.221, 20.775},                  {0, 0, 284, 5.769, 3149.164},
+    {0, 0, 281, 5.882, 1349.867},                {0, 0, 274, 0.542, 3340.545},
+    {0, 0, 274, 0.134, 3340.680},                {0, 0, 239, 5.372, 4136.910},
+    {0, 0, 236, 5.755, 3333.499},                {0, 0, 231, 1.282, 3870.303},
+    {0, 0, 221, 3.505, 382.897},                 {0, 0, 204, 2.821, 1221.849},
+    {0, 0, 193, 3.357, 3.590},                   {0, 0, 189, 1.491, 9492.146},
+    {0, 0, 179, 1.006, 951.718},                 {0, 0, 174, 2.414, 553.569},
+    {0, 0, 172, 0.439, 5486.778},                {0, 0, 160, 3.949, 4562.461},
+    {0, 0, 144, 1.419, 135.065},                 {0, 0, 140, 3.326, 2700.715},
+    {0, 0, 138, 4.301, 7.114},                   {0, 0, 131, 4.045, 12303.068},
+    {0, 0, 128, 2.208, 1592.596},                {0, 0, 128, 1.807, 5088.629},
+    {0, 0, 117, 3.128, 7903.073},                {0, 0, 113, 3.701, 1589.073},
+    {0, 0, 110, 1.052, 242.729},                 {0, 0, 105, 0.785, 8827.390},
+    {0, 0, 100, 3.243, 11773.377},               {0, 1, 334085627474, 0, 0},
+    {0, 1, 1458227, 3.6042605, 3340.6124267},    {0, 1, 164901, 3.926313, 6681.224853},
+    {0, 1, 19963, 4.26594, 10021.83728},         {0, 1, 3452, 4.7321, 3.5231},
+    {0, 1, 2485, 4.6128, 13362.4497},            {0, 1, 842, 4.459, 2281.230},
+    {0, 1, 538, 5.016, 398.149},                 {0, 1, 521, 4.994, 3344.136},
+    {0, 1, 433, 2.561, 191.448},                 {0, 1, 430, 5.316, 155.420},
+    {0, 1, 382, 3.539, 796.298},                 {0, 1, 314, 4.963, 16703.062},
+    {0, 1, 283, 3.160, 2544.314},                {0, 1, 206, 4.569, 2146.165},
+    {0, 1, 169, 1.329, 3337.089},                {0, 1, 158, 4.185, 1751.540},
+    {0, 1, 134, 2.233, 0.980},                   {0, 1, 134, 5.974, 1748.016},
+    {0, 1, 118, 6.024, 6151.534},                {0, 1, 117, 2.213, 1059.382},
+    {0, 1, 114, 2.129, 1194.447},                {0, 1, 114, 5.428, 3738.761},
+    {0, 1, 91, 1.10, 1349.87},                   {0, 1, 85, 3.91, 553.57},
+    {0, 1, 83, 5.30, 6684.75},                   {0, 1, 81, 4.43, 529.69},
+    {0, 1, 80, 2.25, 8962.46},                   {0, 1, 73, 2.50, 951.72},
+    {0, 1, 73, 5.84, 242.73},                    {0, 1, 71, 3.86, 2914.01},
+    {0, 1, 68, 5.02, 382.90},                    {0, 1, 65, 1.02, 3340.60},
+    {0, 1, 65, 3.05, 3340.63},                   {0, 1, 62, 4.15, 3149.16},
+    {0, 1, 57, 3.89, 4136.91},                   {0, 1, 48, 4.87, 213.30},
+    {0, 1, 48, 1.18, 3333.50},                   {0, 1, 47, 1.31, 3185.19},
+    {0, 1, 41, 0.71, 1592.60},                   {0, 1, 40, 2.73, 7.11},
+    {0, 1, 40, 5.32, 20043.67},                  {0, 1, 33, 5.41, 6283.08},
+    {0, 1, 28, 0.05, 9492.15},                   {0, 1, 27, 3.89, 1221.85},
+    {0, 1, 27, 5.11, 2700.72},                   {0, 2, 58016, 2.04979, 3340.61243},
+    {0, 2, 54188, 0, 0},                         {0, 2, 13908, 2.45742, 6681.22485},
+    {0, 2, 2465, 2.8000, 10021.8373},            {0, 2, 398, 3.141, 13362.450},
+    {0, 2, 222, 3.194, 3.523},                   {0, 2, 121, 0.543, 155.420},
+    {0, 2, 62, 3.49, 16703.06},                  {0, 2, 54, 3.54, 3344.14},
+    {0, 2, 34, 6.00, 2281.23},                   {0, 2, 32, 4.14, 191.45},
+    {0, 2, 30, 2.00, 796.30},                    {0, 2, 23, 4.33, 242.73},
+    {0, 2, 22, 3.45, 398.15},                    {0, 2, 20, 5.42, 553.57},
+    {0, 2, 16, 0.66, 0.98},                      {0, 2, 16, 6.11, 2146.17},
+    {0, 2, 16, 1.22, 1748.02},                   {0, 2, 15, 6.10, 3185.19},
+    {0, 2, 14, 4.02, 951.72},                    {0, 2, 14, 2.62, 1349.87},
+    {0, 2, 13, 0.60, 1194.45},                   {0, 2, 12, 3.86, 6684.75},
+    {0, 2, 11, 4.72, 2544.31},                   {0, 2, 10, 0.25, 382.90},
+    {0, 2, 9, 0.68, 1059.38},                    {0, 2, 9, 3.83, 20043.67},
+    {0, 2, 9, 3.88, 3738.76},                    {0, 2, 8, 5.46, 1751.54},
+    {0, 2, 7, 2.58, 3149.16},                    {0, 2, 7, 2.38, 4136.91},
+    {0, 2, 6, 5.48, 1592.60},                    {0, 2, 6, 2.34, 3097.88},
+    {0, 3, 1482, 0.4443, 3340.6124},             {0, 3, 662, 0.885, 6681.225},
+    {0, 3, 188, 1.288, 10021.837},               {0, 3, 41, 1.65, 13362.45},
+    {0, 3, 26, 0, 0},                            {0, 3, 23, 2.05, 155.42},
+    {0, 3, 10, 1.58, 3.52},                      {0, 3, 8, 2.00, 16703.06},
+    {0, 3, 5, 2.82, 242.73},                     {0, 3, 4, 2.02, 3344.14},
+    {0, 3, 3, 4.59, 3185.19},                    {0, 3, 3, 0.65, 553.57},
+    {0, 4, 114, 3.1416, 0},                      {0, 4, 29, 5.64, 6681.22},
+    {0, 4, 24, 5.14, 3340.61},                   {0, 4, 11, 6.03, 10021.84},
+    {0, 4, 3, 0.13, 13362.45},                   {0, 4, 3, 3.56, 155.42},
+    {0, 4, 1, 0.49, 16703.06},                   {0, 4, 1, 1.32, 242.73},
+    {0, 5, 1, 3.14, 0},                          {1, 0, 3197135, 3.7683204, 3340.6124267},
+    {1, 0, 298033, 4.106170, 6681.224853},       {1, 0, 289105, 0, 0},
+    {1, 0, 31366, 4.44651, 10021.83728},         {1, 0, 3484, 4.7881, 13362.4497},
+    {1, 0, 443, 5.026, 3344.136},                {1, 0, 443, 5.652, 3337.089},
+    {1, 0, 399, 5.131, 16703.062},               {1, 0, 293, 3.793, 2281.230},
+    {1, 0, 182, 6.136, 6151.534},                {1, 0, 163, 4.264, 529.691},
+    {1, 0, 160, 2.232, 1059.382},                {1, 0, 149, 2.165, 5621.843},
+    {1, 0, 143, 1.182, 3340.595},                {1, 0, 143, 3.213, 3340.630},
+    {1, 0, 139, 2.418, 8962.455},                {1, 1, 350069, 5.368478, 3340.612427},
+    {1, 1, 14116, 3.14159, 0},                   {1, 1, 9671, 5.4788, 6681.2249},
+    {1, 1, 1472, 3.2021, 10021.8373},            {1, 1, 426, 3.408, 13362.450},
+    {1, 1, 102, 0.776, 3337.089},                {1, 1, 79, 3.72, 16703.06},
+    {1, 1, 33, 3.46, 5621.84},                   {1, 1, 26, 2.48, 2281.23},
+    {1, 2, 16727, 0.60221, 3340.61243},          {1, 2, 4987, 3.1416, 0},
+    {1, 2, 302, 3.559, 6681.225},                {1, 2, 26, 1.90, 13362.45},
+    {1, 2, 21, 0.92, 10021.84},                  {1, 2, 12, 2.24, 3337.09},
+    {1, 2, 8, 2.25, 16703.06},                   {1, 3, 607, 1.981, 3340.612},
+    {1, 3, 43, 0, 0},                            {1, 3, 14, 1.80, 6681.22},
+    {1, 3, 3, 3.45, 10021.84},                   {1, 4, 13, 0, 0},
+    {1, 4, 11, 3.46, 3340.61},                   {2, 0, 153033488, 0, 0},
+    {2, 0, 14184953, 3.47971284, 3340.61242670}, {2, 0, 660776, 3.817834, 6681.224853},
+    {2, 0, 46179, 4.15595, 10021.83728},         {2, 0, 8110, 5.5596, 2810.9215},
+    {2, 0, 7485, 1.7724, 5621.8429},             {2, 0, 5523, 1.3644, 2281.2305},
+    {2, 0, 3825, 4.4941, 13362.4497},            {2, 0, 2484, 4.9255, 2942.4634},
+    {2, 0, 2307, 0.0908, 2544.3144},             {2, 0, 1999, 5.3606, 3337.0893},
+    {2, 0, 1960, 4.7425, 3344.1355},             {2, 0, 1167, 2.1126, 5092.1520},
+    {2, 0, 1103, 5.0091, 398.1490},              {2, 0, 992, 5.839, 6151.534},
+    {2, 0, 899, 4.408, 529.691},                 {2, 0, 807, 2.102, 1059.382},
+    {2, 0, 798, 3.448, 796.298},                 {2, 0, 741, 1.499, 2146.165},
+    {2, 0, 726, 1.245, 8432.764},                {2, 0, 692, 2.134, 8962.455},
+    {2, 0, 633, 0.894, 3340.596},                {2, 0, 633, 2.924, 3340.630},
+    {2, 0, 630, 1.287, 1751.540},                {2, 0, 574, 0.829, 2914.014},
+    {2, 0, 526, 5.383, 3738.761},                {2, 0, 473, 5.199, 3127.313},
+    {2, 0, 348, 4.832, 16703.062},               {2, 0, 284, 2.907, 3532.061},
+    {2, 0, 280, 5.257, 6283.076},                {2, 0, 276, 1.218, 6254.627},
+    {2, 0, 275, 2.908, 1748.016},                {2, 0, 270, 3.764, 5884.927},
+    {2, 0, 239, 2.037, 1194.447},                {2, 0, 234, 5.105, 5486.778},
+    {2, 0, 228, 3.255, 6872.673},                {2, 0, 223, 4.199, 3149.164},
+    {2, 0, 219, 5.583, 191.448},                 {2, 0, 208, 5.255, 3340.545},
+    {2, 0, 208, 4.846, 3340.680},                {2, 0, 186, 5.699, 6677.702},
+    {2, 0, 183, 5.081, 6684.748},                {2, 0, 179, 4.184, 3333.499},
+    {2, 0, 176, 5.953, 3870.303},                {2, 0, 164, 3.799, 4136.910},
+    {2, 1, 1107433, 2.0325052, 3340.6124267},    {2, 1, 103176, 2.370718, 6681.224853},
+    {2, 1, 12877, 0, 0},                         {2, 1, 10816, 2.70888, 10021.83728},
+    {2, 1, 1195, 3.0470, 13362.4497},            {2, 1, 439, 2.888, 2281.230},
+    {2, 1, 396, 3.423, 3344.136},                {2, 1, 183, 1.584, 2544.314},
+    {2, 1, 136, 3.385, 16703.062},               {2, 1, 128, 6.043, 3337.089},
+    {2, 1, 128, 0.630, 1059.382},                {2, 1, 127, 1.954, 796.298},
+    {2, 1, 118, 2.998, 2146.165},                {2, 1, 88, 3.42, 398.15},
+    {2, 1, 83, 3.86, 3738.76},                   {2, 1, 76, 4.45, 6151.53},
+    {2, 1, 72, 2.76, 529.69},                    {2, 1, 67, 2.55, 1751.54},
+    {2, 1, 66, 4.41, 1748.02},                   {2, 1, 58, 0.54, 1194.45},
+    {2, 1, 54, 0.68, 8962.46},                   {2, 1, 51, 3.73, 6684.75},
+    {2, 1, 49, 5.73, 3340.60},                   {2, 1, 49, 1.48, 3340.63},
+    {2, 1, 48, 2.58, 3149.16},                   {2, 1, 48, 2.29, 2914.01},
+    {2, 1, 39, 2.32, 4136.91},                   {2, 2, 44242, 0.47931, 3340.61243},
+    {2, 2, 8138, 0.8700, 6681.2249},             {2, 2, 1275, 1.2259, 10021.8373},
+    {2, 2, 187, 1.573, 13362.450},               {2, 2, 52, 3.14, 0},
+    {2, 2, 41, 1.97, 3344.14},                   {2, 2, 27, 1.92, 16703.06},
+    {2, 2, 18, 4.43, 2281.23},                   {2, 2, 12, 4.53, 3185.19},
+    {2, 2, 10, 5.39, 1059.38},                   {2, 2, 10, 0.42, 796.30},
+    {2, 3, 1113, 5.1499, 3340.6124},             {2, 3, 424, 5.613, 6681.225},
+    {2, 3, 100, 5.997, 10021.837},               {2, 3, 20, 0.08, 13362.45},
+    {2, 3, 5, 3.14, 0},                          {2, 3, 3, 0.43, 16703.06},
+    {2, 4, 20, 3.58, 3340.61},                   {2, 4, 16, 4.05, 6681.22},
+    {2, 4, 6, 4.46, 10021.84},                   {2, 4, 2, 4.84, 13362.45},
+};
+
+// Júpiter: 483 termos.
+const Vsop87TableTerm VSOP87D_JUPITER[483] = {
+    {0, 0, 59954691, 0, 0},                     {0, 0, 9695899, 5.0619179, 529.6909651},
+    {0, 0, 573610, 1.444062, 7.113547},         {0, 0, 306389, 5.417347, 1059.381930},
+    {0, 0, 97178, 4.14265, 632.78374},          {0, 0, 72903, 3.64043, 522.57742},
+    {0, 0, 64264, 3.41145, 103.09277},          {0, 0, 39806, 2.29377, 419.48464},
+    {0, 0, 38858, 1.27232, 316.39187},          {0, 0, 27965, 1.78455, 536.80451},
+    {0, 0, 13590, 5.77481, 1589.07290},         {0, 0, 8769, 3.6300, 949.1756},
+    {0, 0, 8246, 3.5823, 206.1855},             {0, 0, 7368, 5.0810, 735.8765},
+    {0, 0, 6263, 0.0250, 213.2991},             {0, 0, 6114, 4.5132, 1162.4747},
+    {0, 0, 5305, 4.1863, 1052.2684},            {0, 0, 5305, 1.3067, 14.2271},
+    {0, 0, 4905, 1.3208, 110.2063},             {0, 0, 4647, 4.6996, 3.9322},
+    {0, 0, 3045, 4.3168, 426.5982},             {0, 0, 2610, 1.5667, 846.0828},
+    {0, 0, 2028, 1.0638, 3.1814},               {0, 0, 1921, 0.9717, 639.8973},
+    {0, 0, 1765, 2.1415, 1066.4955},            {0, 0, 1723, 3.8804, 1265.5675},
+    {0, 0, 1633, 3.5820, 515.4639},             {0, 0, 1432, 4.2968, 625.6702},
+    {0, 0, 973, 4.098, 95.979},                 {0, 0, 884, 2.437, 412.371},
+    {0, 0, 733, 6.085, 838.969},                {0, 0, 731, 3.806, 1581.959},
+    {0, 0, 709, 1.293, 742.990},                {0, 0, 692, 6.134, 2118.764},
+    {0, 0, 614, 4.109, 1478.867},               {0, 0, 582, 4.540, 309.278},
+    {0, 0, 495, 3.756, 323.505},                {0, 0, 441, 2.958, 454.909},
+    {0, 0, 417, 1.036, 2.448},                  {0, 0, 390, 4.897, 1692.166},
+    {0, 0, 376, 4.703, 1368.660},               {0, 0, 341, 5.715, 533.623},
+    {0, 0, 330, 4.740, 0.048},                  {0, 0, 262, 1.877, 0.963},
+    {0, 0, 261, 0.820, 380.128},                {0, 0, 257, 3.724, 199.072},
+    {0, 0, 244, 5.220, 728.763},                {0, 0, 235, 1.227, 909.819},
+    {0, 0, 220, 1.651, 543.918},                {0, 0, 207, 1.855, 525.759},
+    {0, 0, 202, 1.807, 1375.774},               {0, 0, 197, 5.293, 1155.361},
+    {0, 0, 175, 3.730, 942.062},                {0, 0, 175, 3.226, 1898.351},
+    {0, 0, 175, 5.910, 956.289},                {0, 0, 158, 4.365, 1795.258},
+    {0, 0, 151, 3.906, 74.782},                 {0, 0, 149, 4.377, 1685.052},
+    {0, 0, 141, 3.136, 491.558},                {0, 0, 138, 1.318, 1169.588},
+    {0, 0, 131, 4.169, 1045.155},               {0, 0, 117, 2.500, 1596.186},
+    {0, 0, 117, 3.389, 0.521},                  {0, 0, 106, 4.554, 526.510},
+    {0, 1, 52993480757, 0, 0},                  {0, 1, 489741, 4.220667, 529.690965},
+    {0, 1, 228919, 6.026475, 7.113547},         {0, 1, 27655, 4.57266, 1059.38193},
+    {0, 1, 20721, 5.45939, 522.57742},          {0, 1, 12106, 0.16986, 536.80451},
+    {0, 1, 6068, 4.4242, 103.0928},             {0, 1, 5434, 3.9848, 419.4846},
+    {0, 1, 4238, 5.8901, 14.2271},              {0, 1, 2212, 5.2677, 206.1855},
+    {0, 1, 1746, 4.9267, 1589.0729},            {0, 1, 1296, 5.5513, 3.1814},
+    {0, 1, 1173, 5.8565, 1052.2684},            {0, 1, 1163, 0.5145, 3.9322},
+    {0, 1, 1099, 5.3070, 515.4639},             {0, 1, 1007, 0.4648, 735.8765},
+    {0, 1, 1004, 3.1504, 426.5982},             {0, 1, 848, 5.758, 110.206},
+    {0, 1, 827, 4.803, 213.299},                {0, 1, 816, 0.586, 1066.495},
+    {0, 1, 725, 5.518, 639.897},                {0, 1, 568, 5.989, 625.670},
+    {0, 1, 474, 4.132, 412.371},                {0, 1, 413, 5.737, 95.979},
+    {0, 1, 345, 4.242, 632.784},                {0, 1, 336, 3.732, 1162.475},
+    {0, 1, 234, 4.035, 949.176},                {0, 1, 234, 6.243, 309.278},
+    {0, 1, 199, 1.505, 838.969},                {0, 1, 195, 2.219, 323.505},
+    {0, 1, 187, 6.086, 742.990},                {0, 1, 184, 6.280, 543.918},
+    {0, 1, 171, 5.417, 199.072},                {0, 1, 131, 0.626, 728.763},
+    {0, 1, 115, 0.680, 846.083},                {0, 1, 115, 5.286, 2118.764},
+    {0, 1, 108, 4.493, 956.289},                {0, 1, 80, 5.82, 1045.15},
+    {0, 1, 72, 5.34, 942.06},                   {0, 1, 70, 5.97, 532.87},
+    {0, 1, 67, 5.73, 21.34},                    {0, 1, 66, 0.13, 526.51},
+    {0, 1, 65, 6.09, 1581.96},                  {0, 1, 59, 0.59, 1155.36},
+    {0, 1, 58, 0.99, 1596.19},                  {0, 1, 57, 5.97, 1169.59},
+    {0, 1, 57, 1.41, 533.62},                   {0, 1, 55, 5.43, 10.29},
+    {0, 1, 52, 5.73, 454.91},                   {0, 1, 52, 0.23, 1368.66},
+    {0, 1, 50, 6.08, 12.53},                    {0, 1, 47, 3.63, 1478.87},
+    {0, 1, 47, 0.51, 1265.57},                  {0, 1, 40, 4.16, 1692.17},
+    {0, 1, 34, 0.10, 302.16},                   {0, 1, 33, 5.04, 220.41},
+    {0, 1, 32, 5.37, 508.35},                   {0, 1, 29, 5.42, 1272.68},
+    {0, 1, 29, 3.36, 4.67},                     {0, 1, 29, 0.76, 88.87},
+    {0, 1, 25, 1.61, 831.86},                   {0, 2, 47234, 4.32148, 7.11355},
+    {0, 2, 38966, 0, 0},                        {0, 2, 30629, 2.93021, 529.69097},
+    {0, 2, 3189, 1.0550, 522.5774},             {0, 2, 2729, 4.8455, 536.8045},
+    {0, 2, 2723, 3.4141, 1059.3819},            {0, 2, 1721, 4.1873, 14.2271},
+    {0, 2, 383, 5.768, 419.485},                {0, 2, 378, 0.760, 515.464},
+    {0, 2, 367, 6.055, 103.093},                {0, 2, 337, 3.786, 3.181},
+    {0, 2, 308, 0.694, 206.186},                {0, 2, 218, 3.814, 1589.073},
+    {0, 2, 199, 5.340, 1066.495},               {0, 2, 197, 2.484, 3.932},
+    {0, 2, 156, 1.406, 1052.268},               {0, 2, 146, 3.814, 639.897},
+    {0, 2, 142, 1.634, 426.598},                {0, 2, 130, 5.837, 412.371},
+    {0, 2, 117, 1.414, 625.670},                {0, 2, 97, 4.03, 110.21},
+    {0, 2, 91, 1.11, 95.98},                    {0, 2, 87, 2.52, 632.78},
+    {0, 2, 79, 4.64, 543.92},                   {0, 2, 72, 2.22, 735.88},
+    {0, 2, 58, 0.83, 199.07},                   {0, 2, 57, 3.12, 213.30},
+    {0, 2, 49, 1.67, 309.28},                   {0, 2, 40, 4.02, 21.34},
+    {0, 2, 40, 0.62, 323.51},                   {0, 2, 36, 2.33, 728.76},
+    {0, 2, 29, 3.61, 10.29},                    {0, 2, 28, 3.24, 838.97},
+    {0, 2, 26, 4.50, 742.99},                   {0, 2, 26, 2.51, 1162.47},
+    {0, 2, 25, 1.22, 1045.15},                  {0, 2, 24, 3.01, 956.29},
+    {0, 2, 19, 4.29, 532.87},                   {0, 2, 18, 0.81, 508.35},
+    {0, 2, 17, 4.20, 2118.76},                  {0, 2, 17, 1.83, 526.51},
+    {0, 2, 15, 5.81, 1596.19},                  {0, 2, 15, 0.68, 942.06},
+    {0, 2, 15, 4.00, 117.32},                   {0, 2, 14, 5.95, 316.39},
+    {0, 2, 14, 1.80, 302.16},                   {0, 2, 13, 2.52, 88.87},
+    {0, 2, 13, 4.37, 1169.59},                  {0, 2, 11, 4.44, 525.76},
+    {0, 2, 10, 1.72, 1581.96},                  {0, 2, 9, 2.18, 1155.36},
+    {0, 2, 9, 3.29, 220.41},                    {0, 2, 9, 3.32, 831.86},
+    {0, 2, 8, 5.76, 846.08},                    {0, 2, 8, 2.71, 533.62},
+    {0, 2, 7, 2.18, 1265.57},                   {0, 2, 6, 0.50, 949.18},
+    {0, 3, 6502, 2.5986, 7.1135},               {0, 3, 1357, 1.3464, 529.6910},
+    {0, 3, 471, 2.475, 14.227},                 {0, 3, 417, 3.245, 536.805},
+    {0, 3, 353, 2.974, 522.577},                {0, 3, 155, 2.076, 1059.382},
+    {0, 3, 87, 2.51, 515.46},                   {0, 3, 44, 0, 0},
+    {0, 3, 34, 3.83, 1066.50},                  {0, 3, 28, 2.45, 206.19},
+    {0, 3, 24, 1.28, 412.37},                   {0, 3, 23, 2.98, 543.92},
+    {0, 3, 20, 2.10, 639.90},                   {0, 3, 20, 1.40, 419.48},
+    {0, 3, 19, 1.59, 103.09},                   {0, 3, 17, 2.30, 21.34},
+    {0, 3, 17, 2.60, 1589.07},                  {0, 3, 16, 3.15, 625.67},
+    {0, 3, 16, 3.36, 1052.27},                  {0, 3, 13, 2.76, 95.98},
+    {0, 3, 13, 2.54, 199.07},                   {0, 3, 13, 6.27, 426.60},
+    {0, 3, 9, 1.76, 10.29},                     {0, 3, 9, 2.27, 110.21},
+    {0, 3, 7, 3.43, 309.28},                    {0, 3, 7, 4.04, 728.76},
+    {0, 3, 6, 2.52, 508.35},                    {0, 3, 5, 2.91, 1045.15},
+    {0, 4, 669, 0.853, 7.114},                  {0, 4, 114, 3.142, 0},
+    {0, 4, 100, 0.743, 14.227},                 {0, 4, 50, 1.65, 536.80},
+    {0, 4, 44, 5.82, 529.69},                   {0, 4, 32, 4.86, 522.58},
+    {0, 4, 15, 4.29, 515.46},                   {0, 4, 9, 0.71, 1059.38},
+    {0, 4, 5, 1.30, 543.92},                    {0, 4, 4, 2.32, 1066.50},
+    {0, 4, 4, 0.48, 21.34},                     {0, 4, 3, 3.00, 412.37},
+    {0, 4, 2, 0.40, 639.90},                    {0, 4, 2, 4.26, 199.07},
+    {0, 4, 2, 4.91, 625.67},                    {0, 5, 50, 5.26, 7.11},
+    {0, 5, 16, 5.25, 14.23},                    {0, 5, 4, 0.01, 536.80},
+    {0, 5, 2, 1.10, 522.58},                    {0, 5, 1, 3.14, 0},
+    {1, 0, 2268616, 3.5585261, 529.6909651},    {1, 0, 110090, 0, 0},
+    {1, 0, 109972, 3.908093, 1059.381930},      {1, 0, 8101, 3.6051, 522.5774},
+    {1, 0, 6438, 0.3063, 536.8045},             {1, 0, 6044, 4.2588, 1589.0729},
+    {1, 0, 1107, 2.9853, 1162.4747},            {1, 0, 944, 1.675, 426.598},
+    {1, 0, 942, 2.936, 1052.268},               {1, 0, 894, 1.754, 7.114},
+    {1, 0, 836, 5.179, 103.093},                {1, 0, 767, 2.155, 632.784},
+    {1, 0, 684, 3.678, 213.299},                {1, 0, 629, 0.643, 1066.495},
+    {1, 0, 559, 0.014, 846.083},                {1, 0, 532, 2.703, 110.206},
+    {1, 0, 464, 1.173, 949.176},                {1, 0, 431, 2.608, 419.485},
+    {1, 0, 351, 4.611, 2118.764},               {1, 0, 132, 4.778, 742.990},
+    {1, 0, 123, 3.350, 1692.166},               {1, 0, 116, 1.387, 323.505},
+    {1, 0, 115, 5.049, 316.392},                {1, 0, 104, 3.701, 515.464},
+    {1, 0, 103, 2.319, 1478.867},               {1, 0, 102, 3.153, 1581.959},
+    {1, 1, 177352, 5.701665, 529.690965},       {1, 1, 3230, 5.7794, 1059.3819},
+    {1, 1, 3081, 5.4746, 522.5774},             {1, 1, 2212, 4.7348, 536.8045},
+    {1, 1, 1694, 3.1416, 0},                    {1, 1, 346, 4.746, 1052.268},
+    {1, 1, 234, 5.189, 1066.495},               {1, 1, 196, 6.186, 7.114},
+    {1, 1, 150, 3.927, 1589.073},               {1, 1, 114, 3.439, 632.784},
+    {1, 1, 97, 2.91, 949.18},                   {1, 1, 82, 5.08, 1162.47},
+    {1, 1, 77, 2.51, 103.09},                   {1, 1, 77, 0.61, 419.48},
+    {1, 1, 74, 5.50, 515.46},                   {1, 1, 61, 5.45, 213.30},
+    {1, 1, 50, 3.95, 735.88},                   {1, 1, 46, 0.54, 110.21},
+    {1, 1, 45, 1.90, 846.08},                   {1, 1, 37, 4.70, 543.92},
+    {1, 1, 36, 6.11, 316.39},                   {1, 1, 32, 4.92, 1581.96},
+    {1, 2, 8094, 1.4632, 529.6910},             {1, 2, 813, 3.1416, 0},
+    {1, 2, 742, 0.957, 522.577},                {1, 2, 399, 2.899, 536.805},
+    {1, 2, 342, 1.447, 1059.382},               {1, 2, 74, 0.41, 1052.27},
+    {1, 2, 46, 3.48, 1066.50},                  {1, 2, 30, 1.93, 1589.07},
+    {1, 2, 29, 0.99, 515.46},                   {1, 2, 23, 4.27, 7.11},
+    {1, 2, 14, 2.92, 543.92},                   {1, 2, 12, 5.22, 632.78},
+    {1, 2, 11, 4.88, 949.18},                   {1, 2, 6, 6.21, 1045.15},
+    {1, 3, 252, 3.381, 529.691},                {1, 3, 122, 2.733, 522.577},
+    {1, 3, 49, 1.04, 536.81},                   {1, 3, 11, 2.31, 1059.38},
+    {1, 3, 8, 2.77, 515.46},                    {1, 3, 7, 4.25, 1052.27},
+    {1, 3, 6, 1.78, 1066.50},                   {1, 3, 4, 1.13, 543.92},
+    {1, 3, 3, 3.14, 0},                         {1, 4, 15, 4.53, 522.58},
+    {1, 4, 5, 4.47, 529.69},                    {1, 4, 4, 5.44, 536.81},
+    {1, 4, 3, 0, 0},                            {1, 4, 2, 4.52, 515.46},
+    {1, 4, 1, 4.20, 1052.27},                   {1, 5, 1, 0.09, 522.58},
+    {2, 0, 520887429, 0, 0},                    {2, 0, 25209327, 3.49108640, 529.69096509},
+    {2, 0, 610600, 3.841154, 1059.381930},      {2, 0, 282029, 2.574199, 632.783739},
+    {2, 0, 187647, 2.075904, 522.577418},       {2, 0, 86793, 0.71001, 419.48464},
+    {2, 0, 72063, 0.21466, 536.80451},          {2, 0, 65517, 5.97996, 316.39187},
+    {2, 0, 30135, 2.16132, 949.17561},          {2, 0, 29135, 1.67759, 103.09277},
+    {2, 0, 23947, 0.27458, 7.11355},            {2, 0, 23453, 3.54023, 735.87651},
+    {2, 0, 22284, 4.19363, 1589.07290},         {2, 0, 13033, 2.96043, 1162.47470},
+    {2, 0, 12749, 2.71550, 1052.26838},         {2, 0, 9703, 1.9067, 206.1855},
+    {2, 0, 9161, 4.4135, 213.2991},             {2, 0, 7895, 2.4791, 426.5982},
+    {2, 0, 7058, 2.1818, 1265.5675},            {2, 0, 6138, 6.2642, 846.0828},
+    {2, 0, 5477, 5.6573, 639.8973},             {2, 0, 4170, 2.0161, 515.4639},
+    {2, 0, 4137, 2.7222, 625.6702},             {2, 0, 3503, 0.5653, 1066.4955},
+    {2, 0, 2617, 2.0099, 1581.9593},            {2, 0, 2500, 4.5518, 838.9693},
+    {2, 0, 2128, 6.1275, 742.9901},             {2, 0, 1912, 0.8562, 412.3711},
+    {2, 0, 1611, 3.0887, 1368.6603},            {2, 0, 1479, 2.6803, 1478.8666},
+    {2, 0, 1231, 1.8904, 323.5054},             {2, 0, 1217, 1.8017, 110.2063},
+    {2, 0, 1015, 1.3867, 454.9094},             {2, 0, 999, 2.872, 309.278},
+    {2, 0, 961, 4.549, 2118.764},               {2, 0, 886, 4.148, 533.623},
+    {2, 0, 821, 1.593, 1898.351},               {2, 0, 812, 5.941, 909.819},
+    {2, 0, 777, 3.677, 728.763},                {2, 0, 727, 3.988, 1155.361},
+    {2, 0, 655, 2.791, 1685.052},               {2, 0, 654, 3.382, 1692.166},
+    {2, 0, 621, 4.823, 956.289},                {2, 0, 615, 2.276, 942.062},
+    {2, 0, 562, 0.081, 543.918},                {2, 0, 542, 0.284, 525.759},
+    {2, 1, 1271802, 2.6493751, 529.6909651},    {2, 1, 61662, 3.00076, 1059.38193},
+    {2, 1, 53444, 3.89718, 522.57742},          {2, 1, 41390, 0, 0},
+    {2, 1, 31185, 4.88277, 536.80451},          {2, 1, 11847, 2.41330, 419.48464},
+    {2, 1, 9166, 4.7598, 7.1135},               {2, 1, 3404, 3.3469, 1589.0729},
+    {2, 1, 3203, 5.2108, 735.8765},             {2, 1, 3176, 2.7930, 103.0928},
+    {2, 1, 2806, 3.7422, 515.4639},             {2, 1, 2677, 4.3305, 1052.2684},
+    {2, 1, 2600, 3.6344, 206.1855},             {2, 1, 2412, 1.4695, 426.5982},
+    {2, 1, 2101, 3.9276, 639.8973},             {2, 1, 1646, 5.3095, 1066.4955},
+    {2, 1, 1641, 4.4163, 625.6702},             {2, 1, 1050, 3.1611, 213.2991},
+    {2, 1, 1025, 2.5543, 412.3711},             {2, 1, 806, 2.678, 632.784},
+    {2, 1, 741, 2.171, 1162.475},               {2, 1, 677, 6.250, 838.969},
+    {2, 1, 567, 4.577, 742.990},                {2, 1, 485, 2.469, 949.176},
+    {2, 1, 469, 4.710, 543.918},                {2, 1, 445, 0.403, 323.505},
+    {2, 1, 416, 5.368, 728.763},                {2, 1, 402, 4.605, 309.278},
+    {2, 1, 347, 4.681, 14.227},                 {2, 1, 338, 3.168, 956.289},
+    {2, 1, 261, 5.343, 846.083},                {2, 1, 247, 3.923, 942.062},
+    {2, 1, 220, 4.842, 1368.660},               {2, 1, 203, 5.600, 1155.361},
+    {2, 1, 200, 4.439, 1045.155},               {2, 1, 197, 3.706, 2118.764},
+    {2, 1, 196, 3.759, 199.072},                {2, 1, 184, 4.265, 95.979},
+    {2, 1, 180, 4.402, 532.872},                {2, 1, 170, 4.846, 526.510},
+    {2, 1, 146, 6.130, 533.623},                {2, 1, 133, 1.322, 110.206},
+    {2, 1, 132, 4.512, 525.759},                {2, 2, 79645, 1.35866, 529.69097},
+    {2, 2, 8252, 5.7777, 522.5774},             {2, 2, 7030, 3.2748, 536.8045},
+    {2, 2, 5314, 1.8384, 1059.3819},            {2, 2, 1861, 2.9768, 7.1135},
+    {2, 2, 964, 5.480, 515.464},                {2, 2, 836, 4.199, 419.485},
+    {2, 2, 498, 3.142, 0},                      {2, 2, 427, 2.228, 639.897},
+    {2, 2, 406, 3.783, 1066.495},               {2, 2, 377, 2.242, 1589.073},
+    {2, 2, 363, 5.368, 206.186},                {2, 2, 342, 6.099, 1052.268},
+    {2, 2, 339, 6.127, 625.670},                {2, 2, 333, 0.003, 426.598},
+    {2, 2, 280, 4.262, 412.371},                {2, 2, 257, 0.963, 632.784},
+    {2, 2, 230, 0.705, 735.877},                {2, 2, 201, 3.069, 543.918},
+    {2, 2, 200, 4.429, 103.093},                {2, 2, 139, 2.932, 14.227},
+    {2, 2, 114, 0.787, 728.763},                {2, 2, 95, 1.70, 838.97},
+    {2, 2, 86, 5.14, 323.51},                   {2, 2, 83, 0.06, 309.28},
+    {2, 2, 80, 2.98, 742.99},                   {2, 2, 75, 1.60, 956.29},
+    {2, 2, 70, 1.51, 213.30},                   {2, 2, 67, 5.47, 199.07},
+    {2, 2, 62, 6.10, 1045.15},                  {2, 2, 56, 0.96, 1162.47},
+    {2, 2, 52, 5.58, 942.06},                   {2, 2, 50, 2.72, 532.87},
+    {2, 2, 45, 5.52, 508.35},                   {2, 2, 44, 0.27, 526.51},
+    {2, 2, 40, 5.95, 95.98},                    {2, 3, 3519, 6.0580, 529.6910},
+    {2, 3, 1073, 1.6732, 536.8045},             {2, 3, 916, 1.413, 522.577},
+    {2, 3, 342, 0.523, 1059.382},               {2, 3, 255, 1.196, 7.114},
+    {2, 3, 222, 0.952, 515.464},                {2, 3, 90, 3.14, 0},
+    {2, 3, 69, 2.27, 1066.50},                  {2, 3, 58, 1.41, 543.92},
+    {2, 3, 58, 0.53, 639.90},                   {2, 3, 51, 5.98, 412.37},
+    {2, 3, 47, 1.58, 625.67},                   {2, 3, 43, 6.12, 419.48},
+    {2, 3, 37, 1.18, 14.23},                    {2, 3, 34, 1.67, 1052.27},
+    {2, 3, 34, 0.85, 206.19},                   {2, 3, 31, 1.04, 1589.07},
+    {2, 3, 30, 4.63, 426.60},                   {2, 3, 21, 2.50, 728.76},
+    {2, 3, 15, 0.89, 199.07},                   {2, 3, 14, 0.96, 508.35},
+    {2, 3, 13, 1.50, 1045.15},                  {2, 3, 12, 2.61, 735.88},
+    {2, 3, 12, 3.56, 323.51},                   {2, 3, 11, 1.79, 309.28},
+    {2, 3, 11, 6.28, 956.29},                   {2, 3, 10, 6.26, 103.09},
+    {2, 3, 9, 3.45, 838.97},                    {2, 4, 129, 0.084, 536.805},
+    {2, 4, 113, 4.249, 529.691},                {2, 4, 83, 3.30, 522.58},
+    {2, 4, 38, 2.73, 515.46},                   {2, 4, 27, 5.69, 7.11},
+    {2, 4, 18, 5.40, 1059.38},                  {2, 4, 13, 6.02, 543.92},
+    {2, 4, 9, 0.77, 1066.50},                   {2, 4, 8, 5.68, 14.23},
+    {2, 4, 7, 1.43, 412.37},                    {2, 4, 6, 5.12, 639.90},
+    {2, 4, 5, 3.34, 625.67},                    {2, 4, 3, 3.40, 1052.27},
+    {2, 4, 3, 4.16, 728.76},                    {2, 4, 3, 2.90, 426.60},
+    {2, 5, 11, 4.75, 536.80},                   {2, 5, 4, 5.92, 522.58},
+    {2, 5, 2, 5.57, 515.46},                    {2, 5, 2, 4.30, 543.92},
+    {2, 5, 2, 3.69, 7.11},                      {2, 5, 2, 4.13, 1059.38},
+    {2, 5, 2, 5.49, 1066.50},
+};
+
+// Saturno: 622 termos.
+const Vsop87TableTerm VSOP87D_SATURN[622] = {
+    {0, 0, 87401354, 0, 0},                     {0, 0, 11107660, 3.96205090, 213.29909544},
+    {0, 0, 1414151, 4.5858152, 7.1135470},      {0, 0, 398379, 0.521120, 206.185548},
+    {0, 0, 350769, 3.303299, 426.598191},       {0, 0, 206816, 0.246584, 103.092774},
+    {0, 0, 79271, 3.84007, 220.41264},          {0, 0, 23990, 4.66977, 110.20632},
+    {0, 0, 16574, 0.43719, 419.48464},          {0, 0, 15820, 0.93809, 632.78374},
+    {0, 0, 15054, 2.71670, 639.89729},          {0, 0, 14907, 5.76903, 316.39187},
+    {0, 0, 14610, 1.56519, 3.93215},            {0, 0, 13160, 4.44891, 14.22709},
+    {0, 0, 13005, 5.98119, 11.04570},           {0, 0, 10725, 3.12940, 202.25340},
+    {0, 0, 6126, 1.7633, 277.0350},             {0, 0, 5863, 0.2366, 529.6910},
+    {0, 0, 5228, 4.2078, 3.1814},               {0, 0, 5020, 3.1779, 433.7117},
+    {0, 0, 4593, 0.6198, 199.0720},             {0, 0, 4006, 2.2448, 63.7359},
+    {0, 0, 3874, 3.2228, 138.5175},             {0, 0, 3269, 0.7749, 949.1756},
+    {0, 0, 2954, 0.9828, 95.9792},              {0, 0, 2461, 2.0316, 735.8765},
+    {0, 0, 1758, 3.2658, 522.5774},             {0, 0, 1640, 5.5050, 846.0828},
+    {0, 0, 1581, 4.3727, 309.2783},             {0, 0, 1391, 4.0233, 323.5054},
+    {0, 0, 1124, 2.8373, 415.5525},             {0, 0, 1087, 4.1834, 2.4477},
+    {0, 0, 1017, 3.7170, 227.5262},             {0, 0, 957, 0.507, 1265.567},
+    {0, 0, 853, 3.421, 175.166},                {0, 0, 849, 3.191, 209.367},
+    {0, 0, 789, 5.007, 0.963},                  {0, 0, 749, 2.144, 853.196},
+    {0, 0, 744, 5.253, 224.345},                {0, 0, 687, 1.747, 1052.268},
+    {0, 0, 654, 1.599, 0.048},                  {0, 0, 634, 2.299, 412.371},
+    {0, 0, 625, 0.970, 210.118},                {0, 0, 580, 3.093, 74.782},
+    {0, 0, 546, 2.127, 350.332},                {0, 0, 543, 1.518, 9.561},
+    {0, 0, 530, 4.449, 117.320},                {0, 0, 478, 2.965, 137.033},
+    {0, 0, 474, 5.475, 742.990},                {0, 0, 452, 1.044, 490.334},
+    {0, 0, 449, 1.290, 127.472},                {0, 0, 372, 2.278, 217.231},
+    {0, 0, 355, 3.013, 838.969},                {0, 0, 347, 1.539, 340.771},
+    {0, 0, 343, 0.246, 0.521},                  {0, 0, 330, 0.247, 1581.959},
+    {0, 0, 322, 0.961, 203.738},                {0, 0, 322, 2.572, 647.011},
+    {0, 0, 309, 3.495, 216.480},                {0, 0, 287, 2.370, 351.817},
+    {0, 0, 278, 0.400, 211.815},                {0, 0, 249, 1.470, 1368.660},
+    {0, 0, 227, 4.910, 12.530},                 {0, 0, 220, 4.204, 200.769},
+    {0, 0, 209, 1.345, 625.670},                {0, 0, 208, 0.483, 1162.475},
+    {0, 0, 208, 1.283, 39.357},                 {0, 0, 204, 6.011, 265.989},
+    {0, 0, 185, 3.503, 149.563},                {0, 0, 184, 0.973, 4.193},
+    {0, 0, 182, 5.491, 2.921},                  {0, 0, 174, 1.863, 0.751},
+    {0, 0, 165, 0.440, 5.417},                  {0, 0, 149, 5.736, 52.690},
+    {0, 0, 148, 1.535, 5.629},                  {0, 0, 146, 6.231, 195.140},
+    {0, 0, 140, 4.295, 21.341},                 {0, 0, 131, 4.068, 10.295},
+    {0, 0, 125, 6.277, 1898.351},               {0, 0, 122, 1.976, 4.666},
+    {0, 0, 118, 5.341, 554.070},                {0, 0, 117, 2.679, 1155.361},
+    {0, 0, 114, 5.594, 1059.382},               {0, 0, 112, 1.105, 191.208},
+    {0, 0, 110, 0.166, 1.484},                  {0, 0, 109, 3.438, 536.805},
+    {0, 0, 107, 4.012, 956.289},                {0, 0, 104, 2.192, 88.866},
+    {0, 0, 103, 1.197, 1685.052},               {0, 0, 101, 4.965, 269.921},
+    {0, 1, 21354295596, 0, 0},                  {0, 1, 1296855, 1.8282054, 213.2990954},
+    {0, 1, 564348, 2.885001, 7.113547},         {0, 1, 107679, 2.277699, 206.185548},
+    {0, 1, 98323, 1.08070, 426.59819},          {0, 1, 40255, 2.04128, 220.41264},
+    {0, 1, 19942, 1.27955, 103.09277},          {0, 1, 10512, 2.74880, 14.22709},
+    {0, 1, 6939, 0.4049, 639.8973},             {0, 1, 4803, 2.4419, 419.4846},
+    {0, 1, 4056, 2.9217, 110.2063},             {0, 1, 3769, 3.6497, 3.9322},
+    {0, 1, 3385, 2.4169, 3.1814},               {0, 1, 3302, 1.2626, 433.7117},
+    {0, 1, 3071, 2.3274, 199.0720},             {0, 1, 1953, 3.5639, 11.0457},
+    {0, 1, 1249, 2.6280, 95.9792},              {0, 1, 922, 1.961, 227.526},
+    {0, 1, 706, 4.417, 529.691},                {0, 1, 650, 6.174, 202.253},
+    {0, 1, 628, 6.111, 309.278},                {0, 1, 487, 6.040, 853.196},
+    {0, 1, 479, 4.988, 522.577},                {0, 1, 468, 4.617, 63.736},
+    {0, 1, 417, 2.117, 323.505},                {0, 1, 408, 1.299, 209.367},
+    {0, 1, 352, 2.317, 632.784},                {0, 1, 344, 3.959, 412.371},
+    {0, 1, 340, 3.634, 316.392},                {0, 1, 336, 3.772, 735.877},
+    {0, 1, 332, 2.861, 210.118},                {0, 1, 289, 2.733, 117.320},
+    {0, 1, 281, 5.744, 2.448},                  {0, 1, 266, 0.543, 647.011},
+    {0, 1, 230, 1.644, 216.480},                {0, 1, 192, 2.965, 224.345},
+    {0, 1, 173, 4.077, 846.083},                {0, 1, 167, 2.597, 21.341},
+    {0, 1, 136, 2.286, 10.295},                 {0, 1, 131, 3.441, 742.990},
+    {0, 1, 128, 4.095, 217.231},                {0, 1, 109, 6.161, 415.552},
+    {0, 1, 98, 4.73, 838.97},                   {0, 1, 94, 3.48, 1052.27},
+    {0, 1, 92, 3.95, 88.87},                    {0, 1, 87, 1.22, 440.83},
+    {0, 1, 83, 3.11, 625.67},                   {0, 1, 78, 6.24, 302.16},
+    {0, 1, 67, 0.29, 4.67},                     {0, 1, 66, 5.65, 9.56},
+    {0, 1, 62, 4.29, 127.47},                   {0, 1, 62, 1.83, 195.14},
+    {0, 1, 58, 2.48, 191.96},                   {0, 1, 57, 5.02, 137.03},
+    {0, 1, 55, 0.28, 74.78},                    {0, 1, 54, 5.13, 490.33},
+    {0, 1, 51, 1.46, 536.80},                   {0, 1, 47, 1.18, 149.56},
+    {0, 1, 47, 5.15, 515.46},                   {0, 1, 46, 2.23, 956.29},
+    {0, 1, 44, 2.71, 5.42},                     {0, 1, 40, 0.41, 269.92},
+    {0, 1, 40, 3.89, 728.76},                   {0, 1, 38, 0.65, 422.67},
+    {0, 1, 38, 2.53, 12.53},                    {0, 1, 37, 3.78, 2.92},
+    {0, 1, 35, 6.08, 5.63},                     {0, 1, 34, 3.21, 1368.66},
+    {0, 1, 33, 4.64, 277.03},                   {0, 1, 33, 5.43, 1066.50},
+    {0, 1, 33, 0.30, 351.82},                   {0, 1, 32, 4.39, 1155.36},
+    {0, 1, 31, 2.43, 52.69},                    {0, 1, 30, 2.84, 203.00},
+    {0, 1, 30, 6.19, 284.15},                   {0, 1, 30, 3.39, 1059.38},
+    {0, 1, 29, 2.03, 330.62},                   {0, 1, 28, 2.74, 265.99},
+    {0, 1, 26, 4.51, 340.77},                   {0, 2, 116441, 1.179879, 7.113547},
+    {0, 2, 91921, 0.07425, 213.29910},          {0, 2, 90592, 0, 0},
+    {0, 2, 15277, 4.06492, 206.18555},          {0, 2, 10631, 0.25778, 220.41264},
+    {0, 2, 10605, 5.40964, 426.59819},          {0, 2, 4265, 1.0460, 14.2271},
+    {0, 2, 1216, 2.9186, 103.0928},             {0, 2, 1165, 4.6094, 639.8973},
+    {0, 2, 1082, 5.6913, 433.7117},             {0, 2, 1045, 4.0421, 199.0720},
+    {0, 2, 1020, 0.6337, 3.1814},               {0, 2, 634, 4.388, 419.485},
+    {0, 2, 549, 5.573, 3.932},                  {0, 2, 457, 1.268, 110.206},
+    {0, 2, 425, 0.209, 227.526},                {0, 2, 274, 4.288, 95.979},
+    {0, 2, 162, 1.381, 11.046},                 {0, 2, 129, 1.566, 309.278},
+    {0, 2, 117, 3.881, 853.196},                {0, 2, 105, 4.900, 647.011},
+    {0, 2, 101, 0.893, 21.341},                 {0, 2, 96, 2.91, 316.39},
+    {0, 2, 95, 5.63, 412.37},                   {0, 2, 85, 5.73, 209.37},
+    {0, 2, 83, 6.05, 216.48},                   {0, 2, 82, 1.02, 117.32},
+    {0, 2, 75, 4.76, 210.12},                   {0, 2, 67, 0.46, 522.58},
+    {0, 2, 66, 0.48, 10.29},                    {0, 2, 64, 0.35, 323.51},
+    {0, 2, 61, 4.88, 632.78},                   {0, 2, 53, 2.75, 529.69},
+    {0, 2, 46, 5.69, 440.83},                   {0, 2, 45, 1.67, 202.25},
+    {0, 2, 42, 5.71, 88.87},                    {0, 2, 32, 0.07, 63.74},
+    {0, 2, 32, 1.67, 302.16},                   {0, 2, 31, 4.16, 191.96},
+    {0, 2, 27, 0.83, 224.34},                   {0, 2, 25, 5.66, 735.88},
+    {0, 2, 20, 5.94, 217.23},                   {0, 2, 18, 4.90, 625.67},
+    {0, 2, 17, 1.63, 742.99},                   {0, 2, 16, 0.58, 515.46},
+    {0, 2, 14, 0.21, 838.97},                   {0, 2, 14, 3.76, 195.14},
+    {0, 2, 12, 4.72, 203.00},                   {0, 2, 12, 0.13, 234.64},
+    {0, 2, 12, 3.12, 846.08},                   {0, 2, 11, 5.92, 536.80},
+    {0, 2, 11, 5.60, 728.76},                   {0, 2, 11, 3.20, 1066.50},
+    {0, 2, 10, 4.99, 422.67},                   {0, 2, 10, 0.26, 330.62},
+    {0, 2, 10, 4.15, 860.31},                   {0, 2, 9, 0.46, 956.29},
+    {0, 2, 8, 2.14, 269.92},                    {0, 2, 8, 5.25, 429.78},
+    {0, 2, 8, 4.03, 9.56},                      {0, 2, 7, 5.40, 1052.27},
+    {0, 2, 6, 4.46, 284.15},                    {0, 2, 6, 5.93, 405.26},
+    {0, 3, 16039, 5.73945, 7.11355},            {0, 3, 4250, 4.5854, 213.2991},
+    {0, 3, 1907, 4.7608, 220.4126},             {0, 3, 1466, 5.9133, 206.1855},
+    {0, 3, 1162, 5.6197, 14.2271},              {0, 3, 1067, 3.6082, 426.5982},
+    {0, 3, 239, 3.861, 433.712},                {0, 3, 237, 5.768, 199.072},
+    {0, 3, 166, 5.116, 3.181},                  {0, 3, 151, 2.736, 639.897},
+    {0, 3, 131, 4.743, 227.526},                {0, 3, 63, 0.23, 419.48},
+    {0, 3, 62, 4.74, 103.09},                   {0, 3, 40, 5.47, 21.34},
+    {0, 3, 40, 5.96, 95.98},                    {0, 3, 39, 5.83, 110.21},
+    {0, 3, 28, 3.01, 647.01},                   {0, 3, 25, 0.99, 3.93},
+    {0, 3, 19, 1.92, 853.20},                   {0, 3, 18, 4.97, 10.29},
+    {0, 3, 18, 1.03, 412.37},                   {0, 3, 18, 4.20, 216.48},
+    {0, 3, 18, 3.32, 309.28},                   {0, 3, 16, 3.90, 440.83},
+    {0, 3, 16, 5.62, 117.32},                   {0, 3, 13, 1.18, 88.87},
+    {0, 3, 11, 5.58, 11.05},                    {0, 3, 11, 5.93, 191.96},
+    {0, 3, 10, 3.95, 209.37},                   {0, 3, 9, 3.39, 302.16},
+    {0, 3, 8, 4.88, 323.51},                    {0, 3, 7, 0.38, 632.78},
+    {0, 3, 6, 2.25, 522.58},                    {0, 3, 6, 1.06, 210.12},
+    {0, 3, 5, 4.64, 234.64},                    {0, 3, 4, 3.14, 0},
+    {0, 3, 4, 2.31, 515.46},                    {0, 3, 3, 2.20, 860.31},
+    {0, 3, 3, 0.59, 529.69},                    {0, 3, 3, 4.93, 224.34},
+    {0, 3, 3, 0.42, 625.67},                    {0, 3, 2, 4.77, 330.62},
+    {0, 3, 2, 3.35, 429.78},                    {0, 3, 2, 3.20, 202.25},
+    {0, 3, 2, 1.19, 1066.50},                   {0, 3, 2, 1.35, 405.26},
+    {0, 3, 2, 4.16, 223.59},                    {0, 3, 2, 3.07, 654.12},
+    {0, 4, 1662, 3.9983, 7.1135},               {0, 4, 257, 2.984, 220.413},
+    {0, 4, 236, 3.902, 14.227},                 {0, 4, 149, 2.741, 213.299},
+    {0, 4, 114, 3.142, 0},                      {0, 4, 110, 1.515, 206.186},
+    {0, 4, 68, 1.72, 426.60},                   {0, 4, 40, 2.05, 433.71},
+    {0, 4, 38, 1.24, 199.07},                   {0, 4, 31, 3.01, 227.53},
+    {0, 4, 15, 0.83, 639.90},                   {0, 4, 9, 3.71, 21.34},
+    {0, 4, 6, 2.42, 419.48},                    {0, 4, 6, 1.16, 647.01},
+    {0, 4, 4, 1.45, 95.98},                     {0, 4, 4, 2.12, 440.83},
+    {0, 4, 3, 4.09, 110.21},                    {0, 4, 3, 2.77, 412.37},
+    {0, 4, 3, 3.01, 88.87},                     {0, 4, 3, 0.00, 853.20},
+    {0, 4, 3, 0.39, 103.09},                    {0, 4, 2, 3.78, 117.32},
+    {0, 4, 2, 2.83, 234.64},                    {0, 4, 2, 5.08, 309.28},
+    {0, 4, 2, 2.24, 216.48},                    {0, 4, 2, 5.19, 302.16},
+    {0, 4, 1, 1.55, 191.96},                    {0, 5, 124, 2.259, 7.114},
+    {0, 5, 34, 2.16, 14.23},                    {0, 5, 28, 1.20, 220.41},
+    {0, 5, 6, 1.22, 227.53},                    {0, 5, 5, 0.24, 433.71},
+    {0, 5, 4, 6.23, 426.60},                    {0, 5, 3, 2.97, 199.07},
+    {0, 5, 3, 4.29, 206.19},                    {0, 5, 2, 6.25, 213.30},
+    {0, 5, 1, 5.28, 639.90},                    {0, 5, 1, 0.24, 440.83},
+    {0, 5, 1, 3.14, 0},                         {1, 0, 4330678, 3.6028443, 213.2990954},
+    {1, 0, 240348, 2.852385, 426.598191},       {1, 0, 84746, 0, 0},
+    {1, 0, 34116, 0.57297, 206.18555},          {1, 0, 30863, 3.48442, 220.41264},
+    {1, 0, 14734, 2.11847, 639.89729},          {1, 0, 9917, 5.7900, 419.4846},
+    {1, 0, 6994, 4.7360, 7.1135},               {1, 0, 4808, 5.4331, 316.3919},
+    {1, 0, 4788, 4.9651, 110.2063},             {1, 0, 3432, 2.7326, 433.7117},
+    {1, 0, 1506, 6.0130, 103.0928},             {1, 0, 1060, 5.6310, 529.6910},
+    {1, 0, 969, 5.204, 632.784},                {1, 0, 942, 1.396, 853.196},
+    {1, 0, 708, 3.803, 323.505},                {1, 0, 552, 5.131, 202.253},
+    {1, 0, 400, 3.359, 227.526},                {1, 0, 319, 3.626, 209.367},
+    {1, 0, 316, 1.997, 647.011},                {1, 0, 314, 0.465, 217.231},
+    {1, 0, 284, 4.886, 224.345},                {1, 0, 236, 2.139, 11.046},
+    {1, 0, 215, 5.950, 846.083},                {1, 0, 209, 2.120, 415.552},
+    {1, 0, 207, 0.730, 199.072},                {1, 0, 179, 2.954, 63.736},
+    {1, 0, 141, 0.644, 490.334},                {1, 0, 139, 4.595, 14.227},
+    {1, 0, 139, 1.998, 735.877},                {1, 0, 135, 5.245, 742.990},
+    {1, 0, 122, 3.115, 522.577},                {1, 0, 116, 3.109, 216.480},
+    {1, 0, 114, 0.963, 210.118},                {1, 1, 397555, 5.332900, 213.299095},
+    {1, 1, 49479, 3.14159, 0},                  {1, 1, 18572, 6.09919, 426.59819},
+    {1, 1, 14801, 2.30586, 206.18555},          {1, 1, 9644, 1.6967, 220.4126},
+    {1, 1, 3757, 1.2543, 419.4846},             {1, 1, 2717, 5.9117, 639.8973},
+    {1, 1, 1455, 0.8516, 433.7117},             {1, 1, 1291, 2.9177, 7.1135},
+    {1, 1, 853, 0.436, 316.392},                {1, 1, 298, 0.919, 632.784},
+    {1, 1, 292, 5.316, 853.196},                {1, 1, 284, 1.619, 227.526},
+    {1, 1, 275, 3.889, 103.093},                {1, 1, 172, 0.052, 647.011},
+    {1, 1, 166, 2.444, 199.072},                {1, 1, 158, 5.209, 110.206},
+    {1, 1, 128, 1.207, 529.691},                {1, 1, 110, 2.457, 217.231},
+    {1, 1, 82, 2.76, 210.12},                   {1, 1, 81, 2.86, 14.23},
+    {1, 1, 69, 1.66, 202.25},                   {1, 1, 65, 1.26, 216.48},
+    {1, 1, 61, 1.25, 209.37},                   {1, 1, 59, 1.82, 323.51},
+    {1, 1, 46, 0.82, 440.83},                   {1, 1, 36, 1.82, 224.34},
+    {1, 1, 34, 2.84, 117.32},                   {1, 1, 33, 1.31, 412.37},
+    {1, 1, 32, 1.19, 846.08},                   {1, 1, 27, 4.65, 1066.50},
+    {1, 1, 27, 4.44, 11.05},                    {1, 2, 20630, 0.50482, 213.29910},
+    {1, 2, 3720, 3.9983, 206.1855},             {1, 2, 1627, 6.1819, 220.4126},
+    {1, 2, 1346, 0, 0},                         {1, 2, 706, 3.039, 419.485},
+    {1, 2, 365, 5.099, 426.598},                {1, 2, 330, 5.279, 433.712},
+    {1, 2, 219, 3.828, 639.897},                {1, 2, 139, 1.043, 7.114},
+    {1, 2, 104, 6.157, 227.526},                {1, 2, 93, 1.98, 316.39},
+    {1, 2, 71, 4.15, 199.07},                   {1, 2, 52, 2.88, 632.78},
+    {1, 2, 49, 4.43, 647.01},                   {1, 2, 41, 3.16, 853.20},
+    {1, 2, 29, 4.53, 210.12},                   {1, 2, 24, 1.12, 14.23},
+    {1, 2, 21, 4.35, 217.23},                   {1, 2, 20, 5.31, 440.83},
+    {1, 2, 18, 0.85, 110.21},                   {1, 2, 17, 5.68, 216.48},
+    {1, 2, 16, 4.26, 103.09},                   {1, 2, 14, 3.00, 412.37},
+    {1, 2, 12, 2.53, 529.69},                   {1, 2, 8, 3.32, 202.25},
+    {1, 2, 7, 5.56, 209.37},                    {1, 2, 7, 0.29, 323.51},
+    {1, 2, 6, 1.16, 117.32},                    {1, 2, 6, 3.61, 860.31},
+    {1, 3, 666, 1.990, 213.299},                {1, 3, 632, 5.698, 206.186},
+    {1, 3, 398, 0, 0},                          {1, 3, 188, 4.338, 220.413},
+    {1, 3, 92, 4.84, 419.48},                   {1, 3, 52, 3.42, 433.71},
+    {1, 3, 42, 2.38, 426.60},                   {1, 3, 26, 4.40, 227.53},
+    {1, 3, 21, 5.85, 199.07},                   {1, 3, 18, 1.99, 639.90},
+    {1, 3, 11, 5.37, 7.11},                     {1, 4, 80, 1.12, 206.19},
+    {1, 4, 32, 3.14, 0},                        {1, 4, 17, 2.48, 220.41},
+    {1, 4, 12, 3.14, 213.30},                   {1, 4, 9, 0.38, 419.48},
+    {1, 4, 6, 1.56, 433.71},                    {1, 4, 5, 2.63, 227.53},
+    {1, 4, 5, 1.28, 199.07},                    {1, 4, 1, 1.43, 426.60},
+    {1, 4, 1, 0.67, 647.01},                    {1, 4, 1, 1.72, 440.83},
+    {1, 4, 1, 6.18, 639.90},                    {1, 5, 8, 2.82, 206.19},
+    {1, 5, 1, 0.51, 220.41},                    {2, 0, 955758136, 0, 0},
+    {2, 0, 52921382, 2.39226220, 213.29909544}, {2, 0, 1873680, 5.2354961, 206.1855484},
+    {2, 0, 1464664, 1.6476305, 426.5981909},    {2, 0, 821891, 5.935200, 316.391870},
+    {2, 0, 547507, 5.015326, 103.092774},       {2, 0, 371684, 2.271148, 220.412642},
+    {2, 0, 361778, 3.139043, 7.113547},         {2, 0, 140618, 5.704067, 632.783739},
+    {2, 0, 108975, 3.293136, 110.206321},       {2, 0, 69007, 5.94100, 419.48464},
+    {2, 0, 61053, 0.94038, 639.89729},          {2, 0, 48913, 1.55733, 202.25340},
+    {2, 0, 34144, 0.19519, 277.03499},          {2, 0, 32402, 5.47085, 949.17561},
+    {2, 0, 20937, 0.46349, 735.87651},          {2, 0, 20839, 1.52103, 433.71174},
+    {2, 0, 20747, 5.33256, 199.07200},          {2, 0, 15298, 3.05944, 529.69097},
+    {2, 0, 14296, 2.60434, 323.50542},          {2, 0, 12884, 1.64892, 138.51750},
+    {2, 0, 11993, 5.98051, 846.08283},          {2, 0, 11380, 1.73106, 522.57742},
+    {2, 0, 9796, 5.2048, 1265.5675},            {2, 0, 7753, 5.8519, 95.9792},
+    {2, 0, 6771, 3.0043, 14.2271},              {2, 0, 6466, 0.1773, 1052.2684},
+    {2, 0, 5850, 1.4552, 415.5525},             {2, 0, 5307, 0.5974, 63.7359},
+    {2, 0, 4696, 2.1492, 227.5262},             {2, 0, 4044, 1.6401, 209.3669},
+    {2, 0, 3688, 0.7802, 412.3711},             {2, 0, 3461, 1.8509, 175.1661},
+    {2, 0, 3420, 4.9455, 1581.9593},            {2, 0, 3401, 0.5539, 350.3321},
+    {2, 0, 3376, 3.6953, 224.3448},             {2, 0, 2976, 5.6847, 210.1177},
+    {2, 0, 2885, 1.3876, 838.9693},             {2, 0, 2881, 0.1796, 853.1964},
+    {2, 0, 2508, 3.5385, 742.9901},             {2, 0, 2448, 6.1841, 1368.6603},
+    {2, 0, 2406, 2.9656, 117.3199},             {2, 0, 2174, 0.0151, 340.7709},
+    {2, 0, 2024, 5.0541, 11.0457},              {2, 1, 6182981, 0.2584352, 213.2990954},
+    {2, 1, 506578, 0.711147, 206.185548},       {2, 1, 341394, 5.796358, 426.598191},
+    {2, 1, 188491, 0.472157, 220.412642},       {2, 1, 186262, 3.141593, 0},
+    {2, 1, 143891, 1.407449, 7.113547},         {2, 1, 49621, 6.01744, 103.09277},
+    {2, 1, 20928, 5.09246, 639.89729},          {2, 1, 19953, 1.17560, 419.48464},
+    {2, 1, 18840, 1.60820, 110.20632},          {2, 1, 13877, 0.75886, 199.07200},
+    {2, 1, 12893, 5.94330, 433.71174},          {2, 1, 5397, 1.2885, 14.2271},
+    {2, 1, 4869, 0.8679, 323.5054},             {2, 1, 4247, 0.3930, 227.5262},
+    {2, 1, 3252, 1.2585, 95.9792},              {2, 1, 3081, 3.4366, 522.5774},
+    {2, 1, 2909, 4.6068, 202.2534},             {2, 1, 2856, 2.1673, 735.8765},
+    {2, 1, 1988, 2.4505, 412.3711},             {2, 1, 1941, 6.0239, 209.3669},
+    {2, 1, 1581, 1.2919, 210.1177},             {2, 1, 1340, 4.3080, 853.1964},
+    {2, 1, 1316, 1.2530, 117.3199},             {2, 1, 1203, 1.8665, 316.3919},
+    {2, 1, 1091, 0.0753, 216.4805},             {2, 1, 966, 0.480, 632.784},
+    {2, 1, 954, 5.152, 647.011},                {2, 1, 898, 0.983, 529.691},
+    {2, 1, 882, 1.885, 1052.268},               {2, 1, 874, 1.402, 224.345},
+    {2, 1, 785, 3.064, 838.969},                {2, 1, 740, 1.382, 625.670},
+    {2, 1, 658, 4.144, 309.278},                {2, 1, 650, 1.725, 742.990},
+    {2, 1, 613, 3.033, 63.736},                 {2, 1, 599, 2.549, 217.231},
+    {2, 1, 503, 2.130, 3.932},                  {2, 2, 436902, 4.786717, 213.299095},
+    {2, 2, 71923, 2.50070, 206.18555},          {2, 2, 49767, 4.97168, 220.41264},
+    {2, 2, 43221, 3.86940, 426.59819},          {2, 2, 29646, 5.96310, 7.11355},
+    {2, 2, 4721, 2.4753, 199.0720},             {2, 2, 4142, 4.1067, 433.7117},
+    {2, 2, 3789, 3.0977, 639.8973},             {2, 2, 2964, 1.3721, 103.0928},
+    {2, 2, 2556, 2.8507, 419.4846},             {2, 2, 2327, 0, 0},
+    {2, 2, 2208, 6.2759, 110.2063},             {2, 2, 2188, 5.8555, 14.2271},
+    {2, 2, 1957, 4.9245, 227.5262},             {2, 2, 924, 5.464, 323.505},
+    {2, 2, 706, 2.971, 95.979},                 {2, 2, 546, 4.129, 412.371},
+    {2, 2, 431, 5.178, 522.577},                {2, 2, 405, 4.173, 209.367},
+    {2, 2, 391, 4.481, 216.480},                {2, 2, 374, 5.834, 117.320},
+    {2, 2, 361, 3.277, 647.011},                {2, 2, 356, 3.192, 210.118},
+    {2, 2, 326, 2.269, 853.196},                {2, 2, 207, 4.022, 735.877},
+    {2, 2, 204, 0.088, 202.253},                {2, 2, 180, 3.597, 632.784},
+    {2, 2, 178, 4.097, 440.825},                {2, 2, 154, 3.135, 625.670},
+    {2, 2, 148, 0.136, 302.165},                {2, 2, 133, 2.594, 191.958},
+    {2, 2, 132, 5.933, 309.278},                {2, 3, 20315, 3.02187, 213.29910},
+    {2, 3, 8924, 3.1914, 220.4126},             {2, 3, 6909, 4.3517, 206.1855},
+    {2, 3, 4087, 4.2241, 7.1135},               {2, 3, 3879, 2.0106, 426.5982},
+    {2, 3, 1071, 4.2036, 199.0720},             {2, 3, 907, 2.283, 433.712},
+    {2, 3, 606, 3.175, 227.526},                {2, 3, 597, 4.135, 14.227},
+    {2, 3, 483, 1.173, 639.897},                {2, 3, 393, 0, 0},
+    {2, 3, 229, 4.698, 419.485},                {2, 3, 188, 4.590, 110.206},
+    {2, 3, 150, 3.202, 103.093},                {2, 3, 121, 3.768, 323.505},
+    {2, 3, 102, 4.710, 95.979},                 {2, 3, 101, 5.819, 412.371},
+    {2, 3, 93, 1.44, 647.01},                   {2, 3, 84, 2.63, 216.48},
+    {2, 3, 73, 4.15, 117.32},                   {2, 3, 62, 2.31, 440.83},
+    {2, 3, 55, 0.31, 853.20},                   {2, 3, 50, 2.39, 209.37},
+    {2, 3, 45, 4.37, 191.96},                   {2, 3, 41, 0.69, 522.58},
+    {2, 3, 40, 1.84, 302.16},                   {2, 3, 38, 5.94, 88.87},
+    {2, 3, 32, 4.01, 21.34},                    {2, 4, 1202, 1.4150, 220.4126},
+    {2, 4, 708, 1.162, 213.299},                {2, 4, 516, 6.240, 206.186},
+    {2, 4, 427, 2.469, 7.114},                  {2, 4, 268, 0.187, 426.598},
+    {2, 4, 170, 5.959, 199.072},                {2, 4, 150, 0.480, 433.712},
+    {2, 4, 145, 1.442, 227.526},                {2, 4, 121, 2.405, 14.227},
+    {2, 4, 47, 5.57, 639.90},                   {2, 4, 19, 5.86, 647.01},
+    {2, 4, 17, 0.53, 440.83},                   {2, 4, 16, 2.90, 110.21},
+    {2, 4, 15, 0.30, 419.48},                   {2, 4, 14, 1.30, 412.37},
+    {2, 4, 13, 2.09, 323.51},                   {2, 4, 11, 0.22, 95.98},
+    {2, 4, 11, 2.46, 117.32},                   {2, 4, 10, 3.14, 0},
+    {2, 4, 9, 1.56, 88.87},                     {2, 4, 9, 2.28, 21.34},
+    {2, 4, 9, 0.68, 216.48},                    {2, 4, 8, 1.27, 234.64},
+    {2, 5, 129, 5.913, 220.413},                {2, 5, 32, 0.69, 7.11},
+    {2, 5, 27, 5.91, 227.53},                   {2, 5, 20, 4.95, 433.71},
+    {2, 5, 20, 0.67, 14.23},                    {2, 5, 14, 2.67, 206.19},
+    {2, 5, 14, 1.46, 199.07},                   {2, 5, 13, 4.59, 426.60},
+    {2, 5, 7, 4.63, 213.30},                    {2, 5, 5, 3.61, 639.90},
+    {2, 5, 4, 4.90, 440.83},                    {2, 5, 3, 4.07, 647.01},
+    {2, 5, 3, 4.66, 191.96},                    {2, 5, 3, 0.49, 323.51},
+    {2, 5, 3, 3.18, 419.48},                    {2, 5, 2, 3.70, 88.87},
+    {2, 5, 2, 3.32, 95.98},                     {2, 5, 2, 0.56, 117.32},
+};
+
+// Urano: 393 termos.
+const Vsop87TableTerm VSOP87D_URANUS[393] = {
+    {0, 0, 548129294, 0, 0},                   {0, 0, 9260408, 0.8910642, 74.7815986},
+    {0, 0, 1504248, 3.6271926, 1.4844727},     {0, 0, 365982, 1.899622, 73.297126},
+    {0, 0, 272328, 3.358237, 149.563197},      {0, 0, 70328, 5.39254, 63.73590},
+    {0, 0, 68893, 6.09292, 76.26607},          {0, 0, 61999, 2.26952, 2.96895},
+    {0, 0, 61951, 2.85099, 11.04570},          {0, 0, 26469, 3.14152, 71.81265},
+    {0, 0, 25711, 6.11380, 454.90937},         {0, 0, 21079, 4.36059, 148.07872},
+    {0, 0, 17819, 1.74437, 36.64856},          {0, 0, 14613, 4.73732, 3.93215},
+    {0, 0, 11163, 5.82682, 224.34480},         {0, 0, 10998, 0.48865, 138.51750},
+    {0, 0, 9527, 2.9552, 35.1641},             {0, 0, 7546, 5.2363, 109.9457},
+    {0, 0, 4220, 3.2333, 70.8494},             {0, 0, 4052, 2.2775, 151.0477},
+    {0, 0, 3490, 5.4831, 146.5943},            {0, 0, 3355, 1.0655, 4.4534},
+    {0, 0, 3144, 4.7520, 77.7505},             {0, 0, 2927, 4.6290, 9.5612},
+    {0, 0, 2922, 5.3524, 85.8273},             {0, 0, 2273, 4.3660, 70.3282},
+    {0, 0, 2149, 0.6075, 38.1330},             {0, 0, 2051, 1.5177, 0.1119},
+    {0, 0, 1992, 4.9244, 277.0350},            {0, 0, 1667, 3.6274, 380.1278},
+    {0, 0, 1533, 2.5859, 52.6902},             {0, 0, 1376, 2.0428, 65.2204},
+    {0, 0, 1372, 4.1964, 111.4302},            {0, 0, 1284, 3.1135, 202.2534},
+    {0, 0, 1282, 0.5427, 222.8603},            {0, 0, 1244, 0.9161, 2.4477},
+    {0, 0, 1221, 0.1990, 108.4612},            {0, 0, 1151, 4.1790, 33.6796},
+    {0, 0, 1150, 0.9334, 3.1814},              {0, 0, 1090, 1.7750, 12.5302},
+    {0, 0, 1072, 0.2356, 62.2515},             {0, 0, 946, 1.192, 127.472},
+    {0, 0, 708, 5.183, 213.299},               {0, 0, 653, 0.966, 78.714},
+    {0, 0, 628, 0.182, 984.600},               {0, 0, 607, 5.432, 529.691},
+    {0, 0, 559, 3.358, 0.521},                 {0, 0, 524, 2.013, 299.126},
+    {0, 0, 483, 2.106, 0.963},                 {0, 0, 471, 1.407, 184.727},
+    {0, 0, 467, 0.415, 145.110},               {0, 0, 434, 5.521, 183.243},
+    {0, 0, 405, 5.987, 8.077},                 {0, 0, 399, 0.338, 415.552},
+    {0, 0, 396, 5.870, 351.817},               {0, 0, 379, 2.350, 56.622},
+    {0, 0, 310, 5.833, 145.631},               {0, 0, 300, 5.644, 22.091},
+    {0, 0, 294, 5.839, 39.618},                {0, 0, 252, 1.637, 221.376},
+    {0, 0, 249, 4.746, 225.829},               {0, 0, 239, 2.350, 137.033},
+    {0, 0, 224, 0.516, 84.343},                {0, 0, 223, 2.843, 0.261},
+    {0, 0, 220, 1.922, 67.668},                {0, 0, 217, 6.142, 5.938},
+    {0, 0, 216, 4.779, 340.771},               {0, 0, 208, 5.580, 68.844},
+    {0, 0, 202, 1.297, 0.048},                 {0, 0, 199, 0.956, 152.532},
+    {0, 0, 194, 1.888, 456.394},               {0, 0, 193, 0.916, 453.425},
+    {0, 0, 187, 1.319, 0.160},                 {0, 0, 182, 3.536, 79.235},
+    {0, 0, 173, 1.539, 160.609},               {0, 0, 172, 5.680, 219.891},
+    {0, 0, 170, 3.677, 5.417},                 {0, 0, 169, 5.879, 18.159},
+    {0, 0, 165, 1.424, 106.977},               {0, 0, 163, 3.050, 112.915},
+    {0, 0, 158, 0.738, 54.175},                {0, 0, 147, 1.263, 59.804},
+    {0, 0, 143, 1.300, 35.425},                {0, 0, 139, 5.386, 32.195},
+    {0, 0, 139, 4.260, 909.819},               {0, 0, 124, 1.374, 7.114},
+    {0, 0, 110, 2.027, 554.070},               {0, 0, 109, 5.706, 77.963},
+    {0, 0, 104, 5.028, 0.751},                 {0, 0, 104, 1.458, 24.379},
+    {0, 0, 103, 0.681, 14.978},                {0, 1, 7502543122, 0, 0},
+    {0, 1, 154458, 5.242017, 74.781599},       {0, 1, 24456, 1.71256, 1.48447},
+    {0, 1, 9258, 0.4284, 11.0457},             {0, 1, 8266, 1.5022, 63.7359},
+    {0, 1, 7842, 1.3198, 149.5632},            {0, 1, 3899, 0.4648, 3.9322},
+    {0, 1, 2284, 4.1737, 76.2661},             {0, 1, 1927, 0.5301, 2.9689},
+    {0, 1, 1233, 1.5863, 70.8494},             {0, 1, 791, 5.436, 3.181},
+    {0, 1, 767, 1.996, 73.297},                {0, 1, 482, 2.984, 85.827},
+    {0, 1, 450, 4.138, 138.517},               {0, 1, 446, 3.723, 224.345},
+    {0, 1, 427, 4.731, 71.813},                {0, 1, 354, 2.583, 148.079},
+    {0, 1, 348, 2.454, 9.561},                 {0, 1, 317, 5.579, 52.690},
+    {0, 1, 206, 2.363, 2.448},                 {0, 1, 189, 4.202, 56.622},
+    {0, 1, 184, 0.284, 151.048},               {0, 1, 180, 5.684, 12.530},
+    {0, 1, 171, 3.001, 78.714},                {0, 1, 158, 2.909, 0.963},
+    {0, 1, 155, 5.591, 4.453},                 {0, 1, 154, 4.652, 35.164},
+    {0, 1, 152, 2.942, 77.751},                {0, 1, 143, 2.590, 62.251},
+    {0, 1, 121, 4.148, 127.472},               {0, 1, 116, 3.732, 65.220},
+    {0, 1, 102, 4.188, 145.631},               {0, 1, 102, 6.034, 0.112},
+    {0, 1, 88, 3.99, 18.16},                   {0, 1, 88, 6.16, 202.25},
+    {0, 1, 81, 2.64, 22.09},                   {0, 1, 72, 6.05, 70.33},
+    {0, 1, 69, 4.05, 77.96},                   {0, 1, 59, 3.70, 67.67},
+    {0, 1, 47, 3.54, 351.82},                  {0, 1, 44, 5.91, 7.11},
+    {0, 1, 43, 5.72, 5.42},                    {0, 1, 39, 4.92, 222.86},
+    {0, 1, 36, 5.90, 33.68},                   {0, 1, 36, 3.29, 8.08},
+    {0, 1, 36, 3.33, 71.60},                   {0, 1, 35, 5.08, 38.13},
+    {0, 1, 31, 5.62, 984.60},                  {0, 1, 31, 5.50, 59.80},
+    {0, 1, 31, 5.46, 160.61},                  {0, 1, 30, 1.66, 447.80},
+    {0, 1, 29, 1.15, 462.02},                  {0, 1, 29, 4.52, 84.34},
+    {0, 1, 27, 5.54, 131.40},                  {0, 1, 27, 6.15, 299.13},
+    {0, 1, 26, 4.99, 137.03},                  {0, 1, 25, 5.74, 380.13},
+    {0, 2, 53033, 0, 0},                       {0, 2, 2358, 2.2601, 74.7816},
+    {0, 2, 769, 4.526, 11.046},                {0, 2, 552, 3.258, 63.736},
+    {0, 2, 542, 2.276, 3.932},                 {0, 2, 529, 4.923, 1.484},
+    {0, 2, 258, 3.691, 3.181},                 {0, 2, 239, 5.858, 149.563},
+    {0, 2, 182, 6.218, 70.849},                {0, 2, 54, 1.44, 76.27},
+    {0, 2, 49, 6.03, 56.62},                   {0, 2, 45, 3.91, 2.45},
+    {0, 2, 45, 0.81, 85.83},                   {0, 2, 38, 1.78, 52.69},
+    {0, 2, 37, 4.46, 2.97},                    {0, 2, 33, 0.86, 9.56},
+    {0, 2, 29, 5.10, 73.30},                   {0, 2, 24, 2.11, 18.16},
+    {0, 2, 22, 5.99, 138.52},                  {0, 2, 22, 4.82, 78.71},
+    {0, 2, 21, 2.40, 77.96},                   {0, 2, 21, 2.17, 224.34},
+    {0, 2, 17, 2.54, 145.63},                  {0, 2, 17, 3.47, 12.53},
+    {0, 2, 12, 0.02, 22.09},                   {0, 2, 11, 0.08, 127.47},
+    {0, 2, 10, 5.16, 71.60},                   {0, 2, 10, 4.46, 62.25},
+    {0, 2, 9, 4.26, 7.11},                     {0, 2, 8, 5.50, 67.67},
+    {0, 2, 7, 1.25, 5.42},                     {0, 2, 6, 3.36, 447.80},
+    {0, 2, 6, 5.45, 65.22},                    {0, 2, 6, 4.52, 151.05},
+    {0, 2, 6, 5.73, 462.02},                   {0, 3, 121, 0.024, 74.782},
+    {0, 3, 68, 4.12, 3.93},                    {0, 3, 53, 2.39, 11.05},
+    {0, 3, 46, 0, 0},                          {0, 3, 45, 2.04, 3.18},
+    {0, 3, 44, 2.96, 1.48},                    {0, 3, 25, 4.89, 63.74},
+    {0, 3, 21, 4.55, 70.85},                   {0, 3, 20, 2.31, 149.56},
+    {0, 3, 9, 1.58, 56.62},                    {0, 3, 4, 0.23, 18.16},
+    {0, 3, 4, 5.39, 76.27},                    {0, 3, 4, 0.95, 77.96},
+    {0, 3, 3, 4.98, 85.83},                    {0, 3, 3, 4.13, 52.69},
+    {0, 3, 3, 0.37, 78.71},                    {0, 3, 2, 0.86, 145.63},
+    {0, 3, 2, 5.66, 9.56},                     {0, 4, 114, 3.142, 0},
+    {0, 4, 6, 4.58, 74.78},                    {0, 4, 3, 0.35, 11.05},
+    {0, 4, 1, 3.42, 56.62},                    {1, 0, 1346278, 2.6187781, 74.7815986},
+    {1, 0, 62341, 5.08111, 149.56320},         {1, 0, 61601, 3.14159, 0},
+    {1, 0, 9964, 1.6160, 76.2661},             {1, 0, 9926, 0.5763, 73.2971},
+    {1, 0, 3259, 1.2612, 224.3448},            {1, 0, 2972, 2.2437, 1.4845},
+    {1, 0, 2010, 6.0555, 148.0787},            {1, 0, 1522, 0.2796, 63.7359},
+    {1, 0, 924, 4.038, 151.048},               {1, 0, 761, 6.140, 71.813},
+    {1, 0, 522, 3.321, 138.517},               {1, 0, 463, 0.743, 85.827},
+    {1, 0, 437, 3.381, 529.691},               {1, 0, 435, 0.341, 77.751},
+    {1, 0, 431, 3.554, 213.299},               {1, 0, 420, 5.213, 11.046},
+    {1, 0, 245, 0.788, 2.969},                 {1, 0, 233, 2.257, 222.860},
+    {1, 0, 216, 1.591, 38.133},                {1, 0, 180, 3.725, 299.126},
+    {1, 0, 175, 1.236, 146.594},               {1, 0, 174, 1.937, 380.128},
+    {1, 0, 160, 5.336, 111.430},               {1, 0, 144, 5.962, 35.164},
+    {1, 0, 116, 5.739, 70.849},                {1, 0, 106, 0.941, 70.328},
+    {1, 0, 102, 2.619, 78.714},                {1, 1, 206366, 4.123943, 74.781599},
+    {1, 1, 8563, 0.3382, 149.5632},            {1, 1, 1726, 2.1219, 73.2971},
+    {1, 1, 1374, 0, 0},                        {1, 1, 1369, 3.0686, 76.2661},
+    {1, 1, 451, 3.777, 1.484},                 {1, 1, 400, 2.848, 224.345},
+    {1, 1, 307, 1.255, 148.079},               {1, 1, 154, 3.786, 63.736},
+    {1, 1, 112, 5.573, 151.048},               {1, 1, 111, 5.329, 138.517},
+    {1, 1, 83, 3.59, 71.81},                   {1, 1, 56, 3.40, 85.83},
+    {1, 1, 54, 1.70, 77.75},                   {1, 1, 42, 1.21, 11.05},
+    {1, 1, 41, 4.45, 78.71},                   {1, 1, 32, 3.77, 222.86},
+    {1, 1, 30, 2.56, 2.97},                    {1, 1, 27, 5.34, 213.30},
+    {1, 1, 26, 0.42, 380.13},                  {1, 2, 9212, 5.8004, 74.7816},
+    {1, 2, 557, 0, 0},                         {1, 2, 286, 2.177, 149.563},
+    {1, 2, 95, 3.84, 73.30},                   {1, 2, 45, 4.88, 76.27},
+    {1, 2, 20, 5.46, 1.48},                    {1, 2, 15, 0.88, 138.52},
+    {1, 2, 14, 2.85, 148.08},                  {1, 2, 14, 5.07, 63.74},
+    {1, 2, 10, 5.00, 224.34},                  {1, 2, 8, 6.27, 78.71},
+    {1, 3, 268, 1.251, 74.782},                {1, 3, 11, 3.14, 0},
+    {1, 3, 6, 4.01, 149.56},                   {1, 3, 3, 5.78, 73.30},
+    {1, 4, 6, 2.85, 74.78},                    {2, 0, 1921264848, 0, 0},
+    {2, 0, 88784984, 5.60377527, 74.78159857}, {2, 0, 3440836, 0.3283610, 73.2971259},
+    {2, 0, 2055653, 1.7829517, 149.5631971},   {2, 0, 649322, 4.522473, 76.266071},
+    {2, 0, 602248, 3.860038, 63.735898},       {2, 0, 496404, 1.401399, 454.909367},
+    {2, 0, 338526, 1.580027, 138.517497},      {2, 0, 243508, 1.570866, 71.812653},
+    {2, 0, 190522, 1.998094, 1.484473},        {2, 0, 161858, 2.791379, 148.078724},
+    {2, 0, 143706, 1.383686, 11.045700},       {2, 0, 93192, 0.17437, 36.64856},
+    {2, 0, 89806, 3.66105, 109.94569},         {2, 0, 71424, 4.24509, 224.34480},
+    {2, 0, 46677, 1.39977, 35.16409},          {2, 0, 39026, 3.36235, 277.03499},
+    {2, 0, 39010, 1.66971, 70.84945},          {2, 0, 36755, 3.88649, 146.59425},
+    {2, 0, 30349, 0.70100, 151.04767},         {2, 0, 29156, 3.18056, 77.75054},
+    {2, 0, 25786, 3.78538, 85.82730},          {2, 0, 25620, 5.25656, 380.12777},
+    {2, 0, 22637, 0.72519, 529.69097},         {2, 0, 20473, 2.79640, 70.32818},
+    {2, 0, 20472, 1.55589, 202.25340},         {2, 0, 17901, 0.55455, 2.96895},
+    {2, 0, 15503, 5.35405, 38.13304},          {2, 0, 14702, 4.90434, 108.46122},
+    {2, 0, 12897, 2.62154, 111.43016},         {2, 0, 12328, 5.96039, 127.47180},
+    {2, 0, 11959, 1.75044, 984.60033},         {2, 0, 11853, 0.99343, 52.69020},
+    {2, 0, 11696, 3.29826, 3.93215},           {2, 0, 11495, 0.43774, 65.22037},
+    {2, 0, 10793, 1.42105, 213.29910},         {2, 0, 9111, 4.9964, 62.2514},
+    {2, 0, 8421, 5.2535, 222.8603},            {2, 0, 8402, 5.0388, 415.5525},
+    {2, 0, 7449, 0.7949, 351.8166},            {2, 0, 7329, 3.9728, 183.2428},
+    {2, 0, 6046, 5.6796, 78.7138},             {2, 0, 5524, 3.1150, 9.5612},
+    {2, 0, 5445, 5.1058, 145.1098},            {2, 0, 5238, 2.6296, 33.6796},
+    {2, 0, 4079, 3.2206, 340.7709},            {2, 0, 3919, 4.2502, 39.6175},
+    {2, 0, 3802, 6.1099, 184.7273},            {2, 0, 3781, 3.4584, 456.3938},
+    {2, 0, 3687, 2.4872, 453.4249},            {2, 0, 3102, 4.1403, 219.8914},
+    {2, 0, 2963, 0.8298, 56.6224},             {2, 0, 2942, 0.4239, 299.1264},
+    {2, 0, 2940, 2.1464, 137.0330},            {2, 0, 2938, 3.6766, 140.0020},
+    {2, 0, 2865, 0.3100, 12.5302},             {2, 0, 2538, 4.8546, 131.4039},
+    {2, 0, 2364, 0.4425, 554.0700},            {2, 0, 2183, 2.9404, 305.3462},
+    {2, 1, 1479896, 3.6720571, 74.7815986},    {2, 1, 71212, 6.22601, 63.73590},
+    {2, 1, 68627, 6.13411, 149.56320},         {2, 1, 24060, 3.14159, 0},
+    {2, 1, 21468, 2.60177, 76.26607},          {2, 1, 20857, 5.24625, 11.04570},
+    {2, 1, 11405, 0.01848, 70.84945},          {2, 1, 7497, 0.4236, 73.2971},
+    {2, 1, 4244, 1.4169, 85.8273},             {2, 1, 3927, 3.1551, 71.8127},
+    {2, 1, 3578, 2.3116, 224.3448},            {2, 1, 3506, 2.5835, 138.5175},
+    {2, 1, 3229, 5.2550, 3.9322},              {2, 1, 3060, 0.1532, 1.4845},
+    {2, 1, 2564, 0.9808, 148.0787},            {2, 1, 2429, 3.9944, 52.6902},
+    {2, 1, 1645, 2.6535, 127.4718},            {2, 1, 1584, 1.4305, 78.7138},
+    {2, 1, 1508, 5.0600, 151.0477},            {2, 1, 1490, 2.6756, 56.6224},
+    {2, 1, 1413, 4.5746, 202.2534},            {2, 1, 1403, 1.3699, 77.7505},
+    {2, 1, 1228, 1.0470, 62.2514},             {2, 1, 1033, 0.2646, 131.4039},
+    {2, 1, 992, 2.172, 65.220},                {2, 1, 862, 5.055, 351.817},
+    {2, 1, 744, 3.076, 35.164},                {2, 1, 687, 2.499, 77.963},
+    {2, 1, 647, 4.473, 70.328},                {2, 1, 624, 0.863, 9.561},
+    {2, 1, 604, 0.907, 984.600},               {2, 1, 575, 3.231, 447.796},
+    {2, 1, 562, 2.718, 462.023},               {2, 1, 530, 5.917, 213.299},
+    {2, 1, 528, 5.151, 2.969},                 {2, 2, 22440, 0.69953, 74.78160},
+    {2, 2, 4727, 1.6990, 63.7359},             {2, 2, 1682, 4.6483, 70.8494},
+    {2, 2, 1650, 3.0966, 11.0457},             {2, 2, 1434, 3.5212, 149.5632},
+    {2, 2, 770, 0, 0},                         {2, 2, 500, 6.172, 76.266},
+    {2, 2, 461, 0.767, 3.932},                 {2, 2, 390, 4.496, 56.622},
+    {2, 2, 390, 5.527, 85.827},                {2, 2, 292, 0.204, 52.690},
+    {2, 2, 287, 3.534, 73.297},                {2, 2, 273, 3.847, 138.517},
+    {2, 2, 220, 1.964, 131.404},               {2, 2, 216, 0.848, 77.963},
+    {2, 2, 205, 3.248, 78.714},                {2, 2, 149, 4.898, 127.472},
+    {2, 2, 129, 2.081, 3.181},                 {2, 3, 1164, 4.7345, 74.7816},
+    {2, 3, 212, 3.343, 63.736},                {2, 3, 196, 2.980, 70.849},
+    {2, 3, 105, 0.958, 11.046},                {2, 3, 73, 1.00, 149.56},
+    {2, 3, 72, 0.03, 56.62},                   {2, 3, 55, 2.59, 3.93},
+    {2, 3, 36, 5.65, 77.96},                   {2, 3, 34, 3.82, 76.27},
+    {2, 3, 32, 3.60, 131.40},                  {2, 4, 53, 3.01, 74.78},
+    {2, 4, 10, 1.91, 56.62},
+};
+
+// Netuno: 162 termos.
+const Vsop87TableTerm VSOP87D_NEPTUNE[162] = {
+    {0, 0, 531188633, 0, 0},                   {0, 0, 1798476, 2.9010127, 38.1330356},
+    {0, 0, 1019728, 0.4858092, 1.4844727},     {0, 0, 124532, 4.830081, 36.648563},
+    {0, 0, 42064, 5.41055, 2.96895},           {0, 0, 37715, 6.09222, 35.16409},
+    {0, 0, 33785, 1.24489, 76.26607},          {0, 0, 16483, 0.00008, 491.55793},
+    {0, 0, 9199, 4.9375, 39.6175},             {0, 0, 8994, 0.2746, 175.1661},
+    {0, 0, 4216, 1.9871, 73.2971},             {0, 0, 3365, 1.0359, 33.6796},
+    {0, 0, 2285, 4.2061, 4.4534},              {0, 0, 1434, 2.7834, 74.7816},
+    {0, 0, 900, 2.076, 109.946},               {0, 0, 745, 3.190, 71.813},
+    {0, 0, 506, 5.748, 114.399},               {0, 0, 400, 0.350, 1021.249},
+    {0, 0, 345, 3.462, 41.102},                {0, 0, 340, 3.304, 77.751},
+    {0, 0, 323, 2.248, 32.165},                {0, 0, 306, 0.497, 0.521},
+    {0, 0, 287, 4.505, 0.048},                 {0, 0, 282, 2.246, 146.594},
+    {0, 0, 267, 4.889, 0.963},                 {0, 0, 252, 5.782, 388.465},
+    {0, 0, 245, 1.247, 9.561},                 {0, 0, 233, 2.505, 137.033},
+    {0, 0, 227, 1.797, 453.425},               {0, 0, 170, 3.324, 108.461},
+    {0, 0, 151, 2.192, 33.940},                {0, 0, 150, 2.997, 5.938},
+    {0, 0, 148, 0.859, 111.430},               {0, 0, 119, 3.677, 2.448},
+    {0, 0, 109, 2.416, 183.243},               {0, 0, 103, 0.041, 0.261},
+    {0, 0, 103, 4.404, 70.328},                {0, 0, 102, 5.705, 0.112},
+    {0, 1, 3837687717, 0, 0},                  {0, 1, 16604, 4.86319, 1.48447},
+    {0, 1, 15807, 2.27923, 38.13304},          {0, 1, 3335, 3.6820, 76.2661},
+    {0, 1, 1306, 3.6732, 2.9689},              {0, 1, 605, 1.505, 35.164},
+    {0, 1, 179, 3.453, 39.618},                {0, 1, 107, 2.451, 4.453},
+    {0, 1, 106, 2.755, 33.680},                {0, 1, 73, 5.49, 36.65},
+    {0, 1, 57, 1.86, 114.40},                  {0, 1, 57, 5.22, 0.52},
+    {0, 1, 35, 4.52, 74.78},                   {0, 1, 32, 5.90, 77.75},
+    {0, 1, 30, 3.67, 388.47},                  {0, 1, 29, 5.17, 9.56},
+    {0, 1, 29, 5.17, 2.45},                    {0, 1, 26, 5.25, 168.05},
+    {0, 2, 53893, 0, 0},                       {0, 2, 296, 1.855, 1.484},
+    {0, 2, 281, 1.191, 38.133},                {0, 2, 270, 5.721, 76.266},
+    {0, 2, 23, 1.21, 2.97},                    {0, 2, 9, 4.43, 35.16},
+    {0, 2, 7, 0.54, 2.45},                     {0, 3, 31, 0, 0},
+    {0, 3, 15, 1.35, 76.27},                   {0, 3, 12, 6.04, 1.48},
+    {0, 3, 12, 6.11, 38.13},                   {0, 4, 114, 3.142, 0},
+    {1, 0, 3088623, 1.4410437, 38.1330356},    {1, 0, 27780, 5.91272, 76.26607},
+    {1, 0, 27624, 0, 0},                       {1, 0, 15448, 3.50877, 39.61751},
+    {1, 0, 15355, 2.52124, 36.64856},          {1, 0, 2000, 1.5100, 74.7816},
+    {1, 0, 1968, 4.3778, 1.4845},              {1, 0, 1015, 3.2156, 35.1641},
+    {1, 0, 606, 2.802, 73.297},                {1, 0, 595, 2.129, 41.102},
+    {1, 0, 589, 3.187, 2.969},                 {1, 0, 402, 4.169, 114.399},
+    {1, 0, 280, 1.682, 77.751},                {1, 0, 262, 3.767, 213.299},
+    {1, 0, 254, 3.271, 453.425},               {1, 0, 206, 4.257, 529.691},
+    {1, 0, 140, 3.530, 137.033},               {1, 1, 227279, 3.807931, 38.133036},
+    {1, 1, 1803, 1.9758, 76.2661},             {1, 1, 1433, 3.1416, 0},
+    {1, 1, 1386, 4.8256, 36.6486},             {1, 1, 1073, 6.0805, 39.6175},
+    {1, 1, 148, 3.858, 74.782},                {1, 1, 136, 0.478, 1.484},
+    {1, 1, 70, 6.19, 35.16},                   {1, 1, 52, 5.05, 73.30},
+    {1, 1, 43, 0.31, 114.40},                  {1, 1, 37, 4.89, 41.10},
+    {1, 1, 37, 5.76, 2.97},                    {1, 1, 26, 5.22, 213.30},
+    {1, 2, 9691, 5.5712, 38.1330},             {1, 2, 79, 3.63, 76.27},
+    {1, 2, 72, 0.45, 36.65},                   {1, 2, 59, 3.14, 0},
+    {1, 2, 30, 1.61, 39.62},                   {1, 2, 6, 5.61, 74.78},
+    {1, 3, 273, 1.017, 38.133},                {1, 3, 2, 0, 0},
+    {1, 3, 2, 2.37, 36.65},                    {1, 3, 2, 5.33, 76.27},
+    {1, 4, 6, 2.67, 38.13},                    {2, 0, 3007013206, 0, 0},
+    {2, 0, 27062259, 1.32999459, 38.13303564}, {2, 0, 1691764, 3.2518614, 36.6485629},
+    {2, 0, 807831, 5.185928, 1.484473},        {2, 0, 537761, 4.521139, 35.164090},
+    {2, 0, 495726, 1.571057, 491.557929},      {2, 0, 274572, 1.845523, 175.166060},
+    {2, 0, 135134, 3.372206, 39.617508},       {2, 0, 121802, 5.797544, 76.266071},
+    {2, 0, 100895, 0.377027, 73.297126},       {2, 0, 69792, 3.79617, 2.96895},
+    {2, 0, 46688, 5.74938, 33.67962},          {2, 0, 24594, 0.50802, 109.94569},
+    {2, 0, 16939, 1.59422, 71.81265},          {2, 0, 14230, 1.07786, 74.78160},
+    {2, 0, 12012, 1.92062, 1021.24889},        {2, 0, 8395, 0.6782, 146.5943},
+    {2, 0, 7572, 1.0715, 388.4652},            {2, 0, 5721, 2.5906, 4.4534},
+    {2, 0, 4840, 1.9069, 41.1020},             {2, 0, 4483, 2.9057, 529.6910},
+    {2, 0, 4421, 1.7499, 108.4612},            {2, 0, 4354, 0.6799, 32.1645},
+    {2, 0, 4270, 3.4134, 453.4249},            {2, 0, 3381, 0.8481, 183.2428},
+    {2, 0, 2881, 1.9860, 137.0330},            {2, 0, 2879, 3.6742, 350.3321},
+    {2, 0, 2636, 3.0976, 213.2991},            {2, 0, 2530, 5.7984, 490.0735},
+    {2, 0, 2523, 0.4863, 493.0424},            {2, 0, 2306, 2.8096, 70.3282},
+    {2, 0, 2087, 0.6186, 33.9402},             {2, 1, 236339, 0.704980, 38.133036},
+    {2, 1, 13220, 3.32015, 1.48447},           {2, 1, 8622, 6.2163, 35.1641},
+    {2, 1, 2702, 1.8814, 39.6175},             {2, 1, 2155, 2.0943, 2.9689},
+    {2, 1, 2153, 5.1687, 76.2661},             {2, 1, 1603, 0, 0},
+    {2, 1, 1464, 1.1842, 33.6796},             {2, 1, 1136, 3.9189, 36.6486},
+    {2, 1, 898, 5.241, 388.465},               {2, 1, 790, 0.533, 168.053},
+    {2, 1, 760, 0.021, 182.280},               {2, 1, 607, 1.077, 1021.249},
+    {2, 1, 572, 3.401, 484.444},               {2, 1, 561, 2.887, 498.671},
+    {2, 2, 4247, 5.8991, 38.1330},             {2, 2, 218, 0.346, 1.484},
+    {2, 2, 163, 2.239, 168.053},               {2, 2, 156, 4.594, 182.280},
+    {2, 2, 127, 2.848, 35.164},                {2, 3, 166, 4.552, 38.133},
+};
+
+// Tabela de cada planeta, de Mercúrio a Netuno, no índice do número do planeta menos 1.
+const Vsop87Table VSOP87D_TABLES[8] = {
+    {VSOP87D_MERCURY, std::size(VSOP87D_MERCURY)},
+    {VSOP87D_VENUS, std::size(VSOP87D_VENUS)},
+    {VSOP87D_EARTH, std::size(VSOP87D_EARTH)},
+    {VSOP87D_MARS, std::size(VSOP87D_MARS)},
+    {VSOP87D_JUPITER, std::size(VSOP87D_JUPITER)},
+    {VSOP87D_SATURN, std::size(VSOP87D_SATURN)},
+    {VSOP87D_URANUS, std::size(VSOP87D_URANUS)},
+    {VSOP87D_NEPTUNE, std::size(VSOP87D_NEPTUNE)},
+};